@@ -0,0 +1,634 @@
+//===- llvm/ADT/SwissDenseMap.h - Group-probed hash table -------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the SwissDenseMap class, an open-addressing hash map with
+// the same interface as DenseMap for the common operations.
+//
+// Unlike DenseMap, which interleaves keys and values in one bucket array and
+// identifies empty buckets by comparing keys against sentinel values, a
+// SwissDenseMap keeps one control byte per slot in a separate array.  A full
+// slot's control byte holds seven bits of the key's hash, so a lookup first
+// compares a whole group of control bytes at once (with SSE2 when available)
+// and only touches the key array for the few slots whose hash tag matches.
+// Keys and values are stored in separate arrays so that probing never pulls
+// values into the cache.
+//
+// Because emptiness is tracked in the control bytes, the key type does not
+// need distinct empty and tombstone keys; only getHashValue and isEqual from
+// KeyInfoT are used.
+//
+// Iterators dereference to a proxy with `first` and `second` reference
+// members instead of a reference to a stored std::pair.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ADT_SWISSDENSEMAP_H
+#define LLVM_ADT_SWISSDENSEMAP_H
+
+#include "llvm/ADT/DenseMapInfo.h"
+#include "llvm/ADT/EpochTracker.h"
+#include "llvm/Support/Compiler.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/type_traits.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace llvm {
+
+namespace detail {
+
+/// Control byte values.  A full slot stores the low seven bits of its hash,
+/// so only the empty and deleted states have the sign bit set.
+enum : int8_t { SwissCtrlEmpty = -128, SwissCtrlDeleted = -2 };
+
+/// A group of consecutive control bytes that is matched as a unit.  Every
+/// match returns a bitmask with bit I set if control byte I matched.
+///
+/// The width decides where keys are placed, and lookups are inlined into
+/// their callers, so it must not depend on the flags a file is built with.
+/// It is 16 everywhere; wider vectors are not used.
+struct SwissGroup {
+  static constexpr unsigned Width = 16;
+
+#if defined(__SSE2__)
+  __m128i Ctrl;
+
+  explicit SwissGroup(const int8_t *Pos)
+      : Ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(Pos))) {}
+
+  uint32_t match(int8_t Tag) const {
+    return static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(Tag), Ctrl)));
+  }
+  uint32_t matchEmptyOrDeleted() const {
+    return static_cast<uint32_t>(_mm_movemask_epi8(Ctrl));
+  }
+#else
+  const int8_t *Ctrl;
+
+  explicit SwissGroup(const int8_t *Pos) : Ctrl(Pos) {}
+
+  uint32_t match(int8_t Tag) const {
+    uint32_t Mask = 0;
+    for (unsigned I = 0; I != Width; ++I)
+      if (Ctrl[I] == Tag)
+        Mask |= 1u << I;
+    return Mask;
+  }
+  uint32_t matchEmptyOrDeleted() const {
+    uint32_t Mask = 0;
+    for (unsigned I = 0; I != Width; ++I)
+      if (Ctrl[I] < 0)
+        Mask |= 1u << I;
+    return Mask;
+  }
+#endif
+
+  uint32_t matchEmpty() const { return match(SwissCtrlEmpty); }
+};
+
+/// The value an iterator dereferences to: references to the key and the
+/// value of one slot.
+template <typename KeyT, typename ValueT> struct SwissDenseMapRef {
+  const KeyT &first;
+  ValueT &second;
+
+  const KeyT &getFirst() const { return first; }
+  ValueT &getSecond() const { return second; }
+};
+
+} // end namespace detail
+
+template <typename KeyT, typename ValueT, typename KeyInfoT, bool IsConst>
+class SwissDenseMapIterator;
+
+template <typename KeyT, typename ValueT,
+          typename KeyInfoT = DenseMapInfo<KeyT>>
+class SwissDenseMap : public DebugEpochBase {
+  template <typename T>
+  using const_arg_type_t = typename const_pointer_or_const_ref<T>::type;
+
+  friend class SwissDenseMapIterator<KeyT, ValueT, KeyInfoT, false>;
+  friend class SwissDenseMapIterator<KeyT, ValueT, KeyInfoT, true>;
+
+  static constexpr unsigned GroupWidth = detail::SwissGroup::Width;
+
+  int8_t *Ctrl = nullptr;
+  KeyT *Keys = nullptr;
+  ValueT *Values = nullptr;
+  unsigned NumBuckets = 0;
+  unsigned NumEntries = 0;
+  unsigned NumTombstones = 0;
+
+public:
+  using size_type = unsigned;
+  using key_type = KeyT;
+  using mapped_type = ValueT;
+
+  using iterator = SwissDenseMapIterator<KeyT, ValueT, KeyInfoT, false>;
+  using const_iterator = SwissDenseMapIterator<KeyT, ValueT, KeyInfoT, true>;
+
+  /// Create a map with enough room for \p InitialReserve entries.
+  explicit SwissDenseMap(unsigned InitialReserve = 0) {
+    if (InitialReserve)
+      grow(getMinBucketToReserveForEntries(InitialReserve));
+  }
+
+  SwissDenseMap(const SwissDenseMap &Other) { copyFrom(Other); }
+
+  SwissDenseMap(SwissDenseMap &&Other) { swap(Other); }
+
+  template <typename InputIt>
+  SwissDenseMap(const InputIt &I, const InputIt &E) {
+    reserve(std::distance(I, E));
+    insert(I, E);
+  }
+
+  ~SwissDenseMap() {
+    destroyAll();
+    deallocate();
+  }
+
+  SwissDenseMap &operator=(const SwissDenseMap &Other) {
+    if (&Other != this) {
+      destroyAll();
+      deallocate();
+      copyFrom(Other);
+    }
+    return *this;
+  }
+
+  SwissDenseMap &operator=(SwissDenseMap &&Other) {
+    destroyAll();
+    deallocate();
+    NumBuckets = NumEntries = NumTombstones = 0;
+    swap(Other);
+    return *this;
+  }
+
+  void swap(SwissDenseMap &RHS) {
+    this->incrementEpoch();
+    RHS.incrementEpoch();
+    std::swap(Ctrl, RHS.Ctrl);
+    std::swap(Keys, RHS.Keys);
+    std::swap(Values, RHS.Values);
+    std::swap(NumBuckets, RHS.NumBuckets);
+    std::swap(NumEntries, RHS.NumEntries);
+    std::swap(NumTombstones, RHS.NumTombstones);
+  }
+
+  inline iterator begin() {
+    return empty() ? end() : iterator(this, 0, *this);
+  }
+  inline iterator end() { return iterator(this, NumBuckets, *this, true); }
+  inline const_iterator begin() const {
+    return empty() ? end() : const_iterator(this, 0, *this);
+  }
+  inline const_iterator end() const {
+    return const_iterator(this, NumBuckets, *this, true);
+  }
+
+  LLVM_NODISCARD bool empty() const { return NumEntries == 0; }
+  unsigned size() const { return NumEntries; }
+
+  /// Grow the map so that it can contain at least \p NumEntries items
+  /// before resizing again.
+  void reserve(size_type NumEntries) {
+    unsigned MinBuckets = getMinBucketToReserveForEntries(NumEntries);
+    incrementEpoch();
+    if (MinBuckets > NumBuckets)
+      grow(MinBuckets);
+  }
+
+  void clear() {
+    incrementEpoch();
+    if (NumEntries == 0 && NumTombstones == 0)
+      return;
+
+    // If the capacity of the array is huge, and the # elements used is small,
+    // shrink the array.
+    if (NumEntries * 4 < NumBuckets && NumBuckets > 64) {
+      shrink_and_clear();
+      return;
+    }
+
+    destroyAll();
+    std::memset(Ctrl, detail::SwissCtrlEmpty, NumBuckets);
+    NumEntries = 0;
+    NumTombstones = 0;
+  }
+
+  void shrink_and_clear() {
+    incrementEpoch();
+    unsigned OldNumEntries = NumEntries;
+    destroyAll();
+    deallocate();
+    NumBuckets = NumEntries = NumTombstones = 0;
+
+    // Reduce the number of buckets in the same way DenseMap does.
+    if (OldNumEntries)
+      grow(std::max(64u, 1u << (Log2_32_Ceil(OldNumEntries) + 1)));
+  }
+
+  /// Return 1 if the specified key is in the map, 0 otherwise.
+  size_type count(const_arg_type_t<KeyT> Val) const {
+    return lookupSlot(Val) != NumBuckets ? 1 : 0;
+  }
+
+  iterator find(const_arg_type_t<KeyT> Val) {
+    return iterator(this, lookupSlot(Val), *this, true);
+  }
+  const_iterator find(const_arg_type_t<KeyT> Val) const {
+    return const_iterator(this, lookupSlot(Val), *this, true);
+  }
+
+  /// Alternate version of find() which allows a different, and possibly
+  /// less expensive, key type.
+  /// The KeyInfoT is responsible for supplying methods
+  /// getHashValue(LookupKeyT) and isEqual(LookupKeyT, KeyT) for each key
+  /// type used.
+  template <class LookupKeyT> iterator find_as(const LookupKeyT &Val) {
+    return iterator(this, lookupSlot(Val), *this, true);
+  }
+  template <class LookupKeyT>
+  const_iterator find_as(const LookupKeyT &Val) const {
+    return const_iterator(this, lookupSlot(Val), *this, true);
+  }
+
+  /// lookup - Return the entry for the specified key, or a default
+  /// constructed value if no such entry exists.
+  ValueT lookup(const_arg_type_t<KeyT> Val) const {
+    unsigned Slot = lookupSlot(Val);
+    if (Slot != NumBuckets)
+      return Values[Slot];
+    return ValueT();
+  }
+
+  // Inserts key,value pair into the map if the key isn't already in the map.
+  // If the key is already in the map, it returns false and doesn't update the
+  // value.
+  std::pair<iterator, bool> insert(const std::pair<KeyT, ValueT> &KV) {
+    return try_emplace(KV.first, KV.second);
+  }
+
+  // Inserts key,value pair into the map if the key isn't already in the map.
+  // If the key is already in the map, it returns false and doesn't update the
+  // value.
+  std::pair<iterator, bool> insert(std::pair<KeyT, ValueT> &&KV) {
+    return try_emplace(std::move(KV.first), std::move(KV.second));
+  }
+
+  /// insert - Range insertion of pairs.
+  template <typename InputIt> void insert(InputIt I, InputIt E) {
+    for (; I != E; ++I)
+      insert(*I);
+  }
+
+  // Inserts key,value pair into the map if the key isn't already in the map.
+  // The value is constructed in-place if the key is not in the map, otherwise
+  // it is not moved.
+  template <typename... Ts>
+  std::pair<iterator, bool> try_emplace(KeyT &&Key, Ts &&... Args) {
+    unsigned Slot = lookupSlot(Key);
+    if (Slot != NumBuckets)
+      return std::make_pair(iterator(this, Slot, *this, true), false);
+
+    Slot = prepareInsertSlot(Key);
+    ::new (&Keys[Slot]) KeyT(std::move(Key));
+    ::new (&Values[Slot]) ValueT(std::forward<Ts>(Args)...);
+    return std::make_pair(iterator(this, Slot, *this, true), true);
+  }
+
+  // Inserts key,value pair into the map if the key isn't already in the map.
+  // The value is constructed in-place if the key is not in the map, otherwise
+  // it is not moved.
+  template <typename... Ts>
+  std::pair<iterator, bool> try_emplace(const KeyT &Key, Ts &&... Args) {
+    unsigned Slot = lookupSlot(Key);
+    if (Slot != NumBuckets)
+      return std::make_pair(iterator(this, Slot, *this, true), false);
+
+    Slot = prepareInsertSlot(Key);
+    ::new (&Keys[Slot]) KeyT(Key);
+    ::new (&Values[Slot]) ValueT(std::forward<Ts>(Args)...);
+    return std::make_pair(iterator(this, Slot, *this, true), true);
+  }
+
+  bool erase(const KeyT &Val) {
+    unsigned Slot = lookupSlot(Val);
+    if (Slot == NumBuckets)
+      return false; // not in map.
+    eraseSlot(Slot);
+    return true;
+  }
+  void erase(iterator I) {
+    assert(I.Slot < NumBuckets && "Erasing the end iterator!");
+    eraseSlot(I.Slot);
+  }
+
+  ValueT &operator[](const KeyT &Key) {
+    return try_emplace(Key).first->second;
+  }
+
+  ValueT &operator[](KeyT &&Key) {
+    return try_emplace(std::move(Key)).first->second;
+  }
+
+  /// Return the approximate size (in bytes) of the actual map.
+  /// This is just the raw memory used by the map; if entries point to
+  /// heap data it is not included.
+  size_t getMemorySize() const {
+    return NumBuckets * (1 + sizeof(KeyT) + sizeof(ValueT));
+  }
+
+private:
+  /// Mix the key hash so that both the group index (high bits) and the
+  /// control tag (low seven bits) are well distributed even for the weak
+  /// pointer hashes DenseMapInfo provides.
+  template <typename LookupKeyT>
+  static uint64_t getHash(const LookupKeyT &Val) {
+    uint64_t H = static_cast<uint64_t>(KeyInfoT::getHashValue(Val)) *
+                 0x9E3779B97F4A7C15ULL;
+    return H ^ (H >> 32);
+  }
+  static int8_t getTag(uint64_t Hash) { return Hash & 0x7F; }
+  unsigned getFirstGroup(uint64_t Hash) const {
+    return (Hash >> 7) & (NumBuckets / GroupWidth - 1);
+  }
+  unsigned getNextGroup(unsigned Group, unsigned Probe) const {
+    // Triangular probing visits every group of a power-of-two table.
+    return (Group + Probe) & (NumBuckets / GroupWidth - 1);
+  }
+
+  static unsigned getMinBucketToReserveForEntries(unsigned NumEntries) {
+    // Ensure that "NumEntries * 8 <= NumBuckets * 7".
+    if (NumEntries == 0)
+      return 0;
+    return std::max(GroupWidth,
+                    unsigned(NextPowerOf2(NumEntries * 8 / 7 + 1)));
+  }
+
+  /// Return the slot holding \p Val, or NumBuckets if it is not in the map.
+  template <typename LookupKeyT>
+  unsigned lookupSlot(const LookupKeyT &Val) const {
+    if (NumBuckets == 0)
+      return NumBuckets;
+
+    uint64_t Hash = getHash(Val);
+    int8_t Tag = getTag(Hash);
+    unsigned Group = getFirstGroup(Hash);
+    for (unsigned Probe = 1;; ++Probe) {
+      unsigned Base = Group * GroupWidth;
+      detail::SwissGroup G(Ctrl + Base);
+      for (uint32_t M = G.match(Tag); M; M &= M - 1) {
+        unsigned Slot = Base + countTrailingZeros(M);
+        if (LLVM_LIKELY(KeyInfoT::isEqual(Val, Keys[Slot])))
+          return Slot;
+      }
+      // An empty slot terminates the probe sequence of every key that could
+      // have been placed in this group.
+      if (LLVM_LIKELY(G.matchEmpty()))
+        return NumBuckets;
+      assert(Probe <= NumBuckets / GroupWidth && "Probed every group!");
+      Group = getNextGroup(Group, Probe);
+    }
+  }
+
+  /// Return the first empty or deleted slot on the probe sequence of
+  /// \p Hash.  The table must have at least one empty slot.
+  unsigned findFirstNonFull(uint64_t Hash) const {
+    unsigned Group = getFirstGroup(Hash);
+    for (unsigned Probe = 1;; ++Probe) {
+      unsigned Base = Group * GroupWidth;
+      if (uint32_t M = detail::SwissGroup(Ctrl + Base).matchEmptyOrDeleted())
+        return Base + countTrailingZeros(M);
+      assert(Probe <= NumBuckets / GroupWidth && "Probed every group!");
+      Group = getNextGroup(Group, Probe);
+    }
+  }
+
+  /// Make room for a new key \p Val that is known not to be in the map and
+  /// return the slot it should be constructed in.  The slot is marked full.
+  template <typename LookupKeyT>
+  unsigned prepareInsertSlot(const LookupKeyT &Val) {
+    incrementEpoch();
+
+    // Keep the load factor, including tombstones, at or below 7/8 so that
+    // every probe sequence reaches an empty slot.  If only tombstones push
+    // us over, rehash in place instead of growing.
+    if (LLVM_UNLIKELY((NumEntries + 1) * 8 > NumBuckets * 7))
+      grow(std::max(GroupWidth, NumBuckets * 2));
+    else if (LLVM_UNLIKELY((NumEntries + NumTombstones + 1) * 8 >
+                           NumBuckets * 7))
+      grow(NumBuckets);
+
+    uint64_t Hash = getHash(Val);
+    unsigned Slot = findFirstNonFull(Hash);
+    if (Ctrl[Slot] == detail::SwissCtrlDeleted)
+      --NumTombstones;
+    Ctrl[Slot] = getTag(Hash);
+    ++NumEntries;
+    return Slot;
+  }
+
+  void eraseSlot(unsigned Slot) {
+    incrementEpoch();
+    Keys[Slot].~KeyT();
+    Values[Slot].~ValueT();
+    --NumEntries;
+
+    // If the group already has an empty slot, no probe sequence continues
+    // past it, so the slot can become empty again instead of a tombstone.
+    unsigned Base = Slot - Slot % GroupWidth;
+    if (detail::SwissGroup(Ctrl + Base).matchEmpty()) {
+      Ctrl[Slot] = detail::SwissCtrlEmpty;
+      return;
+    }
+    Ctrl[Slot] = detail::SwissCtrlDeleted;
+    ++NumTombstones;
+  }
+
+  /// Reallocate the table with at least \p AtLeast slots and reinsert every
+  /// entry.  This also drops all tombstones.
+  void grow(unsigned AtLeast) {
+    int8_t *OldCtrl = Ctrl;
+    KeyT *OldKeys = Keys;
+    ValueT *OldValues = Values;
+    unsigned OldNumBuckets = NumBuckets;
+
+    allocate(std::max(GroupWidth, unsigned(NextPowerOf2(AtLeast - 1))));
+    NumTombstones = 0;
+    if (!OldCtrl)
+      return;
+
+    for (unsigned I = 0; I != OldNumBuckets; ++I) {
+      if (OldCtrl[I] < 0)
+        continue;
+      unsigned Slot = findFirstNonFull(getHash(OldKeys[I]));
+      Ctrl[Slot] = OldCtrl[I];
+      ::new (&Keys[Slot]) KeyT(std::move(OldKeys[I]));
+      ::new (&Values[Slot]) ValueT(std::move(OldValues[I]));
+      OldKeys[I].~KeyT();
+      OldValues[I].~ValueT();
+    }
+
+    operator delete(OldCtrl);
+    operator delete(OldKeys);
+    operator delete(OldValues);
+  }
+
+  void allocate(unsigned Num) {
+    NumBuckets = Num;
+    Ctrl = static_cast<int8_t *>(operator new(NumBuckets));
+    Keys = static_cast<KeyT *>(operator new(sizeof(KeyT) * NumBuckets));
+    Values = static_cast<ValueT *>(operator new(sizeof(ValueT) * NumBuckets));
+    std::memset(Ctrl, detail::SwissCtrlEmpty, NumBuckets);
+  }
+
+  void deallocate() {
+    operator delete(Ctrl);
+    operator delete(Keys);
+    operator delete(Values);
+    Ctrl = nullptr;
+    Keys = nullptr;
+    Values = nullptr;
+  }
+
+  void destroyAll() {
+    if (NumEntries == 0)
+      return;
+    for (unsigned I = 0; I != NumBuckets; ++I) {
+      if (Ctrl[I] < 0)
+        continue;
+      Keys[I].~KeyT();
+      Values[I].~ValueT();
+    }
+  }
+
+  void copyFrom(const SwissDenseMap &Other) {
+    incrementEpoch();
+    NumBuckets = NumEntries = NumTombstones = 0;
+    if (Other.NumBuckets == 0)
+      return;
+
+    allocate(Other.NumBuckets);
+    NumEntries = Other.NumEntries;
+    NumTombstones = Other.NumTombstones;
+    std::memcpy(Ctrl, Other.Ctrl, NumBuckets);
+    for (unsigned I = 0; I != NumBuckets; ++I) {
+      if (Ctrl[I] < 0)
+        continue;
+      ::new (&Keys[I]) KeyT(Other.Keys[I]);
+      ::new (&Values[I]) ValueT(Other.Values[I]);
+    }
+  }
+};
+
+template <typename KeyT, typename ValueT, typename KeyInfoT, bool IsConst>
+class SwissDenseMapIterator : DebugEpochBase::HandleBase {
+  friend class SwissDenseMap<KeyT, ValueT, KeyInfoT>;
+  friend class SwissDenseMapIterator<KeyT, ValueT, KeyInfoT, true>;
+  friend class SwissDenseMapIterator<KeyT, ValueT, KeyInfoT, false>;
+
+  using MapT = typename std::conditional<
+      IsConst, const SwissDenseMap<KeyT, ValueT, KeyInfoT>,
+      SwissDenseMap<KeyT, ValueT, KeyInfoT>>::type;
+
+public:
+  using difference_type = ptrdiff_t;
+  using value_type = detail::SwissDenseMapRef<
+      KeyT, typename std::conditional<IsConst, const ValueT, ValueT>::type>;
+  using reference = value_type;
+  using iterator_category = std::forward_iterator_tag;
+
+  /// operator-> needs somewhere to keep the reference proxy alive.
+  class pointer {
+    value_type Ref;
+
+  public:
+    pointer(value_type Ref) : Ref(Ref) {}
+    const value_type *operator->() const { return &Ref; }
+  };
+
+private:
+  MapT *Map = nullptr;
+  unsigned Slot = 0;
+
+public:
+  SwissDenseMapIterator() = default;
+
+  SwissDenseMapIterator(MapT *Map, unsigned Slot, const DebugEpochBase &Epoch,
+                        bool NoAdvance = false)
+      : DebugEpochBase::HandleBase(&Epoch), Map(Map), Slot(Slot) {
+    assert(isHandleInSync() && "invalid construction!");
+    if (!NoAdvance)
+      AdvancePastEmptyBuckets();
+  }
+
+  // Converting ctor from non-const iterators to const iterators. SFINAE'd out
+  // for const iterator destinations so it doesn't end up as a user defined copy
+  // constructor.
+  template <bool IsConstSrc,
+            typename = typename std::enable_if<!IsConstSrc && IsConst>::type>
+  SwissDenseMapIterator(
+      const SwissDenseMapIterator<KeyT, ValueT, KeyInfoT, IsConstSrc> &I)
+      : DebugEpochBase::HandleBase(I), Map(I.Map), Slot(I.Slot) {}
+
+  reference operator*() const {
+    assert(isHandleInSync() && "invalid iterator access!");
+    assert(Slot < Map->NumBuckets && "dereferencing end() iterator");
+    return value_type{Map->Keys[Slot], Map->Values[Slot]};
+  }
+  pointer operator->() const { return pointer(**this); }
+
+  bool operator==(const SwissDenseMapIterator &RHS) const {
+    assert((!Map || isHandleInSync()) && "handle not in sync!");
+    assert((!RHS.Map || RHS.isHandleInSync()) && "handle not in sync!");
+    assert(getEpochAddress() == RHS.getEpochAddress() &&
+           "comparing incomparable iterators!");
+    return Slot == RHS.Slot;
+  }
+  bool operator!=(const SwissDenseMapIterator &RHS) const {
+    return !(*this == RHS);
+  }
+
+  inline SwissDenseMapIterator &operator++() { // Preincrement
+    assert(isHandleInSync() && "invalid iterator access!");
+    ++Slot;
+    AdvancePastEmptyBuckets();
+    return *this;
+  }
+  SwissDenseMapIterator operator++(int) { // Postincrement
+    assert(isHandleInSync() && "invalid iterator access!");
+    SwissDenseMapIterator tmp = *this;
+    ++*this;
+    return tmp;
+  }
+
+private:
+  void AdvancePastEmptyBuckets() {
+    while (Slot < Map->NumBuckets && Map->Ctrl[Slot] < 0)
+      ++Slot;
+  }
+};
+
+} // end namespace llvm
+
+#endif // LLVM_ADT_SWISSDENSEMAP_H
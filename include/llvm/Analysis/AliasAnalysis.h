@@ -38,6 +38,7 @@
 #ifndef LLVM_ANALYSIS_ALIASANALYSIS_H
 #define LLVM_ANALYSIS_ALIASANALYSIS_H
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/Analysis/MemoryLocation.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/IR/CallSite.h"
@@ -656,6 +657,63 @@ private:
 /// pointer or reference.
 typedef AAResults AliasAnalysis;
 
+/// A wrapper around \c AAResults that remembers the result of every alias
+/// and instruction mod/ref query it answers.
+///
+/// \c AAResults itself does not cache across top-level queries, so clients
+/// that ask about the same pairs of locations many times (for example while
+/// building several alias set trackers over the same loop) pay for the full
+/// analysis each time.  A \c BatchAAResults may only be used while the IR is
+/// not modified in a way that changes aliasing: in particular no \c Value
+/// mentioned in a cached query may be deleted, since its address could be
+/// reused.  Call \c clear() after such a change.
+class BatchAAResults {
+  AAResults &AA;
+
+  typedef std::pair<MemoryLocation, MemoryLocation> LocPair;
+  SmallDenseMap<LocPair, AliasResult, 8> AliasCache;
+  typedef std::pair<const Instruction *, MemoryLocation> InstLocPair;
+  SmallDenseMap<InstLocPair, ModRefInfo, 8> ModRefCache;
+
+public:
+  explicit BatchAAResults(AAResults &AA) : AA(AA) {}
+
+  AliasResult alias(const MemoryLocation &LocA, const MemoryLocation &LocB);
+
+  bool isNoAlias(const MemoryLocation &LocA, const MemoryLocation &LocB) {
+    return alias(LocA, LocB) == NoAlias;
+  }
+
+  bool isMustAlias(const MemoryLocation &LocA, const MemoryLocation &LocB) {
+    return alias(LocA, LocB) == MustAlias;
+  }
+
+  ModRefInfo getModRefInfo(const Instruction *I, const MemoryLocation &Loc);
+
+  /// Call site to call site queries are not cached.
+  ModRefInfo getModRefInfo(ImmutableCallSite CS1, ImmutableCallSite CS2) {
+    return AA.getModRefInfo(CS1, CS2);
+  }
+
+  FunctionModRefBehavior getModRefBehavior(ImmutableCallSite CS) {
+    return AA.getModRefBehavior(CS);
+  }
+
+  bool pointsToConstantMemory(const MemoryLocation &Loc,
+                              bool OrLocal = false) {
+    return AA.pointsToConstantMemory(Loc, OrLocal);
+  }
+
+  /// Forget every cached result.  This must be called after the IR is
+  /// changed in a way that may invalidate them.
+  void clear() {
+    AliasCache.clear();
+    ModRefCache.clear();
+  }
+
+  AAResults &getAAResults() const { return AA; }
+};
+
 /// A private abstract base class describing the concept of an individual alias
 /// analysis implementation.
 ///
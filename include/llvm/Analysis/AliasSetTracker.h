@@ -296,10 +296,13 @@ private:
 
 public:
   /// Return true if the specified pointer "may" (or must) alias one of the
-  /// members in the set.
+  /// members in the set.  \p AA is either an \c AliasAnalysis or a
+  /// \c BatchAAResults.
+  template <typename AAT>
   bool aliasesPointer(const Value *Ptr, uint64_t Size, const AAMDNodes &AAInfo,
-                      AliasAnalysis &AA) const;
-  bool aliasesUnknownInst(const Instruction *Inst, AliasAnalysis &AA) const;
+                      AAT &AA) const;
+  template <typename AAT>
+  bool aliasesUnknownInst(const Instruction *Inst, AAT &AA) const;
 };
 
 inline raw_ostream& operator<<(raw_ostream &OS, const AliasSet &AS) {
@@ -324,6 +327,7 @@ class AliasSetTracker {
   struct ASTCallbackVHDenseMapInfo : public DenseMapInfo<Value *> {};
 
   AliasAnalysis &AA;
+  BatchAAResults *BatchAA = nullptr;
   ilist<AliasSet> AliasSets;
 
   typedef DenseMap<ASTCallbackVH, AliasSet::PointerRec*,
@@ -338,6 +342,15 @@ public:
   /// analysis object to disambiguate load and store addresses.
   explicit AliasSetTracker(AliasAnalysis &aa)
       : AA(aa), TotalMayAliasSetSize(0), AliasAnyAS(nullptr) {}
+
+  /// Create an empty collection of AliasSets whose alias queries go through
+  /// \p BatchAA, so that queries repeated across trackers sharing it are only
+  /// computed once.  The caller must keep the IR unchanged while \p BatchAA is
+  /// in use, except for deletions reported through deleteValue, which clear
+  /// it.
+  AliasSetTracker(AliasAnalysis &aa, BatchAAResults &BatchAA)
+      : AA(aa), BatchAA(&BatchAA), TotalMayAliasSetSize(0),
+        AliasAnyAS(nullptr) {}
   ~AliasSetTracker() { clear(); }
 
   /// These methods are used to add different types of instructions to the alias
@@ -389,6 +402,9 @@ public:
   /// Return the underlying alias analysis object used by this tracker.
   AliasAnalysis &getAliasAnalysis() const { return AA; }
 
+  /// Return the batch alias analysis used by this tracker, if any.
+  BatchAAResults *getBatchAAResults() const { return BatchAA; }
+
   /// This method is used to remove a pointer value from the AliasSetTracker
   /// entirely. It should be used when an instruction is deleted from the
   /// program to update the AST. If you don't use this, you would have dangling
@@ -444,6 +460,23 @@ private:
   AliasSet &mergeAllAliasSets();
 
   AliasSet *findAliasSetForUnknownInst(Instruction *Inst);
+
+  // Alias queries made on behalf of the alias sets go through BatchAA when
+  // the tracker has one.
+  AliasResult alias(const MemoryLocation &LocA,
+                    const MemoryLocation &LocB) const {
+    return BatchAA ? BatchAA->alias(LocA, LocB) : AA.alias(LocA, LocB);
+  }
+  bool setAliasesPointer(const AliasSet &AS, const Value *Ptr, uint64_t Size,
+                         const AAMDNodes &AAInfo) const {
+    return BatchAA ? AS.aliasesPointer(Ptr, Size, AAInfo, *BatchAA)
+                   : AS.aliasesPointer(Ptr, Size, AAInfo, AA);
+  }
+  bool setAliasesUnknownInst(const AliasSet &AS,
+                             const Instruction *Inst) const {
+    return BatchAA ? AS.aliasesUnknownInst(Inst, *BatchAA)
+                   : AS.aliasesUnknownInst(Inst, AA);
+  }
 };
 
 inline raw_ostream& operator<<(raw_ostream &OS, const AliasSetTracker &AST) {
@@ -50,6 +50,7 @@ class Pass;
 class TargetLibraryInfo;
 class Type;
 class Value;
+class ValueTrackingCache;
 
 struct SimplifyQuery {
   const DataLayout &DL;
@@ -57,6 +58,8 @@ struct SimplifyQuery {
   const DominatorTree *DT = nullptr;
   AssumptionCache *AC = nullptr;
   const Instruction *CxtI = nullptr;
+  /// Optional cache for the ValueTracking queries made while simplifying.
+  ValueTrackingCache *VTC = nullptr;
 
   SimplifyQuery(const DataLayout &DL, const Instruction *CXTI = nullptr)
       : DL(DL), CxtI(CXTI) {}
@@ -71,6 +74,11 @@ struct SimplifyQuery {
     Copy.CxtI = I;
     return Copy;
   }
+  SimplifyQuery getWithCache(ValueTrackingCache *Cache) const {
+    SimplifyQuery Copy(*this);
+    Copy.VTC = Cache;
+    return Copy;
+  }
 };
 
 // NOTE: the explicit multiple argument versions of these functions are
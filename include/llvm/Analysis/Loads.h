@@ -21,7 +21,10 @@
 namespace llvm {
 
 class DataLayout;
+class LoadInst;
+class Loop;
 class MDNode;
+class ScalarEvolution;
 
 /// Return true if this is always a dereferenceable pointer. If the context
 /// instruction is specified perform context-sensitive analysis and return true
@@ -48,6 +51,15 @@ bool isDereferenceableAndAlignedPointer(const Value *V, unsigned Align,
                                         const Instruction *CtxI = nullptr,
                                         const DominatorTree *DT = nullptr);
 
+/// Return true if \p LI can be executed in every iteration of \p L that
+/// reaches the loop latch, including iterations that an earlier exit would
+/// have skipped. This holds if the loaded address is loop invariant and
+/// dereferenceable, or if it advances by one element per iteration over a
+/// range, covering the constant trip count of the latch exit, that is known
+/// to be dereferenceable and aligned on entry to the loop.
+bool isDereferenceableAndAlignedInLoop(LoadInst *LI, Loop *L,
+                                       ScalarEvolution &SE, DominatorTree &DT);
+
 /// Return true if we know that executing a load from this value cannot trap.
 ///
 /// If DT and ScanFrom are specified this method performs context-sensitive
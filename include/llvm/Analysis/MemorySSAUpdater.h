@@ -63,6 +63,10 @@ private:
 
 public:
   MemorySSAUpdater(MemorySSA *MSSA) : MSSA(MSSA) {}
+
+  /// Get the MemorySSA this updater keeps up to date.
+  MemorySSA *getMemorySSA() const { return MSSA; }
+
   /// Insert a definition into the MemorySSA IR.  RenameUses will rename any use
   /// below the new def block (and any inserted phis).  RenameUses should be set
   /// to true if the definition may cause new aliases for loads below it.  This
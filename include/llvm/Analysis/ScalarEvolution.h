@@ -692,6 +692,10 @@ private:
     /// subexpression.
     bool hasOperand(const SCEV *S, ScalarEvolution *SE) const;
 
+    /// Add every expression for which hasOperand would return true to \p Ops.
+    void collectOperands(ScalarEvolution *SE,
+                         SmallPtrSetImpl<const SCEV *> &Ops) const;
+
     /// Invalidate this result and free associated memory.
     void clear();
   };
@@ -704,6 +708,14 @@ private:
   /// function as they are computed.
   DenseMap<const Loop *, BackedgeTakenInfo> PredicatedBackedgeTakenCounts;
 
+  /// Reverse map from each subexpression of a cached backedge-taken count to
+  /// the loops whose counts contain it.  The integer part says whether the
+  /// count is in PredicatedBackedgeTakenCounts.  This lets invalidating an
+  /// expression drop exactly the counts that depend on it, instead of
+  /// scanning every cached count.
+  DenseMap<const SCEV *, SmallPtrSet<PointerIntPair<const Loop *, 1, bool>, 4>>
+      BECountUsers;
+
   /// This map contains entries for all of the PHI instructions that we
   /// attempt to compute constant evolutions for.  This allows us to avoid
   /// potentially expensive recomputation of these properties.  An instruction
@@ -1096,7 +1108,18 @@ private:
   Optional<APInt> computeConstantDifference(const SCEV *LHS, const SCEV *RHS);
 
   /// Drop memoized information computed for S.
-  void forgetMemoizedResults(const SCEV *S);
+  void forgetMemoizedResults(const SCEV *S) {
+    forgetMemoizedResults(makeArrayRef(S));
+  }
+
+  /// Drop memoized information computed for all of \p SCEVs at once.  This
+  /// walks the caches that are not keyed by expression only once per batch.
+  void forgetMemoizedResults(ArrayRef<const SCEV *> SCEVs);
+
+  /// Record (or, with \p Add false, drop) \p L as a user of the expressions
+  /// in its backedge-taken count \p BTI, in BECountUsers.
+  void updateBECountUsers(const Loop *L, bool Predicated,
+                          const BackedgeTakenInfo &BTI, bool Add);
 
   /// Return an existing SCEV for V if there is one, otherwise return nullptr.
   const SCEV *getExistingSCEV(Value *V);
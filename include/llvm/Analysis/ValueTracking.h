@@ -15,10 +15,15 @@
 #ifndef LLVM_ANALYSIS_VALUETRACKING_H
 #define LLVM_ANALYSIS_VALUETRACKING_H
 
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/IR/CallSite.h"
 #include "llvm/IR/Instruction.h"
 #include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/ValueHandle.h"
 #include "llvm/Support/DataTypes.h"
+#include "llvm/Support/KnownBits.h"
 
 namespace llvm {
 template <typename T> class ArrayRef;
@@ -42,6 +47,77 @@ template <typename T> class ArrayRef;
   enum ID : unsigned;
   }
 
+  /// Memoizes the results of top-level computeKnownBits, ComputeNumSignBits
+  /// and isKnownNonZero queries, keyed on the value and context instruction.
+  ///
+  /// A cache must only be used with one DataLayout, AssumptionCache and
+  /// DominatorTree.  Entries are dropped when the value or context instruction
+  /// they were computed for is deleted or replaced, but not when an
+  /// instruction feeding the value is changed in place; clients that do that
+  /// must clear() the cache.
+  class ValueTrackingCache {
+  public:
+    using KeyT = std::pair<const Value *, const Instruction *>;
+
+  private:
+    class InvalidationVH final : public CallbackVH {
+      ValueTrackingCache *Cache;
+
+      void deleted() override;
+      void allUsesReplacedWith(Value *) override;
+
+    public:
+      InvalidationVH(Value *V, ValueTrackingCache *Cache = nullptr)
+          : CallbackVH(V), Cache(Cache) {}
+    };
+
+    DenseMap<KeyT, KnownBits> KnownBitsMap;
+    DenseMap<KeyT, unsigned> NumSignBitsMap;
+    DenseMap<KeyT, bool> NonZeroMap;
+
+    /// The keys each value takes part in, as the queried value or as the
+    /// context instruction.
+    DenseMap<InvalidationVH, SmallVector<KeyT, 2>, DenseMapInfo<Value *>>
+        KeysByValue;
+
+    void track(const KeyT &Key);
+
+  public:
+    ValueTrackingCache() = default;
+    ValueTrackingCache(const ValueTrackingCache &) = delete;
+    ValueTrackingCache &operator=(const ValueTrackingCache &) = delete;
+
+    const KnownBits *lookupKnownBits(const KeyT &Key) const {
+      auto I = KnownBitsMap.find(Key);
+      return I == KnownBitsMap.end() ? nullptr : &I->second;
+    }
+    void insertKnownBits(const KeyT &Key, const KnownBits &Known);
+
+    Optional<unsigned> lookupNumSignBits(const KeyT &Key) const {
+      auto I = NumSignBitsMap.find(Key);
+      if (I == NumSignBitsMap.end())
+        return None;
+      return I->second;
+    }
+    void insertNumSignBits(const KeyT &Key, unsigned NumSignBits);
+
+    Optional<bool> lookupNonZero(const KeyT &Key) const {
+      auto I = NonZeroMap.find(Key);
+      if (I == NonZeroMap.end())
+        return None;
+      return I->second;
+    }
+    void insertNonZero(const KeyT &Key, bool NonZero);
+
+    /// Drop every result computed for \p V or in the context of \p V.
+    void invalidate(Value *V);
+
+    /// Drop all cached results.
+    void clear();
+
+    bool empty() const { return KeysByValue.empty(); }
+  };
+
   /// Determine which bits of V are known to be either zero or one and return
   /// them in the KnownZero/KnownOne bit sets.
   ///
@@ -50,18 +126,22 @@ template <typename T> class ArrayRef;
   /// where V is a vector, the known zero and known one values are the
   /// same width as the vector element, and the bit is set only if it is true
   /// for all of the elements in the vector.
+  ///
+  /// If \p VTC is given, top-level results are looked up in and added to it.
   void computeKnownBits(const Value *V, KnownBits &Known,
                         const DataLayout &DL, unsigned Depth = 0,
                         AssumptionCache *AC = nullptr,
                         const Instruction *CxtI = nullptr,
                         const DominatorTree *DT = nullptr,
-                        OptimizationRemarkEmitter *ORE = nullptr);
+                        OptimizationRemarkEmitter *ORE = nullptr,
+                        ValueTrackingCache *VTC = nullptr);
   /// Returns the known bits rather than passing by reference.
   KnownBits computeKnownBits(const Value *V, const DataLayout &DL,
                              unsigned Depth = 0, AssumptionCache *AC = nullptr,
                              const Instruction *CxtI = nullptr,
                              const DominatorTree *DT = nullptr,
-                             OptimizationRemarkEmitter *ORE = nullptr);
+                             OptimizationRemarkEmitter *ORE = nullptr,
+                             ValueTrackingCache *VTC = nullptr);
   /// Compute known bits from the range metadata.
   /// \p KnownZero the set of bits that are known to be zero
   /// \p KnownOne the set of bits that are known to be one
@@ -96,7 +176,8 @@ template <typename T> class ArrayRef;
   bool isKnownNonZero(const Value *V, const DataLayout &DL, unsigned Depth = 0,
                       AssumptionCache *AC = nullptr,
                       const Instruction *CxtI = nullptr,
-                      const DominatorTree *DT = nullptr);
+                      const DominatorTree *DT = nullptr,
+                      ValueTrackingCache *VTC = nullptr);
 
   /// Returns true if the give value is known to be non-negative.
   bool isKnownNonNegative(const Value *V, const DataLayout &DL,
@@ -139,7 +220,8 @@ template <typename T> class ArrayRef;
                          const DataLayout &DL,
                          unsigned Depth = 0, AssumptionCache *AC = nullptr,
                          const Instruction *CxtI = nullptr,
-                         const DominatorTree *DT = nullptr);
+                         const DominatorTree *DT = nullptr,
+                         ValueTrackingCache *VTC = nullptr);
 
   /// Return the number of times the sign bit of the register is replicated into
   /// the other bits. We know that at least 1 bit is always equal to the sign
@@ -151,7 +233,8 @@ template <typename T> class ArrayRef;
   unsigned ComputeNumSignBits(const Value *Op, const DataLayout &DL,
                               unsigned Depth = 0, AssumptionCache *AC = nullptr,
                               const Instruction *CxtI = nullptr,
-                              const DominatorTree *DT = nullptr);
+                              const DominatorTree *DT = nullptr,
+                              ValueTrackingCache *VTC = nullptr);
 
   /// This function computes the integer multiple of Base that equals V. If
   /// successful, it returns true and returns the multiple in Multiple. If
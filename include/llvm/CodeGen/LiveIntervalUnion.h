@@ -23,6 +23,7 @@
 #include "llvm/CodeGen/SlotIndexes.h"
 #include <cassert>
 #include <limits>
+#include <utility>
 
 namespace llvm {
 
@@ -58,10 +59,24 @@ public:
   // LiveIntervalUnions share an external allocator.
   using Allocator = LiveSegments::Allocator;
 
+  /// The slot index bounds of a live range that was added or removed.
+  using ChangedRange = std::pair<SlotIndex, SlotIndex>;
+
 private:
   unsigned Tag = 0;       // unique tag for current contents.
   LiveSegments Segments;  // union of virtual reg segments
 
+  // The bounds of the live ranges added or removed by the most recent
+  // changes, indexed by their tag modulo ChangeLogSize.
+  enum { ChangeLogSize = 8 };
+  struct Change {
+    unsigned Tag = 0;
+    ChangedRange Range;
+  };
+  Change ChangeLog[ChangeLogSize];
+
+  void recordChange(const LiveRange &Range);
+
 public:
   explicit LiveIntervalUnion(Allocator &a) : Segments(a) {}
 
@@ -87,6 +102,12 @@ public:
   /// changedSince - Return true if the union change since getTag returned tag.
   bool changedSince(unsigned tag) const { return tag != Tag; }
 
+  /// getChangesSince - Append the bounds of the live ranges added or removed
+  /// since getTag returned tag to Changes.  Return false if the union has
+  /// changed too much since then to tell.
+  bool getChangesSince(unsigned tag,
+                       SmallVectorImpl<ChangedRange> &Changes) const;
+
   // Add a live virtual register to this union and merge its segments.
   void unify(LiveInterval &VirtReg, const LiveRange &Range);
 
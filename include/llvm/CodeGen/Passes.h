@@ -403,6 +403,10 @@ namespace llvm {
   /// if available with PysicalRegisterUsageInfo pass.
   FunctionPass *createRegUsageInfoPropPass();
 
+  /// This pass gives small, hot, internal leaf functions a calling convention
+  /// that preserves most registers across calls to them.
+  ModulePass *createHotLeafCallingConvPass();
+
   /// This pass performs software pipelining on machine instructions.
   extern char &MachinePipelinerID;
 
@@ -23,6 +23,7 @@
 #include "llvm/ADT/IntervalMap.h"
 #include "llvm/ADT/PointerIntPair.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/SwissDenseMap.h"
 #include "llvm/ADT/ilist.h"
 #include "llvm/CodeGen/MachineBasicBlock.h"
 #include "llvm/CodeGen/MachineFunction.h"
@@ -342,7 +343,7 @@ class raw_ostream;
 
     MachineFunction *mf;
 
-    using Mi2IndexMap = DenseMap<const MachineInstr *, SlotIndex>;
+    using Mi2IndexMap = SwissDenseMap<const MachineInstr *, SlotIndex>;
     Mi2IndexMap mi2iMap;
 
     /// MBBRanges - Map MBB number to (start, stop) indexes.
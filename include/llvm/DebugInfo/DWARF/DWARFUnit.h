@@ -10,6 +10,7 @@
 #ifndef LLVM_DEBUGINFO_DWARF_DWARFUNIT_H
 #define LLVM_DEBUGINFO_DWARF_DWARFUNIT_H
 
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallVector.h"
@@ -143,6 +144,10 @@ class DWARFUnit {
   /// IntervalMap does not support range removal, as a result, we use the
   /// std::map::upper_bound for address range lookup.
   std::map<uint64_t, std::pair<uint64_t, DWARFDie>> AddrDieMap;
+  /// Offsets of the subprogram DIEs in AddrDieMap whose inlined subroutines
+  /// have not been added to it yet. They are added the first time an address
+  /// in the subprogram is looked up.
+  DenseSet<uint32_t> UnexpandedSubroutines;
 
   using die_iterator_range =
       iterator_range<std::vector<DWARFDebugInfoEntry>::iterator>;
@@ -186,9 +191,17 @@ public:
     AddrOffsetSectionBase = Base;
   }
 
-  /// Recursively update address to Die map.
+  /// Add the address ranges of \p Die to the address to Die map.
+  void insertAddressRanges(DWARFDie Die);
+
+  /// Recursively add the inlined subroutines in \p Die to the address to
+  /// Die map.
   void updateAddressDieMap(DWARFDie Die);
 
+  /// Add the subprograms below \p Die, nested ones included, to the address
+  /// to Die map, without their inlined subroutines.
+  void addSubprograms(DWARFDie Die);
+
   void setRangesSection(const DWARFSection *RS, uint32_t Base) {
     RangeSection = RS;
     RangeSectionBase = Base;
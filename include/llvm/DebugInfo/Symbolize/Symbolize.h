@@ -33,6 +33,8 @@ using namespace object;
 
 using FunctionNameKind = DILineInfoSpecifier::FunctionNameKind;
 
+class SymbolizationCache;
+
 class LLVMSymbolizer {
 public:
   struct Options {
@@ -42,6 +44,9 @@ public:
     bool RelativeAddresses : 1;
     std::string DefaultArch;
     std::vector<std::string> DsymHints;
+    /// Directory of on-disk caches of code symbolization results, one per
+    /// binary build ID.  Caching is disabled if empty.
+    std::string CachePath;
 
     Options(FunctionNameKind PrintFunctions = FunctionNameKind::LinkageName,
             bool UseSymbolTable = true, bool Demangle = true,
@@ -51,11 +56,8 @@ public:
           DefaultArch(std::move(DefaultArch)) {}
   };
 
-  LLVMSymbolizer(const Options &Opts = Options()) : Opts(Opts) {}
-
-  ~LLVMSymbolizer() {
-    flush();
-  }
+  LLVMSymbolizer(const Options &Opts = Options());
+  ~LLVMSymbolizer();
 
   Expected<DILineInfo> symbolizeCode(const std::string &ModuleName,
                                      uint64_t ModuleOffset);
@@ -63,6 +65,7 @@ public:
                                                 uint64_t ModuleOffset);
   Expected<DIGlobal> symbolizeData(const std::string &ModuleName,
                                    uint64_t ModuleOffset);
+  /// Write out the caches and release all loaded modules.
   void flush();
 
   static std::string
@@ -81,6 +84,13 @@ private:
   Expected<SymbolizableModule *>
   getOrCreateModuleInfo(const std::string &ModuleName);
 
+  /// Returns the on-disk cache for a module, or null if caching is disabled
+  /// or the module has no build ID. Returns an error if the module's object
+  /// could not be loaded; like getOrCreateModuleInfo, that is only reported
+  /// once.
+  Expected<SymbolizationCache *>
+  getOrCreateCache(const std::string &ModuleName);
+
   ObjectFile *lookUpDsymFile(const std::string &Path,
                              const MachOObjectFile *ExeObj,
                              const std::string &ArchName);
@@ -100,6 +110,9 @@ private:
 
   std::map<std::string, std::unique_ptr<SymbolizableModule>> Modules;
 
+  /// \brief Contains the cache opened by getOrCreateCache() for each module.
+  std::map<std::string, std::unique_ptr<SymbolizationCache>> Caches;
+
   /// \brief Contains cached results of getOrCreateObjectPair().
   std::map<std::pair<std::string, std::string>, ObjectPair>
       ObjectPairForPathArch;
@@ -0,0 +1,72 @@
+//===- llvm/IR/CompileTimeBudget.h - Per-function time limits ---*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares CompileTimeBudget, which lets expensive passes notice
+// that a function has used up its compile time and switch to a cheaper but
+// still correct mode of operation.
+//
+// Two limits are available, both in seconds of wall time and both disabled by
+// default: -function-compile-time-budget bounds the time spent on a function
+// by all the passes run on it so far, and -pass-compile-time-limit bounds the
+// time the currently running pass has spent on it.  The legacy function pass
+// manager charges every function pass it runs to the function it runs on.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_IR_COMPILETIMEBUDGET_H
+#define LLVM_IR_COMPILETIMEBUDGET_H
+
+#include "llvm/ADT/SmallVector.h"
+
+namespace llvm {
+
+class Function;
+
+class CompileTimeBudget {
+public:
+  /// The time charged to one function.
+  struct Record {
+    /// Seconds spent in passes that have finished running on the function.
+    double Spent = 0.0;
+    /// Wall time at which the running pass started, or zero if none is.
+    double PassStart = 0.0;
+    /// Passes that have already reported running in degraded mode.
+    SmallVector<const char *, 2> ReportedPasses;
+  };
+
+  /// Charges the time between construction and destruction to a function.
+  /// Nested regions for the same function are folded into the outermost one.
+  class PassRegion {
+    Function *F = nullptr;
+
+  public:
+    explicit PassRegion(Function &F);
+    ~PassRegion();
+    PassRegion(const PassRegion &) = delete;
+    PassRegion &operator=(const PassRegion &) = delete;
+  };
+
+  /// Return true if either limit is set.
+  static bool isEnabled();
+
+  /// Return true if \p F has used up its budget, or the running pass has
+  /// reached its limit on \p F.
+  static bool isExceeded(const Function &F);
+
+  /// Return true if the pass \p PassName should run on \p F in its degraded
+  /// mode, emitting an analysis remark the first time it does.
+  static bool shouldDegrade(const Function &F, const char *PassName);
+
+  /// Drop the record for \p F, which is being destroyed.
+  static void forget(const Function &F);
+};
+
+} // end namespace llvm
+
+#endif // LLVM_IR_COMPILETIMEBUDGET_H
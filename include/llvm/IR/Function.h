@@ -47,6 +47,7 @@ namespace llvm {
 class AssemblyAnnotationWriter;
 class Constant;
 class DISubprogram;
+class FunctionArena;
 class LLVMContext;
 class Module;
 template <typename T> class Optional;
@@ -73,6 +74,7 @@ private:
   std::unique_ptr<ValueSymbolTable>
       SymTab;                             ///< Symbol table of args/instructions
   AttributeList AttributeSets;            ///< Parameter attributes
+  FunctionArena *Arena = nullptr;         ///< Instruction storage, if any
 
   /*
    * Value::SubclassData
@@ -130,6 +132,15 @@ public:
     return new Function(Ty, Linkage, N, M);
   }
 
+  /// Return the arena that instructions for this function are allocated from
+  /// within a FunctionArena::Scope, or null if it has none.
+  FunctionArena *getArena() const { return Arena; }
+
+  /// Return the arena for this function, creating it first if function
+  /// arenas are enabled (-function-arenas).  Returns null otherwise, so the
+  /// result can be handed straight to a FunctionArena::Scope.
+  FunctionArena *getOrCreateArena();
+
   // Provide fast operand accessors.
   DECLARE_TRANSPARENT_OPERAND_ACCESSORS(Value);
 
@@ -0,0 +1,79 @@
+//===- llvm/IR/FunctionArena.h - Bump allocation for IR objects -*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares FunctionArena, an opt-in bump allocator that a Function
+// can own for the instructions (and their co-allocated operands) created for
+// it.  Instructions are only allocated from an arena while a
+// FunctionArena::Scope naming it is active, which clone-heavy transforms set
+// up around the code that fills in a function.  Freeing an arena-allocated
+// instruction only updates the arena's live count; the memory is returned in
+// bulk once the owning function is gone and no instruction allocated from the
+// arena is left, so instructions may still be moved to other functions.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_IR_FUNCTIONARENA_H
+#define LLVM_IR_FUNCTIONARENA_H
+
+#include "llvm/Support/Allocator.h"
+#include "llvm/Support/Compiler.h"
+#include <cstddef>
+
+namespace llvm {
+
+class FunctionArena {
+  BumpPtrAllocator Allocator;
+
+  /// Number of objects allocated from this arena that are not yet freed.
+  size_t NumLive = 0;
+
+  /// False once the owning function has been destroyed.
+  bool OwnerAlive = true;
+
+  /// The arena new instructions are allocated from on this thread, if any.
+  static LLVM_THREAD_LOCAL FunctionArena *Current;
+
+public:
+  FunctionArena() = default;
+  FunctionArena(const FunctionArena &) = delete;
+  FunctionArena &operator=(const FunctionArena &) = delete;
+
+  /// Allocate instructions from \p Arena for the lifetime of this object.  A
+  /// null \p Arena makes instructions use the heap within the scope, so that
+  /// an enclosing scope for another function does not leak into this one.
+  class Scope {
+    FunctionArena *Saved;
+
+  public:
+    explicit Scope(FunctionArena *Arena) : Saved(Current) { Current = Arena; }
+    ~Scope() { Current = Saved; }
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+  };
+
+  /// Return the arena instructions are currently allocated from, or null.
+  static FunctionArena *getCurrent() { return Current; }
+
+  /// Allocate \p Size bytes, aligned for any User.
+  void *allocate(size_t Size);
+
+  /// Release memory returned by allocate() on some arena.
+  static void deallocate(void *Ptr);
+
+  /// Called by the owning function when it is destroyed.  The arena deletes
+  /// itself now, or once the last object allocated from it is freed.
+  void releaseOwner();
+
+  size_t getNumLiveObjects() const { return NumLive; }
+  size_t getTotalMemory() const { return Allocator.getTotalMemory(); }
+};
+
+} // end namespace llvm
+
+#endif // LLVM_IR_FUNCTIONARENA_H
@@ -54,6 +54,12 @@ class Instruction : public User,
 protected:
   ~Instruction(); // Use deleteValue() to delete a generic Instruction.
 
+  /// Instructions are allocated like other Users, except that they come from
+  /// the current FunctionArena, if any.
+  void *operator new(size_t Size);
+  void *operator new(size_t Size, unsigned Us);
+  void *operator new(size_t Size, unsigned Us, unsigned DescBytes);
+
 public:
   Instruction(const Instruction &) = delete;
   Instruction &operator=(const Instruction &) = delete;
@@ -42,14 +42,23 @@ template <typename T> class MutableArrayRef;
 template <class>
 struct OperandTraits;
 
+class FunctionArena;
+
 class User : public Value {
   template <unsigned>
   friend struct HungoffOperandTraits;
 
-  LLVM_ATTRIBUTE_ALWAYS_INLINE inline static void *
-  allocateFixedOperandUser(size_t, unsigned, unsigned);
-
 protected:
+  /// Allocate storage for a User with \p Us co-allocated operands and
+  /// \p DescBytes of descriptor, from \p Arena if it is not null.
+  static void *allocateFixedOperandUser(size_t Size, unsigned Us,
+                                        unsigned DescBytes,
+                                        FunctionArena *Arena);
+
+  /// Allocate storage for a User with hung off operands, from \p Arena if it
+  /// is not null.
+  static void *allocateHungOffOperandUser(size_t Size, FunctionArena *Arena);
+
   /// Allocate a User with an operand pointer co-allocated.
   ///
   /// This is used for subclasses which need to allocate a variable number
@@ -295,7 +295,8 @@ enum class instrprof_error {
   value_site_count_mismatch,
   compress_failed,
   uncompress_failed,
-  empty_raw_profile
+  empty_raw_profile,
+  overlay_base_mismatch
 };
 
 inline std::error_code make_error_code(instrprof_error E) {
@@ -877,6 +878,21 @@ struct Header {
   uint64_t HashOffset;
 };
 
+const uint64_t OverlayMagic = 0x816f666f72706cff; // "\xfflprofo\x81"
+
+// An overlay holds counts to be added to those of a base indexed profile, so
+// that updating a large profile does not require rewriting it. The file
+// starts with this header and the path of the base, padded to a multiple of
+// 8 bytes, followed by an indexed profile of the new counts whose summary
+// describes the combined profile. Offsets in that profile are relative to the
+// start of the overlay file. A relative base path is relative to the
+// directory of the overlay, and the base may itself be an overlay.
+struct OverlayHeader {
+  uint64_t Magic;
+  uint64_t BaseIdentity; // Identity of the base, to detect a replaced base.
+  uint64_t BasePathSize;
+};
+
 // Profile summary data recorded in the profile data file in indexed
 // format. It is introduced in version 4. The summary data follows
 // right after the profile file header.
@@ -397,6 +397,25 @@ private:
   std::unique_ptr<InstrProfReaderIndexBase> Index;
   /// Profile summary data.
   std::unique_ptr<ProfileSummary> Summary;
+  /// The profile this one is an overlay of, if any.
+  std::unique_ptr<IndexedInstrProfReader> Base;
+  /// Whether readNextRecord() is done with the records of the base.
+  bool BaseDone = false;
+  /// Position of readNextRecord() among the records of the current key.
+  unsigned RecordIndex = 0;
+  /// Identifies the file contents without reading the records.
+  uint64_t Identity = 0;
+
+  /// Read the header of an overlay at \p Cur and open its base, leaving
+  /// \p Cur at the header of the indexed profile that follows.
+  Error readOverlayHeader(const unsigned char *&Cur);
+
+  /// Look up a record in this profile without its base.
+  Expected<InstrProfRecord> getOwnRecord(StringRef FuncName,
+                                         uint64_t FuncHash);
+
+  /// Add the names of this profile and its bases to \p Symtab.
+  Error populateSymtab(InstrProfSymtab &Symtab);
 
   // Read the profile summary. Return a pointer pointing to one byte past the
   // end of the summary data if it exists or the input \c Cur.
@@ -413,7 +432,8 @@ public:
   uint64_t getVersion() const { return Index->getVersion(); }
   bool isIRLevelProfile() const override { return Index->isIRLevelProfile(); }
 
-  /// Return true if the given buffer is in an indexed instrprof format.
+  /// Return true if the given buffer is in an indexed instrprof format,
+  /// including an overlay.
   static bool hasFormat(const MemoryBuffer &DataBuffer);
 
   /// Read the file header.
@@ -421,7 +441,8 @@ public:
   /// Read a single record.
   Error readNextRecord(NamedInstrProfRecord &Record) override;
 
-  /// Return the NamedInstrProfRecord associated with FuncName and FuncHash
+  /// Return the NamedInstrProfRecord associated with FuncName and FuncHash.
+  /// For an overlay, the counts of the base are included.
   Expected<InstrProfRecord> getInstrProfRecord(StringRef FuncName,
                                                uint64_t FuncHash);
 
@@ -432,6 +453,11 @@ public:
   /// Return the maximum of all known function counts.
   uint64_t getMaximumFunctionCount() { return Summary->getMaxFunctionCount(); }
 
+  /// Return a hash of the headers and summary of the profile and of its size.
+  /// A profile rewritten with different counts almost always has a different
+  /// summary, so overlays use this to detect a replaced base cheaply.
+  uint64_t getIdentity() const { return Identity; }
+
   /// Factory method to create an indexed reader.
   static Expected<std::unique_ptr<IndexedInstrProfReader>>
   create(const Twine &Path);
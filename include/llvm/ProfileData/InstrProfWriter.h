@@ -27,6 +27,8 @@
 namespace llvm {
 
 /// Writer for instrumentation based profile data.
+class IndexedInstrProfReader;
+class ProfileSummary;
 class InstrProfRecordWriterTrait;
 class ProfOStream;
 class raw_fd_ostream;
@@ -56,13 +58,21 @@ public:
     addRecord(std::move(I), 1, Warn);
   }
 
-  /// Merge existing function counts from the given writer.
+  /// Merge existing function counts from the given writer, which is left
+  /// empty.
   void mergeRecordsFromWriter(InstrProfWriter &&IPW,
                               function_ref<void(Error)> Warn);
 
   /// Write the profile to \c OS
   void write(raw_fd_ostream &OS);
 
+  /// Write the profile to \c OS as an overlay of the indexed profile \p Base,
+  /// which is found at \p BasePath from the directory of the overlay. Fails
+  /// if a record does not match the record of the base with the same name and
+  /// hash.
+  Error writeOverlay(raw_fd_ostream &OS, IndexedInstrProfReader &Base,
+                     StringRef BasePath);
+
   /// Write the profile in text format to \c OS
   Error writeText(raw_fd_ostream &OS);
 
@@ -94,7 +104,7 @@ private:
   void addRecord(StringRef Name, uint64_t Hash, InstrProfRecord &&I,
                  uint64_t Weight, function_ref<void(Error)> Warn);
   bool shouldEncodeData(const ProfilingData &PD);
-  void writeImpl(ProfOStream &OS);
+  void writeImpl(ProfOStream &OS, ProfileSummary *CombinedSummary = nullptr);
 };
 
 } // end namespace llvm
@@ -1028,6 +1028,22 @@ protected:
     return false;
   }
 
+  /// Implementation of analyzeLoop for single block loops that branch back
+  /// on comparing an induction variable, updated by a constant each
+  /// iteration, with a loop-invariant value. The compare has to be recognized
+  /// by analyzeCompare and the update by getIncrementValue.
+  bool analyzeCompareLoop(MachineLoop &L, MachineInstr *&IndVarInst,
+                          MachineInstr *&CmpInst) const;
+
+  /// Implementation of reduceLoopCount for the loops recognized by
+  /// analyzeCompareLoop. Emit at the end of \p MBB the compare the loop does
+  /// after \p NumIters iterations and set \p Cond to the condition under
+  /// which the loop exits then. Return the compared induction variable.
+  unsigned reduceCompareLoopCount(MachineBasicBlock &MBB,
+                                  MachineInstr &IndVar, MachineInstr &Cmp,
+                                  SmallVectorImpl<MachineOperand> &Cond,
+                                  unsigned NumIters) const;
+
 public:
   /// unfoldMemoryOperand - Separate a single instruction which folded a load or
   /// a store or a load and a store into two or more instruction. If this is
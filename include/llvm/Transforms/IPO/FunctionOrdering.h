@@ -0,0 +1,32 @@
+//===- FunctionOrdering.h - Profile-guided function layout ------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This pass orders the functions of a module by call-chain clustering of the
+// profiled call graph, so that functions that call each other frequently are
+// laid out next to each other.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TRANSFORMS_IPO_FUNCTIONORDERING_H
+#define LLVM_TRANSFORMS_IPO_FUNCTIONORDERING_H
+
+#include "llvm/IR/Module.h"
+#include "llvm/IR/PassManager.h"
+
+namespace llvm {
+
+/// Pass to lay out functions by call-chain clustering.
+class FunctionOrderingPass : public PassInfoMixin<FunctionOrderingPass> {
+public:
+  PreservedAnalyses run(Module &M, ModuleAnalysisManager &AM);
+};
+
+} // end namespace llvm
+
+#endif // LLVM_TRANSFORMS_IPO_FUNCTIONORDERING_H
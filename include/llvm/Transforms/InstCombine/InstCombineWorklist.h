@@ -12,8 +12,10 @@
 
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/IR/Instruction.h"
+#include "llvm/IR/ValueHandle.h"
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/raw_ostream.h"
@@ -28,6 +30,11 @@ class InstCombineWorklist {
   SmallVector<Instruction*, 256> Worklist;
   DenseMap<Instruction*, unsigned> WorklistMap;
 
+  /// Instructions added after the initial group since the last call to
+  /// takeChanged(), possibly with duplicates.  Combines may erase
+  /// instructions without going through Remove, hence the value handles.
+  SmallVector<WeakVH, 64> Changed;
+
 public:
   InstCombineWorklist() = default;
 
@@ -37,8 +44,10 @@ public:
   bool isEmpty() const { return Worklist.empty(); }
 
   /// Add - Add the specified instruction to the worklist if it isn't already
-  /// in it.
+  /// in it.  It is recorded as changed either way: an instruction still
+  /// queued from the initial group may have been affected too.
   void Add(Instruction *I) {
+    Changed.push_back(I);
     if (WorklistMap.insert(std::make_pair(I, Worklist.size())).second) {
       DEBUG(dbgs() << "IC: ADD: " << *I << '\n');
       Worklist.push_back(I);
@@ -91,6 +100,20 @@ public:
       Add(cast<Instruction>(U));
   }
 
+  /// AddDeferred - Have \p I seed the next iteration without visiting it in
+  /// this one, e.g. because a combine dropped one of its uses.
+  void AddDeferred(Instruction *I) { Changed.push_back(I); }
+
+  /// takeChanged - Append to \p Out every live instruction that was added
+  /// after the initial group, i.e. created or affected by a combine, and
+  /// start tracking afresh.
+  void takeChanged(SmallVectorImpl<Instruction *> &Out) {
+    SmallPtrSet<Value *, 32> Seen;
+    for (WeakVH &V : Changed)
+      if (V && cast<Instruction>(V)->getParent() && Seen.insert(V).second)
+        Out.push_back(cast<Instruction>(V));
+    Changed.clear();
+  }
 
   /// Zap - check that the worklist is empty and nuke the backing store for
   /// the map if it is large.
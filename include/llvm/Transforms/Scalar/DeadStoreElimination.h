@@ -24,7 +24,9 @@
 namespace llvm {
 
 /// This class implements a trivial dead store elimination. We consider
-/// only the redundant stores that are local to a single Basic Block.
+/// only the redundant stores that are local to a single Basic Block, unless
+/// -enable-dse-memoryssa is given, in which case stores overwritten in later
+/// blocks on every path are removed as well.
 class DSEPass : public PassInfoMixin<DSEPass> {
 public:
   PreservedAnalyses run(Function &F, FunctionAnalysisManager &FAM);
@@ -37,6 +37,7 @@ class BasicBlock;
 class DataLayout;
 class Loop;
 class LoopInfo;
+class MemorySSAUpdater;
 class OptimizationRemarkEmitter;
 class PredicatedScalarEvolution;
 class PredIteratorCache;
@@ -421,10 +422,14 @@ bool formLCSSARecursively(Loop &L, DominatorTree &DT, LoopInfo *LI,
 /// iteration. Takes DomTreeNode, AliasAnalysis, LoopInfo, DominatorTree,
 /// DataLayout, TargetLibraryInfo, Loop, AliasSet information for all
 /// instructions of the loop and loop safety information as
-/// arguments. Diagnostics is emitted via \p ORE. It returns changed status.
+/// arguments. Diagnostics is emitted via \p ORE. If \p MSSAU is set, memory
+/// dependences are answered by MemorySSA instead of the AliasSetTracker, and
+/// MemorySSA is kept up to date. It returns changed status.
 bool sinkRegion(DomTreeNode *, AliasAnalysis *, LoopInfo *, DominatorTree *,
                 TargetLibraryInfo *, Loop *, AliasSetTracker *,
-                LoopSafetyInfo *, OptimizationRemarkEmitter *ORE, bool Rhino);
+                LoopSafetyInfo *, OptimizationRemarkEmitter *ORE, bool Rhino,
+                MemorySSAUpdater *MSSAU = nullptr,
+                unsigned *LicmMssaOptCounter = nullptr);
 
 /// \brief Walk the specified region of the CFG (defined by all blocks
 /// dominated by the specified block, and that are in the current loop) in depth
@@ -433,10 +438,12 @@ bool sinkRegion(DomTreeNode *, AliasAnalysis *, LoopInfo *, DominatorTree *,
 /// Takes DomTreeNode, AliasAnalysis, LoopInfo, DominatorTree, DataLayout,
 /// TargetLibraryInfo, Loop, AliasSet information for all instructions of the
 /// loop and loop safety information as arguments. Diagnostics is emitted via \p
-/// ORE. It returns changed status.
+/// ORE. \p MSSAU is used as in sinkRegion. It returns changed status.
 bool hoistRegion(DomTreeNode *, AliasAnalysis *, LoopInfo *, DominatorTree *,
                  TargetLibraryInfo *, Loop *, AliasSetTracker *,
-                 LoopSafetyInfo *, OptimizationRemarkEmitter *ORE, bool Rhino);
+                 LoopSafetyInfo *, OptimizationRemarkEmitter *ORE, bool Rhino,
+                 MemorySSAUpdater *MSSAU = nullptr,
+                 unsigned *LicmMssaOptCounter = nullptr);
 
 /// \brief Try to promote memory values to scalars by sinking stores out of
 /// the loop and moving loads to before the loop.  We do this by looping over
@@ -444,14 +451,16 @@ bool hoistRegion(DomTreeNode *, AliasAnalysis *, LoopInfo *, DominatorTree *,
 /// loop invariant. It takes AliasSet, Loop exit blocks vector, loop exit blocks
 /// insertion point vector, PredIteratorCache, LoopInfo, DominatorTree, Loop,
 /// AliasSet information for all instructions of the loop and loop safety
-/// information as arguments. Diagnostics is emitted via \p ORE. It returns
-/// changed status.
+/// information as arguments. Diagnostics is emitted via \p ORE. If \p MSSAU
+/// is set, the inserted and deleted accesses are reflected in MemorySSA. It
+/// returns changed status.
 bool promoteLoopAccessesToScalars(AliasSet &, SmallVectorImpl<BasicBlock *> &,
                                   SmallVectorImpl<Instruction *> &,
                                   PredIteratorCache &, LoopInfo *,
                                   DominatorTree *, const TargetLibraryInfo *,
                                   Loop *, AliasSetTracker *, LoopSafetyInfo *,
-                                  OptimizationRemarkEmitter *);
+                                  OptimizationRemarkEmitter *,
+                                  MemorySSAUpdater *MSSAU = nullptr);
 
 /// \brief Computes safety information for a loop
 /// checks loop body & header for the possibility of may throw
@@ -499,10 +508,16 @@ void getLoopAnalysisUsage(AnalysisUsage &AU);
 /// instructions from loop body to preheader/exit. Check if the instruction
 /// can execute speculatively.
 /// If \p ORE is set use it to emit optimization remarks.
+/// If \p MSSAU is set, loads and calls are checked against the loop's
+/// MemorySSA defs instead of \p CurAST. \p LicmMssaOptCounter counts the
+/// clobber walks made for the loop; past the cap, the defining access is used
+/// as is.
 bool canSinkOrHoistInst(Instruction &I, AAResults *AA, DominatorTree *DT,
                         Loop *CurLoop, AliasSetTracker *CurAST,
                         LoopSafetyInfo *SafetyInfo,
-                        OptimizationRemarkEmitter *ORE = nullptr);
+                        OptimizationRemarkEmitter *ORE = nullptr,
+                        MemorySSAUpdater *MSSAU = nullptr,
+                        unsigned *LicmMssaOptCounter = nullptr);
 
 /// Generates a vector reduction using shufflevectors to reduce the value.
 Value *getShuffleReduction(IRBuilder<> &Builder, Value *Src, unsigned Op,
@@ -100,6 +100,15 @@ struct LoopVectorizePass : public PassInfoMixin<LoopVectorizePass> {
                OptimizationRemarkEmitter &ORE);
 
   bool processLoop(Loop *L);
+
+  /// Vectorize \p L, which contains a single innermost loop, along its own
+  /// induction variable.
+  bool processOuterLoop(Loop *L);
+
+  /// Vectorize \p L, which is innermost and may leave early from one block
+  /// besides its latch, by handing over to the original loop in the vector
+  /// iteration in which some lane exits.
+  bool processEarlyExitLoop(Loop *L);
 };
 }
 
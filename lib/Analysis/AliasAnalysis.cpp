@@ -26,6 +26,7 @@
 
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Analysis/AliasAnalysis.h"
 #include "llvm/Analysis/BasicAliasAnalysis.h"
 #include "llvm/Analysis/CFG.h"
@@ -50,6 +51,11 @@
 #include "llvm/Pass.h"
 using namespace llvm;
 
+#define DEBUG_TYPE "aa"
+
+STATISTIC(NumBatchAliasHits, "Number of alias queries answered by BatchAA");
+STATISTIC(NumBatchModRefHits, "Number of mod/ref queries answered by BatchAA");
+
 /// Allow disabling BasicAA from the AA results. This is particularly useful
 /// when testing to isolate a single AA implementation.
 static cl::opt<bool> DisableBasicAA("disable-basicaa", cl::Hidden,
@@ -364,6 +370,42 @@ FunctionModRefBehavior AAResults::getModRefBehavior(const Function *F) {
   return Result;
 }
 
+//===----------------------------------------------------------------------===//
+// BatchAAResults implementation
+//===----------------------------------------------------------------------===//
+
+AliasResult BatchAAResults::alias(const MemoryLocation &LocA,
+                                  const MemoryLocation &LocB) {
+  auto CacheIt = AliasCache.find(LocPair(LocA, LocB));
+  if (CacheIt != AliasCache.end()) {
+    ++NumBatchAliasHits;
+    return CacheIt->second;
+  }
+  // Alias queries are symmetric, so also try the swapped pair.
+  CacheIt = AliasCache.find(LocPair(LocB, LocA));
+  if (CacheIt != AliasCache.end()) {
+    ++NumBatchAliasHits;
+    return CacheIt->second;
+  }
+
+  AliasResult Result = AA.alias(LocA, LocB);
+  AliasCache[LocPair(LocA, LocB)] = Result;
+  return Result;
+}
+
+ModRefInfo BatchAAResults::getModRefInfo(const Instruction *I,
+                                         const MemoryLocation &Loc) {
+  auto CacheIt = ModRefCache.find(InstLocPair(I, Loc));
+  if (CacheIt != ModRefCache.end()) {
+    ++NumBatchModRefHits;
+    return CacheIt->second;
+  }
+
+  ModRefInfo Result = AA.getModRefInfo(I, Loc);
+  ModRefCache[InstLocPair(I, Loc)] = Result;
+  return Result;
+}
+
 //===----------------------------------------------------------------------===//
 // Helper method implementation
 //===----------------------------------------------------------------------===//
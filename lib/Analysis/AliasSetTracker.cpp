@@ -48,14 +48,13 @@ void AliasSet::mergeSetIn(AliasSet &AS, AliasSetTracker &AST) {
     // Check that these two merged sets really are must aliases.  Since both
     // used to be must-alias sets, we can just check any pointer from each set
     // for aliasing.
-    AliasAnalysis &AA = AST.getAliasAnalysis();
     PointerRec *L = getSomePointer();
     PointerRec *R = AS.getSomePointer();
 
     // If the pointers are not a must-alias pair, this set becomes a may alias.
-    if (AA.alias(MemoryLocation(L->getValue(), L->getSize(), L->getAAInfo()),
-                 MemoryLocation(R->getValue(), R->getSize(), R->getAAInfo())) !=
-        MustAlias)
+    if (AST.alias(MemoryLocation(L->getValue(), L->getSize(), L->getAAInfo()),
+                  MemoryLocation(R->getValue(), R->getSize(),
+                                 R->getAAInfo())) != MustAlias)
       Alias = SetMayAlias;
   }
 
@@ -122,10 +121,9 @@ void AliasSet::addPointer(AliasSetTracker &AST, PointerRec &Entry,
   // Check to see if we have to downgrade to _may_ alias.
   if (isMustAlias() && !KnownMustAlias)
     if (PointerRec *P = getSomePointer()) {
-      AliasAnalysis &AA = AST.getAliasAnalysis();
       AliasResult Result =
-          AA.alias(MemoryLocation(P->getValue(), P->getSize(), P->getAAInfo()),
-                   MemoryLocation(Entry.getValue(), Size, AAInfo));
+          AST.alias(MemoryLocation(P->getValue(), P->getSize(), P->getAAInfo()),
+                    MemoryLocation(Entry.getValue(), Size, AAInfo));
       if (Result != MustAlias) {
         Alias = SetMayAlias;
         AST.TotalMayAliasSetSize += size();
@@ -171,9 +169,9 @@ void AliasSet::addUnknownInst(Instruction *I, AliasAnalysis &AA) {
 /// aliasesPointer - Return true if the specified pointer "may" (or must)
 /// alias one of the members in the set.
 ///
+template <typename AAT>
 bool AliasSet::aliasesPointer(const Value *Ptr, uint64_t Size,
-                              const AAMDNodes &AAInfo,
-                              AliasAnalysis &AA) const {
+                              const AAMDNodes &AAInfo, AAT &AA) const {
   if (AliasAny)
     return true;
 
@@ -208,8 +206,15 @@ bool AliasSet::aliasesPointer(const Value *Ptr, uint64_t Size,
   return false;
 }
 
-bool AliasSet::aliasesUnknownInst(const Instruction *Inst,
-                                  AliasAnalysis &AA) const {
+template bool AliasSet::aliasesPointer(const Value *, uint64_t,
+                                       const AAMDNodes &,
+                                       AliasAnalysis &) const;
+template bool AliasSet::aliasesPointer(const Value *, uint64_t,
+                                       const AAMDNodes &,
+                                       BatchAAResults &) const;
+
+template <typename AAT>
+bool AliasSet::aliasesUnknownInst(const Instruction *Inst, AAT &AA) const {
 
   if (AliasAny)
     return true;
@@ -234,6 +239,11 @@ bool AliasSet::aliasesUnknownInst(const Instruction *Inst,
   return false;
 }
 
+template bool AliasSet::aliasesUnknownInst(const Instruction *,
+                                           AliasAnalysis &) const;
+template bool AliasSet::aliasesUnknownInst(const Instruction *,
+                                           BatchAAResults &) const;
+
 void AliasSetTracker::clear() {
   // Delete all the PointerRec entries.
   for (PointerMapType::iterator I = PointerMap.begin(), E = PointerMap.end();
@@ -256,7 +266,8 @@ AliasSet *AliasSetTracker::mergeAliasSetsForPointer(const Value *Ptr,
   AliasSet *FoundSet = nullptr;
   for (iterator I = begin(), E = end(); I != E;) {
     iterator Cur = I++;
-    if (Cur->Forward || !Cur->aliasesPointer(Ptr, Size, AAInfo, AA)) continue;
+    if (Cur->Forward || !setAliasesPointer(*Cur, Ptr, Size, AAInfo))
+      continue;
     
     if (!FoundSet) {      // If this is the first alias set ptr can go into.
       FoundSet = &*Cur;   // Remember it.
@@ -270,7 +281,7 @@ AliasSet *AliasSetTracker::mergeAliasSetsForPointer(const Value *Ptr,
 
 bool AliasSetTracker::containsUnknown(const Instruction *Inst) const {
   for (const AliasSet &AS : *this)
-    if (!AS.Forward && AS.aliasesUnknownInst(Inst, AA))
+    if (!AS.Forward && setAliasesUnknownInst(AS, Inst))
       return true;
   return false;
 }
@@ -279,7 +290,7 @@ AliasSet *AliasSetTracker::findAliasSetForUnknownInst(Instruction *Inst) {
   AliasSet *FoundSet = nullptr;
   for (iterator I = begin(), E = end(); I != E;) {
     iterator Cur = I++;
-    if (Cur->Forward || !Cur->aliasesUnknownInst(Inst, AA))
+    if (Cur->Forward || !setAliasesUnknownInst(*Cur, Inst))
       continue;
     if (!FoundSet)            // If this is the first alias set ptr can go into.
       FoundSet = &*Cur;       // Remember it.
@@ -493,6 +504,11 @@ void AliasSetTracker::add(const AliasSetTracker &AST) {
 // dangling pointers to deleted instructions.
 //
 void AliasSetTracker::deleteValue(Value *PtrVal) {
+  // The deleted value may be part of a cached query, and its address may be
+  // reused for a new value.
+  if (BatchAA)
+    BatchAA->clear();
+
   // First, look up the PointerRec for this pointer.
   PointerMapType::iterator I = PointerMap.find_as(PtrVal);
   if (I == PointerMap.end()) return;  // Noop
@@ -13,6 +13,9 @@
 
 #include "llvm/Analysis/Loads.h"
 #include "llvm/Analysis/AliasAnalysis.h"
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/Analysis/ScalarEvolution.h"
+#include "llvm/Analysis/ScalarEvolutionExpressions.h"
 #include "llvm/Analysis/ValueTracking.h"
 #include "llvm/IR/DataLayout.h"
 #include "llvm/IR/GlobalAlias.h"
@@ -150,6 +153,51 @@ bool llvm::isDereferenceableAndAlignedPointer(const Value *V, unsigned Align,
       CtxI, DT, Visited);
 }
 
+bool llvm::isDereferenceableAndAlignedInLoop(LoadInst *LI, Loop *L,
+                                             ScalarEvolution &SE,
+                                             DominatorTree &DT) {
+  const DataLayout &DL = LI->getModule()->getDataLayout();
+  Value *Ptr = LI->getPointerOperand();
+  APInt EltSize(DL.getPointerTypeSizeInBits(Ptr->getType()),
+                DL.getTypeStoreSize(LI->getType()));
+  unsigned Align = LI->getAlignment();
+  if (!Align)
+    Align = DL.getABITypeAlignment(LI->getType());
+  Instruction *HeaderFirstNonPHI = L->getHeader()->getFirstNonPHI();
+
+  // A loop invariant address only needs to be dereferenceable once.
+  if (L->isLoopInvariant(Ptr))
+    return isDereferenceableAndAlignedPointer(Ptr, Align, EltSize, DL,
+                                              HeaderFirstNonPHI, &DT);
+
+  // Otherwise the address must walk over the elements of an object that is
+  // large enough for every iteration.
+  auto *AddRec = dyn_cast<SCEVAddRecExpr>(SE.getSCEV(Ptr));
+  if (!AddRec || AddRec->getLoop() != L || !AddRec->isAffine())
+    return false;
+  auto *Step = dyn_cast<SCEVConstant>(AddRec->getStepRecurrence(SE));
+  if (!Step || Step->getAPInt() != EltSize)
+    return false;
+
+  BasicBlock *Latch = L->getLoopLatch();
+  unsigned TC = Latch ? SE.getSmallConstantTripCount(L, Latch) : 0;
+  if (!TC)
+    return false;
+
+  auto *StartS = dyn_cast<SCEVUnknown>(AddRec->getStart());
+  if (!StartS)
+    return false;
+  assert(SE.isLoopInvariant(StartS, L) && "implied by addrec definition");
+
+  // Every element is aligned if the base is and the element size is a
+  // multiple of the alignment.
+  if (EltSize.urem(Align) != 0)
+    return false;
+  return isDereferenceableAndAlignedPointer(StartS->getValue(), Align,
+                                            EltSize * TC, DL,
+                                            HeaderFirstNonPHI, &DT);
+}
+
 bool llvm::isDereferenceablePointer(const Value *V, const DataLayout &DL,
                                     const Instruction *CtxI,
                                     const DominatorTree *DT) {
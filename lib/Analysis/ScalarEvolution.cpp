@@ -106,6 +106,12 @@ STATISTIC(NumTripCountsNotComputed,
           "Number of loops without predictable loop counts");
 STATISTIC(NumBruteForceTripCountsComputed,
           "Number of loops with trip counts computed by force");
+STATISTIC(NumSCEVsComputed,
+          "Number of SCEV expressions computed for IR values");
+STATISTIC(NumSCEVsForgotten,
+          "Number of IR values whose SCEV expression was dropped");
+STATISTIC(NumBECountsForgotten,
+          "Number of backedge-taken counts invalidated");
 
 static cl::opt<unsigned>
 MaxBruteForceIterations("scalar-evolution-max-iterations", cl::ReallyHidden,
@@ -3662,6 +3668,7 @@ void ScalarEvolution::eraseValueFromMap(Value *V) {
         SV->remove({V, Offset});
     }
     ValueExprMap.erase(V);
+    ++NumSCEVsForgotten;
   }
 }
 
@@ -3672,6 +3679,7 @@ const SCEV *ScalarEvolution::getSCEV(Value *V) {
 
   const SCEV *S = getExistingSCEV(V);
   if (S == nullptr) {
+    ++NumSCEVsComputed;
     S = createSCEV(V);
     // During PHI resolution, it is possible to create two SCEVs for the same
     // V, so it is needed to double check whether V->S is inserted into
@@ -3922,6 +3930,7 @@ void ScalarEvolution::forgetSymbolicName(Instruction *PN, const SCEV *SymName) {
   PushDefUseChildren(PN, Worklist);
 
   SmallPtrSet<Instruction *, 8> Visited;
+  SmallVector<const SCEV *, 16> ToForget;
   Visited.insert(PN);
   while (!Worklist.empty()) {
     Instruction *I = Worklist.pop_back_val();
@@ -3948,12 +3957,13 @@ void ScalarEvolution::forgetSymbolicName(Instruction *PN, const SCEV *SymName) {
           !isa<SCEVUnknown>(Old) ||
           (I != PN && Old == SymName)) {
         eraseValueFromMap(It->first);
-        forgetMemoizedResults(Old);
+        ToForget.push_back(Old);
       }
     }
 
     PushDefUseChildren(I, Worklist);
   }
+  forgetMemoizedResults(ToForget);
 }
 
 namespace {
@@ -6136,6 +6146,7 @@ ScalarEvolution::getPredicatedBackedgeTakenInfo(const Loop *L) {
   BackedgeTakenInfo Result =
       computeBackedgeTakenCount(L, /*AllowPredicates=*/true);
 
+  updateBECountUsers(L, /*Predicated=*/true, Result, /*Add=*/true);
   return PredicatedBackedgeTakenCounts.find(L)->second = std::move(Result);
 }
 
@@ -6178,6 +6189,7 @@ ScalarEvolution::getBackedgeTakenInfo(const Loop *L) {
     PushLoopPHIs(L, Worklist);
 
     SmallPtrSet<Instruction *, 8> Visited;
+    SmallVector<const SCEV *, 16> ToForget;
     while (!Worklist.empty()) {
       Instruction *I = Worklist.pop_back_val();
       if (!Visited.insert(I).second)
@@ -6196,7 +6208,7 @@ ScalarEvolution::getBackedgeTakenInfo(const Loop *L) {
         // own when it gets to that point.
         if (!isa<PHINode>(I) || !isa<SCEVUnknown>(Old)) {
           eraseValueFromMap(It->first);
-          forgetMemoizedResults(Old);
+          ToForget.push_back(Old);
         }
         if (PHINode *PN = dyn_cast<PHINode>(I))
           ConstantEvolutionLoopExitValue.erase(PN);
@@ -6204,6 +6216,7 @@ ScalarEvolution::getBackedgeTakenInfo(const Loop *L) {
 
       PushDefUseChildren(I, Worklist);
     }
+    forgetMemoizedResults(ToForget);
   }
 
   // Re-lookup the insert position, since the call to
@@ -6211,22 +6224,27 @@ ScalarEvolution::getBackedgeTakenInfo(const Loop *L) {
   // recusive call to getBackedgeTakenInfo (on a different
   // loop), which would invalidate the iterator computed
   // earlier.
+  updateBECountUsers(L, /*Predicated=*/false, Result, /*Add=*/true);
   return BackedgeTakenCounts.find(L)->second = std::move(Result);
 }
 
 void ScalarEvolution::forgetLoop(const Loop *L) {
   // Drop any stored trip count value.
   auto RemoveLoopFromBackedgeMap =
-      [L](DenseMap<const Loop *, BackedgeTakenInfo> &Map) {
+      [L, this](DenseMap<const Loop *, BackedgeTakenInfo> &Map,
+                bool Predicated) {
         auto BTCPos = Map.find(L);
         if (BTCPos != Map.end()) {
+          updateBECountUsers(L, Predicated, BTCPos->second, /*Add=*/false);
           BTCPos->second.clear();
           Map.erase(BTCPos);
+          ++NumBECountsForgotten;
         }
       };
 
-  RemoveLoopFromBackedgeMap(BackedgeTakenCounts);
-  RemoveLoopFromBackedgeMap(PredicatedBackedgeTakenCounts);
+  RemoveLoopFromBackedgeMap(BackedgeTakenCounts, /*Predicated=*/false);
+  RemoveLoopFromBackedgeMap(PredicatedBackedgeTakenCounts,
+                            /*Predicated=*/true);
 
   // Drop information about predicated SCEV rewrites for this loop.
   for (auto I = PredicatedSCEVRewrites.begin();
@@ -6243,6 +6261,7 @@ void ScalarEvolution::forgetLoop(const Loop *L) {
   PushLoopPHIs(L, Worklist);
 
   SmallPtrSet<Instruction *, 8> Visited;
+  SmallVector<const SCEV *, 16> ToForget;
   while (!Worklist.empty()) {
     Instruction *I = Worklist.pop_back_val();
     if (!Visited.insert(I).second)
@@ -6251,14 +6270,15 @@ void ScalarEvolution::forgetLoop(const Loop *L) {
     ValueExprMapType::iterator It =
       ValueExprMap.find_as(static_cast<Value *>(I));
     if (It != ValueExprMap.end()) {
+      ToForget.push_back(It->second);
       eraseValueFromMap(It->first);
-      forgetMemoizedResults(It->second);
       if (PHINode *PN = dyn_cast<PHINode>(I))
         ConstantEvolutionLoopExitValue.erase(PN);
     }
 
     PushDefUseChildren(I, Worklist);
   }
+  forgetMemoizedResults(ToForget);
 
   // Forget all contained loops too, to avoid dangling entries in the
   // ValuesAtScopes map.
@@ -6277,6 +6297,7 @@ void ScalarEvolution::forgetValue(Value *V) {
   Worklist.push_back(I);
 
   SmallPtrSet<Instruction *, 8> Visited;
+  SmallVector<const SCEV *, 16> ToForget;
   while (!Worklist.empty()) {
     I = Worklist.pop_back_val();
     if (!Visited.insert(I).second)
@@ -6285,14 +6306,15 @@ void ScalarEvolution::forgetValue(Value *V) {
     ValueExprMapType::iterator It =
       ValueExprMap.find_as(static_cast<Value *>(I));
     if (It != ValueExprMap.end()) {
+      ToForget.push_back(It->second);
       eraseValueFromMap(It->first);
-      forgetMemoizedResults(It->second);
       if (PHINode *PN = dyn_cast<PHINode>(I))
         ConstantEvolutionLoopExitValue.erase(PN);
     }
 
     PushDefUseChildren(I, Worklist);
   }
+  forgetMemoizedResults(ToForget);
 }
 
 /// Get the exact loop backedge taken count considering all loop exits. A
@@ -6376,6 +6398,22 @@ bool ScalarEvolution::BackedgeTakenInfo::hasOperand(const SCEV *S,
   return false;
 }
 
+void ScalarEvolution::BackedgeTakenInfo::collectOperands(
+    ScalarEvolution *SE, SmallPtrSetImpl<const SCEV *> &Ops) const {
+  auto Collect = [&](const SCEV *Expr) {
+    if (!Expr || Expr == SE->getCouldNotCompute())
+      return;
+    SCEVExprContains(Expr, [&](const SCEV *Op) {
+      Ops.insert(Op);
+      return false;
+    });
+  };
+
+  Collect(getMax());
+  for (auto &ENT : ExitNotTaken)
+    Collect(ENT.ExactNotTaken);
+}
+
 ScalarEvolution::ExitLimit::ExitLimit(const SCEV *E)
     : ExactNotTaken(E), MaxNotTaken(E), MaxOrZero(false) {
   assert((isa<SCEVCouldNotCompute>(MaxNotTaken) ||
@@ -10404,6 +10442,7 @@ ScalarEvolution::ScalarEvolution(ScalarEvolution &&Arg)
       BackedgeTakenCounts(std::move(Arg.BackedgeTakenCounts)),
       PredicatedBackedgeTakenCounts(
           std::move(Arg.PredicatedBackedgeTakenCounts)),
+      BECountUsers(std::move(Arg.BECountUsers)),
       ConstantEvolutionLoopExitValue(
           std::move(Arg.ConstantEvolutionLoopExitValue)),
       ValuesAtScopes(std::move(Arg.ValuesAtScopes)),
@@ -10806,39 +10845,70 @@ bool ScalarEvolution::hasOperand(const SCEV *S, const SCEV *Op) const {
   return SCEVExprContains(S, [&](const SCEV *Expr) { return Expr == Op; });
 }
 
-void ScalarEvolution::forgetMemoizedResults(const SCEV *S) {
-  ValuesAtScopes.erase(S);
-  LoopDispositions.erase(S);
-  BlockDispositions.erase(S);
-  UnsignedRanges.erase(S);
-  SignedRanges.erase(S);
-  ExprValueMap.erase(S);
-  HasRecMap.erase(S);
-  MinTrailingZerosCache.erase(S);
-
-  for (auto I = PredicatedSCEVRewrites.begin(); 
-       I != PredicatedSCEVRewrites.end();) {
-    std::pair<const SCEV *, const Loop *> Entry = I->first;
-    if (Entry.first == S)
-      PredicatedSCEVRewrites.erase(I++);
-    else
-      ++I;
+void ScalarEvolution::updateBECountUsers(const Loop *L, bool Predicated,
+                                         const BackedgeTakenInfo &BTI,
+                                         bool Add) {
+  SmallPtrSet<const SCEV *, 16> Ops;
+  BTI.collectOperands(this, Ops);
+  PointerIntPair<const Loop *, 1, bool> User(L, Predicated);
+  for (const SCEV *S : Ops) {
+    if (Add) {
+      BECountUsers[S].insert(User);
+      continue;
+    }
+    auto It = BECountUsers.find(S);
+    if (It == BECountUsers.end())
+      continue;
+    It->second.erase(User);
+    if (It->second.empty())
+      BECountUsers.erase(It);
   }
+}
 
-  auto RemoveSCEVFromBackedgeMap =
-      [S, this](DenseMap<const Loop *, BackedgeTakenInfo> &Map) {
-        for (auto I = Map.begin(), E = Map.end(); I != E;) {
-          BackedgeTakenInfo &BEInfo = I->second;
-          if (BEInfo.hasOperand(S, this)) {
-            BEInfo.clear();
-            Map.erase(I++);
-          } else
-            ++I;
-        }
-      };
+void ScalarEvolution::forgetMemoizedResults(ArrayRef<const SCEV *> SCEVs) {
+  if (SCEVs.empty())
+    return;
+
+  SmallPtrSet<const SCEV *, 16> ToForget(SCEVs.begin(), SCEVs.end());
+  SmallVector<PointerIntPair<const Loop *, 1, bool>, 4> BECountsToForget;
+  for (const SCEV *S : ToForget) {
+    ValuesAtScopes.erase(S);
+    LoopDispositions.erase(S);
+    BlockDispositions.erase(S);
+    UnsignedRanges.erase(S);
+    SignedRanges.erase(S);
+    ExprValueMap.erase(S);
+    HasRecMap.erase(S);
+    MinTrailingZerosCache.erase(S);
+
+    auto Users = BECountUsers.find(S);
+    if (Users != BECountUsers.end())
+      BECountsToForget.append(Users->second.begin(), Users->second.end());
+  }
+
+  if (!PredicatedSCEVRewrites.empty())
+    for (auto I = PredicatedSCEVRewrites.begin();
+         I != PredicatedSCEVRewrites.end();) {
+      std::pair<const SCEV *, const Loop *> Entry = I->first;
+      if (ToForget.count(Entry.first))
+        PredicatedSCEVRewrites.erase(I++);
+      else
+        ++I;
+    }
 
-  RemoveSCEVFromBackedgeMap(BackedgeTakenCounts);
-  RemoveSCEVFromBackedgeMap(PredicatedBackedgeTakenCounts);
+  for (auto User : BECountsToForget) {
+    auto &Map = User.getInt() ? PredicatedBackedgeTakenCounts
+                              : BackedgeTakenCounts;
+    auto BTCPos = Map.find(User.getPointer());
+    // Already dropped through another expression in this batch.
+    if (BTCPos == Map.end())
+      continue;
+    updateBECountUsers(User.getPointer(), User.getInt(), BTCPos->second,
+                       /*Add=*/false);
+    BTCPos->second.clear();
+    Map.erase(BTCPos);
+    ++NumBECountsForgotten;
+  }
 }
 
 void ScalarEvolution::verify() const {
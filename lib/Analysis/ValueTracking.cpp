@@ -82,6 +82,8 @@ struct Query {
   // Unlike the other analyses, this may be a nullptr because not all clients
   // provide it currently.
   OptimizationRemarkEmitter *ORE;
+  /// Cache for top-level results, if the client provided one.
+  ValueTrackingCache *VTC;
 
   /// Set of assumptions that should be excluded from further queries.
   /// This is because of the potential for mutual recursion to cause
@@ -95,11 +97,13 @@ struct Query {
   unsigned NumExcluded;
 
   Query(const DataLayout &DL, AssumptionCache *AC, const Instruction *CxtI,
-        const DominatorTree *DT, OptimizationRemarkEmitter *ORE = nullptr)
-      : DL(DL), AC(AC), CxtI(CxtI), DT(DT), ORE(ORE), NumExcluded(0) {}
+        const DominatorTree *DT, OptimizationRemarkEmitter *ORE = nullptr,
+        ValueTrackingCache *VTC = nullptr)
+      : DL(DL), AC(AC), CxtI(CxtI), DT(DT), ORE(ORE), VTC(VTC),
+        NumExcluded(0) {}
 
   Query(const Query &Q, const Value *NewExcl)
-      : DL(Q.DL), AC(Q.AC), CxtI(Q.CxtI), DT(Q.DT), ORE(Q.ORE),
+      : DL(Q.DL), AC(Q.AC), CxtI(Q.CxtI), DT(Q.DT), ORE(Q.ORE), VTC(Q.VTC),
         NumExcluded(Q.NumExcluded) {
     Excluded = Q.Excluded;
     Excluded[NumExcluded++] = NewExcl;
@@ -112,9 +116,72 @@ struct Query {
     auto End = Excluded.begin() + NumExcluded;
     return std::find(Excluded.begin(), End, Value) != End;
   }
+
+  /// Whether the result for \p V should go through the cache.  Only complete
+  /// queries on instructions are cached: results computed with less depth or
+  /// with assumptions excluded are less precise.
+  bool useCache(const Value *V, unsigned Depth) const {
+    return VTC && Depth == 0 && NumExcluded == 0 && isa<Instruction>(V);
+  }
 };
 } // end anonymous namespace
 
+void ValueTrackingCache::InvalidationVH::deleted() {
+  Cache->invalidate(getValPtr());
+  // this now dangles!
+}
+
+void ValueTrackingCache::InvalidationVH::allUsesReplacedWith(Value *) {
+  Cache->invalidate(getValPtr());
+  // this now dangles!
+}
+
+void ValueTrackingCache::track(const KeyT &Key) {
+  KeysByValue[InvalidationVH(const_cast<Value *>(Key.first), this)]
+      .push_back(Key);
+  if (Key.second && Key.second != Key.first)
+    KeysByValue[InvalidationVH(const_cast<Instruction *>(Key.second), this)]
+        .push_back(Key);
+}
+
+void ValueTrackingCache::insertKnownBits(const KeyT &Key,
+                                         const KnownBits &Known) {
+  if (KnownBitsMap.insert({Key, Known}).second)
+    track(Key);
+}
+
+void ValueTrackingCache::insertNumSignBits(const KeyT &Key,
+                                           unsigned NumSignBits) {
+  if (NumSignBitsMap.insert({Key, NumSignBits}).second)
+    track(Key);
+}
+
+void ValueTrackingCache::insertNonZero(const KeyT &Key, bool NonZero) {
+  if (NonZeroMap.insert({Key, NonZero}).second)
+    track(Key);
+}
+
+void ValueTrackingCache::invalidate(Value *V) {
+  auto I = KeysByValue.find_as(V);
+  if (I == KeysByValue.end())
+    return;
+  // The keys of the other value in each pair stay listed under it; erasing
+  // them again later is harmless.
+  for (const KeyT &Key : I->second) {
+    KnownBitsMap.erase(Key);
+    NumSignBitsMap.erase(Key);
+    NonZeroMap.erase(Key);
+  }
+  KeysByValue.erase(I);
+}
+
+void ValueTrackingCache::clear() {
+  KnownBitsMap.clear();
+  NumSignBitsMap.clear();
+  NonZeroMap.clear();
+  KeysByValue.clear();
+}
+
 // Given the provided Value and, potentially, a context instruction, return
 // the preferred context instruction (if any).
 static const Instruction *safeCxtI(const Value *V, const Instruction *CxtI) {
@@ -138,9 +205,10 @@ void llvm::computeKnownBits(const Value *V, KnownBits &Known,
                             const DataLayout &DL, unsigned Depth,
                             AssumptionCache *AC, const Instruction *CxtI,
                             const DominatorTree *DT,
-                            OptimizationRemarkEmitter *ORE) {
+                            OptimizationRemarkEmitter *ORE,
+                            ValueTrackingCache *VTC) {
   ::computeKnownBits(V, Known, Depth,
-                     Query(DL, AC, safeCxtI(V, CxtI), DT, ORE));
+                     Query(DL, AC, safeCxtI(V, CxtI), DT, ORE, VTC));
 }
 
 static KnownBits computeKnownBits(const Value *V, unsigned Depth,
@@ -150,9 +218,10 @@ KnownBits llvm::computeKnownBits(const Value *V, const DataLayout &DL,
                                  unsigned Depth, AssumptionCache *AC,
                                  const Instruction *CxtI,
                                  const DominatorTree *DT,
-                                 OptimizationRemarkEmitter *ORE) {
+                                 OptimizationRemarkEmitter *ORE,
+                                 ValueTrackingCache *VTC) {
   return ::computeKnownBits(V, Depth,
-                            Query(DL, AC, safeCxtI(V, CxtI), DT, ORE));
+                            Query(DL, AC, safeCxtI(V, CxtI), DT, ORE, VTC));
 }
 
 bool llvm::haveNoCommonBitsSet(const Value *LHS, const Value *RHS,
@@ -200,8 +269,9 @@ static bool isKnownNonZero(const Value *V, unsigned Depth, const Query &Q);
 
 bool llvm::isKnownNonZero(const Value *V, const DataLayout &DL, unsigned Depth,
                           AssumptionCache *AC, const Instruction *CxtI,
-                          const DominatorTree *DT) {
-  return ::isKnownNonZero(V, Depth, Query(DL, AC, safeCxtI(V, CxtI), DT));
+                          const DominatorTree *DT, ValueTrackingCache *VTC) {
+  return ::isKnownNonZero(V, Depth,
+                          Query(DL, AC, safeCxtI(V, CxtI), DT, nullptr, VTC));
 }
 
 bool llvm::isKnownNonNegative(const Value *V, const DataLayout &DL,
@@ -248,9 +318,11 @@ static bool MaskedValueIsZero(const Value *V, const APInt &Mask, unsigned Depth,
 bool llvm::MaskedValueIsZero(const Value *V, const APInt &Mask,
                              const DataLayout &DL,
                              unsigned Depth, AssumptionCache *AC,
-                             const Instruction *CxtI, const DominatorTree *DT) {
+                             const Instruction *CxtI, const DominatorTree *DT,
+                             ValueTrackingCache *VTC) {
   return ::MaskedValueIsZero(V, Mask, Depth,
-                             Query(DL, AC, safeCxtI(V, CxtI), DT));
+                             Query(DL, AC, safeCxtI(V, CxtI), DT, nullptr,
+                                   VTC));
 }
 
 static unsigned ComputeNumSignBits(const Value *V, unsigned Depth,
@@ -259,8 +331,10 @@ static unsigned ComputeNumSignBits(const Value *V, unsigned Depth,
 unsigned llvm::ComputeNumSignBits(const Value *V, const DataLayout &DL,
                                   unsigned Depth, AssumptionCache *AC,
                                   const Instruction *CxtI,
-                                  const DominatorTree *DT) {
-  return ::ComputeNumSignBits(V, Depth, Query(DL, AC, safeCxtI(V, CxtI), DT));
+                                  const DominatorTree *DT,
+                                  ValueTrackingCache *VTC) {
+  return ::ComputeNumSignBits(
+      V, Depth, Query(DL, AC, safeCxtI(V, CxtI), DT, nullptr, VTC));
 }
 
 static void computeKnownBitsAddSub(bool Add, const Value *Op0, const Value *Op1,
@@ -1494,8 +1568,27 @@ KnownBits computeKnownBits(const Value *V, unsigned Depth, const Query &Q) {
 /// where V is a vector, known zero, and known one values are the
 /// same width as the vector element, and the bit is set only if it is true
 /// for all of the elements in the vector.
+static void computeKnownBitsImpl(const Value *V, KnownBits &Known,
+                                 unsigned Depth, const Query &Q);
+
 void computeKnownBits(const Value *V, KnownBits &Known, unsigned Depth,
                       const Query &Q) {
+  if (!Q.useCache(V, Depth)) {
+    computeKnownBitsImpl(V, Known, Depth, Q);
+    return;
+  }
+
+  ValueTrackingCache::KeyT Key(V, Q.CxtI);
+  if (const KnownBits *Cached = Q.VTC->lookupKnownBits(Key)) {
+    Known = *Cached;
+    return;
+  }
+  computeKnownBitsImpl(V, Known, Depth, Q);
+  Q.VTC->insertKnownBits(Key, Known);
+}
+
+static void computeKnownBitsImpl(const Value *V, KnownBits &Known,
+                                 unsigned Depth, const Query &Q) {
   assert(V && "No Value?");
   assert(Depth <= MaxDepth && "Limit Search Depth");
   unsigned BitWidth = Known.getBitWidth();
@@ -1779,7 +1872,23 @@ static bool rangeMetadataExcludesValue(const MDNode* Ranges, const APInt& Value)
 /// specified, perform context-sensitive analysis and return true if the
 /// pointer couldn't possibly be null at the specified instruction.
 /// Supports values with integer or pointer type and vectors of integers.
+static bool isKnownNonZeroImpl(const Value *V, unsigned Depth,
+                               const Query &Q);
+
 bool isKnownNonZero(const Value *V, unsigned Depth, const Query &Q) {
+  if (!Q.useCache(V, Depth))
+    return isKnownNonZeroImpl(V, Depth, Q);
+
+  ValueTrackingCache::KeyT Key(V, Q.CxtI);
+  if (Optional<bool> Cached = Q.VTC->lookupNonZero(Key))
+    return *Cached;
+  bool NonZero = isKnownNonZeroImpl(V, Depth, Q);
+  Q.VTC->insertNonZero(Key, NonZero);
+  return NonZero;
+}
+
+static bool isKnownNonZeroImpl(const Value *V, unsigned Depth,
+                               const Query &Q) {
   if (auto *C = dyn_cast<Constant>(V)) {
     if (C->isNullValue())
       return false;
@@ -2048,8 +2157,16 @@ static unsigned ComputeNumSignBitsImpl(const Value *V, unsigned Depth,
 
 static unsigned ComputeNumSignBits(const Value *V, unsigned Depth,
                                    const Query &Q) {
+  ValueTrackingCache::KeyT Key(V, Q.CxtI);
+  bool UseCache = Q.useCache(V, Depth);
+  if (UseCache)
+    if (Optional<unsigned> Cached = Q.VTC->lookupNumSignBits(Key))
+      return *Cached;
+
   unsigned Result = ComputeNumSignBitsImpl(V, Depth, Q);
   assert(Result > 0 && "At least one sign bit needs to be present!");
+  if (UseCache)
+    Q.VTC->insertNumSignBits(Key, Result);
   return Result;
 }
 
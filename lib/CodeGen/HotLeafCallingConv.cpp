@@ -0,0 +1,155 @@
+//===- HotLeafCallingConv.cpp - Preserve registers across hot leaf calls --===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This pass switches small, hot, internal leaf functions to the preserve_most
+// calling convention.  Callers then only have to assume that the few scratch
+// registers of that convention are clobbered, so values that are live across
+// a hot call no longer have to be spilled and reloaded around it; the leaf
+// saves the registers it actually uses instead, which is cheap because it
+// makes no calls of its own.
+//
+// Interprocedural register allocation gives callers the exact clobber set of
+// a callee compiled earlier in the same module, which is at least as good, so
+// this pass is only scheduled when IPRA is off.  Both rely on seeing every
+// caller of the function, which limits them to functions with local linkage;
+// ThinLTO backends benefit for the functions they internalize.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/Triple.h"
+#include "llvm/Analysis/ProfileSummaryInfo.h"
+#include "llvm/CodeGen/Passes.h"
+#include "llvm/IR/CallSite.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Debug.h"
+using namespace llvm;
+
+#define DEBUG_TYPE "hot-leaf-cc"
+
+STATISTIC(NumHotLeaves, "Number of hot leaf functions given preserve_most");
+
+static cl::opt<unsigned> HotLeafMaxSize(
+    "hot-leaf-cc-max-size", cl::init(64), cl::Hidden,
+    cl::desc("Maximum number of instructions in a leaf function that is "
+             "given the preserve_most calling convention"));
+
+namespace {
+class HotLeafCallingConv : public ModulePass {
+public:
+  static char ID; // Pass identification, replacement for typeid
+  HotLeafCallingConv() : ModulePass(ID) {
+    initializeHotLeafCallingConvPass(*PassRegistry::getPassRegistry());
+  }
+
+  void getAnalysisUsage(AnalysisUsage &AU) const override {
+    AU.addRequired<ProfileSummaryInfoWrapperPass>();
+  }
+
+  bool runOnModule(Module &M) override;
+};
+} // end anonymous namespace
+
+char HotLeafCallingConv::ID = 0;
+
+INITIALIZE_PASS_BEGIN(HotLeafCallingConv, DEBUG_TYPE,
+                      "Preserve registers across hot leaf calls", false, false)
+INITIALIZE_PASS_DEPENDENCY(ProfileSummaryInfoWrapperPass)
+INITIALIZE_PASS_END(HotLeafCallingConv, DEBUG_TYPE,
+                    "Preserve registers across hot leaf calls", false, false)
+
+ModulePass *llvm::createHotLeafCallingConvPass() {
+  return new HotLeafCallingConv();
+}
+
+/// Return true if the calling convention of \p F can be changed without
+/// anyone but the callers in this module noticing.
+static bool hasOnlyKnownCallers(const Function &F) {
+  if (F.isDeclaration() || !F.hasLocalLinkage() || F.hasAddressTaken())
+    return false;
+  if (F.getCallingConv() != CallingConv::C || F.isVarArg() ||
+      F.hasFnAttribute(Attribute::Naked))
+    return false;
+  for (const User *U : F.users()) {
+    // A musttail call requires the caller and callee conventions to match.
+    if (const auto *CI = dyn_cast<CallInst>(U))
+      if (CI->isMustTailCall())
+        return false;
+  }
+  return true;
+}
+
+/// Return true if \p F is small and makes no calls that survive to
+/// instruction selection.
+static bool isSmallLeaf(const Function &F) {
+  unsigned Size = 0;
+  for (const BasicBlock &BB : F)
+    for (const Instruction &I : BB) {
+      if (isa<DbgInfoIntrinsic>(I))
+        continue;
+      if (++Size > HotLeafMaxSize)
+        return false;
+      if (!isa<CallInst>(I) && !isa<InvokeInst>(I))
+        continue;
+      const auto *II = dyn_cast<IntrinsicInst>(&I);
+      if (!II)
+        return false;
+      switch (II->getIntrinsicID()) {
+      case Intrinsic::lifetime_start:
+      case Intrinsic::lifetime_end:
+      case Intrinsic::assume:
+        break;
+      default:
+        // Memory intrinsics and the math intrinsics may become library calls.
+        return false;
+      }
+    }
+  return true;
+}
+
+bool HotLeafCallingConv::runOnModule(Module &M) {
+  if (skipModule(M))
+    return false;
+
+  // Only targets that implement preserve_most with a useful set of preserved
+  // registers.
+  Triple TT(M.getTargetTriple());
+  if (TT.getArch() != Triple::x86_64 && TT.getArch() != Triple::aarch64)
+    return false;
+
+  ProfileSummaryInfo *PSI =
+      getAnalysis<ProfileSummaryInfoWrapperPass>().getPSI();
+  if (!PSI->hasProfileSummary())
+    return false;
+
+  bool Changed = false;
+  for (Function &F : M) {
+    if (!hasOnlyKnownCallers(F) || !PSI->isFunctionEntryHot(&F) ||
+        !isSmallLeaf(F))
+      continue;
+
+    DEBUG(dbgs() << "Using preserve_most for hot leaf " << F.getName()
+                 << "\n");
+    F.setCallingConv(CallingConv::PreserveMost);
+    for (User *U : F.users()) {
+      // Blocks of F whose address is taken do not make F's address taken.
+      if (isa<BlockAddress>(U))
+        continue;
+      CallSite(U).setCallingConv(CallingConv::PreserveMost);
+    }
+    ++NumHotLeaves;
+    Changed = true;
+  }
+  return Changed;
+}
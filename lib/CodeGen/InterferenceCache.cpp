@@ -81,13 +81,36 @@ InterferenceCache::Entry *InterferenceCache::get(unsigned PhysReg) {
 /// revalidate - LIU contents have changed, update tags.
 void InterferenceCache::Entry::revalidate(LiveIntervalUnion *LIUArray,
                                           const TargetRegisterInfo *TRI) {
-  // Invalidate all block entries.
-  ++Tag;
+  // Find the parts of the function where the interference changed. Most
+  // assignments only touch a few blocks, and the interference cached for the
+  // other blocks is still good.
+  SmallVector<LiveIntervalUnion::ChangedRange, 8> Changes;
+  bool KnownChanges = true;
+  unsigned i = 0;
+  for (MCRegUnitIterator Units(PhysReg, TRI); Units.isValid(); ++Units, ++i) {
+    LiveIntervalUnion &LIU = LIUArray[*Units];
+    if (KnownChanges && LIU.changedSince(RegUnits[i].VirtTag))
+      KnownChanges = LIU.getChangesSince(RegUnits[i].VirtTag, Changes);
+    RegUnits[i].VirtTag = LIU.getTag();
+  }
+
   // Invalidate all iterators.
   PrevPos = SlotIndex();
-  unsigned i = 0;
-  for (MCRegUnitIterator Units(PhysReg, TRI); Units.isValid(); ++Units, ++i)
-    RegUnits[i].VirtTag = LIUArray[*Units].getTag();
+
+  if (!KnownChanges) {
+    // Invalidate all block entries.
+    ++Tag;
+    return;
+  }
+
+  // Invalidate the block entries overlapping a changed live range.
+  for (const LiveIntervalUnion::ChangedRange &R : Changes) {
+    MachineFunction::const_iterator MFI =
+        Indexes->getMBBFromIndex(R.first)->getIterator();
+    for (; MFI != MF->end() && Indexes->getMBBStartIdx(&*MFI) < R.second;
+         ++MFI)
+      Blocks[MFI->getNumber()].Tag = Tag - 1;
+  }
 }
 
 void InterferenceCache::Entry::reset(unsigned physReg,
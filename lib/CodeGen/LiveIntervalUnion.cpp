@@ -26,11 +26,32 @@ using namespace llvm;
 
 #define DEBUG_TYPE "regalloc"
 
+void LiveIntervalUnion::recordChange(const LiveRange &Range) {
+  ++Tag;
+  Change &C = ChangeLog[Tag % ChangeLogSize];
+  C.Tag = Tag;
+  C.Range = ChangedRange(Range.beginIndex(), Range.endIndex());
+}
+
+bool LiveIntervalUnion::getChangesSince(
+    unsigned tag, SmallVectorImpl<ChangedRange> &Changes) const {
+  if (Tag - tag > ChangeLogSize)
+    return false;
+  // clear() changes the tag without logging a range.
+  for (unsigned T = tag + 1; T != Tag + 1; ++T) {
+    const Change &C = ChangeLog[T % ChangeLogSize];
+    if (C.Tag != T)
+      return false;
+    Changes.push_back(C.Range);
+  }
+  return true;
+}
+
 // Merge a LiveInterval's segments. Guarantee no overlaps.
 void LiveIntervalUnion::unify(LiveInterval &VirtReg, const LiveRange &Range) {
   if (Range.empty())
     return;
-  ++Tag;
+  recordChange(Range);
 
   // Insert each of the virtual register's live segments into the map.
   LiveRange::const_iterator RegPos = Range.begin();
@@ -57,7 +78,7 @@ void LiveIntervalUnion::unify(LiveInterval &VirtReg, const LiveRange &Range) {
 void LiveIntervalUnion::extract(LiveInterval &VirtReg, const LiveRange &Range) {
   if (Range.empty())
     return;
-  ++Tag;
+  recordChange(Range);
 
   // Remove each of the virtual register's live segments from the map.
   LiveRange::const_iterator RegPos = Range.begin();
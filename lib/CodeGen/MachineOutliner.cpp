@@ -38,8 +38,15 @@
 /// For more information on the suffix tree data structure, please see
 /// https://www.cs.helsinki.fi/u/ukkonen/SuffixT1withFigs.pdf
 ///
+/// The benefit of each repeated sequence only depends on the tree, so with
+/// -outliner-parallel-benefit it is evaluated on all threads before the
+/// candidates are picked in order. With -outliner-cold-only, only functions
+/// known to be cold are outlined from, for use alongside hot/cold splitting.
+/// Functions outlined only from cold code are placed in .text.unlikely.
+///
 //===----------------------------------------------------------------------===//
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/CodeGen/MachineFrameInfo.h"
@@ -49,7 +56,9 @@
 #include "llvm/CodeGen/Passes.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/Support/Allocator.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Target/TargetInstrInfo.h"
 #include "llvm/Target/TargetMachine.h"
@@ -67,6 +76,29 @@ using namespace llvm;
 
 STATISTIC(NumOutlined, "Number of candidates outlined");
 STATISTIC(FunctionsCreated, "Number of functions created");
+STATISTIC(ColdFunctionsCreated, "Number of functions created in cold sections");
+
+static cl::opt<bool> ParallelBenefit(
+    "outliner-parallel-benefit", cl::init(false), cl::Hidden,
+    cl::desc("Evaluate the benefit of repeated sequences on all threads"));
+
+static cl::opt<unsigned> ParallelBenefitThreshold(
+    "outliner-parallel-benefit-threshold", cl::init(4096), cl::Hidden,
+    cl::desc("Minimum number of repeated sequences to evaluate in parallel"));
+
+static cl::opt<bool> OutlineColdOnly(
+    "outliner-cold-only", cl::init(false), cl::Hidden,
+    cl::desc("Only outline from functions known to be cold"));
+
+/// Returns true if \p F is known to be rarely executed, either from its
+/// attributes or from the section prefix CodeGenPrepare derived from its
+/// profile.
+static bool isColdFunction(const Function &F) {
+  if (F.hasFnAttribute(Attribute::Cold))
+    return true;
+  Optional<StringRef> Prefix = F.getSectionPrefix();
+  return Prefix && *Prefix == ".unlikely";
+}
 
 namespace {
 
@@ -131,6 +163,10 @@ struct OutlinedFunction {
   /// replaced with tail calls to this OutlinedFunction.
   bool IsTailCall = false;
 
+  /// Set to true if every candidate outlined into this function comes from a
+  /// cold function.
+  bool IsCold = false;
+
   OutlinedFunction(size_t Name, size_t OccurrenceCount,
                    const std::vector<unsigned> &Sequence,
                    unsigned Benefit, bool IsTailCall)
@@ -388,38 +424,44 @@ private:
   /// respective suffixes. Also stores each leaf in \p LeafVector at its
   /// respective suffix index.
   ///
-  /// \param[in] CurrNode The node currently being visited.
-  /// \param CurrIdx The current index of the string being visited.
-  void setSuffixIndices(SuffixTreeNode &CurrNode, size_t CurrIdx) {
-
-    bool IsLeaf = CurrNode.Children.size() == 0 && !CurrNode.isRoot();
-
-    // Store the length of the concatenation of all strings from the root to
-    // this node.
-    if (!CurrNode.isRoot()) {
-      if (CurrNode.ConcatLen == 0)
+  /// The tree is as deep as the longest repeated sequence, so it is walked
+  /// with an explicit stack rather than recursively.
+  void setSuffixIndices() {
+    // Each entry is a node and the length of the string ending at it.
+    SmallVector<std::pair<SuffixTreeNode *, size_t>, 64> Worklist;
+    Worklist.push_back({Root, 0});
+
+    while (!Worklist.empty()) {
+      SuffixTreeNode &CurrNode = *Worklist.back().first;
+      size_t CurrIdx = Worklist.back().second;
+      Worklist.pop_back();
+
+      // Store the length of the concatenation of all strings from the root to
+      // this node.
+      if (!CurrNode.isRoot()) {
         CurrNode.ConcatLen = CurrNode.size();
+        if (CurrNode.Parent)
+          CurrNode.ConcatLen += CurrNode.Parent->ConcatLen;
+      }
 
-      if (CurrNode.Parent)
-       CurrNode.ConcatLen += CurrNode.Parent->ConcatLen;
-    }
-
-    // Traverse the tree depth-first.
-    for (auto &ChildPair : CurrNode.Children) {
-      assert(ChildPair.second && "Node had a null child!");
-      setSuffixIndices(*ChildPair.second,
-                       CurrIdx + ChildPair.second->size());
-    }
+      // Is this node a leaf?
+      if (CurrNode.Children.empty() && !CurrNode.isRoot()) {
+        // If yes, give it a suffix index and bump its parent's occurrence
+        // count.
+        CurrNode.SuffixIdx = Str.size() - CurrIdx;
+        assert(CurrNode.Parent && "CurrNode had no parent!");
+        CurrNode.Parent->OccurrenceCount++;
 
-    // Is this node a leaf?
-    if (IsLeaf) {
-      // If yes, give it a suffix index and bump its parent's occurrence count.
-      CurrNode.SuffixIdx = Str.size() - CurrIdx;
-      assert(CurrNode.Parent && "CurrNode had no parent!");
-      CurrNode.Parent->OccurrenceCount++;
+        // Store the leaf in the leaf vector for pruning later.
+        LeafVector[CurrNode.SuffixIdx] = &CurrNode;
+        continue;
+      }
 
-      // Store the leaf in the leaf vector for pruning later.
-      LeafVector[CurrNode.SuffixIdx] = &CurrNode;
+      for (auto &ChildPair : CurrNode.Children) {
+        assert(ChildPair.second && "Node had a null child!");
+        Worklist.push_back(
+            {ChildPair.second, CurrIdx + ChildPair.second->size()});
+      }
     }
   }
 
@@ -454,7 +496,8 @@ private:
       unsigned FirstChar = Str[Active.Idx];
 
       // Have we inserted anything starting with FirstChar at the current node?
-      if (Active.Node->Children.count(FirstChar) == 0) {
+      auto ChildIt = Active.Node->Children.find(FirstChar);
+      if (ChildIt == Active.Node->Children.end()) {
         // If not, then we can just insert a leaf and move too the next step.
         insertLeaf(*Active.Node, EndIdx, FirstChar);
 
@@ -467,7 +510,7 @@ private:
       } else {
         // There's a match with FirstChar, so look for the point in the tree to
         // insert a new node.
-        SuffixTreeNode *NextNode = Active.Node->Children[FirstChar];
+        SuffixTreeNode *NextNode = ChildIt->second;
 
         size_t SubstringLen = NextNode->size();
 
@@ -583,6 +626,11 @@ public:
     size_t FnIdx = 0;
     size_t MaxLen = 0;
 
+    // Collect each repeated substring once, together with the first leaf
+    // that has it as a prefix. Visiting the leaves in order keeps the
+    // numbering of the outlined functions independent of the tree's layout.
+    std::vector<std::pair<SuffixTreeNode *, SuffixTreeNode *>> Repeated;
+    SmallPtrSet<SuffixTreeNode *, 32> Seen;
     for (SuffixTreeNode* Leaf : LeafVector) {
       assert(Leaf && "Leaves in LeafVector cannot be null!");
       if (!Leaf->IsInTree)
@@ -595,16 +643,39 @@ public:
       if (Parent.OccurrenceCount < 2 || Parent.isRoot() || !Parent.IsInTree)
         continue;
 
-      size_t StringLen = Leaf->ConcatLen - Leaf->size();
+      if (Seen.insert(&Parent).second)
+        Repeated.push_back({&Parent, Leaf});
+    }
 
-      // How many instructions would outlining this string save?
-      unsigned Benefit = BenefitFn(Parent,
-        StringLen, Str[Leaf->SuffixIdx + StringLen - 1]);
+    // How many instructions would outlining each string save? This only reads
+    // the tree, so it can be done for all of the strings at once.
+    std::vector<unsigned> Benefits(Repeated.size());
+    auto EvaluateBenefit = [&](size_t I) {
+      SuffixTreeNode &Parent = *Repeated[I].first;
+      SuffixTreeNode &Leaf = *Repeated[I].second;
+      size_t StringLen = Leaf.ConcatLen - Leaf.size();
+      Benefits[I] =
+          BenefitFn(Parent, StringLen, Str[Leaf.SuffixIdx + StringLen - 1]);
+    };
+#if LLVM_ENABLE_THREADS
+    if (ParallelBenefit && Repeated.size() >= ParallelBenefitThreshold)
+      parallel::for_each_n(parallel::par, size_t(0), Repeated.size(),
+                           EvaluateBenefit);
+    else
+#endif
+      parallel::for_each_n(parallel::seq, size_t(0), Repeated.size(),
+                           EvaluateBenefit);
+
+    for (size_t I = 0, E = Repeated.size(); I != E; ++I) {
+      SuffixTreeNode &Parent = *Repeated[I].first;
+      SuffixTreeNode *Leaf = Repeated[I].second;
+      unsigned Benefit = Benefits[I];
 
       // If it's not beneficial, skip it.
       if (Benefit < 1)
         continue;
 
+      size_t StringLen = Leaf->ConcatLen - Leaf->size();
       if (StringLen > MaxLen)
         MaxLen = StringLen;
 
@@ -622,9 +693,9 @@ public:
       }
 
       // Save the function for the new candidate sequence.
-      std::vector<unsigned> CandidateSequence;
-      for (unsigned i = Leaf->SuffixIdx; i < Leaf->SuffixIdx + StringLen; i++)
-        CandidateSequence.push_back(Str[i]);
+      std::vector<unsigned> CandidateSequence(
+          Str.begin() + Leaf->SuffixIdx,
+          Str.begin() + Leaf->SuffixIdx + StringLen);
 
       FunctionList.emplace_back(FnIdx, OccurrenceCount, CandidateSequence,
                                 Benefit, false);
@@ -662,7 +733,7 @@ public:
 
     // Set the suffix indices of each leaf.
     assert(Root && "Root node can't be nullptr!");
-    setSuffixIndices(*Root, 0);
+    setSuffixIndices();
   }
 };
 
@@ -1060,9 +1131,9 @@ MachineOutliner::buildCandidateList(std::vector<Candidate> &CandidateList,
     if (Occurrences < 2)
       return 0u;
 
-    // Check if the last instruction in the sequence is a return.
-    MachineInstr *LastInstr =
-    Mapper.IntegerInstructionMap[EndVal];
+    // Check if the last instruction in the sequence is a return. This may be
+    // called from several threads at once, so the map must not be modified.
+    MachineInstr *LastInstr = Mapper.IntegerInstructionMap.lookup(EndVal);
     assert(LastInstr && "Last instruction in sequence was unmapped!");
 
     // The only way a terminator could be mapped as legal is if it was safe to
@@ -1106,6 +1177,13 @@ MachineOutliner::createOutlinedFunction(Module &M, const OutlinedFunction &OF,
   F->setLinkage(GlobalValue::PrivateLinkage);
   F->setUnnamedAddr(GlobalValue::UnnamedAddr::Global);
 
+  // Keep code that is only reached from cold functions out of the way of the
+  // hot code.
+  if (OF.IsCold) {
+    F->addFnAttr(Attribute::Cold);
+    F->setSectionPrefix(".unlikely");
+  }
+
   BasicBlock *EntryBB = BasicBlock::Create(C, "entry", F);
   IRBuilder<> Builder(EntryBB);
   Builder.CreateRetVoid();
@@ -1146,6 +1224,17 @@ bool MachineOutliner::outline(Module &M,
 
   bool OutlinedSomething = false;
 
+  // Find the functions that will only be called from cold code.
+  for (OutlinedFunction &OF : FunctionList)
+    OF.IsCold = true;
+  for (const Candidate &C : CandidateList) {
+    if (!C.InCandidateList)
+      continue;
+    const MachineBasicBlock *MBB = Mapper.InstrList[C.StartIdx]->getParent();
+    if (!isColdFunction(*MBB->getParent()->getFunction()))
+      FunctionList[C.FunctionIdx].IsCold = false;
+  }
+
   // Replace the candidates with calls to their respective outlined functions.
   for (const Candidate &C : CandidateList) {
 
@@ -1176,6 +1265,8 @@ bool MachineOutliner::outline(Module &M,
     if (!OF.MF) {
       OF.MF = createOutlinedFunction(M, OF, Mapper);
       FunctionsCreated++;
+      if (OF.IsCold)
+        ColdFunctionsCreated++;
     }
 
     MachineFunction *MF = OF.MF;
@@ -1222,6 +1313,10 @@ bool MachineOutliner::runOnModule(Module &M) {
     if (F.empty() || !TII->isFunctionSafeToOutlineFrom(MF))
       continue;
 
+    // Leave hot code alone when outlining to complement hot/cold splitting.
+    if (OutlineColdOnly && !isColdFunction(F))
+      continue;
+
     // If it is, look at each MachineBasicBlock in the function.
     for (MachineBasicBlock &MBB : MF) {
 
@@ -50,7 +50,14 @@
 // nodes. We also perform several passes over the DAG to eliminate unnecessary
 // edges that inhibit the ability to pipeline. The implementation uses the
 // DFAPacketizer class to compute the minimum initiation interval and the check
-// where an instruction may be inserted in the pipelined schedule.
+// where an instruction may be inserted in the pipelined schedule. Targets
+// without a DFA are modeled with the processor resources and the issue width
+// of their scheduling model instead.
+//
+// A compare that only feeds the loop branch is kept with the terminators, out
+// of the schedule, so that it tests the newest iteration in the kernel. This
+// lets targets pipeline loops controlled by an induction variable and a
+// compare rather than by a hardware loop.
 //
 // In order for the SMS pass to work, several target specific hooks need to be
 // implemented to get information about the loop structure and to rewrite
@@ -67,6 +74,7 @@
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallSet.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/iterator_range.h"
 #include "llvm/Analysis/AliasAnalysis.h"
@@ -90,9 +98,11 @@
 #include "llvm/CodeGen/ScheduleDAG.h"
 #include "llvm/CodeGen/ScheduleDAGInstrs.h"
 #include "llvm/CodeGen/ScheduleDAGMutation.h"
+#include "llvm/CodeGen/TargetSchedule.h"
 #include "llvm/IR/Attributes.h"
 #include "llvm/IR/DebugLoc.h"
 #include "llvm/MC/MCInstrItineraries.h"
+#include "llvm/MC/MCSchedule.h"
 #include "llvm/PassAnalysisSupport.h"
 #include "llvm/PassRegistry.h"
 #include "llvm/PassSupport.h"
@@ -161,6 +171,13 @@ static cl::opt<bool>
 static cl::opt<int> SwpLoopLimit("pipeliner-max", cl::Hidden, cl::init(-1));
 #endif
 
+/// A command line option to pipeline loops that an out-of-order core would
+/// overlap by itself.
+static cl::opt<bool> SwpCheckReorderWindow(
+    "pipeliner-check-reorder-window", cl::Hidden, cl::init(true),
+    cl::desc("Only pipeline loops whose overlapped iterations do not fit in "
+             "the reorder buffer of the scheduling model"));
+
 static cl::opt<bool> SwpIgnoreRecMII("pipeliner-ignore-recmii",
                                      cl::ReallyHidden, cl::init(false),
                                      cl::ZeroOrMore, cl::desc("Ignore RecMII"));
@@ -385,7 +402,9 @@ private:
   void updatePhiDependences();
   void changeDependences();
   unsigned calculateResMII();
+  unsigned calculateSchedModelResMII();
   unsigned calculateRecMII(NodeSetType &RecNodeSets);
+  bool isProfitableToPipeline(SMSchedule &Schedule);
   void findCircuits(NodeSetType &NodeSets);
   void fuseRecs(NodeSetType &NodeSets);
   void removeDuplicateNodes(NodeSetType &NodeSets);
@@ -557,6 +576,83 @@ public:
 #endif
 };
 
+/// Tracks the resources used by the instructions issued in one cycle.  Targets
+/// that provide a DFA packetizer are modeled with it.  For the others, each
+/// instruction takes one unit of every processor resource it writes in its
+/// scheduling class, and its micro-ops count against the issue width.
+class ResourceManager {
+private:
+  TargetSchedModel SchedModel;
+  std::unique_ptr<DFAPacketizer> DFAResources;
+
+  /// Number of units of each processor resource used in the cycle.
+  SmallVector<unsigned, 16> ProcResourceCount;
+
+  /// Number of micro-ops issued in the cycle.
+  unsigned NumMicroOps = 0;
+
+  const MCSchedClassDesc *getSchedClass(const MachineInstr &MI) const {
+    if (!SchedModel.hasInstrSchedModel())
+      return nullptr;
+    const MCSchedClassDesc *SCDesc = SchedModel.resolveSchedClass(&MI);
+    return SCDesc->isValid() ? SCDesc : nullptr;
+  }
+
+public:
+  ResourceManager(const TargetSubtargetInfo &ST)
+      : DFAResources(ST.getInstrInfo()->CreateTargetScheduleState(ST)) {
+    SchedModel.init(ST.getSchedModel(), &ST, ST.getInstrInfo());
+    ProcResourceCount.resize(SchedModel.getNumProcResourceKinds());
+  }
+
+  bool canReserveResources(MachineInstr &MI) const {
+    if (DFAResources)
+      return DFAResources->canReserveResources(MI);
+    // Always allow the first instruction of a cycle, even if it needs more
+    // than the issue width.
+    unsigned IssueWidth = SchedModel.getIssueWidth();
+    if (NumMicroOps &&
+        NumMicroOps + SchedModel.getNumMicroOps(&MI) > IssueWidth)
+      return false;
+    const MCSchedClassDesc *SCDesc = getSchedClass(MI);
+    if (!SCDesc)
+      return true;
+    for (const MCWriteProcResEntry &PRE :
+         make_range(SchedModel.getWriteProcResBegin(SCDesc),
+                    SchedModel.getWriteProcResEnd(SCDesc)))
+      if (PRE.Cycles && ProcResourceCount[PRE.ProcResourceIdx] >=
+                            SchedModel.getProcResource(PRE.ProcResourceIdx)
+                                ->NumUnits)
+        return false;
+    return true;
+  }
+
+  void reserveResources(MachineInstr &MI) {
+    if (DFAResources) {
+      DFAResources->reserveResources(MI);
+      return;
+    }
+    NumMicroOps += SchedModel.getNumMicroOps(&MI);
+    const MCSchedClassDesc *SCDesc = getSchedClass(MI);
+    if (!SCDesc)
+      return;
+    for (const MCWriteProcResEntry &PRE :
+         make_range(SchedModel.getWriteProcResBegin(SCDesc),
+                    SchedModel.getWriteProcResEnd(SCDesc)))
+      if (PRE.Cycles)
+        ++ProcResourceCount[PRE.ProcResourceIdx];
+  }
+
+  void clearResources() {
+    if (DFAResources) {
+      DFAResources->clearResources();
+      return;
+    }
+    std::fill(ProcResourceCount.begin(), ProcResourceCount.end(), 0);
+    NumMicroOps = 0;
+  }
+};
+
 /// This class repesents the scheduled code.  The main data structure is a
 /// map from scheduled cycle to instructions.  During scheduling, the
 /// data structure explicitly represents all stages/iterations.   When
@@ -595,12 +691,12 @@ private:
   /// Virtual register information.
   MachineRegisterInfo &MRI;
 
-  std::unique_ptr<DFAPacketizer> Resources;
+  std::unique_ptr<ResourceManager> Resources;
 
 public:
   SMSchedule(MachineFunction *mf)
       : ST(mf->getSubtarget()), MRI(mf->getRegInfo()),
-        Resources(ST.getInstrInfo()->CreateTargetScheduleState(ST)) {
+        Resources(llvm::make_unique<ResourceManager>(ST)) {
     FirstCycle = 0;
     LastCycle = 0;
     InitiationInterval = 0;
@@ -618,6 +714,9 @@ public:
   /// Set the initiation interval for this schedule.
   void setInitiationInterval(int ii) { InitiationInterval = ii; }
 
+  /// Return the initiation interval for this schedule.
+  int getInitiationInterval() const { return InitiationInterval; }
+
   /// Return the first cycle in the completed schedule.  This
   /// can be a negative value.
   int getFirstCycle() const { return FirstCycle; }
@@ -697,6 +796,8 @@ public:
   }
 
   bool isValidSchedule(SwingSchedulerDAG *SSD);
+  bool isPhysRegClobbered(SwingSchedulerDAG *SSD, SUnit *Def, SUnit *Use,
+                          unsigned Reg);
   void finalizeSchedule(SwingSchedulerDAG *SSD);
   bool orderDependence(SwingSchedulerDAG *SSD, SUnit *SU,
                        std::deque<SUnit *> &Insts);
@@ -798,6 +899,22 @@ bool MachinePipeliner::canPipelineLoop(MachineLoop &L) {
   if (TII->analyzeLoop(L, LI.LoopInductionVar, LI.LoopCompare))
     return false;
 
+  // A compare that is not a terminator stays with the terminators, so it has
+  // to be right before them and may only set the condition of the branch.
+  if (MachineInstr *Cmp = LI.LoopCompare)
+    if (!Cmp->isTerminator()) {
+      MachineBasicBlock *Header = L.getHeader();
+      if (Cmp->getParent() != Header ||
+          std::next(MachineBasicBlock::iterator(Cmp)) !=
+              Header->getFirstTerminator())
+        return false;
+      for (const MachineOperand &MO : Cmp->operands())
+        if (MO.isReg() && MO.isDef() &&
+            TargetRegisterInfo::isVirtualRegister(MO.getReg()) &&
+            !MF->getRegInfo().use_nodbg_empty(MO.getReg()))
+          return false;
+    }
+
   if (!L.getLoopPreheader())
     return false;
 
@@ -829,15 +946,19 @@ bool MachinePipeliner::swingModuloScheduler(MachineLoop &L) {
   // will be added back later.
   SMS.startBlock(MBB);
 
+  // The loop compare, if it is not a terminator itself, is kept with them.
+  MachineBasicBlock::iterator End = MBB->getFirstTerminator();
+  if (LI.LoopCompare && !LI.LoopCompare->isTerminator())
+    End = LI.LoopCompare;
+
   // Compute the number of 'real' instructions in the basic block by
   // ignoring terminators.
   unsigned size = MBB->size();
-  for (MachineBasicBlock::iterator I = MBB->getFirstTerminator(),
-                                   E = MBB->instr_end();
-       I != E; ++I, --size)
+  for (MachineBasicBlock::iterator I = End, E = MBB->instr_end(); I != E;
+       ++I, --size)
     ;
 
-  SMS.enterRegion(MBB, MBB->begin(), MBB->getFirstTerminator(), size);
+  SMS.enterRegion(MBB, MBB->begin(), End, size);
   SMS.schedule();
   SMS.exitRegion();
 
@@ -930,10 +1051,41 @@ void SwingSchedulerDAG::schedule() {
   if (SwpMaxStages > -1 && (int)numStages > SwpMaxStages)
     return;
 
+  // The loop compare tests the induction variable of the iteration in the
+  // first stage of the kernel, so the induction variable has to be updated
+  // in that stage.
+  if (MachineInstr *IndVar = Pass.LI.LoopInductionVar)
+    if (Schedule.stageScheduled(getSUnit(IndVar)) != 0)
+      return;
+
+  if (!isProfitableToPipeline(Schedule))
+    return;
+
   generatePipelinedLoop(Schedule);
   ++NumPipelined;
 }
 
+/// Return true if the pipelined loop is expected to run faster than the
+/// original one.  An out-of-order core overlaps the iterations of the original
+/// loop by itself as long as the micro-ops of all the iterations in flight fit
+/// in its reorder buffer, so pipelining only pays off beyond that.
+bool SwingSchedulerDAG::isProfitableToPipeline(SMSchedule &Schedule) {
+  if (!SwpCheckReorderWindow || !SchedModel.hasInstrSchedModel())
+    return true;
+  int BufferSize = SchedModel.getMCSchedModel()->MicroOpBufferSize;
+  if (BufferSize <= 1)
+    return true;
+
+  unsigned NumMicroOps = 0;
+  for (SUnit &SU : SUnits)
+    NumMicroOps += SchedModel.getNumMicroOps(SU.getInstr());
+  unsigned NumInFlight = Schedule.getMaxStageCount() + 1;
+  DEBUG(dbgs() << "Iterations in flight = " << NumInFlight << " x "
+               << NumMicroOps << " micro-ops, reorder buffer = " << BufferSize
+               << "\n");
+  return NumInFlight * NumMicroOps > (unsigned)BufferSize;
+}
+
 /// Clean up after the software pipeliner runs.
 void SwingSchedulerDAG::finishBlock() {
   for (MachineInstr *I : NewMIs)
@@ -1254,14 +1406,40 @@ namespace {
 // the number of functional unit choices.
 struct FuncUnitSorter {
   const InstrItineraryData *InstrItins;
+  const TargetSchedModel *SchedModel;
   DenseMap<unsigned, unsigned> Resources;
 
+  // Without itineraries, the functional units are the processor resources
+  // of the scheduling model, each identified by its index.
+  const MCSchedClassDesc *getSchedClass(const MachineInstr *Inst) const {
+    if (!InstrItins->isEmpty() || !SchedModel->hasInstrSchedModel())
+      return nullptr;
+    const MCSchedClassDesc *SCDesc = SchedModel->resolveSchedClass(Inst);
+    return SCDesc->isValid() ? SCDesc : nullptr;
+  }
+
   // Compute the number of functional unit alternatives needed
   // at each stage, and take the minimum value. We prioritize the
   // instructions by the least number of choices first.
   unsigned minFuncUnits(const MachineInstr *Inst, unsigned &F) const {
     unsigned schedClass = Inst->getDesc().getSchedClass();
     unsigned min = UINT_MAX;
+    if (InstrItins->isEmpty()) {
+      if (const MCSchedClassDesc *SCDesc = getSchedClass(Inst))
+        for (const MCWriteProcResEntry &PRE :
+             make_range(SchedModel->getWriteProcResBegin(SCDesc),
+                        SchedModel->getWriteProcResEnd(SCDesc))) {
+          if (!PRE.Cycles)
+            continue;
+          unsigned NumUnits =
+              SchedModel->getProcResource(PRE.ProcResourceIdx)->NumUnits;
+          if (NumUnits < min) {
+            min = NumUnits;
+            F = PRE.ProcResourceIdx;
+          }
+        }
+      return min;
+    }
     for (const InstrStage *IS = InstrItins->beginStage(schedClass),
                           *IE = InstrItins->endStage(schedClass);
          IS != IE; ++IS) {
@@ -1281,6 +1459,16 @@ struct FuncUnitSorter {
   // for computing the resource MII. The instrutions that require
   // the same, highly used, functional unit have high priority.
   void calcCriticalResources(MachineInstr &MI) {
+    if (InstrItins->isEmpty()) {
+      if (const MCSchedClassDesc *SCDesc = getSchedClass(&MI))
+        for (const MCWriteProcResEntry &PRE :
+             make_range(SchedModel->getWriteProcResBegin(SCDesc),
+                        SchedModel->getWriteProcResEnd(SCDesc)))
+          if (PRE.Cycles &&
+              SchedModel->getProcResource(PRE.ProcResourceIdx)->NumUnits == 1)
+            Resources[PRE.ProcResourceIdx]++;
+      return;
+    }
     unsigned SchedClass = MI.getDesc().getSchedClass();
     for (const InstrStage *IS = InstrItins->beginStage(SchedClass),
                           *IE = InstrItins->endStage(SchedClass);
@@ -1291,7 +1479,8 @@ struct FuncUnitSorter {
     }
   }
 
-  FuncUnitSorter(const InstrItineraryData *IID) : InstrItins(IID) {}
+  FuncUnitSorter(const InstrItineraryData *IID, const TargetSchedModel *TSM)
+      : InstrItins(IID), SchedModel(TSM) {}
   /// Return true if IS1 has less priority than IS2.
   bool operator()(const MachineInstr *IS1, const MachineInstr *IS2) const {
     unsigned F1 = 0, F2 = 0;
@@ -1315,20 +1504,22 @@ unsigned SwingSchedulerDAG::calculateResMII() {
   SmallVector<DFAPacketizer *, 8> Resources;
   MachineBasicBlock *MBB = Loop.getHeader();
   Resources.push_back(TII->CreateTargetScheduleState(MF.getSubtarget()));
+  if (!Resources.front()) {
+    Resources.clear();
+    return calculateSchedModelResMII();
+  }
 
   // Sort the instructions by the number of available choices for scheduling,
   // least to most. Use the number of critical resources as the tie breaker.
   FuncUnitSorter FUS =
-      FuncUnitSorter(MF.getSubtarget().getInstrItineraryData());
-  for (MachineBasicBlock::iterator I = MBB->getFirstNonPHI(),
-                                   E = MBB->getFirstTerminator();
+      FuncUnitSorter(MF.getSubtarget().getInstrItineraryData(), &SchedModel);
+  for (MachineBasicBlock::iterator I = MBB->getFirstNonPHI(), E = RegionEnd;
        I != E; ++I)
     FUS.calcCriticalResources(*I);
   PriorityQueue<MachineInstr *, std::vector<MachineInstr *>, FuncUnitSorter>
       FuncUnitOrder(FUS);
 
-  for (MachineBasicBlock::iterator I = MBB->getFirstNonPHI(),
-                                   E = MBB->getFirstTerminator();
+  for (MachineBasicBlock::iterator I = MBB->getFirstNonPHI(), E = RegionEnd;
        I != E; ++I)
     FuncUnitOrder.push(&*I);
 
@@ -1374,6 +1565,38 @@ unsigned SwingSchedulerDAG::calculateResMII() {
   return Resmii;
 }
 
+/// Calculate the resource constrained minimum initiation interval for targets
+/// without a DFA. The bound is given by the issue width and by the processor
+/// resource of the scheduling model with the most cycles per unit.
+unsigned SwingSchedulerDAG::calculateSchedModelResMII() {
+  SmallVector<unsigned, 16> ResourceCycles(SchedModel.getNumProcResourceKinds());
+  unsigned NumMicroOps = 0;
+  for (SUnit &SU : SUnits) {
+    MachineInstr *MI = SU.getInstr();
+    if (TII->isZeroCost(MI->getOpcode()))
+      continue;
+    NumMicroOps += SchedModel.getNumMicroOps(MI);
+    if (!SchedModel.hasInstrSchedModel())
+      continue;
+    const MCSchedClassDesc *SCDesc = SchedModel.resolveSchedClass(MI);
+    if (!SCDesc->isValid())
+      continue;
+    for (const MCWriteProcResEntry &PRE :
+         make_range(SchedModel.getWriteProcResBegin(SCDesc),
+                    SchedModel.getWriteProcResEnd(SCDesc)))
+      ResourceCycles[PRE.ProcResourceIdx] += PRE.Cycles;
+  }
+
+  unsigned IssueWidth = std::max(SchedModel.getIssueWidth(), 1u);
+  unsigned ResMII = (NumMicroOps + IssueWidth - 1) / IssueWidth;
+  for (unsigned Idx = 1, E = ResourceCycles.size(); Idx != E; ++Idx) {
+    unsigned NumUnits = SchedModel.getProcResource(Idx)->NumUnits;
+    if (NumUnits)
+      ResMII = std::max(ResMII, (ResourceCycles[Idx] + NumUnits - 1) / NumUnits);
+  }
+  return ResMII;
+}
+
 /// Calculate the recurrence-constrainted minimum initiation interval.
 /// Iterate over each circuit.  Compute the delay(c) and distance(c)
 /// for each circuit. The II needs to satisfy the inequality
@@ -1595,7 +1818,9 @@ void SwingSchedulerDAG::computeNodeFunctions(NodeSetType &NodeSets) {
     for (SUnit::const_succ_iterator IS = SU->Succs.begin(),
                                     ES = SU->Succs.end();
          IS != ES; ++IS) {
-      if (ignoreDependence(*IS, true))
+      // The loop compare, kept out of the schedule, uses values through
+      // edges to the exit node.
+      if (ignoreDependence(*IS, true) || IS->getSUnit()->isBoundaryNode())
         continue;
       SUnit *succ = IS->getSUnit();
       alap = std::min(alap, (int)(getALAP(succ) - getLatency(SU, *IS) +
@@ -1667,7 +1892,7 @@ static bool succ_L(SetVector<SUnit *> &NodeOrder,
          SI != SE; ++SI) {
       if (S && S->count(SI->getSUnit()) == 0)
         continue;
-      if (ignoreDependence(*SI, false))
+      if (ignoreDependence(*SI, false) || SI->getSUnit()->isBoundaryNode())
         continue;
       if (NodeOrder.count(SI->getSUnit()) == 0)
         Succs.insert(SI->getSUnit());
@@ -1924,7 +2149,8 @@ void SwingSchedulerDAG::addConnectedNodes(SUnit *SU, NodeSet &NewSet,
   NodesAdded.insert(SU);
   for (auto &SI : SU->Succs) {
     SUnit *Successor = SI.getSUnit();
-    if (!SI.isArtificial() && NodesAdded.count(Successor) == 0)
+    if (!SI.isArtificial() && !Successor->isBoundaryNode() &&
+        NodesAdded.count(Successor) == 0)
       addConnectedNodes(Successor, NewSet, NodesAdded);
   }
   for (auto &PI : SU->Preds) {
@@ -2278,8 +2504,7 @@ void SwingSchedulerDAG::generatePipelinedLoop(SMSchedule &Schedule) {
 
   // Copy any terminator instructions to the new kernel, and update
   // names as needed.
-  for (MachineBasicBlock::iterator I = BB->getFirstTerminator(),
-                                   E = BB->instr_end();
+  for (MachineBasicBlock::iterator I = RegionEnd, E = BB->instr_end();
        I != E; ++I) {
     MachineInstr *NewMI = MF.CloneMachineInstr(&*I);
     updateInstruction(NewMI, false, MaxStageCount, 0, Schedule, VRMap);
@@ -2347,7 +2572,7 @@ void SwingSchedulerDAG::generateProlog(SMSchedule &Schedule, unsigned LastStage,
     // in original program order.
     for (int StageNum = i; StageNum >= 0; --StageNum) {
       for (MachineBasicBlock::iterator BBI = BB->instr_begin(),
-                                       BBE = BB->getFirstTerminator();
+                                       BBE = RegionEnd;
            BBI != BBE; ++BBI) {
         if (Schedule.isScheduledAtStage(getSUnit(&*BBI), (unsigned)StageNum)) {
           if (BBI->isPHI())
@@ -2763,7 +2988,7 @@ void SwingSchedulerDAG::generatePhis(
   }
 
   for (MachineBasicBlock::iterator BBI = BB->getFirstNonPHI(),
-                                   BBE = BB->instr_end();
+                                   BBE = RegionEnd;
        BBI != BBE; ++BBI) {
     for (unsigned i = 0, e = BBI->getNumOperands(); i != e; ++i) {
       MachineOperand &MO = BBI->getOperand(i);
@@ -3855,6 +4080,8 @@ bool SMSchedule::isLoopCarriedDefOfUse(SwingSchedulerDAG *SSD,
 // an instruction that uses a physical register is scheduled in a
 // different stage than the definition. The pipeliner does not handle
 // physical register values that may cross a basic block boundary.
+// The definition and the use must also stay together in the kernel, see
+// isPhysRegClobbered.
 bool SMSchedule::isValidSchedule(SwingSchedulerDAG *SSD) {
   for (int i = 0, e = SSD->SUnits.size(); i < e; ++i) {
     SUnit &SU = SSD->SUnits[i];
@@ -3864,13 +4091,46 @@ bool SMSchedule::isValidSchedule(SwingSchedulerDAG *SSD) {
     assert(StageDef != -1 && "Instruction should have been scheduled.");
     for (auto &SI : SU.Succs)
       if (SI.isAssignedRegDep())
-        if (ST.getRegisterInfo()->isPhysicalRegister(SI.getReg()))
+        if (ST.getRegisterInfo()->isPhysicalRegister(SI.getReg())) {
           if (stageScheduled(SI.getSUnit()) != StageDef)
             return false;
+          if (isPhysRegClobbered(SSD, &SU, SI.getSUnit(), SI.getReg()))
+            return false;
+        }
   }
   return true;
 }
 
+/// Return true if an instruction from another stage than \p Def redefines
+/// the physical register \p Reg between \p Def and its use \p Use in the
+/// kernel. The dependences only order the instructions of one iteration, so
+/// nothing keeps the flags set by an instruction of another iteration from
+/// landing between a compare and the conditional move that reads them.
+bool SMSchedule::isPhysRegClobbered(SwingSchedulerDAG *SSD, SUnit *Def,
+                                    SUnit *Use, unsigned Reg) {
+  const TargetRegisterInfo *TRI = ST.getRegisterInfo();
+  int StageDef = stageScheduled(Def);
+  unsigned DefCycle = cycleScheduled(Def);
+  unsigned UseCycle = cycleScheduled(Use);
+  for (SUnit &SU : SSD->SUnits) {
+    if (&SU == Def || &SU == Use || stageScheduled(&SU) == StageDef)
+      continue;
+    // The order of the instructions within a cycle is decided later, so an
+    // instruction in the cycle of the definition or of the use may end up
+    // between them too.
+    unsigned Cycle = cycleScheduled(&SU);
+    if (Cycle < DefCycle || Cycle > UseCycle)
+      continue;
+    if (SU.getInstr()->modifiesRegister(Reg, TRI)) {
+      DEBUG(dbgs() << "SU(" << SU.NodeNum << ") clobbers " << PrintReg(Reg, TRI)
+                   << " between SU(" << Def->NodeNum << ") and SU("
+                   << Use->NodeNum << ")\n");
+      return true;
+    }
+  }
+  return false;
+}
+
 /// After the schedule has been formed, call this function to combine
 /// the instructions from the different stages/cycles.  That is, this
 /// function creates a schedule that represents a single iteration.
@@ -84,6 +84,8 @@ using namespace llvm;
 STATISTIC(NumGlobalSplits, "Number of split global live ranges");
 STATISTIC(NumLocalSplits,  "Number of split local live ranges");
 STATISTIC(NumEvicted,      "Number of interferences evicted");
+STATISTIC(NumGrowRegionBailouts,
+          "Number of split regions abandoned for compile time");
 
 static cl::opt<SplitEditor::ComplementSpillMode> SplitSpillMode(
     "split-spill-mode", cl::Hidden,
@@ -129,6 +131,24 @@ CSRFirstTimeCost("regalloc-csr-first-time-cost",
               cl::desc("Cost for first time use of callee-saved register."),
               cl::init(0), cl::Hidden);
 
+static cl::opt<unsigned> GrowRegionComplexityBudget(
+    "grow-region-complexity-budget",
+    cl::desc("Number of edge bundle blocks growRegion may visit for a split "
+             "candidate before giving up on it"),
+    cl::init(10000), cl::Hidden);
+
+static cl::opt<unsigned> HugeSplitLiveBlocks(
+    "huge-split-live-blocks",
+    cl::desc("Number of blocks a live range must be live in before region "
+             "splitting limits the registers it tries"),
+    cl::init(1000), cl::Hidden);
+
+static cl::opt<unsigned> HugeSplitMaxCandidates(
+    "huge-split-max-candidates",
+    cl::desc("Maximum number of registers region splitting tries for a huge "
+             "live range"),
+    cl::init(4), cl::Hidden);
+
 static RegisterRegAlloc greedyRegAlloc("greedy", "greedy register allocator",
                                        createGreedyRegisterAllocator);
 
@@ -381,7 +401,7 @@ private:
   BlockFrequency calcSpillCost();
   bool addSplitConstraints(InterferenceCache::Cursor, BlockFrequency&);
   void addThroughConstraints(InterferenceCache::Cursor, ArrayRef<unsigned>);
-  void growRegion(GlobalSplitCandidate &Cand);
+  bool growRegion(GlobalSplitCandidate &Cand);
   BlockFrequency calcGlobalSplitCost(GlobalSplitCandidate&);
   bool calcCompactRegion(GlobalSplitCandidate&);
   void splitAroundRegion(LiveRangeEdit&, ArrayRef<unsigned>);
@@ -1099,11 +1119,15 @@ void RAGreedy::addThroughConstraints(InterferenceCache::Cursor Intf,
   SpillPlacer->addLinks(makeArrayRef(TBS, T));
 }
 
-void RAGreedy::growRegion(GlobalSplitCandidate &Cand) {
+/// growRegion - Grow the region of live bundles of Cand as far as the spill
+/// placement allows. Return false if that takes more than the complexity
+/// budget, in which case Cand should not be used.
+bool RAGreedy::growRegion(GlobalSplitCandidate &Cand) {
   // Keep track of through blocks that have not been added to SpillPlacer.
   BitVector Todo = SA->getThroughBlocks();
   SmallVectorImpl<unsigned> &ActiveBlocks = Cand.ActiveBlocks;
   unsigned AddedTo = 0;
+  unsigned Budget = GrowRegionComplexityBudget;
 #ifndef NDEBUG
   unsigned Visited = 0;
 #endif
@@ -1115,6 +1139,14 @@ void RAGreedy::growRegion(GlobalSplitCandidate &Cand) {
       unsigned Bundle = NewBundles[i];
       // Look at all blocks connected to Bundle in the full graph.
       ArrayRef<unsigned> Blocks = Bundles->getBlocks(Bundle);
+      // The number of iterations does not scale with the size of the live
+      // range, so bail out when the budget is used up.
+      if (Blocks.size() >= Budget) {
+        DEBUG(dbgs() << ", over budget");
+        ++NumGrowRegionBailouts;
+        return false;
+      }
+      Budget -= Blocks.size();
       for (ArrayRef<unsigned>::iterator I = Blocks.begin(), E = Blocks.end();
            I != E; ++I) {
         unsigned Block = *I;
@@ -1147,6 +1179,7 @@ void RAGreedy::growRegion(GlobalSplitCandidate &Cand) {
     SpillPlacer->iterate();
   }
   DEBUG(dbgs() << ", v=" << Visited);
+  return true;
 }
 
 /// calcCompactRegion - Compute the set of edge bundles that should be live
@@ -1177,7 +1210,10 @@ bool RAGreedy::calcCompactRegion(GlobalSplitCandidate &Cand) {
     return false;
   }
 
-  growRegion(Cand);
+  if (!growRegion(Cand)) {
+    DEBUG(dbgs() << ", none.\n");
+    return false;
+  }
   SpillPlacer->finish();
 
   if (!Cand.LiveBundles.any()) {
@@ -1443,10 +1479,21 @@ unsigned RAGreedy::calculateRegionSplitCost(LiveInterval &VirtReg,
                                             unsigned &NumCands,
                                             bool IgnoreCSR) {
   unsigned BestCand = NoCand;
+  // Evaluating a candidate costs time proportional to the size of the live
+  // range. For huge live ranges, only try the first few registers in the
+  // allocation order; if none of them works, the caller falls back to
+  // per-block splitting.
+  unsigned CandBudget = SA->getNumLiveBlocks() >= HugeSplitLiveBlocks
+                            ? HugeSplitMaxCandidates
+                            : ~0u;
   Order.rewind();
   while (unsigned PhysReg = Order.next()) {
     if (IgnoreCSR && isUnusedCalleeSavedReg(PhysReg))
       continue;
+    if (!CandBudget--) {
+      DEBUG(dbgs() << "Candidate limit reached for huge live range\n");
+      break;
+    }
 
     // Discard bad candidates before we run out of interference cache cursors.
     // This will only affect register classes with a lot of registers (>32).
@@ -1491,7 +1538,10 @@ unsigned RAGreedy::calculateRegionSplitCost(LiveInterval &VirtReg,
       });
       continue;
     }
-    growRegion(Cand);
+    if (!growRegion(Cand)) {
+      DEBUG(dbgs() << ", giving up.\n");
+      continue;
+    }
 
     SpillPlacer->finish();
 
@@ -106,6 +106,10 @@ bool RegUsageInfoPropagationPass::runOnMachineFunction(MachineFunction &MF) {
       DEBUG(dbgs() << MI << "\n");
 
       auto UpdateRegMask = [&](const Function *F) {
+        // The linker may pick another definition of a function that is not
+        // exact, and that one may clobber more registers.
+        if (!F || !F->isDefinitionExact())
+          return;
         const auto *RegMask = PRUI->getRegUsageInfo(F);
         if (!RegMask)
           return;
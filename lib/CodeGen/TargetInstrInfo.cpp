@@ -262,6 +262,148 @@ bool TargetInstrInfo::findCommutedOpIndices(MachineInstr &MI,
   return true;
 }
 
+/// Return the index of the operand of the induction variable update \p IndVar
+/// that reads the Phi of the induction variable in \p LoopBB, or -1.
+static int findIndVarPhiOperand(const MachineInstr &IndVar,
+                                const MachineBasicBlock *LoopBB,
+                                const MachineRegisterInfo &MRI) {
+  for (unsigned i = 0, e = IndVar.getNumOperands(); i != e; ++i) {
+    const MachineOperand &MO = IndVar.getOperand(i);
+    if (!MO.isReg() || !MO.isUse() ||
+        !TargetRegisterInfo::isVirtualRegister(MO.getReg()))
+      continue;
+    const MachineInstr *Phi = MRI.getVRegDef(MO.getReg());
+    if (Phi && Phi->isPHI() && Phi->getParent() == LoopBB)
+      return i;
+  }
+  return -1;
+}
+
+bool TargetInstrInfo::analyzeCompareLoop(MachineLoop &L,
+                                         MachineInstr *&IndVarInst,
+                                         MachineInstr *&CmpInst) const {
+  if (L.getNumBlocks() != 1)
+    return true;
+  MachineBasicBlock *LoopBB = L.getHeader();
+  MachineBasicBlock *TBB = nullptr, *FBB = nullptr;
+  SmallVector<MachineOperand, 4> Cond;
+  if (analyzeBranch(*LoopBB, TBB, FBB, Cond) || Cond.empty() ||
+      (TBB != LoopBB && FBB != LoopBB))
+    return true;
+
+  // The compare is the last instruction before the branch.
+  MachineBasicBlock::iterator I = LoopBB->getFirstTerminator();
+  if (I == LoopBB->begin())
+    return true;
+  MachineInstr &Cmp = *std::prev(I);
+  unsigned SrcReg, SrcReg2;
+  int Mask, Value;
+  if (!analyzeCompare(Cmp, SrcReg, SrcReg2, Mask, Value) ||
+      !TargetRegisterInfo::isVirtualRegister(SrcReg))
+    return true;
+
+  // The other side of the compare is an immediate or loop invariant.
+  const MachineRegisterInfo &MRI = LoopBB->getParent()->getRegInfo();
+  if (SrcReg2) {
+    if (!TargetRegisterInfo::isVirtualRegister(SrcReg2))
+      return true;
+    const MachineInstr *Def = MRI.getVRegDef(SrcReg2);
+    if (!Def || Def->getParent() == LoopBB)
+      return true;
+  }
+
+  // The compared value is the next value of the induction variable, which is
+  // the Phi's incoming value from the loop.
+  MachineInstr *IndVar = MRI.getVRegDef(SrcReg);
+  int Step;
+  if (!IndVar || IndVar->getParent() != LoopBB ||
+      !getIncrementValue(*IndVar, Step) || !IndVar->getOperand(0).isReg() ||
+      IndVar->getOperand(0).getReg() != SrcReg)
+    return true;
+  int PhiOp = findIndVarPhiOperand(*IndVar, LoopBB, MRI);
+  if (PhiOp < 0)
+    return true;
+  const MachineInstr *Phi = MRI.getVRegDef(IndVar->getOperand(PhiOp).getReg());
+  if (Phi->getNumOperands() != 5)
+    return true;
+  for (unsigned i = 1, e = Phi->getNumOperands(); i != e; i += 2) {
+    if (Phi->getOperand(i + 1).getMBB() != LoopBB)
+      continue;
+    // Instruction selection may leave a copy between the increment and the
+    // Phi when their register classes differ.
+    unsigned LoopReg = Phi->getOperand(i).getReg();
+    const MachineInstr *LoopDef = MRI.getVRegDef(LoopReg);
+    if (LoopDef && LoopDef->isCopy() && LoopDef->getParent() == LoopBB &&
+        !LoopDef->getOperand(1).getSubReg())
+      LoopReg = LoopDef->getOperand(1).getReg();
+    if (LoopReg != SrcReg)
+      return true;
+  }
+
+  IndVarInst = IndVar;
+  CmpInst = &Cmp;
+  return false;
+}
+
+unsigned TargetInstrInfo::reduceCompareLoopCount(
+    MachineBasicBlock &MBB, MachineInstr &IndVar, MachineInstr &Cmp,
+    SmallVectorImpl<MachineOperand> &Cond, unsigned NumIters) const {
+  MachineBasicBlock *LoopBB = Cmp.getParent();
+  MachineFunction &MF = *MBB.getParent();
+  MachineRegisterInfo &MRI = MF.getRegInfo();
+  unsigned IndVarReg = IndVar.getOperand(0).getReg();
+  int PhiOp = findIndVarPhiOperand(IndVar, LoopBB, MRI);
+  assert(PhiOp >= 0 && "Induction variable not updated from a Phi");
+
+  // Start from the value the induction variable has on entry, and repeat
+  // its update once for every iteration.
+  unsigned PhiReg = IndVar.getOperand(PhiOp).getReg();
+  const MachineInstr *Phi = MRI.getVRegDef(PhiReg);
+  unsigned Reg = 0;
+  for (unsigned i = 1, e = Phi->getNumOperands(); i != e; i += 2)
+    if (Phi->getOperand(i + 1).getMBB() != LoopBB)
+      Reg = Phi->getOperand(i).getReg();
+  if (!MRI.constrainRegClass(Reg, MRI.getRegClass(PhiReg))) {
+    unsigned Copy = MRI.createVirtualRegister(MRI.getRegClass(PhiReg));
+    BuildMI(&MBB, Cmp.getDebugLoc(), get(TargetOpcode::COPY), Copy)
+        .addReg(Reg);
+    Reg = Copy;
+  }
+  for (unsigned It = 0; It != NumIters; ++It) {
+    MachineInstr *NewMI = MF.CloneMachineInstr(&IndVar);
+    unsigned NewReg = MRI.createVirtualRegister(MRI.getRegClass(IndVarReg));
+    NewMI->getOperand(0).setReg(NewReg);
+    NewMI->getOperand(PhiOp).setReg(Reg);
+    NewMI->clearKillInfo();
+    MBB.push_back(NewMI);
+    Reg = NewReg;
+  }
+
+  // Compare it the way the loop does.
+  MachineInstr *NewCmp = MF.CloneMachineInstr(&Cmp);
+  for (MachineOperand &MO : NewCmp->operands()) {
+    if (!MO.isReg() || !TargetRegisterInfo::isVirtualRegister(MO.getReg()))
+      continue;
+    if (MO.isDef())
+      MO.setReg(MRI.createVirtualRegister(MRI.getRegClass(MO.getReg())));
+    else if (MO.getReg() == IndVarReg)
+      MO.setReg(Reg);
+  }
+  NewCmp->clearKillInfo();
+  MBB.push_back(NewCmp);
+
+  // The loop branches back to itself unless it exits.
+  MachineBasicBlock *TBB = nullptr, *FBB = nullptr;
+  SmallVector<MachineOperand, 4> LoopCond;
+  bool CantAnalyze = analyzeBranch(*LoopBB, TBB, FBB, LoopCond);
+  assert(!CantAnalyze && "Loop branch was analyzed before");
+  (void)CantAnalyze;
+  if (TBB == LoopBB)
+    reverseBranchCondition(LoopCond);
+  Cond.append(LoopCond.begin(), LoopCond.end());
+  return Reg;
+}
+
 bool TargetInstrInfo::isUnpredicatedTerminator(const MachineInstr &MI) const {
   if (!MI.isTerminator()) return false;
 
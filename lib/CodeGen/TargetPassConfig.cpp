@@ -140,6 +140,11 @@ cl::opt<bool> MISchedPostRA("misched-postra", cl::Hidden,
 static cl::opt<bool> EarlyLiveIntervals("early-live-intervals", cl::Hidden,
     cl::desc("Run live interval analysis earlier in the pipeline"));
 
+// Experimental option to give hot internal leaf functions preserve_most.
+static cl::opt<bool> EnableHotLeafCC("enable-hot-leaf-cc", cl::Hidden,
+    cl::desc("Use the preserve_most calling convention for hot internal leaf "
+             "functions when IPRA is disabled"));
+
 // Experimental option to use CFL-AA in codegen
 enum class CFLAAType { None, Steensgaard, Andersen, Both };
 static cl::opt<CFLAAType> UseCFLAA(
@@ -640,6 +645,11 @@ bool TargetPassConfig::addISelPasses() {
   if (TM->Options.EmulatedTLS)
     addPass(createLowerEmuTLSPass());
 
+  // IPRA already tells callers exactly what an internal callee clobbers.
+  if (EnableHotLeafCC && !TM->Options.EnableIPRA &&
+      getOptLevel() != CodeGenOpt::None)
+    addPass(createHotLeafCallingConvPass());
+
   addPass(createPreISelIntrinsicLoweringPass());
   addPass(createTargetTransformInfoWrapperPass(TM->getTargetIRAnalysis()));
   addIRPasses();
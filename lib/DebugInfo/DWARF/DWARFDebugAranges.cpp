@@ -8,10 +8,12 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/DebugInfo/DWARF/DWARFDebugAranges.h"
+#include "llvm/ADT/BitVector.h"
 #include "llvm/DebugInfo/DWARF/DWARFCompileUnit.h"
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
 #include "llvm/DebugInfo/DWARF/DWARFDebugArangeSet.h"
 #include "llvm/Support/DataExtractor.h"
+#include "llvm/Support/Parallel.h"
 #include <algorithm>
 #include <cassert>
 #include <cstdint>
@@ -49,14 +51,45 @@ void DWARFDebugAranges::generate(DWARFContext *CTX) {
   // Generate aranges from DIEs: even if .debug_aranges section is present,
   // it may describe only a small subset of compilation units, so we need to
   // manually build aranges for the rest of them.
-  for (const auto &CU : CTX->compile_units()) {
-    uint32_t CUOffset = CU->getOffset();
-    if (ParsedCUOffsets.insert(CUOffset).second) {
-      DWARFAddressRangesVector CURanges;
-      CU->collectAddressRanges(CURanges);
-      for (const auto &R : CURanges)
-        appendRange(CUOffset, R.LowPC, R.HighPC);
-    }
+  std::vector<DWARFCompileUnit *> Units;
+  for (const auto &CU : CTX->compile_units())
+    if (ParsedCUOffsets.insert(CU->getOffset()).second)
+      Units.push_back(CU.get());
+
+  // Walking the DIEs of a unit that has no DW_AT_ranges is the expensive
+  // part, so do it for all units at once.  Units only share data that was
+  // read while parsing the unit headers; the exception is a split unit,
+  // whose .dwo file is opened through the context, so those are left to the
+  // loop below.
+  std::vector<DWARFAddressRangesVector> UnitRanges(Units.size());
+  BitVector Collected(Units.size());
+  SmallVector<size_t, 16> ParallelUnits;
+  for (size_t I = 0, E = Units.size(); I != E; ++I) {
+    DWARFDie UnitDie = Units[I]->getUnitDIE();
+    if (!UnitDie || !UnitDie.getAddressRanges().empty())
+      continue;
+    if (UnitDie.find(dwarf::DW_AT_GNU_dwo_name) ||
+        UnitDie.find(dwarf::DW_AT_dwo_name))
+      continue;
+    ParallelUnits.push_back(I);
+  }
+  if (ParallelUnits.size() > 1) {
+    parallel::for_each_n(parallel::par, size_t(0), ParallelUnits.size(),
+                         [&](size_t I) {
+                           size_t U = ParallelUnits[I];
+                           Units[U]->collectAddressRanges(UnitRanges[U]);
+                         });
+    for (size_t U : ParallelUnits)
+      Collected.set(U);
+  }
+
+  // Append in unit order so that overlapping units resolve the same way
+  // however the work above was scheduled.
+  for (size_t I = 0, E = Units.size(); I != E; ++I) {
+    if (!Collected.test(I))
+      Units[I]->collectAddressRanges(UnitRanges[I]);
+    for (const auto &R : UnitRanges[I])
+      appendRange(Units[I]->getOffset(), R.LowPC, R.HighPC);
   }
 
   construct();
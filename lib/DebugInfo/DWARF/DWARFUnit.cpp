@@ -343,24 +343,30 @@ void DWARFUnit::collectAddressRanges(DWARFAddressRangesVector &CURanges) {
     clearDIEs(true);
 }
 
-void DWARFUnit::updateAddressDieMap(DWARFDie Die) {
-  if (Die.isSubroutineDIE()) {
-    for (const auto &R : Die.getAddressRanges()) {
-      // Ignore 0-sized ranges.
-      if (R.LowPC == R.HighPC)
-        continue;
-      auto B = AddrDieMap.upper_bound(R.LowPC);
-      if (B != AddrDieMap.begin() && R.LowPC < (--B)->second.first) {
-        // The range is a sub-range of existing ranges, we need to split the
-        // existing range.
-        if (R.HighPC < B->second.first)
-          AddrDieMap[R.HighPC] = B->second;
-        if (R.LowPC > B->first)
-          AddrDieMap[B->first].first = R.LowPC;
-      }
-      AddrDieMap[R.LowPC] = std::make_pair(R.HighPC, Die);
+void DWARFUnit::insertAddressRanges(DWARFDie Die) {
+  for (const auto &R : Die.getAddressRanges()) {
+    // Ignore 0-sized ranges.
+    if (R.LowPC == R.HighPC)
+      continue;
+    auto B = AddrDieMap.upper_bound(R.LowPC);
+    if (B != AddrDieMap.begin() && R.LowPC < (--B)->second.first) {
+      // The range is a sub-range of existing ranges, we need to split the
+      // existing range.
+      if (R.HighPC < B->second.first)
+        AddrDieMap[R.HighPC] = B->second;
+      if (R.LowPC > B->first)
+        AddrDieMap[B->first].first = R.LowPC;
     }
+    AddrDieMap[R.LowPC] = std::make_pair(R.HighPC, Die);
   }
+}
+
+void DWARFUnit::updateAddressDieMap(DWARFDie Die) {
+  // Subprograms, nested ones included, are already in the map.
+  if (Die.getTag() == DW_TAG_subprogram)
+    return;
+  if (Die.isSubroutineDIE())
+    insertAddressRanges(Die);
   // Parent DIEs are added to the AddrDieMap prior to the Children DIEs to
   // simplify the logic to update AddrDieMap. The child's range will always
   // be equal or smaller than the parent's range. With this assumption, when
@@ -370,18 +376,42 @@ void DWARFUnit::updateAddressDieMap(DWARFDie Die) {
     updateAddressDieMap(Child);
 }
 
+void DWARFUnit::addSubprograms(DWARFDie Die) {
+  for (DWARFDie Child = Die.getFirstChild(); Child; Child = Child.getSibling()) {
+    // A nested subprogram (a GCC nested function, a Fortran contained
+    // procedure) need not lie within the ranges of its parent, so it is
+    // indexed with the outermost ones rather than when its parent is
+    // expanded.
+    if (Child.getTag() == DW_TAG_subprogram) {
+      insertAddressRanges(Child);
+      UnexpandedSubroutines.insert(Child.getOffset());
+    }
+    addSubprograms(Child);
+  }
+}
+
 DWARFDie DWARFUnit::getSubroutineForAddress(uint64_t Address) {
   extractDIEsIfNeeded(false);
+  // Most users look up a few addresses in a unit, so only index the
+  // inlined subroutines of the subprograms they land in.  Optimized code has
+  // many more inlined subroutines and lexical blocks than functions.
   if (AddrDieMap.empty())
-    updateAddressDieMap(getUnitDIE());
-  auto R = AddrDieMap.upper_bound(Address);
-  if (R == AddrDieMap.begin())
-    return DWARFDie();
-  // upper_bound's previous item contains Address.
-  --R;
-  if (Address >= R->second.first)
-    return DWARFDie();
-  return R->second.second;
+    addSubprograms(getUnitDIE());
+  while (true) {
+    auto R = AddrDieMap.upper_bound(Address);
+    if (R == AddrDieMap.begin())
+      return DWARFDie();
+    // upper_bound's previous item contains Address.
+    --R;
+    if (Address >= R->second.first)
+      return DWARFDie();
+    DWARFDie Die = R->second.second;
+    if (!UnexpandedSubroutines.erase(Die.getOffset()))
+      return Die;
+    for (DWARFDie Child = Die.getFirstChild(); Child;
+         Child = Child.getSibling())
+      updateAddressDieMap(Child);
+  }
 }
 
 void
@@ -398,6 +428,9 @@ DWARFUnit::getInlinedChainForAddress(uint64_t Address,
   while (SubroutineDIE) {
     if (SubroutineDIE.isSubroutineDIE())
       InlinedChain.push_back(SubroutineDIE);
+    // The parent of a nested subprogram is not one of its callers.
+    if (SubroutineDIE.getTag() == DW_TAG_subprogram)
+      break;
     SubroutineDIE  = SubroutineDIE.getParent();
   }
 }
@@ -0,0 +1,212 @@
+//===- SymbolizationCache.cpp ---------------------------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Implementation of SymbolizationCache class.
+//
+//===----------------------------------------------------------------------===//
+
+#include "SymbolizationCache.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace llvm;
+using namespace symbolize;
+using namespace support;
+
+static const char CacheMagic[8] = {'L', 'L', 'V', 'M', 'S', 'Y', 'M', 'C'};
+static const uint32_t CacheVersion = 1;
+static const size_t HeaderSize = 24;
+static const size_t IndexEntrySize = 16;
+
+SymbolizationCache::SymbolizationCache(StringRef Path, uint64_t Fingerprint)
+    : Path(Path), Fingerprint(Fingerprint) {
+  auto BufOrErr = MemoryBuffer::getFile(Path, /*FileSize=*/-1,
+                                        /*RequiresNullTerminator=*/false);
+  if (!BufOrErr)
+    return;
+  StringRef Data = (*BufOrErr)->getBuffer();
+  if (Data.size() < HeaderSize ||
+      memcmp(Data.data(), CacheMagic, sizeof(CacheMagic)) != 0)
+    return;
+  const char *P = Data.data() + sizeof(CacheMagic);
+  uint32_t Version = endian::read32le(P);
+  uint64_t NumEntries = endian::read32le(P + 4);
+  if (Version != CacheVersion || endian::read64le(P + 8) != Fingerprint ||
+      HeaderSize + NumEntries * IndexEntrySize > Data.size())
+    return;
+  Buffer = std::move(*BufOrErr);
+}
+
+uint32_t SymbolizationCache::getNumEntries() const {
+  if (!Buffer)
+    return 0;
+  return endian::read32le(Buffer->getBufferStart() + sizeof(CacheMagic) + 4);
+}
+
+SymbolizationCache::Key SymbolizationCache::getKey(uint32_t Index) const {
+  const char *P =
+      Buffer->getBufferStart() + HeaderSize + Index * IndexEntrySize;
+  return Key(endian::read32le(P + 8), endian::read64le(P));
+}
+
+bool SymbolizationCache::readRecord(uint32_t Index,
+                                    DIInliningInfo &Result) const {
+  StringRef Data = Buffer->getBuffer();
+  size_t RecordsStart = HeaderSize + getNumEntries() * IndexEntrySize;
+  const char *Entry = Data.data() + HeaderSize + Index * IndexEntrySize;
+  uint64_t Offset = RecordsStart + endian::read32le(Entry + 12);
+
+  // The file may have been truncated or written by a broken tool, so check
+  // every read against the end of the buffer.
+  auto ReadU32 = [&](uint32_t &V) {
+    if (Offset + 4 > Data.size())
+      return false;
+    V = endian::read32le(Data.data() + Offset);
+    Offset += 4;
+    return true;
+  };
+  auto ReadString = [&](std::string &S) {
+    uint32_t Length;
+    if (!ReadU32(Length) || Offset + Length > Data.size())
+      return false;
+    S.assign(Data.data() + Offset, Length);
+    Offset += Length;
+    return true;
+  };
+
+  uint32_t NumFrames;
+  if (!ReadU32(NumFrames))
+    return false;
+  DIInliningInfo Info;
+  for (uint32_t I = 0; I != NumFrames; ++I) {
+    DILineInfo Frame;
+    if (!ReadU32(Frame.Line) || !ReadU32(Frame.Column) ||
+        !ReadU32(Frame.StartLine) || !ReadU32(Frame.Discriminator) ||
+        !ReadString(Frame.FileName) || !ReadString(Frame.FunctionName))
+      return false;
+    Info.addFrame(Frame);
+  }
+  Result = std::move(Info);
+  return true;
+}
+
+bool SymbolizationCache::lookup(EntryKind Kind, uint64_t Address,
+                                DIInliningInfo &Result) const {
+  Key K(Kind, Address);
+  auto I = Added.find(K);
+  if (I != Added.end()) {
+    Result = I->second;
+    return true;
+  }
+
+  // Binary search the index of the mapped file.
+  uint32_t Lo = 0, Hi = getNumEntries();
+  while (Lo < Hi) {
+    uint32_t Mid = Lo + (Hi - Lo) / 2;
+    if (getKey(Mid) < K)
+      Lo = Mid + 1;
+    else
+      Hi = Mid;
+  }
+  if (Lo == getNumEntries() || getKey(Lo) != K)
+    return false;
+  return readRecord(Lo, Result);
+}
+
+void SymbolizationCache::insert(EntryKind Kind, uint64_t Address,
+                                const DIInliningInfo &Info) {
+  Added[Key(Kind, Address)] = Info;
+}
+
+Error SymbolizationCache::write() {
+  if (Added.empty())
+    return Error::success();
+
+  // Merge the entries of the mapped file with the new ones.
+  std::map<Key, DIInliningInfo> Entries;
+  for (uint32_t I = 0, E = getNumEntries(); I != E; ++I) {
+    DIInliningInfo Info;
+    if (readRecord(I, Info))
+      Entries.emplace(getKey(I), std::move(Info));
+  }
+  for (auto &KV : Added)
+    Entries[KV.first] = std::move(KV.second);
+  Added.clear();
+
+  std::string Index, Records;
+  raw_string_ostream IndexOS(Index), RecordsOS(Records);
+  endian::Writer<little> IW(IndexOS), RW(RecordsOS);
+  auto WriteString = [&](StringRef S) {
+    RW.write<uint32_t>(S.size());
+    RecordsOS << S;
+  };
+  for (const auto &KV : Entries) {
+    // Record offsets are stored in 32 bits.
+    uint64_t RecordOffset = RecordsOS.tell();
+    if (RecordOffset > UINT32_MAX)
+      return make_error<StringError>("too many entries to cache in " + Path,
+                                     inconvertibleErrorCode());
+    IW.write<uint64_t>(KV.first.second);
+    IW.write<uint32_t>(KV.first.first);
+    IW.write<uint32_t>(RecordOffset);
+    const DIInliningInfo &Info = KV.second;
+    RW.write<uint32_t>(Info.getNumberOfFrames());
+    for (uint32_t I = 0, E = Info.getNumberOfFrames(); I != E; ++I) {
+      DILineInfo Frame = Info.getFrame(I);
+      RW.write<uint32_t>(Frame.Line);
+      RW.write<uint32_t>(Frame.Column);
+      RW.write<uint32_t>(Frame.StartLine);
+      RW.write<uint32_t>(Frame.Discriminator);
+      WriteString(Frame.FileName);
+      WriteString(Frame.FunctionName);
+    }
+  }
+  IndexOS.flush();
+  RecordsOS.flush();
+
+  // Write to a temporary file next to the cache and move it into place.
+  StringRef Dir = sys::path::parent_path(Path);
+  if (!Dir.empty())
+    if (std::error_code EC = sys::fs::create_directories(Dir))
+      return errorCodeToError(EC);
+  int FD;
+  SmallString<128> TempPath;
+  if (std::error_code EC =
+          sys::fs::createUniqueFile(Path + ".tmp-%%%%%%%%", FD, TempPath))
+    return errorCodeToError(EC);
+  {
+    raw_fd_ostream OS(FD, /*shouldClose=*/true);
+    endian::Writer<little> W(OS);
+    OS.write(CacheMagic, sizeof(CacheMagic));
+    W.write<uint32_t>(CacheVersion);
+    W.write<uint32_t>(Entries.size());
+    W.write<uint64_t>(Fingerprint);
+    OS << Index << Records;
+    OS.close();
+    if (OS.has_error()) {
+      OS.clear_error();
+      sys::fs::remove(TempPath);
+      return make_error<StringError>("cannot write " + TempPath,
+                                     inconvertibleErrorCode());
+    }
+  }
+  if (std::error_code EC = sys::fs::rename(TempPath, Path)) {
+    sys::fs::remove(TempPath);
+    return errorCodeToError(EC);
+  }
+
+  // Map the new file so later lookups see the merged entries.
+  *this = SymbolizationCache(Path, Fingerprint);
+  return Error::success();
+}
@@ -0,0 +1,82 @@
+//===- SymbolizationCache.h -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares the SymbolizationCache class, an on-disk store of the
+// results computed for one build of a binary.
+//
+// A cache file is mapped and searched in place, so looking up an address
+// does not have to read the rest of the file.  All integers are little
+// endian:
+//
+//   Header:  char Magic[8] = "LLVMSYMC", u32 Version, u32 NumEntries,
+//            u64 Fingerprint
+//   Index:   NumEntries x { u64 Address, u32 Kind, u32 RecordOffset },
+//            sorted by (Kind, Address)
+//   Records: u32 NumFrames, then per frame u32 Line, u32 Column,
+//            u32 StartLine, u32 Discriminator, and the file and function
+//            names, each as a u32 length followed by the bytes.
+//
+// RecordOffset is relative to the end of the index, so the records may take
+// up to 4 GiB; write() fails rather than go past that.  The fingerprint covers
+// everything besides the binary that affects the results; a file written with
+// another fingerprint is ignored and replaced.
+//
+//===----------------------------------------------------------------------===//
+#ifndef LLVM_LIB_DEBUGINFO_SYMBOLIZE_SYMBOLIZATIONCACHE_H
+#define LLVM_LIB_DEBUGINFO_SYMBOLIZE_SYMBOLIZATIONCACHE_H
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/DebugInfo/DIContext.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace llvm {
+namespace symbolize {
+
+class SymbolizationCache {
+public:
+  enum EntryKind : uint32_t { Code = 0, InlinedCode = 1 };
+
+  /// Open the cache file at \p Path.  The file does not need to exist.
+  SymbolizationCache(StringRef Path, uint64_t Fingerprint);
+
+  /// Look up the result of a query of kind \p Kind for \p Address.
+  bool lookup(EntryKind Kind, uint64_t Address, DIInliningInfo &Result) const;
+
+  /// Remember the result of a query, to be written out by write().
+  void insert(EntryKind Kind, uint64_t Address, const DIInliningInfo &Info);
+
+  /// Write the file back if anything was inserted.  The new file replaces
+  /// the old one atomically, so concurrent readers see one or the other.
+  Error write();
+
+private:
+  using Key = std::pair<uint32_t, uint64_t>;
+
+  uint32_t getNumEntries() const;
+  Key getKey(uint32_t Index) const;
+  bool readRecord(uint32_t Index, DIInliningInfo &Result) const;
+
+  std::string Path;
+  uint64_t Fingerprint;
+  /// The mapped file, or null if it was missing or unusable.
+  std::unique_ptr<MemoryBuffer> Buffer;
+  /// Results inserted since the file was mapped.
+  std::map<Key, DIInliningInfo> Added;
+};
+
+} // end namespace symbolize
+} // end namespace llvm
+
+#endif // LLVM_LIB_DEBUGINFO_SYMBOLIZE_SYMBOLIZATIONCACHE_H
@@ -14,8 +14,10 @@
 #include "llvm/DebugInfo/Symbolize/Symbolize.h"
 
 #include "SymbolizableObjectFile.h"
+#include "SymbolizationCache.h"
 
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/BinaryFormat/COFF.h"
 #include "llvm/Config/config.h"
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
@@ -30,6 +32,7 @@
 #include "llvm/Support/DataExtractor.h"
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include <algorithm>
@@ -53,8 +56,24 @@
 namespace llvm {
 namespace symbolize {
 
+LLVMSymbolizer::LLVMSymbolizer(const Options &Opts) : Opts(Opts) {}
+
+LLVMSymbolizer::~LLVMSymbolizer() {
+  flush();
+}
+
 Expected<DILineInfo> LLVMSymbolizer::symbolizeCode(const std::string &ModuleName,
                                                   uint64_t ModuleOffset) {
+  SymbolizationCache *Cache;
+  if (auto CacheOrErr = getOrCreateCache(ModuleName))
+    Cache = CacheOrErr.get();
+  else
+    return CacheOrErr.takeError();
+  DIInliningInfo Cached;
+  if (Cache && Cache->lookup(SymbolizationCache::Code, ModuleOffset, Cached))
+    return Cached.getFrame(0);
+  uint64_t CacheAddress = ModuleOffset;
+
   SymbolizableModule *Info;
   if (auto InfoOrErr = getOrCreateModuleInfo(ModuleName))
     Info = InfoOrErr.get();
@@ -75,12 +94,28 @@ Expected<DILineInfo> LLVMSymbolizer::symbolizeCode(const std::string &ModuleName
                                             Opts.UseSymbolTable);
   if (Opts.Demangle)
     LineInfo.FunctionName = DemangleName(LineInfo.FunctionName, Info);
+  if (Cache) {
+    DIInliningInfo Entry;
+    Entry.addFrame(LineInfo);
+    Cache->insert(SymbolizationCache::Code, CacheAddress, Entry);
+  }
   return LineInfo;
 }
 
 Expected<DIInliningInfo>
 LLVMSymbolizer::symbolizeInlinedCode(const std::string &ModuleName,
                                      uint64_t ModuleOffset) {
+  SymbolizationCache *Cache;
+  if (auto CacheOrErr = getOrCreateCache(ModuleName))
+    Cache = CacheOrErr.get();
+  else
+    return CacheOrErr.takeError();
+  DIInliningInfo Cached;
+  if (Cache &&
+      Cache->lookup(SymbolizationCache::InlinedCode, ModuleOffset, Cached))
+    return Cached;
+  uint64_t CacheAddress = ModuleOffset;
+
   SymbolizableModule *Info;
   if (auto InfoOrErr = getOrCreateModuleInfo(ModuleName))
     Info = InfoOrErr.get();
@@ -105,6 +140,9 @@ LLVMSymbolizer::symbolizeInlinedCode(const std::string &ModuleName,
       Frame->FunctionName = DemangleName(Frame->FunctionName, Info);
     }
   }
+  if (Cache)
+    Cache->insert(SymbolizationCache::InlinedCode, CacheAddress,
+                  InlinedContext);
   return InlinedContext;
 }
 
@@ -134,6 +172,12 @@ Expected<DIGlobal> LLVMSymbolizer::symbolizeData(const std::string &ModuleName,
 }
 
 void LLVMSymbolizer::flush() {
+  // The caches are only an optimization; failing to update one must not
+  // fail symbolization.
+  for (auto &KV : Caches)
+    if (KV.second)
+      consumeError(KV.second->write());
+  Caches.clear();
   ObjectForUBPathAndArch.clear();
   BinaryForPath.clear();
   ObjectPairForPathArch.clear();
@@ -230,6 +274,54 @@ bool getGNUDebuglinkContents(const ObjectFile *Obj, std::string &DebugName,
   return false;
 }
 
+// Split "/path/to/binary:arch" into the path and the architecture.
+void splitModuleName(const std::string &ModuleName,
+                     const std::string &DefaultArch, std::string &BinaryName,
+                     std::string &ArchName) {
+  BinaryName = ModuleName;
+  ArchName = DefaultArch;
+  size_t ColonPos = ModuleName.find_last_of(':');
+  // Verify that substring after colon form a valid arch name.
+  if (ColonPos != std::string::npos) {
+    std::string ArchStr = ModuleName.substr(ColonPos + 1);
+    if (Triple(ArchStr).getArch() != Triple::UnknownArch) {
+      BinaryName = ModuleName.substr(0, ColonPos);
+      ArchName = ArchStr;
+    }
+  }
+}
+
+// Return the GNU build ID of an ELF file or the UUID of a Mach-O file, or an
+// empty array if the object has neither.
+ArrayRef<uint8_t> getBuildID(const ObjectFile *Obj) {
+  if (auto *MachObj = dyn_cast<MachOObjectFile>(Obj))
+    return MachObj->getUuid();
+  if (!isa<ELFObjectFileBase>(Obj))
+    return ArrayRef<uint8_t>();
+  for (const SectionRef &Section : Obj->sections()) {
+    StringRef Name;
+    Section.getName(Name);
+    if (Name != ".note.gnu.build-id")
+      continue;
+    StringRef Data;
+    Section.getContents(Data);
+    // The note is namesz, descsz and type, then the padded name "GNU", then
+    // the ID itself.
+    DataExtractor DE(Data, Obj->isLittleEndian(), 0);
+    uint32_t Offset = 0;
+    uint32_t NameSize = DE.getU32(&Offset);
+    uint32_t DescSize = DE.getU32(&Offset);
+    uint32_t Type = DE.getU32(&Offset);
+    Offset += alignTo(NameSize, 4);
+    if (Type != ELF::NT_GNU_BUILD_ID || DescSize == 0 ||
+        !DE.isValidOffsetForDataOfSize(Offset, DescSize))
+      break;
+    return ArrayRef<uint8_t>(
+        reinterpret_cast<const uint8_t *>(Data.data()) + Offset, DescSize);
+  }
+  return ArrayRef<uint8_t>();
+}
+
 bool darwinDsymMatchesBinary(const MachOObjectFile *DbgObj,
                              const MachOObjectFile *Obj) {
   ArrayRef<uint8_t> dbg_uuid = DbgObj->getUuid();
@@ -369,17 +461,8 @@ LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName) {
   if (I != Modules.end()) {
     return I->second.get();
   }
-  std::string BinaryName = ModuleName;
-  std::string ArchName = Opts.DefaultArch;
-  size_t ColonPos = ModuleName.find_last_of(':');
-  // Verify that substring after colon form a valid arch name.
-  if (ColonPos != std::string::npos) {
-    std::string ArchStr = ModuleName.substr(ColonPos + 1);
-    if (Triple(ArchStr).getArch() != Triple::UnknownArch) {
-      BinaryName = ModuleName.substr(0, ColonPos);
-      ArchName = ArchStr;
-    }
-  }
+  std::string BinaryName, ArchName;
+  splitModuleName(ModuleName, Opts.DefaultArch, BinaryName, ArchName);
   auto ObjectsOrErr = getOrCreateObjectPair(BinaryName, ArchName);
   if (!ObjectsOrErr) {
     // Failed to find valid object file.
@@ -388,6 +471,12 @@ LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName) {
     return ObjectsOrErr.takeError();
   }
   ObjectPair Objects = ObjectsOrErr.get();
+  // Loading the object failed earlier, and that error was reported then.
+  if (!Objects.first) {
+    Modules.insert(
+        std::make_pair(ModuleName, std::unique_ptr<SymbolizableModule>()));
+    return nullptr;
+  }
 
   std::unique_ptr<DIContext> Context;
   // If this is a COFF object containing PDB info, use a PDBContext to
@@ -424,6 +513,49 @@ LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName) {
   return InsertResult.first->second.get();
 }
 
+Expected<SymbolizationCache *>
+LLVMSymbolizer::getOrCreateCache(const std::string &ModuleName) {
+  if (Opts.CachePath.empty())
+    return nullptr;
+  const auto &I = Caches.find(ModuleName);
+  if (I != Caches.end())
+    return I->second.get();
+  std::unique_ptr<SymbolizationCache> &Cache = Caches[ModuleName];
+
+  std::string BinaryName, ArchName;
+  splitModuleName(ModuleName, Opts.DefaultArch, BinaryName, ArchName);
+  auto ObjectsOrErr = getOrCreateObjectPair(BinaryName, ArchName);
+  if (!ObjectsOrErr) {
+    // The failed load is remembered, so record the module as failed too, the
+    // way getOrCreateModuleInfo() does, and report the error only here.
+    Modules.insert(
+        std::make_pair(ModuleName, std::unique_ptr<SymbolizableModule>()));
+    return ObjectsOrErr.takeError();
+  }
+  ObjectPair Objects = ObjectsOrErr.get();
+  if (!Objects.first)
+    return nullptr;
+  ArrayRef<uint8_t> BuildID = getBuildID(Objects.first);
+  if (BuildID.empty())
+    return nullptr;
+
+  // Results also depend on the options and on which file the debug info came
+  // from, which changes when a separate debug file is installed.
+  MD5 Hash;
+  Hash.update(ArrayRef<uint8_t>({uint8_t(Opts.PrintFunctions),
+                                 uint8_t(Opts.UseSymbolTable),
+                                 uint8_t(Opts.Demangle),
+                                 uint8_t(Opts.RelativeAddresses)}));
+  Hash.update(Objects.second->getFileName());
+  MD5::MD5Result Fingerprint;
+  Hash.final(Fingerprint);
+
+  SmallString<128> CacheFile(Opts.CachePath);
+  sys::path::append(CacheFile, toHex(BuildID) + ".symcache");
+  Cache.reset(new SymbolizationCache(CacheFile, Fingerprint.low()));
+  return Cache.get();
+}
+
 namespace {
 
 // Undo these various manglings for Win32 extern "C" functions:
@@ -0,0 +1,107 @@
+//===- CompileTimeBudget.cpp - Per-function time limits -------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the CompileTimeBudget class.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/IR/CompileTimeBudget.h"
+#include "LLVMContextImpl.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/IR/DiagnosticInfo.h"
+#include "llvm/IR/Function.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/Timer.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace llvm;
+
+static cl::opt<double> FunctionBudget(
+    "function-compile-time-budget", cl::init(0), cl::Hidden,
+    cl::desc("Seconds of compile time a function may use before expensive "
+             "passes switch to a cheaper mode (0 = unlimited)"));
+
+static cl::opt<double> PassLimit(
+    "pass-compile-time-limit", cl::init(0), cl::Hidden,
+    cl::desc("Seconds a single pass may spend on a function before switching "
+             "to a cheaper mode (0 = unlimited)"));
+
+static double getWallTime() {
+  return TimeRecord::getCurrentTime(/*Start=*/false).getWallTime();
+}
+
+static CompileTimeBudget::Record &getRecord(const Function &F) {
+  return F.getContext().pImpl->FunctionCompileTimes[&F];
+}
+
+CompileTimeBudget::PassRegion::PassRegion(Function &Fn) {
+  if (!isEnabled())
+    return;
+  Record &R = getRecord(Fn);
+  if (R.PassStart != 0.0)
+    return;
+  R.PassStart = getWallTime();
+  F = &Fn;
+}
+
+CompileTimeBudget::PassRegion::~PassRegion() {
+  if (!F)
+    return;
+  Record &R = getRecord(*F);
+  R.Spent += getWallTime() - R.PassStart;
+  R.PassStart = 0.0;
+}
+
+bool CompileTimeBudget::isEnabled() {
+  return FunctionBudget > 0 || PassLimit > 0;
+}
+
+bool CompileTimeBudget::isExceeded(const Function &F) {
+  if (!isEnabled())
+    return false;
+
+  auto &Times = F.getContext().pImpl->FunctionCompileTimes;
+  auto I = Times.find(&F);
+  if (I == Times.end())
+    return false;
+  const Record &R = I->second;
+
+  double InPass = R.PassStart != 0.0 ? getWallTime() - R.PassStart : 0.0;
+  if (PassLimit > 0 && InPass >= PassLimit)
+    return true;
+  return FunctionBudget > 0 && R.Spent + InPass >= FunctionBudget;
+}
+
+bool CompileTimeBudget::shouldDegrade(const Function &F,
+                                      const char *PassName) {
+  if (!isExceeded(F))
+    return false;
+
+  Record &R = getRecord(F);
+  if (is_contained(R.ReportedPasses, PassName))
+    return true;
+  R.ReportedPasses.push_back(PassName);
+
+  double InPass = R.PassStart != 0.0 ? getWallTime() - R.PassStart : 0.0;
+  std::string Spent;
+  raw_string_ostream(Spent) << format("%.3f", R.Spent + InPass);
+
+  OptimizationRemarkAnalysis Remark(PassName, "CompileTimeBudgetExceeded",
+                                    DiagnosticLocation(F.getSubprogram()),
+                                    &F.getEntryBlock());
+  Remark << "compile-time budget exceeded after " << Spent
+         << "s; running in a degraded mode";
+  F.getContext().diagnose(Remark);
+  return true;
+}
+
+void CompileTimeBudget::forget(const Function &F) {
+  F.getContext().pImpl->FunctionCompileTimes.erase(&F);
+}
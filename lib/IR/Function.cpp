@@ -27,9 +27,11 @@
 #include "llvm/IR/Attributes.h"
 #include "llvm/IR/BasicBlock.h"
 #include "llvm/IR/CallSite.h"
+#include "llvm/IR/CompileTimeBudget.h"
 #include "llvm/IR/Constant.h"
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/DerivedTypes.h"
+#include "llvm/IR/FunctionArena.h"
 #include "llvm/IR/GlobalValue.h"
 #include "llvm/IR/InstIterator.h"
 #include "llvm/IR/Instruction.h"
@@ -47,6 +49,7 @@
 #include "llvm/IR/Value.h"
 #include "llvm/IR/ValueSymbolTable.h"
 #include "llvm/Support/Casting.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/ErrorHandling.h"
 #include <algorithm>
@@ -58,6 +61,11 @@
 
 using namespace llvm;
 
+static cl::opt<bool> UseFunctionArenas(
+    "function-arenas", cl::init(false), cl::Hidden,
+    cl::desc("Allocate instructions created by function cloning and "
+             "inlining from a per-function arena"));
+
 // Explicit instantiations of SymbolTableListTraits since some of the methods
 // are not in the public header file...
 template class llvm::SymbolTableListTraits<BasicBlock>;
@@ -244,6 +252,20 @@ Function::~Function() {
 
   // Remove the function from the on-the-side GC table.
   clearGC();
+
+  if (CompileTimeBudget::isEnabled())
+    CompileTimeBudget::forget(*this);
+
+  // Instructions moved to other functions may still live in the arena; it
+  // goes away with the last of them.
+  if (Arena)
+    Arena->releaseOwner();
+}
+
+FunctionArena *Function::getOrCreateArena() {
+  if (!Arena && UseFunctionArenas)
+    Arena = new FunctionArena();
+  return Arena;
 }
 
 void Function::BuildLazyArguments() const {
@@ -0,0 +1,43 @@
+//===- FunctionArena.cpp - Bump allocation for IR objects -----------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the FunctionArena class.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/IR/FunctionArena.h"
+#include <cassert>
+
+using namespace llvm;
+
+LLVM_THREAD_LOCAL FunctionArena *FunctionArena::Current = nullptr;
+
+// Each allocation is preceded by a pointer to its arena, so that it can be
+// freed without knowing which function it was allocated for.
+void *FunctionArena::allocate(size_t Size) {
+  void **Mem = static_cast<void **>(
+      Allocator.Allocate(sizeof(void *) + Size, alignof(void *)));
+  *Mem = this;
+  ++NumLive;
+  return Mem + 1;
+}
+
+void FunctionArena::deallocate(void *Ptr) {
+  auto *Arena = static_cast<FunctionArena *>(static_cast<void **>(Ptr)[-1]);
+  assert(Arena->NumLive && "Freeing more objects than were allocated");
+  if (--Arena->NumLive == 0 && !Arena->OwnerAlive)
+    delete Arena;
+}
+
+void FunctionArena::releaseOwner() {
+  assert(OwnerAlive && "Arena released twice");
+  OwnerAlive = false;
+  if (NumLive == 0)
+    delete this;
+}
@@ -12,6 +12,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/IR/Instruction.h"
+#include "llvm/IR/FunctionArena.h"
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/IR/CallSite.h"
 #include "llvm/IR/Constants.h"
@@ -49,6 +50,18 @@ Instruction::~Instruction() {
     clearMetadataHashEntries();
 }
 
+void *Instruction::operator new(size_t Size) {
+  return allocateHungOffOperandUser(Size, FunctionArena::getCurrent());
+}
+
+void *Instruction::operator new(size_t Size, unsigned Us) {
+  return allocateFixedOperandUser(Size, Us, 0, FunctionArena::getCurrent());
+}
+
+void *Instruction::operator new(size_t Size, unsigned Us, unsigned DescBytes) {
+  return allocateFixedOperandUser(Size, Us, DescBytes,
+                                  FunctionArena::getCurrent());
+}
 
 void Instruction::setParent(BasicBlock *P) {
   Parent = P;
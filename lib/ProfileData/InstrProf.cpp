@@ -111,6 +111,8 @@ static std::string getInstrProfErrString(instrprof_error Err) {
     return "Failed to uncompress data (zlib)";
   case instrprof_error::empty_raw_profile:
     return "Empty raw profile file";
+  case instrprof_error::overlay_base_mismatch:
+    return "Overlay profile does not match its base profile";
   }
   llvm_unreachable("A value of instrprof_error has no message.");
 }
@@ -15,6 +15,7 @@
 #include "llvm/ProfileData/InstrProfReader.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/IR/ProfileSummary.h"
 #include "llvm/ProfileData/InstrProf.h"
@@ -22,7 +23,9 @@
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorOr.h"
+#include "llvm/Support/MD5.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/SwapByteOrder.h"
 #include <algorithm>
 #include <cctype>
@@ -596,7 +599,40 @@ bool IndexedInstrProfReader::hasFormat(const MemoryBuffer &DataBuffer) {
   uint64_t Magic =
       endian::read<uint64_t, little, aligned>(DataBuffer.getBufferStart());
   // Verify that it's magical.
-  return Magic == IndexedInstrProf::Magic;
+  return Magic == IndexedInstrProf::Magic ||
+         Magic == IndexedInstrProf::OverlayMagic;
+}
+
+Error IndexedInstrProfReader::readOverlayHeader(const unsigned char *&Cur) {
+  using namespace support;
+
+  const unsigned char *End =
+      (const unsigned char *)DataBuffer->getBufferEnd();
+  if (End - Cur < (ptrdiff_t)sizeof(IndexedInstrProf::OverlayHeader))
+    return error(instrprof_error::truncated);
+  auto *Header = reinterpret_cast<const IndexedInstrProf::OverlayHeader *>(Cur);
+  uint64_t BaseIdentity =
+      endian::byte_swap<uint64_t, little>(Header->BaseIdentity);
+  uint64_t PathSize = endian::byte_swap<uint64_t, little>(Header->BasePathSize);
+  Cur += sizeof(IndexedInstrProf::OverlayHeader);
+  if ((uint64_t)(End - Cur) < alignTo(PathSize, sizeof(uint64_t)))
+    return error(instrprof_error::truncated);
+  SmallString<128> BasePath(StringRef((const char *)Cur, PathSize));
+  Cur += alignTo(PathSize, sizeof(uint64_t));
+
+  if (sys::path::is_relative(BasePath)) {
+    SmallString<128> Resolved(
+        sys::path::parent_path(DataBuffer->getBufferIdentifier()));
+    sys::path::append(Resolved, BasePath);
+    BasePath = Resolved;
+  }
+  auto BaseOrErr = IndexedInstrProfReader::create(BasePath);
+  if (Error E = BaseOrErr.takeError())
+    return E;
+  Base = std::move(BaseOrErr.get());
+  if (Base->getIdentity() != BaseIdentity)
+    return error(instrprof_error::overlay_base_mismatch);
+  return success();
 }
 
 const unsigned char *
@@ -659,6 +695,14 @@ Error IndexedInstrProfReader::readHeader() {
   if ((const unsigned char *)DataBuffer->getBufferEnd() - Cur < 24)
     return error(instrprof_error::truncated);
 
+  if (endian::read<uint64_t, little, aligned>(Cur) ==
+      IndexedInstrProf::OverlayMagic) {
+    if (Error E = readOverlayHeader(Cur))
+      return E;
+    if ((const unsigned char *)DataBuffer->getBufferEnd() - Cur < 24)
+      return error(instrprof_error::truncated);
+  }
+
   auto *Header = reinterpret_cast<const IndexedInstrProf::Header *>(Cur);
   Cur += sizeof(IndexedInstrProf::Header);
 
@@ -683,20 +727,42 @@ Error IndexedInstrProfReader::readHeader() {
 
   uint64_t HashOffset = endian::byte_swap<uint64_t, little>(Header->HashOffset);
 
+  // Everything up to here is small, and the summary changes with the counts.
+  MD5 IdentityHash;
+  IdentityHash.update(makeArrayRef(Start, Cur));
+  uint64_t Size = endian::byte_swap<uint64_t, little>(
+      DataBuffer->getBufferSize());
+  IdentityHash.update(
+      makeArrayRef(reinterpret_cast<const uint8_t *>(&Size), sizeof(Size)));
+  MD5::MD5Result IdentityResult;
+  IdentityHash.final(IdentityResult);
+  Identity = IdentityResult.low();
+
   // The rest of the file is an on disk hash table.
   InstrProfReaderIndexBase *IndexPtr = nullptr;
   IndexPtr = new InstrProfReaderIndex<OnDiskHashTableImplV3>(
       Start + HashOffset, Cur, Start, HashType, FormatVersion);
   Index.reset(IndexPtr);
+
+  if (Base && Base->isIRLevelProfile() != isIRLevelProfile())
+    return error(instrprof_error::overlay_base_mismatch);
   return success();
 }
 
+Error IndexedInstrProfReader::populateSymtab(InstrProfSymtab &Symtab) {
+  if (Error E = Index->populateSymtab(Symtab))
+    return E;
+  if (Base)
+    return Base->populateSymtab(Symtab);
+  return Error::success();
+}
+
 InstrProfSymtab &IndexedInstrProfReader::getSymtab() {
   if (Symtab.get())
     return *Symtab.get();
 
   std::unique_ptr<InstrProfSymtab> NewSymtab = make_unique<InstrProfSymtab>();
-  if (Error E = Index->populateSymtab(*NewSymtab.get())) {
+  if (Error E = populateSymtab(*NewSymtab.get())) {
     consumeError(error(InstrProfError::take(std::move(E))));
   }
 
@@ -705,8 +771,7 @@ InstrProfSymtab &IndexedInstrProfReader::getSymtab() {
 }
 
 Expected<InstrProfRecord>
-IndexedInstrProfReader::getInstrProfRecord(StringRef FuncName,
-                                           uint64_t FuncHash) {
+IndexedInstrProfReader::getOwnRecord(StringRef FuncName, uint64_t FuncHash) {
   ArrayRef<NamedInstrProfRecord> Data;
   Error Err = Index->getRecords(FuncName, Data);
   if (Err)
@@ -721,6 +786,32 @@ IndexedInstrProfReader::getInstrProfRecord(StringRef FuncName,
   return error(instrprof_error::hash_mismatch);
 }
 
+Expected<InstrProfRecord>
+IndexedInstrProfReader::getInstrProfRecord(StringRef FuncName,
+                                           uint64_t FuncHash) {
+  Expected<InstrProfRecord> Own = getOwnRecord(FuncName, FuncHash);
+  if (!Base)
+    return Own;
+
+  Expected<InstrProfRecord> FromBase =
+      Base->getInstrProfRecord(FuncName, FuncHash);
+  if (!FromBase) {
+    if (Own) {
+      consumeError(FromBase.takeError());
+      return Own;
+    }
+    consumeError(Own.takeError());
+    return FromBase;
+  }
+  if (!Own) {
+    consumeError(Own.takeError());
+    return FromBase;
+  }
+  // The overlay writer checked that the records are compatible.
+  FromBase->merge(*Own, 1, [](instrprof_error) {});
+  return FromBase;
+}
+
 Error IndexedInstrProfReader::getFunctionCounts(StringRef FuncName,
                                                 uint64_t FuncHash,
                                                 std::vector<uint64_t> &Counts) {
@@ -733,18 +824,43 @@ Error IndexedInstrProfReader::getFunctionCounts(StringRef FuncName,
 }
 
 Error IndexedInstrProfReader::readNextRecord(NamedInstrProfRecord &Record) {
-  static unsigned RecordIndex = 0;
+  // An overlay first returns the records of its base with its own counts
+  // added, then its records that are not in the base.
+  if (Base && !BaseDone) {
+    if (Error E = Base->readNextRecord(Record)) {
+      instrprof_error IPE = InstrProfError::take(std::move(E));
+      if (IPE != instrprof_error::eof)
+        return error(IPE);
+      BaseDone = true;
+    } else {
+      Expected<InstrProfRecord> Own = getOwnRecord(Record.Name, Record.Hash);
+      if (Own)
+        Record.merge(*Own, 1, [](instrprof_error) {});
+      else
+        consumeError(Own.takeError());
+      return success();
+    }
+  }
 
-  ArrayRef<NamedInstrProfRecord> Data;
+  while (true) {
+    ArrayRef<NamedInstrProfRecord> Data;
 
-  Error E = Index->getRecords(Data);
-  if (E)
-    return error(std::move(E));
+    Error E = Index->getRecords(Data);
+    if (E)
+      return error(std::move(E));
 
-  Record = Data[RecordIndex++];
-  if (RecordIndex >= Data.size()) {
-    Index->advanceToNextKey();
-    RecordIndex = 0;
+    Record = Data[RecordIndex++];
+    if (RecordIndex >= Data.size()) {
+      Index->advanceToNextKey();
+      RecordIndex = 0;
+    }
+    if (!Base)
+      return success();
+    Expected<InstrProfRecord> FromBase =
+        Base->getInstrProfRecord(Record.Name, Record.Hash);
+    if (!FromBase) {
+      consumeError(FromBase.takeError());
+      return success();
+    }
   }
-  return success();
 }
@@ -17,6 +17,7 @@
 #include "llvm/ADT/StringRef.h"
 #include "llvm/IR/ProfileSummary.h"
 #include "llvm/ProfileData/InstrProf.h"
+#include "llvm/ProfileData/InstrProfReader.h"
 #include "llvm/ProfileData/ProfileCommon.h"
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/EndianStream.h"
@@ -216,6 +217,9 @@ void InstrProfWriter::mergeRecordsFromWriter(InstrProfWriter &&IPW,
   for (auto &I : IPW.FunctionData)
     for (auto &Func : I.getValue())
       addRecord(I.getKey(), Func.first, std::move(Func.second), 1, Warn);
+  // Release the source's memory now rather than when it is destroyed, which
+  // matters when many writers are merged together.
+  IPW.FunctionData.clear();
 }
 
 bool InstrProfWriter::shouldEncodeData(const ProfilingData &PD) {
@@ -246,7 +250,8 @@ static void setSummary(IndexedInstrProf::Summary *TheSummary,
     TheSummary->setEntry(I, Res[I]);
 }
 
-void InstrProfWriter::writeImpl(ProfOStream &OS) {
+void InstrProfWriter::writeImpl(ProfOStream &OS,
+                                ProfileSummary *CombinedSummary) {
   using namespace IndexedInstrProf;
 
   OnDiskChainedHashTableGenerator<InstrProfRecordWriterTrait> Generator;
@@ -297,7 +302,7 @@ void InstrProfWriter::writeImpl(ProfOStream &OS) {
   // Compute the Summary and copy the data to the data
   // structure to be serialized out (to disk or buffer).
   std::unique_ptr<ProfileSummary> PS = ISB.getSummary();
-  setSummary(TheSummary.get(), *PS);
+  setSummary(TheSummary.get(), CombinedSummary ? *CombinedSummary : *PS);
   InfoObj->SummaryBuilder = nullptr;
 
   // Now do the final patch:
@@ -316,6 +321,59 @@ void InstrProfWriter::write(raw_fd_ostream &OS) {
   writeImpl(POS);
 }
 
+Error InstrProfWriter::writeOverlay(raw_fd_ostream &OS,
+                                    IndexedInstrProfReader &Base,
+                                    StringRef BasePath) {
+  if (Error E = setIsIRLevelProfile(Base.isIRLevelProfile()))
+    return E;
+
+  // The summary describes the combined profile, so walk the base once with
+  // the new counts merged in.
+  InstrProfSummaryBuilder ISB(ProfileSummaryBuilder::DefaultCutoffs);
+  for (auto &Record : Base) {
+    auto Func = FunctionData.find(Record.Name);
+    if (Func != FunctionData.end()) {
+      auto New = Func->getValue().find(Record.Hash);
+      if (New != Func->getValue().end()) {
+        InstrProfRecord Copy = New->second;
+        auto Mismatch = instrprof_error::success;
+        Record.merge(Copy, 1, [&](instrprof_error E) {
+          if (E != instrprof_error::counter_overflow)
+            Mismatch = E;
+        });
+        if (Mismatch != instrprof_error::success)
+          return make_error<InstrProfError>(Mismatch);
+      }
+    }
+    ISB.addRecord(Record);
+  }
+  if (Base.hasError())
+    return Base.getError();
+  for (const auto &Func : FunctionData) {
+    if (!shouldEncodeData(Func.getValue()))
+      continue;
+    for (const auto &New : Func.getValue()) {
+      Expected<InstrProfRecord> InBase =
+          Base.getInstrProfRecord(Func.getKey(), New.first);
+      if (InBase)
+        continue;
+      consumeError(InBase.takeError());
+      ISB.addRecord(New.second);
+    }
+  }
+  std::unique_ptr<ProfileSummary> CombinedSummary = ISB.getSummary();
+
+  ProfOStream POS(OS);
+  POS.write(IndexedInstrProf::OverlayMagic);
+  POS.write(Base.getIdentity());
+  POS.write(BasePath.size());
+  OS << BasePath;
+  for (uint64_t I = BasePath.size(); I % sizeof(uint64_t); ++I)
+    OS << '\0';
+  writeImpl(POS, CombinedSummary.get());
+  return Error::success();
+}
+
 std::unique_ptr<MemoryBuffer> InstrProfWriter::writeBuffer() {
   std::string Data;
   raw_string_ostream OS(Data);
@@ -322,6 +322,60 @@ bool AArch64InstrInfo::reverseBranchCondition(
   return false;
 }
 
+// Loops are pipelined when they are controlled by a compare of the induction
+// variable, which the prolog blocks repeat for their own iteration.
+bool AArch64InstrInfo::analyzeLoop(MachineLoop &L, MachineInstr *&IndVarInst,
+                                   MachineInstr *&CmpInst) const {
+  return analyzeCompareLoop(L, IndVarInst, CmpInst);
+}
+
+unsigned AArch64InstrInfo::reduceLoopCount(
+    MachineBasicBlock &MBB, MachineInstr *IndVar, MachineInstr &Cmp,
+    SmallVectorImpl<MachineOperand> &Cond,
+    SmallVectorImpl<MachineInstr *> &PrevInsts, unsigned Iter,
+    unsigned MaxIter) const {
+  return reduceCompareLoopCount(MBB, *IndVar, Cmp, Cond, Iter + 1);
+}
+
+bool AArch64InstrInfo::getBaseAndOffsetPosition(const MachineInstr &MI,
+                                                unsigned &BasePos,
+                                                unsigned &OffsetPos) const {
+  if (!MI.mayLoadOrStore())
+    return false;
+  unsigned Scale, Width;
+  int64_t MinOffset, MaxOffset;
+  if (!getMemOpInfo(MI.getOpcode(), Scale, Width, MinOffset, MaxOffset))
+    return false;
+  // The base register and the immediate offset follow one or two data
+  // registers.
+  unsigned NumOps = MI.getNumExplicitOperands();
+  if (NumOps != 3 && NumOps != 4)
+    return false;
+  BasePos = NumOps - 2;
+  OffsetPos = NumOps - 1;
+  return MI.getOperand(BasePos).isReg() && MI.getOperand(OffsetPos).isImm();
+}
+
+bool AArch64InstrInfo::getIncrementValue(const MachineInstr &MI,
+                                         int &Value) const {
+  switch (MI.getOpcode()) {
+  default:
+    return false;
+  case AArch64::ADDWri:
+  case AArch64::ADDXri:
+  case AArch64::SUBWri:
+  case AArch64::SUBXri:
+    break;
+  }
+  if (!MI.getOperand(1).isReg() || !MI.getOperand(2).isImm())
+    return false;
+  Value = MI.getOperand(2).getImm()
+          << AArch64_AM::getShiftValue(MI.getOperand(3).getImm());
+  if (MI.getOpcode() == AArch64::SUBWri || MI.getOpcode() == AArch64::SUBXri)
+    Value = -Value;
+  return true;
+}
+
 unsigned AArch64InstrInfo::removeBranch(MachineBasicBlock &MBB,
                                         int *BytesRemoved) const {
   MachineBasicBlock::iterator I = MBB.getLastNonDebugInstr();
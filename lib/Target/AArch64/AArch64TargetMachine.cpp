@@ -134,6 +134,11 @@ static cl::opt<bool>
                            cl::desc("Enable the loop data prefetch pass"),
                            cl::init(true));
 
+static cl::opt<bool>
+    EnablePipeliner("aarch64-enable-pipeliner", cl::Hidden,
+                    cl::desc("Enable software pipelining of inner loops"),
+                    cl::init(false));
+
 static cl::opt<int> EnableGlobalISelAtO(
     "aarch64-enable-global-isel-at-O", cl::Hidden,
     cl::desc("Enable GlobalISel at or below an opt level (-1 to disable)"),
@@ -472,6 +477,9 @@ void AArch64PassConfig::addPreRegAlloc() {
     // be register coaleascer friendly.
     addPass(&PeepholeOptimizerID);
   }
+
+  if (TM->getOptLevel() >= CodeGenOpt::Default && EnablePipeliner)
+    addPass(&MachinePipelinerID);
 }
 
 void AArch64PassConfig::addPostRegAlloc() {
@@ -9246,6 +9246,86 @@ reverseBranchCondition(SmallVectorImpl<MachineOperand> &Cond) const {
   return false;
 }
 
+// Loops are pipelined when they are controlled by a compare of the induction
+// variable, which the prolog blocks repeat for their own iteration.
+bool X86InstrInfo::analyzeLoop(MachineLoop &L, MachineInstr *&IndVarInst,
+                               MachineInstr *&CmpInst) const {
+  return analyzeCompareLoop(L, IndVarInst, CmpInst);
+}
+
+unsigned X86InstrInfo::reduceLoopCount(
+    MachineBasicBlock &MBB, MachineInstr *IndVar, MachineInstr &Cmp,
+    SmallVectorImpl<MachineOperand> &Cond,
+    SmallVectorImpl<MachineInstr *> &PrevInsts, unsigned Iter,
+    unsigned MaxIter) const {
+  return reduceCompareLoopCount(MBB, *IndVar, Cmp, Cond, Iter + 1);
+}
+
+bool X86InstrInfo::getBaseAndOffsetPosition(const MachineInstr &MI,
+                                            unsigned &BasePos,
+                                            unsigned &OffsetPos) const {
+  if (!MI.mayLoadOrStore())
+    return false;
+  const MCInstrDesc &Desc = MI.getDesc();
+  int MemRefBegin = X86II::getMemoryOperandNo(Desc.TSFlags);
+  if (MemRefBegin < 0)
+    return false;
+  MemRefBegin += X86II::getOperandBias(Desc);
+  if (MI.getNumOperands() < unsigned(MemRefBegin) + X86::AddrNumOperands)
+    return false;
+
+  // Only a base register plus an immediate displacement is understood.
+  const MachineOperand &Base = MI.getOperand(MemRefBegin + X86::AddrBaseReg);
+  const MachineOperand &Scale = MI.getOperand(MemRefBegin + X86::AddrScaleAmt);
+  const MachineOperand &Index = MI.getOperand(MemRefBegin + X86::AddrIndexReg);
+  const MachineOperand &Disp = MI.getOperand(MemRefBegin + X86::AddrDisp);
+  if (!Base.isReg() || !Scale.isImm() || Scale.getImm() != 1 ||
+      !Index.isReg() || Index.getReg() != X86::NoRegister || !Disp.isImm())
+    return false;
+  BasePos = MemRefBegin + X86::AddrBaseReg;
+  OffsetPos = MemRefBegin + X86::AddrDisp;
+  return true;
+}
+
+bool X86InstrInfo::getIncrementValue(const MachineInstr &MI,
+                                     int &Value) const {
+  switch (MI.getOpcode()) {
+  default:
+    return false;
+  case X86::INC32r:
+  case X86::INC64r:
+    Value = 1;
+    return true;
+  case X86::DEC32r:
+  case X86::DEC64r:
+    Value = -1;
+    return true;
+  case X86::ADD32ri:
+  case X86::ADD32ri8:
+  case X86::ADD64ri8:
+  case X86::ADD64ri32:
+  case X86::SUB32ri:
+  case X86::SUB32ri8:
+  case X86::SUB64ri8:
+  case X86::SUB64ri32:
+    break;
+  }
+  if (!MI.getOperand(2).isImm())
+    return false;
+  Value = MI.getOperand(2).getImm();
+  switch (MI.getOpcode()) {
+  case X86::SUB32ri:
+  case X86::SUB32ri8:
+  case X86::SUB64ri8:
+  case X86::SUB64ri32:
+    Value = -Value;
+    break;
+  default:
+    break;
+  }
+  return true;
+}
+
 bool X86InstrInfo::
 isSafeToMoveRegClassDefs(const TargetRegisterClass *RC) const {
   // FIXME: Return false for x87 stack register classes for now. We can't
@@ -45,6 +45,7 @@
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Target/TargetLoweringObjectFile.h"
 #include "llvm/Target/TargetOptions.h"
+#include "llvm/Transforms/Scalar.h"
 #include <memory>
 #include <string>
 
@@ -54,6 +55,16 @@ static cl::opt<bool> EnableMachineCombinerPass("x86-machine-combiner",
                                cl::desc("Enable the machine combiner pass"),
                                cl::init(true), cl::Hidden);
 
+static cl::opt<bool>
+    EnableLoopDataPrefetch("x86-enable-loop-data-prefetch", cl::Hidden,
+                           cl::desc("Enable the loop data prefetch pass"),
+                           cl::init(false));
+
+static cl::opt<bool>
+    EnablePipeliner("x86-enable-pipeliner", cl::Hidden,
+                    cl::desc("Enable software pipelining of inner loops"),
+                    cl::init(false));
+
 namespace llvm {
 
 void initializeWinEHStatePassPass(PassRegistry &);
@@ -330,6 +341,11 @@ TargetPassConfig *X86TargetMachine::createPassConfig(PassManagerBase &PM) {
 void X86PassConfig::addIRPasses() {
   addPass(createAtomicExpandPass());
 
+  // Run LoopDataPrefetch before LSR to remove the multiplies involved in
+  // computing the pointer values N iterations ahead.
+  if (TM->getOptLevel() != CodeGenOpt::None && EnableLoopDataPrefetch)
+    addPass(createLoopDataPrefetchPass());
+
   TargetPassConfig::addIRPasses();
 
   if (TM->getOptLevel() != CodeGenOpt::None)
@@ -394,6 +410,8 @@ void X86PassConfig::addPreRegAlloc() {
     addPass(createX86OptimizeLEAs());
     addPass(createX86CallFrameOptimization());
   }
+  if (getOptLevel() >= CodeGenOpt::Default && EnablePipeliner)
+    addPass(&MachinePipelinerID);
 
   addPass(createX86WinAllocaExpander());
 }
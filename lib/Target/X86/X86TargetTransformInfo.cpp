@@ -99,6 +99,21 @@ unsigned X86TTIImpl::getLoadStoreVecRegBitWidth(unsigned) const {
   return getRegisterBitWidth(true);
 }
 
+unsigned X86TTIImpl::getPrefetchDistance() {
+  // A prefetch has to be issued about one memory latency, some 200 cycles,
+  // ahead of the access.  Loops bound by cache misses rarely retire more than
+  // half of the issue width, which gives the distance in instructions.
+  const MCSchedModel &SchedModel = ST->getSchedModel();
+  return 200 * std::max(SchedModel.IssueWidth, 2u) / 2;
+}
+
+unsigned X86TTIImpl::getMinPrefetchStride() {
+  // The hardware prefetchers follow strided streams within a 4K page, so only
+  // strides that leave the page on every other access are worth prefetching.
+  // Indirect accesses are prefetched regardless of this limit.
+  return 2048;
+}
+
 unsigned X86TTIImpl::getMaxInterleaveFactor(unsigned VF) {
   // If the loop will not be vectorized, don't interleave the loop.
   // Let regular unroll to unroll the loop, which saves the overflow
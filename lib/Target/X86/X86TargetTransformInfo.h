@@ -45,6 +45,10 @@ public:
   /// @{
   TTI::PopcntSupportKind getPopcntSupport(unsigned TyWidth);
 
+  unsigned getCacheLineSize() { return 64; }
+  unsigned getPrefetchDistance();
+  unsigned getMinPrefetchStride();
+
   /// @}
 
   /// \name Vector TTI Implementations
@@ -0,0 +1,344 @@
+//===- FunctionOrdering.cpp - Profile-guided function layout --------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This pass reorders the functions of a module with the call-chain clustering
+// (C3) heuristic from "Optimizing Function Placement for Large-Scale
+// Data-Center Applications" (Ottoni and Maher, CGO 2017), so that hot callers
+// and callees share i-cache lines and pages.
+//
+// The call graph is weighted with the profile counts of the blocks containing
+// the call sites.  Visiting functions from the most to the least frequently
+// called, each function's cluster is appended to the cluster of its most
+// frequent caller, unless the merged cluster would grow too large or much
+// less dense.  The clusters are then laid out by decreasing density, followed
+// by the functions without a profile in their original order.
+//
+// Functions are emitted in the order of the module, so the new order applies
+// to the object file as is.  When functions are placed in their own sections
+// and a linker reorders them, -function-order-file writes the symbol order
+// for its symbol ordering option instead.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Transforms/IPO/FunctionOrdering.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Analysis/BlockFrequencyInfo.h"
+#include "llvm/IR/CallSite.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Mangler.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Transforms/IPO.h"
+#include <numeric>
+using namespace llvm;
+
+#define DEBUG_TYPE "function-ordering"
+
+STATISTIC(NumOrdered, "Number of functions placed by call-chain clustering");
+STATISTIC(NumClusters, "Number of call-chain clusters");
+
+// The paper limits clusters to a page, so that a hot call chain costs as few
+// iTLB entries as possible.  Sizes are in IR instructions, which roughly
+// corresponds to a 4KiB page on common targets.
+static cl::opt<unsigned> MaxClusterSize(
+    "function-ordering-max-cluster-size", cl::init(1024), cl::Hidden,
+    cl::desc("Maximum size of a call-chain cluster, in instructions"));
+
+static cl::opt<std::string> FunctionOrderFile(
+    "function-order-file", cl::init(""), cl::Hidden,
+    cl::value_desc("filename"),
+    cl::desc("Write the symbols of the ordered functions, one per line"));
+
+/// Merging is skipped if it would make the caller's cluster this many times
+/// less dense.
+static const uint64_t MaxDensityDegradation = 8;
+
+/// Calls that make up less than 1 / MinEdgeRatio of the calls to a function
+/// don't pull it into its caller's cluster.
+static const uint64_t MinEdgeRatio = 10;
+
+namespace {
+
+class FunctionOrdering {
+public:
+  explicit FunctionOrdering(
+      function_ref<BlockFrequencyInfo *(Function &)> LookupBFI)
+      : LookupBFI(LookupBFI) {}
+
+  bool run(Module &M);
+
+private:
+  struct Cluster {
+    /// The functions in the cluster, in layout order.
+    std::vector<unsigned> Members;
+    uint64_t Size = 0;
+    uint64_t Weight = 0;
+
+    /// Compare densities without dividing.
+    bool isDenserThan(const Cluster &Other) const {
+      return Weight * Other.Size > Other.Weight * Size;
+    }
+  };
+
+  /// Per function: the number of calls it receives, and its most frequent
+  /// caller together with the number of calls from it.
+  struct Node {
+    Function *F;
+    uint64_t Size;
+    uint64_t Weight = 0;
+    unsigned BestCaller = ~0U;
+    uint64_t BestCallerWeight = 0;
+
+    Node(Function *F, uint64_t Size) : F(F), Size(Size) {}
+  };
+
+  void buildCallGraph(Module &M);
+  std::vector<unsigned> clusterFunctions();
+  void writeOrderFile(Module &M, ArrayRef<unsigned> Order);
+
+  function_ref<BlockFrequencyInfo *(Function &)> LookupBFI;
+  std::vector<Node> Nodes;
+  DenseMap<Function *, unsigned> NodeIndex;
+};
+
+} // end anonymous namespace
+
+static uint64_t getFunctionSize(const Function &F) {
+  uint64_t Size = 0;
+  for (const BasicBlock &BB : F)
+    for (const Instruction &I : BB)
+      if (!isa<DbgInfoIntrinsic>(I))
+        ++Size;
+  return std::max<uint64_t>(Size, 1);
+}
+
+void FunctionOrdering::buildCallGraph(Module &M) {
+  for (Function &F : M) {
+    if (F.isDeclaration() || !F.getEntryCount())
+      continue;
+    NodeIndex[&F] = Nodes.size();
+    Nodes.emplace_back(&F, getFunctionSize(F));
+  }
+
+  // Weight each edge with the number of times its call sites ran.
+  DenseMap<std::pair<unsigned, unsigned>, uint64_t> Edges;
+  for (unsigned Caller = 0, E = Nodes.size(); Caller != E; ++Caller) {
+    Function &F = *Nodes[Caller].F;
+    BlockFrequencyInfo *BFI = LookupBFI(F);
+    for (BasicBlock &BB : F) {
+      Optional<uint64_t> Count = BFI->getBlockProfileCount(&BB);
+      if (!Count || !*Count)
+        continue;
+      for (Instruction &I : BB) {
+        CallSite CS(&I);
+        if (!CS)
+          continue;
+        Function *Callee = CS.getCalledFunction();
+        auto It = Callee ? NodeIndex.find(Callee) : NodeIndex.end();
+        if (It == NodeIndex.end() || It->second == Caller)
+          continue;
+        Edges[{Caller, It->second}] += *Count;
+      }
+    }
+  }
+
+  for (const auto &Edge : Edges) {
+    unsigned Caller = Edge.first.first;
+    Node &Callee = Nodes[Edge.first.second];
+    Callee.Weight += Edge.second;
+    // Break ties towards the earlier caller, so that the result does not
+    // depend on the order of the map.
+    if (Edge.second > Callee.BestCallerWeight ||
+        (Edge.second == Callee.BestCallerWeight && Caller < Callee.BestCaller)) {
+      Callee.BestCaller = Caller;
+      Callee.BestCallerWeight = Edge.second;
+    }
+  }
+
+  // Functions that are only entered from outside the module, or through
+  // indirect calls, are weighted by their entry count.
+  for (Node &N : Nodes)
+    N.Weight = std::max(N.Weight, *N.F->getEntryCount());
+}
+
+std::vector<unsigned> FunctionOrdering::clusterFunctions() {
+  std::vector<Cluster> Clusters(Nodes.size());
+  std::vector<unsigned> ClusterOf(Nodes.size());
+  for (unsigned I = 0, E = Nodes.size(); I != E; ++I) {
+    Clusters[I].Members.push_back(I);
+    Clusters[I].Size = Nodes[I].Size;
+    Clusters[I].Weight = Nodes[I].Weight;
+    ClusterOf[I] = I;
+  }
+
+  // Visit the most frequently called functions first.
+  std::vector<unsigned> Worklist(Nodes.size());
+  std::iota(Worklist.begin(), Worklist.end(), 0);
+  std::stable_sort(Worklist.begin(), Worklist.end(),
+                   [&](unsigned A, unsigned B) {
+                     return Nodes[A].Weight > Nodes[B].Weight;
+                   });
+
+  for (unsigned I : Worklist) {
+    const Node &N = Nodes[I];
+    if (N.BestCaller == ~0U || N.BestCallerWeight * MinEdgeRatio <= N.Weight)
+      continue;
+
+    unsigned To = ClusterOf[N.BestCaller];
+    unsigned From = ClusterOf[I];
+    if (To == From)
+      continue;
+
+    Cluster &Pred = Clusters[To];
+    Cluster &C = Clusters[From];
+    if (Pred.Size + C.Size > MaxClusterSize)
+      continue;
+
+    // Would the merged cluster be much less dense than the caller's?
+    uint64_t NewWeight = Pred.Weight + C.Weight;
+    uint64_t NewSize = Pred.Size + C.Size;
+    if (NewWeight * Pred.Size * MaxDensityDegradation < Pred.Weight * NewSize)
+      continue;
+
+    for (unsigned Member : C.Members)
+      ClusterOf[Member] = To;
+    Pred.Members.insert(Pred.Members.end(), C.Members.begin(),
+                        C.Members.end());
+    Pred.Size = NewSize;
+    Pred.Weight = NewWeight;
+    C.Members.clear();
+  }
+
+  // Lay out the clusters from the densest to the sparsest.
+  std::vector<Cluster *> Sorted;
+  for (Cluster &C : Clusters)
+    if (!C.Members.empty())
+      Sorted.push_back(&C);
+  std::stable_sort(Sorted.begin(), Sorted.end(),
+                   [](const Cluster *A, const Cluster *B) {
+                     return A->isDenserThan(*B);
+                   });
+  NumClusters += Sorted.size();
+
+  std::vector<unsigned> Order;
+  for (Cluster *C : Sorted) {
+    DEBUG({
+      dbgs() << "Cluster of size " << C->Size << ", weight " << C->Weight
+             << ":";
+      for (unsigned Member : C->Members)
+        dbgs() << " " << Nodes[Member].F->getName();
+      dbgs() << "\n";
+    });
+    Order.insert(Order.end(), C->Members.begin(), C->Members.end());
+  }
+  return Order;
+}
+
+void FunctionOrdering::writeOrderFile(Module &M, ArrayRef<unsigned> Order) {
+  std::error_code EC;
+  raw_fd_ostream OS(FunctionOrderFile, EC, sys::fs::F_Text);
+  if (EC) {
+    M.getContext().emitError("could not open function order file '" +
+                             FunctionOrderFile + "': " + EC.message());
+    return;
+  }
+
+  Mangler Mang;
+  for (unsigned I : Order) {
+    Mang.getNameWithPrefix(OS, Nodes[I].F, /*CannotUsePrivateLabel=*/false);
+    OS << "\n";
+  }
+}
+
+bool FunctionOrdering::run(Module &M) {
+  buildCallGraph(M);
+  if (Nodes.empty())
+    return false;
+
+  std::vector<unsigned> Order = clusterFunctions();
+  NumOrdered += Order.size();
+  if (!FunctionOrderFile.empty())
+    writeOrderFile(M, Order);
+
+  // Move the ordered functions to the end of the module, followed by the
+  // definitions without a profile. Declarations stay where they are.
+  std::vector<Function *> Unprofiled;
+  for (Function &F : M)
+    if (!F.isDeclaration() && !NodeIndex.count(&F))
+      Unprofiled.push_back(&F);
+
+  bool Changed = false;
+  Module::FunctionListType &Functions = M.getFunctionList();
+  auto MoveToEnd = [&](Function *F) {
+    if (&Functions.back() != F) {
+      Functions.splice(Functions.end(), Functions, F->getIterator());
+      Changed = true;
+    }
+  };
+  for (unsigned I : Order)
+    MoveToEnd(Nodes[I].F);
+  for (Function *F : Unprofiled)
+    MoveToEnd(F);
+  return Changed;
+}
+
+namespace {
+
+struct FunctionOrderingLegacyPass : public ModulePass {
+  static char ID; // Pass identification, replacement for typeid
+  FunctionOrderingLegacyPass() : ModulePass(ID) {
+    initializeFunctionOrderingLegacyPassPass(*PassRegistry::getPassRegistry());
+  }
+
+  void getAnalysisUsage(AnalysisUsage &AU) const override {
+    AU.addRequired<BlockFrequencyInfoWrapperPass>();
+    AU.setPreservesAll();
+  }
+
+  bool runOnModule(Module &M) override {
+    if (skipModule(M))
+      return false;
+
+    auto LookupBFI = [this](Function &F) {
+      return &this->getAnalysis<BlockFrequencyInfoWrapperPass>(F).getBFI();
+    };
+    return FunctionOrdering(LookupBFI).run(M);
+  }
+};
+
+} // end anonymous namespace
+
+char FunctionOrderingLegacyPass::ID = 0;
+INITIALIZE_PASS_BEGIN(FunctionOrderingLegacyPass, "function-ordering",
+                      "Profile-guided Function Ordering", false, false)
+INITIALIZE_PASS_DEPENDENCY(BlockFrequencyInfoWrapperPass)
+INITIALIZE_PASS_END(FunctionOrderingLegacyPass, "function-ordering",
+                    "Profile-guided Function Ordering", false, false)
+
+ModulePass *llvm::createFunctionOrderingPass() {
+  return new FunctionOrderingLegacyPass();
+}
+
+PreservedAnalyses FunctionOrderingPass::run(Module &M,
+                                            ModuleAnalysisManager &AM) {
+  auto &FAM = AM.getResult<FunctionAnalysisManagerModuleProxy>(M).getManager();
+  auto LookupBFI = [&FAM](Function &F) {
+    return &FAM.getResult<BlockFrequencyAnalysis>(F);
+  };
+
+  FunctionOrdering(LookupBFI).run(M);
+  // Only the order of the functions changed.
+  return PreservedAnalyses::all();
+}
@@ -0,0 +1,326 @@
+//===- HotColdSplitting.cpp - Outline cold regions ------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This pass outlines the cold regions of a function into separate functions,
+// named after the original one with a ".cold.N" suffix.  They are marked cold
+// and minsize and placed in .text.unlikely, so that rarely executed code such
+// as error handling no longer shares cache lines and pages with the hot code
+// around it.
+//
+// A block is cold if the profile says so, or if it ends in unreachable or
+// calls a cold function.  Blocks whose successors are all cold and blocks
+// whose predecessors are all cold are cold as well.  Each cold block that is
+// not yet part of a region heads a new one, made of the cold blocks it
+// dominates that can only be entered through it.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Transforms/IPO/HotColdSplitting.h"
+#include "llvm/ADT/PostOrderIterator.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Analysis/BlockFrequencyInfo.h"
+#include "llvm/Analysis/BranchProbabilityInfo.h"
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/Analysis/OptimizationDiagnosticInfo.h"
+#include "llvm/Analysis/ProfileSummaryInfo.h"
+#include "llvm/Analysis/TargetTransformInfo.h"
+#include "llvm/IR/CFG.h"
+#include "llvm/IR/CallSite.h"
+#include "llvm/IR/DiagnosticInfo.h"
+#include "llvm/IR/Dominators.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Transforms/IPO.h"
+#include "llvm/Transforms/Utils/CodeExtractor.h"
+using namespace llvm;
+
+#define DEBUG_TYPE "hotcoldsplit"
+
+STATISTIC(NumColdRegionsOutlined, "Number of cold regions outlined");
+
+static cl::opt<int> SplittingThreshold(
+    "hotcoldsplit-threshold", cl::init(2), cl::Hidden,
+    cl::desc("Minimum cost of a cold region for it to be outlined"));
+
+static cl::opt<bool> StaticColdBlocks(
+    "hotcoldsplit-static", cl::init(true), cl::Hidden,
+    cl::desc("Treat blocks ending in unreachable or calling cold functions as "
+             "cold regardless of the profile"));
+
+namespace {
+
+class HotColdSplitting {
+public:
+  HotColdSplitting(ProfileSummaryInfo *PSI,
+                   std::function<TargetTransformInfo &(Function &)> *GetTTI)
+      : PSI(PSI), GetTTI(GetTTI) {}
+
+  bool run(Module &M);
+
+private:
+  bool isColdBlock(const BasicBlock &BB, BlockFrequencyInfo &BFI) const;
+  bool splitFunction(Function &F);
+  Function *outlineRegion(Function &F, ArrayRef<BasicBlock *> Region,
+                          DominatorTree &DT, unsigned Count);
+
+  ProfileSummaryInfo *PSI;
+  std::function<TargetTransformInfo &(Function &)> *GetTTI;
+};
+
+} // end anonymous namespace
+
+/// Returns true if \p BB can be moved to an outlined function.
+static bool isSplittableBlock(const BasicBlock &BB) {
+  // The region must leave the function through its exits, not return or
+  // unwind from inside the outlined function.
+  const TerminatorInst *TI = BB.getTerminator();
+  if (!isa<BranchInst>(TI) && !isa<SwitchInst>(TI) && !isa<UnreachableInst>(TI))
+    return false;
+
+  // A setjmp must stay in the frame that is later longjmp'd to.
+  for (const Instruction &I : BB)
+    if (auto CS = ImmutableCallSite(&I))
+      if (CS.hasFnAttr(Attribute::ReturnsTwice))
+        return false;
+
+  return CodeExtractor::isBlockValidForExtraction(BB);
+}
+
+static bool callsColdFunction(const BasicBlock &BB) {
+  for (const Instruction &I : BB)
+    if (auto CS = ImmutableCallSite(&I))
+      if (CS.hasFnAttr(Attribute::Cold))
+        return true;
+  return false;
+}
+
+bool HotColdSplitting::isColdBlock(const BasicBlock &BB,
+                                   BlockFrequencyInfo &BFI) const {
+  if (PSI->isColdBB(&BB, &BFI))
+    return true;
+  if (!StaticColdBlocks)
+    return false;
+  return isa<UnreachableInst>(BB.getTerminator()) || callsColdFunction(BB);
+}
+
+Function *HotColdSplitting::outlineRegion(Function &F,
+                                          ArrayRef<BasicBlock *> Region,
+                                          DominatorTree &DT, unsigned Count) {
+  CodeExtractor CE(Region, &DT);
+  if (!CE.isEligible())
+    return nullptr;
+  Function *Outlined = CE.extractCodeRegion();
+  if (!Outlined)
+    return nullptr;
+
+  Outlined->setName(F.getName() + ".cold." + Twine(Count));
+  Outlined->addFnAttr(Attribute::Cold);
+  Outlined->addFnAttr(Attribute::MinSize);
+  Outlined->addFnAttr(Attribute::NoInline);
+  Outlined->setSectionPrefix(".unlikely");
+
+  // A region that only left the function through unreachable never returns,
+  // and nor does the call that replaced it.
+  CallInst *Call = cast<CallInst>(*Outlined->user_begin());
+  if (none_of(*Outlined, [](const BasicBlock &BB) {
+        return isa<ReturnInst>(BB.getTerminator());
+      })) {
+    Outlined->setDoesNotReturn();
+    Call->setDoesNotReturn();
+    TerminatorInst *TI = Call->getParent()->getTerminator();
+    if (isa<ReturnInst>(TI)) {
+      new UnreachableInst(F.getContext(), TI);
+      TI->eraseFromParent();
+    }
+  }
+  return Outlined;
+}
+
+bool HotColdSplitting::splitFunction(Function &F) {
+  if (F.isDeclaration() || F.hasFnAttribute(Attribute::Cold) ||
+      F.hasFnAttribute(Attribute::OptimizeNone) ||
+      F.hasFnAttribute(Attribute::Naked))
+    return false;
+
+  // Detached tasks must stay in the function that spawns them; their code is
+  // split once Tapir has been lowered.
+  for (BasicBlock &BB : F) {
+    const TerminatorInst *TI = BB.getTerminator();
+    if (isa<DetachInst>(TI) || isa<ReattachInst>(TI) || isa<SyncInst>(TI))
+      return false;
+  }
+
+  DominatorTree DT(F);
+  LoopInfo LI(DT);
+  BranchProbabilityInfo BPI(F, LI);
+  BlockFrequencyInfo BFI(F, BPI, LI);
+  BasicBlock *Entry = &F.getEntryBlock();
+
+  SmallPtrSet<BasicBlock *, 16> ColdBlocks;
+  ReversePostOrderTraversal<Function *> RPOT(&F);
+  for (BasicBlock *BB : RPOT)
+    if (BB != Entry && isColdBlock(*BB, BFI))
+      ColdBlocks.insert(BB);
+  if (ColdBlocks.empty())
+    return false;
+
+  // A block that can only lead to cold code, or can only be reached from it,
+  // is cold too.
+  auto IsCold = [&](BasicBlock *BB) { return ColdBlocks.count(BB) != 0; };
+  for (BasicBlock *BB : post_order(&F))
+    if (BB != Entry && succ_begin(BB) != succ_end(BB) &&
+        all_of(successors(BB), IsCold))
+      ColdBlocks.insert(BB);
+  for (BasicBlock *BB : RPOT)
+    if (BB != Entry && pred_begin(BB) != pred_end(BB) &&
+        all_of(predecessors(BB), IsCold))
+      ColdBlocks.insert(BB);
+
+  // Form the regions, visiting dominators before the blocks they dominate so
+  // that each region is as large as possible.
+  TargetTransformInfo &TTI = (*GetTTI)(F);
+  SmallPtrSet<BasicBlock *, 16> Claimed;
+  std::vector<SetVector<BasicBlock *>> Regions;
+  for (BasicBlock *Header : RPOT) {
+    if (!IsCold(Header) || Claimed.count(Header) ||
+        !isSplittableBlock(*Header))
+      continue;
+
+    SetVector<BasicBlock *> Region;
+    Region.insert(Header);
+    for (unsigned I = 0; I != Region.size(); ++I)
+      for (BasicBlock *Succ : successors(Region[I]))
+        if (Succ != Header && IsCold(Succ) && !Claimed.count(Succ) &&
+            DT.dominates(Header, Succ) && isSplittableBlock(*Succ))
+          Region.insert(Succ);
+
+    // Only the header may be entered from outside the region.
+    bool Changed;
+    do {
+      Changed = false;
+      for (BasicBlock *BB : make_range(std::next(Region.begin()), Region.end()))
+        if (any_of(predecessors(BB),
+                   [&](BasicBlock *Pred) { return !Region.count(Pred); })) {
+          Region.remove(BB);
+          Changed = true;
+          break;
+        }
+    } while (Changed);
+
+    Claimed.insert(Region.begin(), Region.end());
+
+    int Cost = 0;
+    for (BasicBlock *BB : Region)
+      for (Instruction &I : *BB)
+        Cost += TTI.getUserCost(&I);
+    DEBUG(dbgs() << "Cold region at " << Header->getName() << " in "
+                 << F.getName() << ": " << Region.size() << " blocks, cost "
+                 << Cost << "\n");
+    if (Cost < SplittingThreshold)
+      continue;
+    Regions.push_back(std::move(Region));
+  }
+
+  OptimizationRemarkEmitter ORE(&F);
+  unsigned Count = 0;
+  for (SetVector<BasicBlock *> &Region : Regions) {
+    // Outlining a region leaves the others intact, but not the dominator
+    // tree that the code extractor checks them against.
+    if (Count)
+      DT.recalculate(F);
+    const Instruction *Loc = Region[0]->getFirstNonPHI();
+    Function *Outlined =
+        outlineRegion(F, Region.getArrayRef(), DT, Count + 1);
+    if (!Outlined)
+      continue;
+    ++Count;
+    ++NumColdRegionsOutlined;
+    ORE.emit(OptimizationRemark(DEBUG_TYPE, "HotColdSplit", Loc)
+             << "split cold code into " << ore::NV("Split", Outlined));
+  }
+  return Count != 0;
+}
+
+bool HotColdSplitting::run(Module &M) {
+  // Collect the functions first, since splitting adds new ones.
+  SmallVector<Function *, 16> Functions;
+  for (Function &F : M)
+    Functions.push_back(&F);
+
+  bool Changed = false;
+  for (Function *F : Functions)
+    Changed |= splitFunction(*F);
+  return Changed;
+}
+
+namespace {
+
+struct HotColdSplittingLegacyPass : public ModulePass {
+  static char ID; // Pass identification, replacement for typeid
+  HotColdSplittingLegacyPass() : ModulePass(ID) {
+    initializeHotColdSplittingLegacyPassPass(*PassRegistry::getPassRegistry());
+  }
+
+  void getAnalysisUsage(AnalysisUsage &AU) const override {
+    AU.addRequired<ProfileSummaryInfoWrapperPass>();
+    AU.addRequired<TargetTransformInfoWrapperPass>();
+  }
+
+  bool runOnModule(Module &M) override {
+    if (skipModule(M))
+      return false;
+
+    TargetTransformInfoWrapperPass *TTIWP =
+        &getAnalysis<TargetTransformInfoWrapperPass>();
+    ProfileSummaryInfo *PSI =
+        getAnalysis<ProfileSummaryInfoWrapperPass>().getPSI();
+
+    std::function<TargetTransformInfo &(Function &)> GetTTI =
+        [&TTIWP](Function &F) -> TargetTransformInfo & {
+      return TTIWP->getTTI(F);
+    };
+
+    return HotColdSplitting(PSI, &GetTTI).run(M);
+  }
+};
+
+} // end anonymous namespace
+
+char HotColdSplittingLegacyPass::ID = 0;
+INITIALIZE_PASS_BEGIN(HotColdSplittingLegacyPass, "hotcoldsplit",
+                      "Hot Cold Splitting", false, false)
+INITIALIZE_PASS_DEPENDENCY(ProfileSummaryInfoWrapperPass)
+INITIALIZE_PASS_DEPENDENCY(TargetTransformInfoWrapperPass)
+INITIALIZE_PASS_END(HotColdSplittingLegacyPass, "hotcoldsplit",
+                    "Hot Cold Splitting", false, false)
+
+ModulePass *llvm::createHotColdSplittingPass() {
+  return new HotColdSplittingLegacyPass();
+}
+
+PreservedAnalyses HotColdSplittingPass::run(Module &M,
+                                            ModuleAnalysisManager &AM) {
+  auto &FAM = AM.getResult<FunctionAnalysisManagerModuleProxy>(M).getManager();
+
+  std::function<TargetTransformInfo &(Function &)> GetTTI =
+      [&FAM](Function &F) -> TargetTransformInfo & {
+    return FAM.getResult<TargetIRAnalysis>(F);
+  };
+
+  ProfileSummaryInfo *PSI = &AM.getResult<ProfileSummaryAnalysis>(M);
+
+  if (HotColdSplitting(PSI, &GetTTI).run(M))
+    return PreservedAnalyses::none();
+  return PreservedAnalyses::all();
+}
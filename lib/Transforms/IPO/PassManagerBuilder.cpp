@@ -50,6 +50,14 @@ static cl::opt<bool>
     RunPartialInlining("enable-partial-inlining", cl::init(false), cl::Hidden,
                        cl::ZeroOrMore, cl::desc("Run Partial inlinining pass"));
 
+static cl::opt<bool>
+    EnableHotColdSplit("hot-cold-split", cl::init(false), cl::Hidden,
+                       cl::desc("Outline cold regions into separate functions"));
+
+static cl::opt<bool> EnableFunctionOrdering(
+    "order-functions", cl::init(false), cl::Hidden,
+    cl::desc("Lay out functions by call-chain clustering of the profile"));
+
 static cl::opt<bool>
     RunLoopVectorization("vectorize-loops", cl::Hidden,
                          cl::desc("Run the Loop vectorization passes"));
@@ -700,6 +708,18 @@ void PassManagerBuilder::populateModulePassManager(
   if (MergeFunctions)
     MPM.add(createMergeFunctionsPass());
 
+  // Split out cold code once the optimizations that could make use of it in
+  // its original context have run. Leave it in place for LTO, which sees
+  // more of the program.
+  if (EnableHotColdSplit && !(PrepareForLTO || PrepareForThinLTO))
+    MPM.add(createHotColdSplittingPass());
+
+  // Order the functions once they will no longer be split, merged or
+  // deleted. With LTO this is done at link time, where the whole call graph
+  // is known.
+  if (EnableFunctionOrdering && !(PrepareForLTO || PrepareForThinLTO))
+    MPM.add(createFunctionOrderingPass());
+
   // LoopSink pass sinks instructions hoisted by LICM, which serves as a
   // canonicalization pass that enables other optimizations. As a result,
   // LoopSink pass needs to be a very late IR pass to avoid undoing LICM
@@ -914,6 +934,12 @@ void PassManagerBuilder::addLateLTOOptimizationPasses(
   // Now that we have optimized the program, discard unreachable functions.
   PM.add(createGlobalDCEPass());
 
+  if (EnableHotColdSplit)
+    PM.add(createHotColdSplittingPass());
+
+  if (EnableFunctionOrdering)
+    PM.add(createFunctionOrderingPass());
+
   // FIXME: this is profitable (for compiler time) to do at -O0 too, but
   // currently it damages debug info.
   if (MergeFunctions)
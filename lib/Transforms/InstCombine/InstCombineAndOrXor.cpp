@@ -170,7 +170,7 @@ Instruction *InstCombiner::OptAndOp(BinaryOperator *Op,
           // the XOR is to toggle the bit.  If it is clear, then the ADD has
           // no effect.
           if ((AddRHS & AndRHSV).isNullValue()) { // Bit is not set, noop
-            TheAnd.setOperand(0, X);
+            replaceOperand(TheAnd, 0, X);
             return &TheAnd;
           } else {
             // Pull the XOR out of the AND.
@@ -197,7 +197,7 @@ Instruction *InstCombiner::OptAndOp(BinaryOperator *Op,
       return replaceInstUsesWith(TheAnd, Op);   // No need for the and.
 
     if (CI != AndRHS) {                  // Reducing bits set in and.
-      TheAnd.setOperand(1, CI);
+      replaceOperand(TheAnd, 1, CI);
       return &TheAnd;
     }
     break;
@@ -217,7 +217,7 @@ Instruction *InstCombiner::OptAndOp(BinaryOperator *Op,
       return replaceInstUsesWith(TheAnd, Op);
 
     if (CI != AndRHS) {
-      TheAnd.setOperand(1, CI);  // Reduce bits set in and cst.
+      replaceOperand(TheAnd, 1, CI);  // Reduce bits set in and cst.
       return &TheAnd;
     }
     break;
@@ -2483,8 +2483,8 @@ Instruction *InstCombiner::visitXor(BinaryOperator &I) {
             NewRHS = ConstantExpr::getAnd(NewRHS,
                                        ConstantExpr::getNot(CommonBits));
             Worklist.Add(Op0I);
-            I.setOperand(0, Op0I->getOperand(0));
-            I.setOperand(1, NewRHS);
+            replaceOperand(I, 0, Op0I->getOperand(0));
+            replaceOperand(I, 1, NewRHS);
             return &I;
           }
         } else if (Op0I->getOpcode() == Instruction::LShr) {
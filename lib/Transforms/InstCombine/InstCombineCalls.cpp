@@ -246,7 +246,7 @@ Instruction *InstCombiner::SimplifyMemTransfer(MemIntrinsic *MI) {
     S->setMetadata(LLVMContext::MD_mem_parallel_loop_access, LoopMemParallelMD);
 
   // Set the size of the copy to 0, it will be deleted on the next iteration.
-  MI->setArgOperand(2, Constant::getNullValue(MemOpLength->getType()));
+  replaceOperand(*MI, 2, Constant::getNullValue(MemOpLength->getType()));
   return MI;
 }
 
@@ -1402,7 +1402,7 @@ static Instruction *foldCttzCtlz(IntrinsicInst &II, InstCombiner &IC) {
       isKnownNonZero(Op0, IC.getDataLayout(), 0, &IC.getAssumptionCache(), &II,
                      &IC.getDominatorTree())) {
     if (!match(II.getArgOperand(1), m_One())) {
-      II.setOperand(1, IC.Builder.getTrue());
+      IC.replaceOperand(II, 1, IC.Builder.getTrue());
       return &II;
     }
   }
@@ -2035,8 +2035,8 @@ Instruction *InstCombiner::visitCallInst(CallInst &CI) {
         !isa<Constant>(II->getArgOperand(1))) {
       // Canonicalize constants into the RHS.
       Value *LHS = II->getArgOperand(0);
-      II->setArgOperand(0, II->getArgOperand(1));
-      II->setArgOperand(1, LHS);
+      replaceOperand(*II, 0, II->getArgOperand(1));
+      replaceOperand(*II, 1, LHS);
       return II;
     }
     LLVM_FALLTHROUGH;
@@ -2062,8 +2062,8 @@ Instruction *InstCombiner::visitCallInst(CallInst &CI) {
     Value *Arg1 = II->getArgOperand(1);
     // Canonicalize constants to the RHS.
     if (isa<ConstantFP>(Arg0) && !isa<ConstantFP>(Arg1)) {
-      II->setArgOperand(0, Arg1);
-      II->setArgOperand(1, Arg0);
+      replaceOperand(*II, 0, Arg1);
+      replaceOperand(*II, 1, Arg0);
       return II;
     }
     if (Value *V = simplifyMinnumMaxnum(*II))
@@ -2090,8 +2090,8 @@ Instruction *InstCombiner::visitCallInst(CallInst &CI) {
 
     // Canonicalize constants into the RHS.
     if (isa<Constant>(Src0) && !isa<Constant>(Src1)) {
-      II->setArgOperand(0, Src1);
-      II->setArgOperand(1, Src0);
+      replaceOperand(*II, 0, Src1);
+      replaceOperand(*II, 1, Src0);
       std::swap(Src0, Src1);
     }
 
@@ -2101,16 +2101,16 @@ Instruction *InstCombiner::visitCallInst(CallInst &CI) {
     // fma fneg(x), fneg(y), z -> fma x, y, z
     if (match(Src0, m_FNeg(m_Value(LHS))) &&
         match(Src1, m_FNeg(m_Value(RHS)))) {
-      II->setArgOperand(0, LHS);
-      II->setArgOperand(1, RHS);
+      replaceOperand(*II, 0, LHS);
+      replaceOperand(*II, 1, RHS);
       return II;
     }
 
     // fma fabs(x), fabs(x), z -> fma x, x, z
     if (match(Src0, m_Intrinsic<Intrinsic::fabs>(m_Value(LHS))) &&
         match(Src1, m_Intrinsic<Intrinsic::fabs>(m_Value(RHS))) && LHS == RHS) {
-      II->setArgOperand(0, LHS);
-      II->setArgOperand(1, RHS);
+      replaceOperand(*II, 0, LHS);
+      replaceOperand(*II, 1, RHS);
       return II;
     }
 
@@ -2163,7 +2163,7 @@ Instruction *InstCombiner::visitCallInst(CallInst &CI) {
         match(Src, m_Intrinsic<Intrinsic::fabs>(m_Value(SrcSrc)))) {
       // cos(-x) -> cos(x)
       // cos(fabs(x)) -> cos(x)
-      II->setArgOperand(0, SrcSrc);
+      replaceOperand(*II, 0, SrcSrc);
       return II;
     }
 
@@ -2286,7 +2286,7 @@ Instruction *InstCombiner::visitCallInst(CallInst &CI) {
 
     // We only use the lowest lanes of the argument.
     if (Value *V = SimplifyDemandedVectorEltsLow(Arg, ArgWidth, RetWidth)) {
-      II->setArgOperand(0, V);
+      replaceOperand(*II, 0, V);
       return II;
     }
     break;
@@ -2321,7 +2321,7 @@ Instruction *InstCombiner::visitCallInst(CallInst &CI) {
     Value *Arg = II->getArgOperand(0);
     unsigned VWidth = Arg->getType()->getVectorNumElements();
     if (Value *V = SimplifyDemandedVectorEltsLow(Arg, VWidth, 1)) {
-      II->setArgOperand(0, V);
+      replaceOperand(*II, 0, V);
       return II;
     }
     break;
@@ -2374,11 +2374,11 @@ Instruction *InstCombiner::visitCallInst(CallInst &CI) {
     Value *Arg1 = II->getArgOperand(1);
     unsigned VWidth = Arg0->getType()->getVectorNumElements();
     if (Value *V = SimplifyDemandedVectorEltsLow(Arg0, VWidth, 1)) {
-      II->setArgOperand(0, V);
+      replaceOperand(*II, 0, V);
       MadeChange = true;
     }
     if (Value *V = SimplifyDemandedVectorEltsLow(Arg1, VWidth, 1)) {
-      II->setArgOperand(1, V);
+      replaceOperand(*II, 1, V);
       MadeChange = true;
     }
     if (MadeChange)
@@ -2410,8 +2410,8 @@ Instruction *InstCombiner::visitCallInst(CallInst &CI) {
          cast<Instruction>(Arg0)->getFastMathFlags().noInfs())) {
       if (Arg0IsZero)
         std::swap(A, B);
-      II->setArgOperand(0, A);
-      II->setArgOperand(1, B);
+      replaceOperand(*II, 0, A);
+      replaceOperand(*II, 1, B);
       return II;
     }
     break;
@@ -2640,7 +2640,7 @@ Instruction *InstCombiner::visitCallInst(CallInst &CI) {
     unsigned VWidth = Arg1->getType()->getVectorNumElements();
 
     if (Value *V = SimplifyDemandedVectorEltsLow(Arg1, VWidth, VWidth / 2)) {
-      II->setArgOperand(1, V);
+      replaceOperand(*II, 1, V);
       return II;
     }
     break;
@@ -2731,7 +2731,7 @@ Instruction *InstCombiner::visitCallInst(CallInst &CI) {
       DemandedElts = (Imm & 0x01) ? 2 : 1;
       if (Value *V = SimplifyDemandedVectorElts(Arg0, DemandedElts,
                                                 UndefElts1)) {
-        II->setArgOperand(0, V);
+        replaceOperand(*II, 0, V);
         MadeChange = true;
       }
 
@@ -2739,7 +2739,7 @@ Instruction *InstCombiner::visitCallInst(CallInst &CI) {
       DemandedElts = (Imm & 0x10) ? 2 : 1;
       if (Value *V = SimplifyDemandedVectorElts(Arg1, DemandedElts,
                                                 UndefElts2)) {
-        II->setArgOperand(1, V);
+        replaceOperand(*II, 1, V);
         MadeChange = true;
       }
 
@@ -2786,11 +2786,11 @@ Instruction *InstCombiner::visitCallInst(CallInst &CI) {
     // operands and the lowest 16-bits of the second.
     bool MadeChange = false;
     if (Value *V = SimplifyDemandedVectorEltsLow(Op0, VWidth0, 1)) {
-      II->setArgOperand(0, V);
+      replaceOperand(*II, 0, V);
       MadeChange = true;
     }
     if (Value *V = SimplifyDemandedVectorEltsLow(Op1, VWidth1, 2)) {
-      II->setArgOperand(1, V);
+      replaceOperand(*II, 1, V);
       MadeChange = true;
     }
     if (MadeChange)
@@ -2817,7 +2817,7 @@ Instruction *InstCombiner::visitCallInst(CallInst &CI) {
     // EXTRQI only uses the lowest 64-bits of the first 128-bit vector
     // operand.
     if (Value *V = SimplifyDemandedVectorEltsLow(Op0, VWidth, 1)) {
-      II->setArgOperand(0, V);
+      replaceOperand(*II, 0, V);
       return II;
     }
     break;
@@ -2850,7 +2850,7 @@ Instruction *InstCombiner::visitCallInst(CallInst &CI) {
     // INSERTQ only uses the lowest 64-bits of the first 128-bit vector
     // operand.
     if (Value *V = SimplifyDemandedVectorEltsLow(Op0, VWidth, 1)) {
-      II->setArgOperand(0, V);
+      replaceOperand(*II, 0, V);
       return II;
     }
     break;
@@ -2884,11 +2884,11 @@ Instruction *InstCombiner::visitCallInst(CallInst &CI) {
     // operands.
     bool MadeChange = false;
     if (Value *V = SimplifyDemandedVectorEltsLow(Op0, VWidth0, 1)) {
-      II->setArgOperand(0, V);
+      replaceOperand(*II, 0, V);
       MadeChange = true;
     }
     if (Value *V = SimplifyDemandedVectorEltsLow(Op1, VWidth1, 1)) {
-      II->setArgOperand(1, V);
+      replaceOperand(*II, 1, V);
       MadeChange = true;
     }
     if (MadeChange)
@@ -3099,9 +3099,9 @@ Instruction *InstCombiner::visitCallInst(CallInst &CI) {
     unsigned AlignArg = II->getNumArgOperands() - 1;
     ConstantInt *IntrAlign = dyn_cast<ConstantInt>(II->getArgOperand(AlignArg));
     if (IntrAlign && IntrAlign->getZExtValue() < MemAlign) {
-      II->setArgOperand(AlignArg,
-                        ConstantInt::get(Type::getInt32Ty(II->getContext()),
-                                         MemAlign, false));
+      replaceOperand(*II, AlignArg,
+                     ConstantInt::get(Type::getInt32Ty(II->getContext()),
+                                      MemAlign, false));
       return II;
     }
     break;
@@ -3321,8 +3321,8 @@ Instruction *InstCombiner::visitCallInst(CallInst &CI) {
 
       if (Width >= IntSize) {
         // Hardware ignores high bits, so remove those.
-        II->setArgOperand(2, ConstantInt::get(CWidth->getType(),
-                                              Width & (IntSize - 1)));
+        replaceOperand(*II, 2, ConstantInt::get(CWidth->getType(),
+                                                Width & (IntSize - 1)));
         return II;
       }
     }
@@ -3332,8 +3332,8 @@ Instruction *InstCombiner::visitCallInst(CallInst &CI) {
     if (COffset) {
       Offset = COffset->getZExtValue();
       if (Offset >= IntSize) {
-        II->setArgOperand(1, ConstantInt::get(COffset->getType(),
-                                              Offset & (IntSize - 1)));
+        replaceOperand(*II, 1, ConstantInt::get(COffset->getType(),
+                                                Offset & (IntSize - 1)));
         return II;
       }
     }
@@ -3389,7 +3389,7 @@ Instruction *InstCombiner::visitCallInst(CallInst &CI) {
           (IsCompr && ((EnBits & (0x3 << (2 * I))) == 0))) {
         Value *Src = II->getArgOperand(I + 2);
         if (!isa<UndefValue>(Src)) {
-          II->setArgOperand(I + 2, UndefValue::get(Src->getType()));
+          replaceOperand(*II, I + 2, UndefValue::get(Src->getType()));
           Changed = true;
         }
       }
@@ -3429,9 +3429,9 @@ Instruction *InstCombiner::visitCallInst(CallInst &CI) {
     }
 
     if (Swap) {
-      II->setArgOperand(0, Src0);
-      II->setArgOperand(1, Src1);
-      II->setArgOperand(2, Src2);
+      replaceOperand(*II, 0, Src0);
+      replaceOperand(*II, 1, Src1);
+      replaceOperand(*II, 2, Src2);
       return II;
     }
 
@@ -3501,10 +3501,10 @@ Instruction *InstCombiner::visitCallInst(CallInst &CI) {
       // Canonicalize constants to RHS.
       CmpInst::Predicate SwapPred
         = CmpInst::getSwappedPredicate(static_cast<CmpInst::Predicate>(CCVal));
-      II->setArgOperand(0, Src1);
-      II->setArgOperand(1, Src0);
-      II->setArgOperand(2, ConstantInt::get(CC->getType(),
-                                            static_cast<int>(SwapPred)));
+      replaceOperand(*II, 0, Src1);
+      replaceOperand(*II, 1, Src0);
+      replaceOperand(*II, 2, ConstantInt::get(CC->getType(),
+                                              static_cast<int>(SwapPred)));
       return II;
     }
 
@@ -3521,8 +3521,8 @@ Instruction *InstCombiner::visitCallInst(CallInst &CI) {
         ((match(Src1, m_One()) && match(Src0, m_ZExt(m_Value(ExtSrc)))) ||
          (match(Src1, m_AllOnes()) && match(Src0, m_SExt(m_Value(ExtSrc))))) &&
         ExtSrc->getType()->isIntegerTy(1)) {
-      II->setArgOperand(1, ConstantInt::getNullValue(Src1->getType()));
-      II->setArgOperand(2, ConstantInt::get(CC->getType(), CmpInst::ICMP_NE));
+      replaceOperand(*II, 1, ConstantInt::getNullValue(Src1->getType()));
+      replaceOperand(*II, 2, ConstantInt::get(CC->getType(), CmpInst::ICMP_NE));
       return II;
     }
 
@@ -3730,7 +3730,7 @@ Instruction *InstCombiner::visitCallInst(CallInst &CI) {
         return eraseInstFromFunction(*NextInst);
 
       // Otherwise canonicalize guard(a); guard(b) -> guard(a & b).
-      II->setArgOperand(0, Builder.CreateAnd(CurrCond, NextCond));
+      replaceOperand(*II, 0, Builder.CreateAnd(CurrCond, NextCond));
       return eraseInstFromFunction(*NextInst);
     }
     break;
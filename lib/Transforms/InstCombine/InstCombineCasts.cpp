@@ -1601,7 +1601,7 @@ Instruction *InstCombiner::commonPointerCastTransforms(CastInst &CI) {
       // here because the pointer operand is being replaced with another
       // pointer operand so the opcode doesn't need to change.
       Worklist.Add(GEP);
-      CI.setOperand(0, GEP->getOperand(0));
+      replaceOperand(CI, 0, GEP->getOperand(0));
       return &CI;
     }
   }
@@ -2063,7 +2063,7 @@ Instruction *InstCombiner::optimizeBitCastFromPhi(CastInst &CI, PHINode *PN) {
       Builder.SetInsertPoint(SI);
       auto *NewBC =
           cast<BitCastInst>(Builder.CreateBitCast(NewPNodes[PN], SrcTy));
-      SI->setOperand(0, NewBC);
+      replaceOperand(*SI, 0, NewBC);
       Worklist.Add(SI);
       assert(hasStoreUsersOnly(*NewBC));
     }
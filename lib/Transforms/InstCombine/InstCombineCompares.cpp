@@ -1512,7 +1512,7 @@ Instruction *InstCombiner::foldICmpXorConstant(ICmpInst &Cmp,
     // If the sign bit of the XorCst is not set, there is no change to
     // the operation, just stop using the Xor.
     if (!XorC->isNegative()) {
-      Cmp.setOperand(0, X);
+      replaceOperand(Cmp, 0, X);
       Worklist.Add(Xor);
       return &Cmp;
     }
@@ -1611,10 +1611,10 @@ Instruction *InstCombiner::foldICmpAndShift(ICmpInst &Cmp, BinaryOperator *And,
         if (Cmp.getPredicate() == ICmpInst::ICMP_NE)
           return replaceInstUsesWith(Cmp, ConstantInt::getTrue(Cmp.getType()));
       } else {
-        Cmp.setOperand(1, ConstantInt::get(And->getType(), NewCst));
+        replaceOperand(Cmp, 1, ConstantInt::get(And->getType(), NewCst));
         APInt NewAndCst = IsShl ? C2->lshr(*C3) : C2->shl(*C3);
-        And->setOperand(1, ConstantInt::get(And->getType(), NewAndCst));
-        And->setOperand(0, Shift->getOperand(0));
+        replaceOperand(*And, 1, ConstantInt::get(And->getType(), NewAndCst));
+        replaceOperand(*And, 0, Shift->getOperand(0));
         Worklist.Add(Shift); // Shift is dead.
         return &Cmp;
       }
@@ -1633,7 +1633,7 @@ Instruction *InstCombiner::foldICmpAndShift(ICmpInst &Cmp, BinaryOperator *And,
 
     // Compute X & (C2 << Y).
     Value *NewAnd = Builder.CreateAnd(Shift->getOperand(0), NewShift);
-    Cmp.setOperand(0, NewAnd);
+    replaceOperand(Cmp, 0, NewAnd);
     return &Cmp;
   }
 
@@ -1710,7 +1710,7 @@ Instruction *InstCombiner::foldICmpAndConstConst(ICmpInst &Cmp,
       }
       if (NewOr) {
         Value *NewAnd = Builder.CreateAnd(A, NewOr, And->getName());
-        Cmp.setOperand(0, NewAnd);
+        replaceOperand(Cmp, 0, NewAnd);
         return &Cmp;
       }
     }
@@ -2091,7 +2091,7 @@ Instruction *InstCombiner::foldICmpShrConstant(ICmpInst &Cmp,
     Value *Tmp = IsAShr ? Builder.CreateSDiv(X, DivCst, "", Shr->isExact())
                         : Builder.CreateUDiv(X, DivCst, "", Shr->isExact());
 
-    Cmp.setOperand(0, Tmp);
+    replaceOperand(Cmp, 0, Tmp);
 
     // If the builder folded the binop, just return it.
     BinaryOperator *TheDiv = dyn_cast<BinaryOperator>(Tmp);
@@ -2757,8 +2757,8 @@ Instruction *InstCombiner::foldICmpIntrinsicWithConstant(ICmpInst &Cmp,
   switch (II->getIntrinsicID()) {
   case Intrinsic::bswap:
     Worklist.Add(II);
-    Cmp.setOperand(0, II->getArgOperand(0));
-    Cmp.setOperand(1, ConstantInt::get(Ty, C->byteSwap()));
+    replaceOperand(Cmp, 0, II->getArgOperand(0));
+    replaceOperand(Cmp, 1, ConstantInt::get(Ty, C->byteSwap()));
     return &Cmp;
 
   case Intrinsic::ctlz:
@@ -2766,8 +2766,8 @@ Instruction *InstCombiner::foldICmpIntrinsicWithConstant(ICmpInst &Cmp,
     // ctz(A) == bitwidth(A)  ->  A == 0 and likewise for !=
     if (*C == C->getBitWidth()) {
       Worklist.Add(II);
-      Cmp.setOperand(0, II->getArgOperand(0));
-      Cmp.setOperand(1, ConstantInt::getNullValue(Ty));
+      replaceOperand(Cmp, 0, II->getArgOperand(0));
+      replaceOperand(Cmp, 1, ConstantInt::getNullValue(Ty));
       return &Cmp;
     }
     break;
@@ -2778,10 +2778,10 @@ Instruction *InstCombiner::foldICmpIntrinsicWithConstant(ICmpInst &Cmp,
     bool IsZero = C->isNullValue();
     if (IsZero || *C == C->getBitWidth()) {
       Worklist.Add(II);
-      Cmp.setOperand(0, II->getArgOperand(0));
+      replaceOperand(Cmp, 0, II->getArgOperand(0));
       auto *NewOp =
           IsZero ? Constant::getNullValue(Ty) : Constant::getAllOnesValue(Ty);
-      Cmp.setOperand(1, NewOp);
+      replaceOperand(Cmp, 1, NewOp);
       return &Cmp;
     }
     break;
@@ -3380,8 +3380,8 @@ Instruction *InstCombiner::foldICmpEquality(ICmpInst &I) {
     if (X) { // Build (X^Y) & Z
       Op1 = Builder.CreateXor(X, Y);
       Op1 = Builder.CreateAnd(Op1, Z);
-      I.setOperand(0, Op1);
-      I.setOperand(1, Constant::getNullValue(Op1->getType()));
+      replaceOperand(I, 0, Op1);
+      replaceOperand(I, 1, Constant::getNullValue(Op1->getType()));
       return &I;
     }
   }
@@ -3869,7 +3869,7 @@ static Instruction *processUMulZExtIdiom(ICmpInst &I, Value *MulVal,
         if (TI->getType()->getPrimitiveSizeInBits() == MulWidth)
           IC.replaceInstUsesWith(*TI, Mul);
         else
-          TI->setOperand(0, Mul);
+          IC.replaceOperand(*TI, 0, Mul);
       } else if (BinaryOperator *BO = dyn_cast<BinaryOperator>(U)) {
         assert(BO->getOpcode() == Instruction::And);
         // Replace (mul & mask) --> zext (mul.with.overflow & short_mask)
@@ -4960,7 +4960,7 @@ Instruction *InstCombiner::visitFCmpInst(FCmpInst &I) {
     case FCmpInst::FCMP_UNE:    // True if unordered or not equal
       // Canonicalize these to be 'fcmp uno %X, 0.0'.
       I.setPredicate(FCmpInst::FCMP_UNO);
-      I.setOperand(1, Constant::getNullValue(Op0->getType()));
+      replaceOperand(I, 1, Constant::getNullValue(Op0->getType()));
       return &I;
 
     case FCmpInst::FCMP_ORD:    // True if ordered (no nans)
@@ -4969,7 +4969,7 @@ Instruction *InstCombiner::visitFCmpInst(FCmpInst &I) {
     case FCmpInst::FCMP_OLE:    // True if ordered and less than or equal
       // Canonicalize these to be 'fcmp ord %X, 0.0'.
       I.setPredicate(FCmpInst::FCMP_ORD);
-      I.setOperand(1, Constant::getNullValue(Op0->getType()));
+      replaceOperand(I, 1, Constant::getNullValue(Op0->getType()));
       return &I;
     }
   }
@@ -225,6 +225,9 @@ private:
   TargetLibraryInfo &TLI;
   DominatorTree &DT;
   const DataLayout &DL;
+  /// Cache for ValueTracking queries, if enabled.  It is cleared whenever the
+  /// IR changes, including by replaceOperand within a visit.
+  ValueTrackingCache *VTC;
   const SimplifyQuery SQ;
   // Optional analyses. When non-null, these can both be used to do better
   // combining and will be updated to reflect any changes.
@@ -236,10 +239,13 @@ public:
   InstCombiner(InstCombineWorklist &Worklist, BuilderTy &Builder,
                bool MinimizeSize, bool ExpensiveCombines, AliasAnalysis *AA,
                AssumptionCache &AC, TargetLibraryInfo &TLI, DominatorTree &DT,
-               const DataLayout &DL, LoopInfo *LI)
+               const DataLayout &DL, LoopInfo *LI,
+               ValueTrackingCache *VTC = nullptr)
       : Worklist(Worklist), Builder(Builder), MinimizeSize(MinimizeSize),
         ExpensiveCombines(ExpensiveCombines), AA(AA), AC(AC), TLI(TLI), DT(DT),
-        DL(DL), SQ(DL, &TLI, &DT, &AC), LI(LI), MadeIRChange(false) {}
+        DL(DL), VTC(VTC),
+        SQ(SimplifyQuery(DL, &TLI, &DT, &AC).getWithCache(VTC)), LI(LI),
+        MadeIRChange(false) {}
 
   /// \brief Run the combiner over the entire worklist until it is empty.
   ///
@@ -505,6 +511,21 @@ public:
     return &I;
   }
 
+  /// \brief Replace operand \p OpNum of \p I with \p V, and return \p I.
+  ///
+  /// Combines that change an existing instruction in place should use this
+  /// rather than setOperand.  The value handles of the ValueTracking cache
+  /// cannot see such changes, and the visitor may query known bits again
+  /// before it returns, so all cached results are dropped.  Plain setOperand
+  /// is only safe right before the visit returns, since run() clears the
+  /// cache after every visit that changed the IR.
+  Instruction *replaceOperand(Instruction &I, unsigned OpNum, Value *V) {
+    I.setOperand(OpNum, V);
+    if (VTC && !VTC->empty())
+      VTC->clear();
+    return &I;
+  }
+
   /// Creates a result tuple for an overflow intrinsic \p II with a given
   /// \p Result and a constant \p Overflow value.
   Instruction *CreateOverflowTuple(IntrinsicInst *II, Value *Result,
@@ -532,6 +553,12 @@ public:
         if (auto *Inst = dyn_cast<Instruction>(Operand))
           Worklist.Add(Inst);
     }
+    // Combines that scan the block, such as merging adjacent guards or
+    // forwarding stores to loads, may see further without I.
+    if (Instruction *Prev = I.getPrevNode())
+      Worklist.AddDeferred(Prev);
+    if (Instruction *Next = I.getNextNode())
+      Worklist.AddDeferred(Next);
     Worklist.Remove(&I);
     I.eraseFromParent();
     MadeIRChange = true;
@@ -540,11 +567,11 @@ public:
 
   void computeKnownBits(const Value *V, KnownBits &Known,
                         unsigned Depth, const Instruction *CxtI) const {
-    llvm::computeKnownBits(V, Known, DL, Depth, &AC, CxtI, &DT);
+    llvm::computeKnownBits(V, Known, DL, Depth, &AC, CxtI, &DT, nullptr, VTC);
   }
   KnownBits computeKnownBits(const Value *V, unsigned Depth,
                              const Instruction *CxtI) const {
-    return llvm::computeKnownBits(V, DL, Depth, &AC, CxtI, &DT);
+    return llvm::computeKnownBits(V, DL, Depth, &AC, CxtI, &DT, nullptr, VTC);
   }
 
   bool isKnownToBeAPowerOfTwo(const Value *V, bool OrZero = false,
@@ -555,11 +582,11 @@ public:
 
   bool MaskedValueIsZero(const Value *V, const APInt &Mask, unsigned Depth = 0,
                          const Instruction *CxtI = nullptr) const {
-    return llvm::MaskedValueIsZero(V, Mask, DL, Depth, &AC, CxtI, &DT);
+    return llvm::MaskedValueIsZero(V, Mask, DL, Depth, &AC, CxtI, &DT, VTC);
   }
   unsigned ComputeNumSignBits(const Value *Op, unsigned Depth = 0,
                               const Instruction *CxtI = nullptr) const {
-    return llvm::ComputeNumSignBits(Op, DL, Depth, &AC, CxtI, &DT);
+    return llvm::ComputeNumSignBits(Op, DL, Depth, &AC, CxtI, &DT, VTC);
   }
   OverflowResult computeOverflowForUnsignedMul(const Value *LHS,
                                                const Value *RHS,
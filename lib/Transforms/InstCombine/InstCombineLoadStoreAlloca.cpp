@@ -190,7 +190,7 @@ static Instruction *simplifyAllocaArraySize(InstCombiner &IC, AllocaInst &AI) {
 
     // Canonicalize it.
     Value *V = IC.Builder.getInt32(1);
-    AI.setOperand(0, V);
+    IC.replaceOperand(AI, 0, V);
     return &AI;
   }
 
@@ -230,7 +230,7 @@ static Instruction *simplifyAllocaArraySize(InstCombiner &IC, AllocaInst &AI) {
   Type *IntPtrTy = IC.getDataLayout().getIntPtrType(AI.getType());
   if (AI.getArraySize()->getType() != IntPtrTy) {
     Value *V = IC.Builder.CreateIntCast(AI.getArraySize(), IntPtrTy, false);
-    AI.setOperand(0, V);
+    IC.replaceOperand(AI, 0, V);
     return &AI;
   }
 
@@ -355,7 +355,8 @@ Instruction *InstCombiner::visitAllocaInst(AllocaInst &AI) {
       // This is helpful if the array size is a complicated expression not used
       // elsewhere.
       if (AI.isArrayAllocation()) {
-        AI.setOperand(0, ConstantInt::get(AI.getArraySize()->getType(), 1));
+        replaceOperand(AI, 0,
+                       ConstantInt::get(AI.getArraySize()->getType(), 1));
         return &AI;
       }
 
@@ -923,7 +924,7 @@ static Instruction *replaceGEPIdxWithZero(InstCombiner &IC, Value *Ptr,
       NewGEPI->setOperand(Idx,
         ConstantInt::get(GEPI->getOperand(Idx)->getType(), 0));
       NewGEPI->insertBefore(GEPI);
-      MemI.setOperand(MemI.getPointerOperandIndex(), NewGEPI);
+      IC.replaceOperand(MemI, MemI.getPointerOperandIndex(), NewGEPI);
       return NewGEPI;
     }
   }
@@ -1035,14 +1036,14 @@ Instruction *InstCombiner::visitLoadInst(LoadInst &LI) {
       // load (select (cond, null, P)) -> load P
       if (isa<ConstantPointerNull>(SI->getOperand(1)) &&
           LI.getPointerAddressSpace() == 0) {
-        LI.setOperand(0, SI->getOperand(2));
+        replaceOperand(LI, 0, SI->getOperand(2));
         return &LI;
       }
 
       // load (select (cond, P, null)) -> load P
       if (isa<ConstantPointerNull>(SI->getOperand(2)) &&
           LI.getPointerAddressSpace() == 0) {
-        LI.setOperand(0, SI->getOperand(1));
+        replaceOperand(LI, 0, SI->getOperand(1));
         return &LI;
       }
     }
@@ -1394,7 +1395,7 @@ Instruction *InstCombiner::visitStoreInst(StoreInst &SI) {
   // store X, null    -> turns into 'unreachable' in SimplifyCFG
   if (isa<ConstantPointerNull>(Ptr) && SI.getPointerAddressSpace() == 0) {
     if (!isa<UndefValue>(Val)) {
-      SI.setOperand(0, UndefValue::get(Val->getType()));
+      replaceOperand(SI, 0, UndefValue::get(Val->getType()));
       if (Instruction *U = dyn_cast<Instruction>(Val))
         Worklist.Add(U);  // Dropped a use.
     }
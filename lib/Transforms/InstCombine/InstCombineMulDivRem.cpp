@@ -51,7 +51,7 @@ static Value *simplifyValueKnownNonZero(Value *V, InstCombiner &IC,
     // We know that this is an exact/nuw shift and that the input is a
     // non-zero context as well.
     if (Value *V2 = simplifyValueKnownNonZero(I->getOperand(0), IC, CxtI)) {
-      I->setOperand(0, V2);
+      IC.replaceOperand(*I, 0, V2);
       MadeChange = true;
     }
 
@@ -700,7 +700,7 @@ Instruction *InstCombiner::visitFMul(BinaryOperator &I) {
     if (OpX && OpY) {
       BuilderTy::FastMathFlagGuard Guard(Builder);
       Builder.setFastMathFlags(Log2->getFastMathFlags());
-      Log2->setArgOperand(0, OpY);
+      replaceOperand(*Log2, 0, OpY);
       Value *FMulVal = Builder.CreateFMul(OpX, Log2);
       Value *FSub = Builder.CreateFSub(FMulVal, OpX);
       FSub->takeName(&I);
@@ -794,7 +794,7 @@ bool InstCombiner::SimplifyDivRemOfSelect(BinaryOperator &I) {
   Value *SelectCond = SI->getOperand(0);
 
   // Change the div/rem to use 'Y' instead of the select.
-  I.setOperand(1, SI->getOperand(NonNullOperand));
+  replaceOperand(I, 1, SI->getOperand(NonNullOperand));
 
   // Okay, we know we replace the operand of the div/rem with 'Y' with no
   // problem.  However, the select, or the condition of the select may have
@@ -853,7 +853,7 @@ Instruction *InstCombiner::commonIDivTransforms(BinaryOperator &I) {
 
   // The RHS is known non-zero.
   if (Value *V = simplifyValueKnownNonZero(I.getOperand(1), *this, I)) {
-    I.setOperand(1, V);
+    replaceOperand(I, 1, V);
     return &I;
   }
 
@@ -1412,8 +1412,8 @@ Instruction *InstCombiner::visitFDiv(BinaryOperator &I) {
 
   // -x / -y -> x / y
   if (match(Op0, m_FNeg(m_Value(LHS))) && match(Op1, m_FNeg(m_Value(RHS)))) {
-    I.setOperand(0, LHS);
-    I.setOperand(1, RHS);
+    replaceOperand(I, 0, LHS);
+    replaceOperand(I, 1, RHS);
     return &I;
   }
 
@@ -1429,7 +1429,7 @@ Instruction *InstCombiner::commonIRemTransforms(BinaryOperator &I) {
 
   // The RHS is known non-zero.
   if (Value *V = simplifyValueKnownNonZero(I.getOperand(1), *this, I)) {
-    I.setOperand(1, V);
+    replaceOperand(I, 1, V);
     return &I;
   }
 
@@ -1526,7 +1526,7 @@ Instruction *InstCombiner::visitSRem(BinaryOperator &I) {
     // X % -Y -> X % Y
     if (match(Op1, m_APInt(Y)) && Y->isNegative() && !Y->isMinSignedValue()) {
       Worklist.AddValue(I.getOperand(1));
-      I.setOperand(1, ConstantInt::get(I.getType(), -*Y));
+      replaceOperand(I, 1, ConstantInt::get(I.getType(), -*Y));
       return &I;
     }
   }
@@ -1572,7 +1572,7 @@ Instruction *InstCombiner::visitSRem(BinaryOperator &I) {
       Constant *NewRHSV = ConstantVector::get(Elts);
       if (NewRHSV != C) {  // Don't loop on -MININT
         Worklist.AddValue(I.getOperand(1));
-        I.setOperand(1, NewRHSV);
+        replaceOperand(I, 1, NewRHSV);
         return &I;
       }
     }
@@ -459,7 +459,7 @@ static Value *foldSelectCttzCtlz(ICmpInst *ICI, Value *TrueVal, Value *FalseVal,
 /// Return true if we find and adjust an icmp+select pattern where the compare
 /// is with a constant that can be incremented or decremented to match the
 /// minimum or maximum idiom.
-static bool adjustMinMax(SelectInst &Sel, ICmpInst &Cmp) {
+static bool adjustMinMax(SelectInst &Sel, ICmpInst &Cmp, InstCombiner &IC) {
   ICmpInst::Predicate Pred = Cmp.getPredicate();
   Value *CmpLHS = Cmp.getOperand(0);
   Value *CmpRHS = Cmp.getOperand(1);
@@ -536,10 +536,10 @@ static bool adjustMinMax(SelectInst &Sel, ICmpInst &Cmp) {
   CmpRHS = AdjustedRHS;
   std::swap(FalseVal, TrueVal);
   Cmp.setPredicate(Pred);
-  Cmp.setOperand(0, CmpLHS);
-  Cmp.setOperand(1, CmpRHS);
-  Sel.setOperand(1, TrueVal);
-  Sel.setOperand(2, FalseVal);
+  IC.replaceOperand(Cmp, 0, CmpLHS);
+  IC.replaceOperand(Cmp, 1, CmpRHS);
+  IC.replaceOperand(Sel, 1, TrueVal);
+  IC.replaceOperand(Sel, 2, FalseVal);
   Sel.swapProfMetadata();
 
   // Move the compare instruction right before the select instruction. Otherwise
@@ -600,7 +600,7 @@ Instruction *InstCombiner::foldSelectInstWithICmp(SelectInst &SI,
   if (Instruction *NewSel = canonicalizeMinMaxWithConstant(SI, *ICI, Builder))
     return NewSel;
 
-  bool Changed = adjustMinMax(SI, *ICI);
+  bool Changed = adjustMinMax(SI, *ICI, *this);
 
   ICmpInst::Predicate Pred = ICI->getPredicate();
   Value *CmpLHS = ICI->getOperand(0);
@@ -644,11 +644,11 @@ Instruction *InstCombiner::foldSelectInstWithICmp(SelectInst &SI,
   if (CmpRHS != CmpLHS && isa<Constant>(CmpRHS)) {
     if (CmpLHS == TrueVal && Pred == ICmpInst::ICMP_EQ) {
       // Transform (X == C) ? X : Y -> (X == C) ? C : Y
-      SI.setOperand(1, CmpRHS);
+      replaceOperand(SI, 1, CmpRHS);
       Changed = true;
     } else if (CmpLHS == FalseVal && Pred == ICmpInst::ICMP_NE) {
       // Transform (X != C) ? Y : X -> (X != C) ? Y : C
-      SI.setOperand(2, CmpRHS);
+      replaceOperand(SI, 2, CmpRHS);
       Changed = true;
     }
   }
@@ -1174,8 +1174,8 @@ Instruction *InstCombiner::visitSelectInst(SelectInst &SI) {
     // Swap true/false values and condition.
     CmpInst *Cond = cast<CmpInst>(CondVal);
     Cond->setPredicate(CmpInst::getInversePredicate(Pred));
-    SI.setOperand(1, FalseVal);
-    SI.setOperand(2, TrueVal);
+    replaceOperand(SI, 1, FalseVal);
+    replaceOperand(SI, 2, TrueVal);
     SI.swapProfMetadata();
     Worklist.Add(Cond);
     return &SI;
@@ -1452,7 +1452,7 @@ Instruction *InstCombiner::visitSelectInst(SelectInst &SI) {
       if (TrueSI->getCondition() == CondVal) {
         if (SI.getTrueValue() == TrueSI->getTrueValue())
           return nullptr;
-        SI.setOperand(1, TrueSI->getTrueValue());
+        replaceOperand(SI, 1, TrueSI->getTrueValue());
         return &SI;
       }
       // select(C0, select(C1, a, b), b) -> select(C0&C1, a, b)
@@ -1460,8 +1460,8 @@ Instruction *InstCombiner::visitSelectInst(SelectInst &SI) {
       // paths for the values (this helps GetUnderlyingObjects() for example).
       if (TrueSI->getFalseValue() == FalseVal && TrueSI->hasOneUse()) {
         Value *And = Builder.CreateAnd(CondVal, TrueSI->getCondition());
-        SI.setOperand(0, And);
-        SI.setOperand(1, TrueSI->getTrueValue());
+        replaceOperand(SI, 0, And);
+        replaceOperand(SI, 1, TrueSI->getTrueValue());
         return &SI;
       }
     }
@@ -1472,23 +1472,23 @@ Instruction *InstCombiner::visitSelectInst(SelectInst &SI) {
       if (FalseSI->getCondition() == CondVal) {
         if (SI.getFalseValue() == FalseSI->getFalseValue())
           return nullptr;
-        SI.setOperand(2, FalseSI->getFalseValue());
+        replaceOperand(SI, 2, FalseSI->getFalseValue());
         return &SI;
       }
       // select(C0, a, select(C1, a, b)) -> select(C0|C1, a, b)
       if (FalseSI->getTrueValue() == TrueVal && FalseSI->hasOneUse()) {
         Value *Or = Builder.CreateOr(CondVal, FalseSI->getCondition());
-        SI.setOperand(0, Or);
-        SI.setOperand(2, FalseSI->getFalseValue());
+        replaceOperand(SI, 0, Or);
+        replaceOperand(SI, 2, FalseSI->getFalseValue());
         return &SI;
       }
     }
   }
 
   if (BinaryOperator::isNot(CondVal)) {
-    SI.setOperand(0, BinaryOperator::getNotArgument(CondVal));
-    SI.setOperand(1, FalseVal);
-    SI.setOperand(2, TrueVal);
+    replaceOperand(SI, 0, BinaryOperator::getNotArgument(CondVal));
+    replaceOperand(SI, 1, FalseVal);
+    replaceOperand(SI, 2, TrueVal);
     return &SI;
   }
 
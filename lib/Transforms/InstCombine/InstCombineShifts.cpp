@@ -58,7 +58,7 @@ Instruction *InstCombiner::commonShiftTransforms(BinaryOperator &I) {
     // demand the sign bit (and many others) here??
     Value *Rem = Builder.CreateAnd(A, ConstantInt::get(I.getType(), *B - 1),
                                    Op1->getName());
-    I.setOperand(1, Rem);
+    replaceOperand(I, 1, Rem);
     return &I;
   }
 
@@ -280,10 +280,10 @@ static Value *getShiftedValue(Value *V, unsigned NumBits, bool isLeftShift,
   case Instruction::Or:
   case Instruction::Xor:
     // Bitwise operators can all arbitrarily be arbitrarily evaluated shifted.
-    I->setOperand(
-        0, getShiftedValue(I->getOperand(0), NumBits, isLeftShift, IC, DL));
-    I->setOperand(
-        1, getShiftedValue(I->getOperand(1), NumBits, isLeftShift, IC, DL));
+    IC.replaceOperand(*I, 0, getShiftedValue(I->getOperand(0), NumBits,
+                                             isLeftShift, IC, DL));
+    IC.replaceOperand(*I, 1, getShiftedValue(I->getOperand(1), NumBits,
+                                             isLeftShift, IC, DL));
     return I;
 
   case Instruction::Shl:
@@ -292,10 +292,10 @@ static Value *getShiftedValue(Value *V, unsigned NumBits, bool isLeftShift,
                             IC.Builder);
 
   case Instruction::Select:
-    I->setOperand(
-        1, getShiftedValue(I->getOperand(1), NumBits, isLeftShift, IC, DL));
-    I->setOperand(
-        2, getShiftedValue(I->getOperand(2), NumBits, isLeftShift, IC, DL));
+    IC.replaceOperand(*I, 1, getShiftedValue(I->getOperand(1), NumBits,
+                                             isLeftShift, IC, DL));
+    IC.replaceOperand(*I, 2, getShiftedValue(I->getOperand(2), NumBits,
+                                             isLeftShift, IC, DL));
     return I;
   case Instruction::PHI: {
     // We can change a phi if we can change all operands.  Note that we never
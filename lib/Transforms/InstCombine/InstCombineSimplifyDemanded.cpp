@@ -27,7 +27,7 @@ using namespace llvm::PatternMatch;
 /// constant integer. If so, check to see if there are any bits set in the
 /// constant that are not demanded. If so, shrink the constant and return true.
 static bool ShrinkDemandedConstant(Instruction *I, unsigned OpNo,
-                                   const APInt &Demanded) {
+                                   const APInt &Demanded, InstCombiner &IC) {
   assert(I && "No instruction?");
   assert(OpNo < I->getNumOperands() && "Operand index too large");
 
@@ -42,7 +42,7 @@ static bool ShrinkDemandedConstant(Instruction *I, unsigned OpNo,
     return false;
 
   // This instruction is producing bits that are not demanded. Shrink the RHS.
-  I->setOperand(OpNo, ConstantInt::get(Op->getType(), *C & Demanded));
+  IC.replaceOperand(*I, OpNo, ConstantInt::get(Op->getType(), *C & Demanded));
 
   return true;
 }
@@ -179,7 +179,7 @@ Value *InstCombiner::SimplifyDemandedUseBits(Value *V, APInt DemandedMask,
       return I->getOperand(1);
 
     // If the RHS is a constant, see if we can simplify it.
-    if (ShrinkDemandedConstant(I, 1, DemandedMask & ~LHSKnown.Zero))
+    if (ShrinkDemandedConstant(I, 1, DemandedMask & ~LHSKnown.Zero, *this))
       return I;
 
     Known.Zero = std::move(IKnownZero);
@@ -213,7 +213,7 @@ Value *InstCombiner::SimplifyDemandedUseBits(Value *V, APInt DemandedMask,
       return I->getOperand(1);
 
     // If the RHS is a constant, see if we can simplify it.
-    if (ShrinkDemandedConstant(I, 1, DemandedMask))
+    if (ShrinkDemandedConstant(I, 1, DemandedMask, *this))
       return I;
 
     Known.Zero = std::move(IKnownZero);
@@ -270,7 +270,7 @@ Value *InstCombiner::SimplifyDemandedUseBits(Value *V, APInt DemandedMask,
 
     // If the RHS is a constant, see if we can simplify it.
     // FIXME: for XOR, we prefer to force bits to 1 if they will make a -1.
-    if (ShrinkDemandedConstant(I, 1, DemandedMask))
+    if (ShrinkDemandedConstant(I, 1, DemandedMask, *this))
       return I;
 
     // If our LHS is an 'and' and if it has one use, and if any of the bits we
@@ -317,8 +317,8 @@ Value *InstCombiner::SimplifyDemandedUseBits(Value *V, APInt DemandedMask,
     assert(!LHSKnown.hasConflict() && "Bits known to be one AND zero?");
 
     // If the operands are constants, see if we can simplify them.
-    if (ShrinkDemandedConstant(I, 1, DemandedMask) ||
-        ShrinkDemandedConstant(I, 2, DemandedMask))
+    if (ShrinkDemandedConstant(I, 1, DemandedMask, *this) ||
+        ShrinkDemandedConstant(I, 2, DemandedMask, *this))
       return I;
 
     // Only known if known in both the LHS and RHS.
@@ -400,9 +400,9 @@ Value *InstCombiner::SimplifyDemandedUseBits(Value *V, APInt DemandedMask,
       // Right fill the mask of bits for this ADD/SUB to demand the most
       // significant bit and all those below it.
       APInt DemandedFromOps(APInt::getLowBitsSet(BitWidth, BitWidth-NLZ));
-      if (ShrinkDemandedConstant(I, 0, DemandedFromOps) ||
+      if (ShrinkDemandedConstant(I, 0, DemandedFromOps, *this) ||
           SimplifyDemandedBits(I, 0, DemandedFromOps, LHSKnown, Depth + 1) ||
-          ShrinkDemandedConstant(I, 1, DemandedFromOps) ||
+          ShrinkDemandedConstant(I, 1, DemandedFromOps, *this) ||
           SimplifyDemandedBits(I, 1, DemandedFromOps, RHSKnown, Depth + 1)) {
         // Disable the nsw and nuw flags here: We can no longer guarantee that
         // we won't wrap after simplification. Removing the nsw/nuw flags is
@@ -989,7 +989,7 @@ Value *InstCombiner::SimplifyDemandedVectorElts(Value *V, APInt DemandedElts,
       // which elt is getting updated.
       TmpV = SimplifyDemandedVectorElts(I->getOperand(0), DemandedElts,
                                         UndefElts2, Depth + 1);
-      if (TmpV) { I->setOperand(0, TmpV); MadeChange = true; }
+      if (TmpV) { replaceOperand(*I, 0, TmpV); MadeChange = true; }
       break;
     }
 
@@ -1007,7 +1007,7 @@ Value *InstCombiner::SimplifyDemandedVectorElts(Value *V, APInt DemandedElts,
     DemandedElts2.clearBit(IdxNo);
     TmpV = SimplifyDemandedVectorElts(I->getOperand(0), DemandedElts2,
                                       UndefElts, Depth + 1);
-    if (TmpV) { I->setOperand(0, TmpV); MadeChange = true; }
+    if (TmpV) { replaceOperand(*I, 0, TmpV); MadeChange = true; }
 
     // The inserted element is defined.
     UndefElts.clearBit(IdxNo);
@@ -1035,12 +1035,12 @@ Value *InstCombiner::SimplifyDemandedVectorElts(Value *V, APInt DemandedElts,
     APInt LHSUndefElts(LHSVWidth, 0);
     TmpV = SimplifyDemandedVectorElts(I->getOperand(0), LeftDemanded,
                                       LHSUndefElts, Depth + 1);
-    if (TmpV) { I->setOperand(0, TmpV); MadeChange = true; }
+    if (TmpV) { replaceOperand(*I, 0, TmpV); MadeChange = true; }
 
     APInt RHSUndefElts(LHSVWidth, 0);
     TmpV = SimplifyDemandedVectorElts(I->getOperand(1), RightDemanded,
                                       RHSUndefElts, Depth + 1);
-    if (TmpV) { I->setOperand(1, TmpV); MadeChange = true; }
+    if (TmpV) { replaceOperand(*I, 1, TmpV); MadeChange = true; }
 
     bool NewUndefElts = false;
     unsigned LHSIdx = -1u, LHSValIdx = -1u;
@@ -1118,7 +1118,7 @@ Value *InstCombiner::SimplifyDemandedVectorElts(Value *V, APInt DemandedElts,
           Elts.push_back(ConstantInt::get(Type::getInt32Ty(I->getContext()),
                                           Shuffle->getMaskValue(i)));
       }
-      I->setOperand(2, ConstantVector::get(Elts));
+      replaceOperand(*I, 2, ConstantVector::get(Elts));
       MadeChange = true;
     }
     break;
@@ -1142,11 +1142,11 @@ Value *InstCombiner::SimplifyDemandedVectorElts(Value *V, APInt DemandedElts,
 
     TmpV = SimplifyDemandedVectorElts(I->getOperand(1), LeftDemanded, UndefElts,
                                       Depth + 1);
-    if (TmpV) { I->setOperand(1, TmpV); MadeChange = true; }
+    if (TmpV) { replaceOperand(*I, 1, TmpV); MadeChange = true; }
 
     TmpV = SimplifyDemandedVectorElts(I->getOperand(2), RightDemanded,
                                       UndefElts2, Depth + 1);
-    if (TmpV) { I->setOperand(2, TmpV); MadeChange = true; }
+    if (TmpV) { replaceOperand(*I, 2, TmpV); MadeChange = true; }
 
     // Output elements are undefined if both are undefined.
     UndefElts &= UndefElts2;
@@ -1191,7 +1191,7 @@ Value *InstCombiner::SimplifyDemandedVectorElts(Value *V, APInt DemandedElts,
     TmpV = SimplifyDemandedVectorElts(I->getOperand(0), InputDemandedElts,
                                       UndefElts2, Depth + 1);
     if (TmpV) {
-      I->setOperand(0, TmpV);
+      replaceOperand(*I, 0, TmpV);
       MadeChange = true;
     }
 
@@ -1227,10 +1227,10 @@ Value *InstCombiner::SimplifyDemandedVectorElts(Value *V, APInt DemandedElts,
     // div/rem demand all inputs, because they don't want divide by zero.
     TmpV = SimplifyDemandedVectorElts(I->getOperand(0), DemandedElts, UndefElts,
                                       Depth + 1);
-    if (TmpV) { I->setOperand(0, TmpV); MadeChange = true; }
+    if (TmpV) { replaceOperand(*I, 0, TmpV); MadeChange = true; }
     TmpV = SimplifyDemandedVectorElts(I->getOperand(1), DemandedElts,
                                       UndefElts2, Depth + 1);
-    if (TmpV) { I->setOperand(1, TmpV); MadeChange = true; }
+    if (TmpV) { replaceOperand(*I, 1, TmpV); MadeChange = true; }
 
     // Output elements are undefined if both are undefined.  Consider things
     // like undef&0.  The result is known zero, not undef.
@@ -1240,7 +1240,7 @@ Value *InstCombiner::SimplifyDemandedVectorElts(Value *V, APInt DemandedElts,
   case Instruction::FPExt:
     TmpV = SimplifyDemandedVectorElts(I->getOperand(0), DemandedElts, UndefElts,
                                       Depth + 1);
-    if (TmpV) { I->setOperand(0, TmpV); MadeChange = true; }
+    if (TmpV) { replaceOperand(*I, 0, TmpV); MadeChange = true; }
     break;
 
   case Instruction::Call: {
@@ -1264,7 +1264,7 @@ Value *InstCombiner::SimplifyDemandedVectorElts(Value *V, APInt DemandedElts,
       DemandedElts = 1;
       TmpV = SimplifyDemandedVectorElts(II->getArgOperand(0), DemandedElts,
                                         UndefElts, Depth + 1);
-      if (TmpV) { II->setArgOperand(0, TmpV); MadeChange = true; }
+      if (TmpV) { replaceOperand(*II, 0, TmpV); MadeChange = true; }
 
       // Only the lower element is undefined. The high elements are zero.
       UndefElts = UndefElts[0];
@@ -1277,7 +1277,7 @@ Value *InstCombiner::SimplifyDemandedVectorElts(Value *V, APInt DemandedElts,
     case Intrinsic::x86_sse2_sqrt_sd:
       TmpV = SimplifyDemandedVectorElts(II->getArgOperand(0), DemandedElts,
                                         UndefElts, Depth + 1);
-      if (TmpV) { II->setArgOperand(0, TmpV); MadeChange = true; }
+      if (TmpV) { replaceOperand(*II, 0, TmpV); MadeChange = true; }
 
       // If lowest element of a scalar op isn't used then use Arg0.
       if (!DemandedElts[0]) {
@@ -1299,7 +1299,7 @@ Value *InstCombiner::SimplifyDemandedVectorElts(Value *V, APInt DemandedElts,
     case Intrinsic::x86_sse2_cmp_sd: {
       TmpV = SimplifyDemandedVectorElts(II->getArgOperand(0), DemandedElts,
                                         UndefElts, Depth + 1);
-      if (TmpV) { II->setArgOperand(0, TmpV); MadeChange = true; }
+      if (TmpV) { replaceOperand(*II, 0, TmpV); MadeChange = true; }
 
       // If lowest element of a scalar op isn't used then use Arg0.
       if (!DemandedElts[0]) {
@@ -1311,7 +1311,7 @@ Value *InstCombiner::SimplifyDemandedVectorElts(Value *V, APInt DemandedElts,
       DemandedElts = 1;
       TmpV = SimplifyDemandedVectorElts(II->getArgOperand(1), DemandedElts,
                                         UndefElts2, Depth + 1);
-      if (TmpV) { II->setArgOperand(1, TmpV); MadeChange = true; }
+      if (TmpV) { replaceOperand(*II, 1, TmpV); MadeChange = true; }
 
       // Lower element is undefined if both lower elements are undefined.
       // Consider things like undef&0.  The result is known zero, not undef.
@@ -1330,7 +1330,7 @@ Value *InstCombiner::SimplifyDemandedVectorElts(Value *V, APInt DemandedElts,
       DemandedElts2.clearBit(0);
       TmpV = SimplifyDemandedVectorElts(II->getArgOperand(0), DemandedElts2,
                                         UndefElts, Depth + 1);
-      if (TmpV) { II->setArgOperand(0, TmpV); MadeChange = true; }
+      if (TmpV) { replaceOperand(*II, 0, TmpV); MadeChange = true; }
 
       // If lowest element of a scalar op isn't used then use Arg0.
       if (!DemandedElts[0]) {
@@ -1342,7 +1342,7 @@ Value *InstCombiner::SimplifyDemandedVectorElts(Value *V, APInt DemandedElts,
       DemandedElts = 1;
       TmpV = SimplifyDemandedVectorElts(II->getArgOperand(1), DemandedElts,
                                         UndefElts2, Depth + 1);
-      if (TmpV) { II->setArgOperand(1, TmpV); MadeChange = true; }
+      if (TmpV) { replaceOperand(*II, 1, TmpV); MadeChange = true; }
 
       // Take the high undef elements from operand 0 and take the lower element
       // from operand 1.
@@ -1380,7 +1380,7 @@ Value *InstCombiner::SimplifyDemandedVectorElts(Value *V, APInt DemandedElts,
     case Intrinsic::x86_avx512_maskz_vfmadd_sd:
       TmpV = SimplifyDemandedVectorElts(II->getArgOperand(0), DemandedElts,
                                         UndefElts, Depth + 1);
-      if (TmpV) { II->setArgOperand(0, TmpV); MadeChange = true; }
+      if (TmpV) { replaceOperand(*II, 0, TmpV); MadeChange = true; }
 
       // If lowest element of a scalar op isn't used then use Arg0.
       if (!DemandedElts[0]) {
@@ -1392,10 +1392,10 @@ Value *InstCombiner::SimplifyDemandedVectorElts(Value *V, APInt DemandedElts,
       DemandedElts = 1;
       TmpV = SimplifyDemandedVectorElts(II->getArgOperand(1), DemandedElts,
                                         UndefElts2, Depth + 1);
-      if (TmpV) { II->setArgOperand(1, TmpV); MadeChange = true; }
+      if (TmpV) { replaceOperand(*II, 1, TmpV); MadeChange = true; }
       TmpV = SimplifyDemandedVectorElts(II->getArgOperand(2), DemandedElts,
                                         UndefElts3, Depth + 1);
-      if (TmpV) { II->setArgOperand(2, TmpV); MadeChange = true; }
+      if (TmpV) { replaceOperand(*II, 2, TmpV); MadeChange = true; }
 
       // Lower element is undefined if all three lower elements are undefined.
       // Consider things like undef&0.  The result is known zero, not undef.
@@ -1413,7 +1413,7 @@ Value *InstCombiner::SimplifyDemandedVectorElts(Value *V, APInt DemandedElts,
       // These intrinsics get the passthru bits from operand 2.
       TmpV = SimplifyDemandedVectorElts(II->getArgOperand(2), DemandedElts,
                                         UndefElts, Depth + 1);
-      if (TmpV) { II->setArgOperand(2, TmpV); MadeChange = true; }
+      if (TmpV) { replaceOperand(*II, 2, TmpV); MadeChange = true; }
 
       // If lowest element of a scalar op isn't used then use Arg2.
       if (!DemandedElts[0]) {
@@ -1425,10 +1425,10 @@ Value *InstCombiner::SimplifyDemandedVectorElts(Value *V, APInt DemandedElts,
       DemandedElts = 1;
       TmpV = SimplifyDemandedVectorElts(II->getArgOperand(0), DemandedElts,
                                         UndefElts2, Depth + 1);
-      if (TmpV) { II->setArgOperand(0, TmpV); MadeChange = true; }
+      if (TmpV) { replaceOperand(*II, 0, TmpV); MadeChange = true; }
       TmpV = SimplifyDemandedVectorElts(II->getArgOperand(1), DemandedElts,
                                         UndefElts3, Depth + 1);
-      if (TmpV) { II->setArgOperand(1, TmpV); MadeChange = true; }
+      if (TmpV) { replaceOperand(*II, 1, TmpV); MadeChange = true; }
 
       // Lower element is undefined if all three lower elements are undefined.
       // Consider things like undef&0.  The result is known zero, not undef.
@@ -1456,12 +1456,12 @@ Value *InstCombiner::SimplifyDemandedVectorElts(Value *V, APInt DemandedElts,
       UndefElts2 = APInt(InnerVWidth, 0);
       TmpV = SimplifyDemandedVectorElts(Op0, InnerDemandedElts, UndefElts2,
                                         Depth + 1);
-      if (TmpV) { II->setArgOperand(0, TmpV); MadeChange = true; }
+      if (TmpV) { replaceOperand(*II, 0, TmpV); MadeChange = true; }
 
       UndefElts3 = APInt(InnerVWidth, 0);
       TmpV = SimplifyDemandedVectorElts(Op1, InnerDemandedElts, UndefElts3,
                                         Depth + 1);
-      if (TmpV) { II->setArgOperand(1, TmpV); MadeChange = true; }
+      if (TmpV) { replaceOperand(*II, 1, TmpV); MadeChange = true; }
 
       break;
     }
@@ -1507,7 +1507,7 @@ Value *InstCombiner::SimplifyDemandedVectorElts(Value *V, APInt DemandedElts,
         TmpV = SimplifyDemandedVectorElts(Op, OpDemandedElts, OpUndefElts,
                                           Depth + 1);
         if (TmpV) {
-          II->setArgOperand(OpNum, TmpV);
+          replaceOperand(*II, OpNum, TmpV);
           MadeChange = true;
         }
 
@@ -1540,7 +1540,7 @@ Value *InstCombiner::SimplifyDemandedVectorElts(Value *V, APInt DemandedElts,
       Value *Op1 = II->getArgOperand(1);
       TmpV = SimplifyDemandedVectorElts(Op1, DemandedElts, UndefElts,
                                         Depth + 1);
-      if (TmpV) { II->setArgOperand(1, TmpV); MadeChange = true; }
+      if (TmpV) { replaceOperand(*II, 1, TmpV); MadeChange = true; }
       break;
     }
 
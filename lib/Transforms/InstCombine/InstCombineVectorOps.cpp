@@ -173,7 +173,7 @@ Instruction *InstCombiner::visitExtractElementInst(ExtractElementInst &EI) {
       DemandedMask.setBit(IndexVal);
       if (Value *V = SimplifyDemandedVectorElts(EI.getOperand(0), DemandedMask,
                                                 UndefElts)) {
-        EI.setOperand(0, V);
+        replaceOperand(EI, 0, V);
         return &EI;
       }
     }
@@ -220,7 +220,7 @@ Instruction *InstCombiner::visitExtractElementInst(ExtractElementInst &EI) {
       // be the same value, extract from the pre-inserted value instead.
       if (isa<Constant>(IE->getOperand(2)) && isa<Constant>(EI.getOperand(1))) {
         Worklist.AddValue(EI.getOperand(0));
-        EI.setOperand(0, IE->getOperand(0));
+        replaceOperand(EI, 0, IE->getOperand(0));
         return &EI;
       }
     } else if (ShuffleVectorInst *SVI = dyn_cast<ShuffleVectorInst>(I)) {
@@ -1187,9 +1187,9 @@ Instruction *InstCombiner::visitShuffleVectorInst(ShuffleVectorInst &SVI) {
         Elts.push_back(ConstantInt::get(Int32Ty, Mask[i]));
       }
     }
-    SVI.setOperand(0, SVI.getOperand(1));
-    SVI.setOperand(1, UndefValue::get(RHS->getType()));
-    SVI.setOperand(2, ConstantVector::get(Elts));
+    replaceOperand(SVI, 0, SVI.getOperand(1));
+    replaceOperand(SVI, 1, UndefValue::get(RHS->getType()));
+    replaceOperand(SVI, 2, ConstantVector::get(Elts));
     LHS = SVI.getOperand(0);
     RHS = SVI.getOperand(1);
     MadeChange = true;
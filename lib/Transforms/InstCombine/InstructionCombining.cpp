@@ -35,6 +35,7 @@
 
 #include "InstCombineInternal.h"
 #include "llvm-c/Initialization.h"
+#include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/StringSwitch.h"
@@ -60,6 +61,7 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/KnownBits.h"
+#include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/InstCombine/InstCombine.h"
 #include "llvm/Transforms/Scalar.h"
@@ -78,6 +80,17 @@ STATISTIC(NumSunkInst , "Number of instructions sunk");
 STATISTIC(NumExpand,    "Number of expansions");
 STATISTIC(NumFactor   , "Number of factorizations");
 STATISTIC(NumReassoc  , "Number of reassociations");
+STATISTIC(NumWorklistIterations,
+          "Number of instruction combining iterations performed");
+STATISTIC(NumIncrementalIterations,
+          "Number of iterations seeded only from changed instructions");
+STATISTIC(NumOneIteration, "Number of functions with one iteration");
+STATISTIC(NumTwoIterations, "Number of functions with two iterations");
+STATISTIC(NumThreeIterations, "Number of functions with three iterations");
+STATISTIC(NumFourOrMoreIterations,
+          "Number of functions with four or more iterations");
+STATISTIC(NumIterationLimitReached,
+          "Number of functions that hit the iteration limit");
 
 static cl::opt<bool>
 EnableExpensiveCombines("expensive-combines",
@@ -87,6 +100,23 @@ static cl::opt<unsigned>
 MaxArraySize("instcombine-maxarray-size", cl::init(1024),
              cl::desc("Maximum array size considered when doing a combine"));
 
+static cl::opt<unsigned> MaxIterations(
+    "instcombine-max-iterations", cl::init(1000), cl::Hidden,
+    cl::desc("Maximum number of worklist iterations per function"));
+
+static cl::opt<bool> IncrementalIterations(
+    "instcombine-incremental", cl::init(true), cl::Hidden,
+    cl::desc("Seed iterations after the first only from the instructions "
+             "changed by the previous one"));
+
+static cl::opt<bool> CacheValueTracking(
+    "instcombine-cache-value-tracking", cl::init(false), cl::Hidden,
+    cl::desc("Reuse known bits, sign bits and non-zero results across "
+             "visits that do not change the IR"));
+
+static const char *const TimerGroupName = "instcombine";
+static const char *const TimerGroupDescription = "Instruction Combining";
+
 Value *InstCombiner::EmitGEPOffset(User *GEP) {
   return llvm::EmitGEPOffset(&Builder, DL, GEP);
 }
@@ -175,7 +205,8 @@ static void ClearSubclassDataAfterReassociation(BinaryOperator &I) {
 /// cast to eliminate one of the associative operations:
 /// (op (cast (op X, C2)), C1) --> (cast (op X, op (C1, C2)))
 /// (op (cast (op X, C2)), C1) --> (op (cast X), op (C1, C2))
-static bool simplifyAssocCastAssoc(BinaryOperator *BinOp1) {
+static bool simplifyAssocCastAssoc(BinaryOperator *BinOp1,
+                                   InstCombiner &IC) {
   auto *Cast = dyn_cast<CastInst>(BinOp1->getOperand(0));
   if (!Cast || !Cast->hasOneUse())
     return false;
@@ -208,8 +239,8 @@ static bool simplifyAssocCastAssoc(BinaryOperator *BinOp1) {
   Type *DestTy = C1->getType();
   Constant *CastC2 = ConstantExpr::getCast(CastOpcode, C2, DestTy);
   Constant *FoldedC = ConstantExpr::get(AssocOpcode, C1, CastC2);
-  Cast->setOperand(0, BinOp2->getOperand(0));
-  BinOp1->setOperand(1, FoldedC);
+  IC.replaceOperand(*Cast, 0, BinOp2->getOperand(0));
+  IC.replaceOperand(*BinOp1, 1, FoldedC);
   return true;
 }
 
@@ -258,8 +289,8 @@ bool InstCombiner::SimplifyAssociativeOrCommutative(BinaryOperator &I) {
         // Does "B op C" simplify?
         if (Value *V = SimplifyBinOp(Opcode, B, C, SQ.getWithInstruction(&I))) {
           // It simplifies to V.  Form "A op V".
-          I.setOperand(0, A);
-          I.setOperand(1, V);
+          replaceOperand(I, 0, A);
+          replaceOperand(I, 1, V);
           // Conservatively clear the optional flags, since they may not be
           // preserved by the reassociation.
           if (MaintainNoSignedWrap(I, B, C) &&
@@ -287,8 +318,8 @@ bool InstCombiner::SimplifyAssociativeOrCommutative(BinaryOperator &I) {
         // Does "A op B" simplify?
         if (Value *V = SimplifyBinOp(Opcode, A, B, SQ.getWithInstruction(&I))) {
           // It simplifies to V.  Form "V op C".
-          I.setOperand(0, V);
-          I.setOperand(1, C);
+          replaceOperand(I, 0, V);
+          replaceOperand(I, 1, C);
           // Conservatively clear the optional flags, since they may not be
           // preserved by the reassociation.
           ClearSubclassDataAfterReassociation(I);
@@ -300,7 +331,7 @@ bool InstCombiner::SimplifyAssociativeOrCommutative(BinaryOperator &I) {
     }
 
     if (I.isAssociative() && I.isCommutative()) {
-      if (simplifyAssocCastAssoc(&I)) {
+      if (simplifyAssocCastAssoc(&I, *this)) {
         Changed = true;
         ++NumReassoc;
         continue;
@@ -315,8 +346,8 @@ bool InstCombiner::SimplifyAssociativeOrCommutative(BinaryOperator &I) {
         // Does "C op A" simplify?
         if (Value *V = SimplifyBinOp(Opcode, C, A, SQ.getWithInstruction(&I))) {
           // It simplifies to V.  Form "V op B".
-          I.setOperand(0, V);
-          I.setOperand(1, B);
+          replaceOperand(I, 0, V);
+          replaceOperand(I, 1, B);
           // Conservatively clear the optional flags, since they may not be
           // preserved by the reassociation.
           ClearSubclassDataAfterReassociation(I);
@@ -335,8 +366,8 @@ bool InstCombiner::SimplifyAssociativeOrCommutative(BinaryOperator &I) {
         // Does "C op A" simplify?
         if (Value *V = SimplifyBinOp(Opcode, C, A, SQ.getWithInstruction(&I))) {
           // It simplifies to V.  Form "B op V".
-          I.setOperand(0, B);
-          I.setOperand(1, V);
+          replaceOperand(I, 0, B);
+          replaceOperand(I, 1, V);
           // Conservatively clear the optional flags, since they may not be
           // preserved by the reassociation.
           ClearSubclassDataAfterReassociation(I);
@@ -368,8 +399,8 @@ bool InstCombiner::SimplifyAssociativeOrCommutative(BinaryOperator &I) {
         }
         InsertNewInstWith(New, I);
         New->takeName(Op1);
-        I.setOperand(0, New);
-        I.setOperand(1, Folded);
+        replaceOperand(I, 0, New);
+        replaceOperand(I, 1, Folded);
         // Conservatively clear the optional flags, since they may not be
         // preserved by the reassociation.
         ClearSubclassDataAfterReassociation(I);
@@ -1321,7 +1352,7 @@ Value *InstCombiner::Descale(Value *Val, APInt Scale, bool &NoSignedWrap) {
   assert(Parent.first->hasOneUse() && "Drilled down when more than one use!");
   assert(Op != Parent.first->getOperand(Parent.second) &&
          "Descaling was a no-op?");
-  Parent.first->setOperand(Parent.second, Op);
+  replaceOperand(*Parent.first, Parent.second, Op);
   Worklist.Add(Parent.first);
 
   // Now work back up the expression correcting nsw flags.  The logic is based
@@ -1598,7 +1629,7 @@ Instruction *InstCombiner::visitGetElementPtrInst(GetElementPtrInst &GEP) {
       NewGEP->setOperand(DI, NewPN);
     }
 
-    GEP.setOperand(0, NewGEP);
+    replaceOperand(GEP, 0, NewGEP);
     PtrOp = NewGEP;
   }
 
@@ -1650,8 +1681,8 @@ Instruction *InstCombiner::visitGetElementPtrInst(GetElementPtrInst &GEP) {
 
       // Update the GEP in place if possible.
       if (Src->getNumOperands() == 2) {
-        GEP.setOperand(0, Src->getOperand(0));
-        GEP.setOperand(1, Sum);
+        replaceOperand(GEP, 0, Src->getOperand(0));
+        replaceOperand(GEP, 1, Sum);
         return &GEP;
       }
       Indices.append(Src->op_begin()+1, Src->op_end()-1);
@@ -1772,7 +1803,7 @@ Instruction *InstCombiner::visitGetElementPtrInst(GetElementPtrInst &GEP) {
             // array.  Because the array type is never stepped over (there
             // is a leading zero) we can fold the cast into this GEP.
             if (StrippedPtrTy->getAddressSpace() == GEP.getAddressSpace()) {
-              GEP.setOperand(0, StrippedPtr);
+              replaceOperand(GEP, 0, StrippedPtr);
               GEP.setSourceElementType(XATy);
               return &GEP;
             }
@@ -2238,7 +2269,7 @@ Instruction *InstCombiner::visitReturnInst(ReturnInst &RI) {
   // determine the value. If so, constant fold it.
   KnownBits Known = computeKnownBits(ResultOp, 0, &RI);
   if (Known.isConstant())
-    RI.setOperand(0, Constant::getIntegerValue(VTy, Known.getConstant()));
+    replaceOperand(RI, 0, Constant::getIntegerValue(VTy, Known.getConstant()));
 
   return nullptr;
 }
@@ -2873,7 +2904,17 @@ static bool TryToSinkInstruction(Instruction *I, BasicBlock *DestBlock) {
 }
 
 bool InstCombiner::run() {
+  // MadeIRChange is reset after every change so that cached ValueTracking
+  // results can be dropped; RunChanged remembers it for the return value.
+  bool RunChanged = false;
   while (!Worklist.isEmpty()) {
+    if (MadeIRChange) {
+      RunChanged = true;
+      MadeIRChange = false;
+      if (VTC)
+        VTC->clear();
+    }
+
     Instruction *I = Worklist.RemoveOne();
     if (I == nullptr) continue;  // skip null values.
 
@@ -2974,6 +3015,13 @@ bool InstCombiner::run() {
     DEBUG(raw_string_ostream SS(OrigI); I->print(SS); OrigI = SS.str(););
     DEBUG(dbgs() << "IC: Visiting: " << OrigI << '\n');
 
+    // A combine that rewrites I in place may drop its uses of these, which
+    // can leave them dead or combinable.
+    SmallVector<Instruction *, 4> OrigOperands;
+    for (Value *Op : I->operands())
+      if (auto *OpI = dyn_cast<Instruction>(Op))
+        OrigOperands.push_back(OpI);
+
     if (Instruction *Result = visit(*I)) {
       ++NumCombined;
       // Should we replace the old instruction with a new one?
@@ -3009,6 +3057,9 @@ bool InstCombiner::run() {
         DEBUG(dbgs() << "IC: Mod = " << OrigI << '\n'
                      << "    New = " << *I << '\n');
 
+        for (Instruction *OpI : OrigOperands)
+          Worklist.AddDeferred(OpI);
+
         // If the instruction was modified, it's possible that it is now dead.
         // if so, remove it.
         if (isInstructionTriviallyDead(I, &TLI)) {
@@ -3023,6 +3074,37 @@ bool InstCombiner::run() {
   }
 
   Worklist.Zap();
+  if (VTC)
+    VTC->clear();
+  return RunChanged || MadeIRChange;
+}
+
+/// \brief Constant fold the constant vector and constant expression operands
+/// of \p Inst, caching the results in \p FoldedConstants.
+static bool
+foldOperandConstants(Instruction *Inst, const DataLayout &DL,
+                     const TargetLibraryInfo *TLI,
+                     DenseMap<Constant *, Constant *> &FoldedConstants) {
+  bool MadeIRChange = false;
+  for (Use &U : Inst->operands()) {
+    if (!isa<ConstantVector>(U) && !isa<ConstantExpr>(U))
+      continue;
+
+    auto *C = cast<Constant>(U);
+    Constant *&FoldRes = FoldedConstants[C];
+    if (!FoldRes)
+      FoldRes = ConstantFoldConstant(C, DL, TLI);
+    if (!FoldRes)
+      FoldRes = C;
+
+    if (FoldRes != C) {
+      DEBUG(dbgs() << "IC: ConstFold operand of: " << *Inst
+                   << "\n    Old = " << *C
+                   << "\n    New = " << *FoldRes << '\n');
+      U = FoldRes;
+      MadeIRChange = true;
+    }
+  }
   return MadeIRChange;
 }
 
@@ -3080,25 +3162,7 @@ static bool AddReachableCodeToWorklist(BasicBlock *BB, const DataLayout &DL,
         }
 
       // See if we can constant fold its operands.
-      for (Use &U : Inst->operands()) {
-        if (!isa<ConstantVector>(U) && !isa<ConstantExpr>(U))
-          continue;
-
-        auto *C = cast<Constant>(U);
-        Constant *&FoldRes = FoldedConstants[C];
-        if (!FoldRes)
-          FoldRes = ConstantFoldConstant(C, DL, TLI);
-        if (!FoldRes)
-          FoldRes = C;
-
-        if (FoldRes != C) {
-          DEBUG(dbgs() << "IC: ConstFold operand of: " << *Inst
-                       << "\n    Old = " << *C
-                       << "\n    New = " << *FoldRes << '\n');
-          U = FoldRes;
-          MadeIRChange = true;
-        }
-      }
+      MadeIRChange |= foldOperandConstants(Inst, DL, TLI, FoldedConstants);
 
       // Skip processing debug intrinsics in InstCombine. Processing these call instructions
       // consumes non-trivial amount of time and provides no value for the optimization.
@@ -3169,6 +3233,48 @@ static bool prepareICWorklistFromFunction(Function &F, const DataLayout &DL,
   return MadeIRChange;
 }
 
+/// \brief Populate the IC worklist with the instructions changed by the
+/// previous iteration, together with their operands and users, which are the
+/// only instructions whose combines could have been enabled by it.
+///
+/// Like the full sweep, this constant folds the operands of the instructions
+/// it adds, since combines may have created new constant expressions.  Sets
+/// \p MadeIRChange if it folded any.
+///
+/// Returns false, leaving the worklist empty, if a terminator is involved: a
+/// branch condition may have become constant, so the function needs a full
+/// prepareICWorklistFromFunction sweep to prune dead blocks.
+static bool prepareICWorklistFromChanges(ArrayRef<Instruction *> Changed,
+                                         const DataLayout &DL,
+                                         TargetLibraryInfo *TLI,
+                                         InstCombineWorklist &ICWorklist,
+                                         bool &MadeIRChange) {
+  SmallSetVector<Instruction *, 64> Seeds;
+  for (Instruction *I : Changed) {
+    if (isa<TerminatorInst>(I))
+      return false;
+    // Like the full sweep, leave debug intrinsics alone.
+    if (isa<DbgInfoIntrinsic>(I))
+      continue;
+    Seeds.insert(I);
+    for (Value *Op : I->operands())
+      if (auto *OpI = dyn_cast<Instruction>(Op))
+        Seeds.insert(OpI);
+    for (User *U : I->users()) {
+      if (isa<TerminatorInst>(U))
+        return false;
+      Seeds.insert(cast<Instruction>(U));
+    }
+  }
+
+  DenseMap<Constant *, Constant *> FoldedConstants;
+  for (Instruction *I : Seeds)
+    MadeIRChange |= foldOperandConstants(I, DL, TLI, FoldedConstants);
+
+  ICWorklist.AddInitialGroup(Seeds.getArrayRef());
+  return true;
+}
+
 static bool
 combineInstructionsOverFunction(Function &F, InstCombineWorklist &Worklist,
                                 AliasAnalysis *AA, AssumptionCache &AC,
@@ -3194,23 +3300,63 @@ combineInstructionsOverFunction(Function &F, InstCombineWorklist &Worklist,
   // by instcombiner.
   bool MadeIRChange = LowerDbgDeclare(F);
 
-  // Iterate while there is work to do.
-  int Iteration = 0;
+  // Iterate while there is work to do.  Only the first iteration has to look
+  // at the whole function; later ones start from what the previous one
+  // changed.
+  unsigned Iteration = 0;
+  SmallVector<Instruction *, 64> Changed;
+  bool FullSweep = true;
+  ValueTrackingCache VTC;
   for (;;) {
+    if (Iteration == MaxIterations) {
+      DEBUG(dbgs() << "IC: Iteration limit reached on " << F.getName()
+                   << "\n");
+      ++NumIterationLimitReached;
+      break;
+    }
     ++Iteration;
     DEBUG(dbgs() << "\n\nINSTCOMBINE ITERATION #" << Iteration << " on "
                  << F.getName() << "\n");
 
-    MadeIRChange |= prepareICWorklistFromFunction(F, DL, &TLI, Worklist);
+    {
+      NamedRegionTimer T("prepare", "Worklist Population", TimerGroupName,
+                         TimerGroupDescription, TimePassesIsEnabled);
+      if (!FullSweep && prepareICWorklistFromChanges(Changed, DL, &TLI,
+                                                     Worklist, MadeIRChange))
+        ++NumIncrementalIterations;
+      else
+        MadeIRChange |= prepareICWorklistFromFunction(F, DL, &TLI, Worklist);
+    }
 
     InstCombiner IC(Worklist, Builder, F.optForMinSize(), ExpensiveCombines,
-                    AA, AC, TLI, DT, DL, LI);
+                    AA, AC, TLI, DT, DL, LI,
+                    CacheValueTracking ? &VTC : nullptr);
     IC.MaxArraySizeForCombine = MaxArraySize;
 
-    if (!IC.run())
+    bool IterationChanged;
+    {
+      NamedRegionTimer T("combine", "Combining", TimerGroupName,
+                         TimerGroupDescription, TimePassesIsEnabled);
+      IterationChanged = IC.run();
+    }
+
+    Changed.clear();
+    Worklist.takeChanged(Changed);
+    if (!IterationChanged)
       break;
+    FullSweep = !IncrementalIterations;
   }
 
+  NumWorklistIterations += Iteration;
+  if (Iteration == 1)
+    ++NumOneIteration;
+  else if (Iteration == 2)
+    ++NumTwoIterations;
+  else if (Iteration == 3)
+    ++NumThreeIterations;
+  else if (Iteration > 3)
+    ++NumFourOrMoreIterations;
+
   return MadeIRChange || Iteration > 1;
 }
 
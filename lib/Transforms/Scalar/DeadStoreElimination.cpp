@@ -10,8 +10,9 @@
 // This file implements a trivial dead store elimination that only considers
 // basic-block local redundant stores.
 //
-// FIXME: This should eventually be extended to be a post-dominator tree
-// traversal.  Doing so would be pretty trivial.
+// With -enable-dse-memoryssa, stores are instead checked against later
+// writes by walking MemorySSA def-use chains, which also finds stores that
+// are overwritten in other blocks on every path.
 //
 //===----------------------------------------------------------------------===//
 
@@ -25,6 +26,9 @@
 #include "llvm/Analysis/GlobalsModRef.h"
 #include "llvm/Analysis/MemoryBuiltins.h"
 #include "llvm/Analysis/MemoryDependenceAnalysis.h"
+#include "llvm/Analysis/MemorySSA.h"
+#include "llvm/Analysis/MemorySSAUpdater.h"
+#include "llvm/Analysis/PostDominators.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/Analysis/ValueTracking.h"
 #include "llvm/IR/Constants.h"
@@ -34,6 +38,7 @@
 #include "llvm/IR/GlobalVariable.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/Operator.h"
 #include "llvm/Pass.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
@@ -49,12 +54,26 @@ STATISTIC(NumRedundantStores, "Number of redundant stores deleted");
 STATISTIC(NumFastStores, "Number of stores deleted");
 STATISTIC(NumFastOther , "Number of other instrs removed");
 STATISTIC(NumCompletePartials, "Number of stores dead by later partials");
+STATISTIC(NumCrossBlockStores,
+          "Number of stores deleted because of a store in another block");
+STATISTIC(NumMemorySSAScanLimit,
+          "Number of MemorySSA walks that gave up at the scan limit");
 
 static cl::opt<bool>
 EnablePartialOverwriteTracking("enable-dse-partial-overwrite-tracking",
   cl::init(true), cl::Hidden,
   cl::desc("Enable partial-overwrite tracking in DSE"));
 
+static cl::opt<bool>
+EnableMemorySSA("enable-dse-memoryssa", cl::init(false), cl::Hidden,
+  cl::desc("Use MemorySSA walks instead of per-block MemDep queries to find "
+           "killing stores in DSE, including stores in other blocks"));
+
+static cl::opt<unsigned>
+MemorySSAScanLimit("dse-memoryssa-scanlimit", cl::init(150), cl::Hidden,
+  cl::desc("The number of memory accesses DSE visits when walking MemorySSA "
+           "uses of a single store"));
+
 
 //===----------------------------------------------------------------------===//
 // Helper functions
@@ -66,12 +85,15 @@ typedef DenseMap<Instruction *, OverlapIntervalsTy> InstOverlapIntervalsTy;
 /// operands of this instruction.  If any of them become dead, delete them and
 /// the computation tree that feeds them.
 /// If ValueSet is non-null, remove any deleted instructions from it as well.
+/// If MSSA is non-null, the memory accesses of deleted instructions are
+/// removed from it.
 static void
 deleteDeadInstruction(Instruction *I, BasicBlock::iterator *BBI,
                       MemoryDependenceResults &MD, const TargetLibraryInfo &TLI,
                       InstOverlapIntervalsTy &IOL,
                       DenseMap<Instruction*, size_t> *InstrOrdering,
-                      SmallSetVector<Value *, 16> *ValueSet = nullptr) {
+                      SmallSetVector<Value *, 16> *ValueSet = nullptr,
+                      MemorySSA *MSSA = nullptr) {
   SmallVector<Instruction*, 32> NowDeadInsts;
 
   NowDeadInsts.push_back(I);
@@ -90,6 +112,9 @@ deleteDeadInstruction(Instruction *I, BasicBlock::iterator *BBI,
     // MemDep, which needs to know the operands and needs it to be in the
     // function.
     MD.removeInstruction(DeadInst);
+    if (MSSA)
+      if (MemoryAccess *MA = MSSA->getMemoryAccess(DeadInst))
+        MemorySSAUpdater(MSSA).removeMemoryAccess(MA);
 
     for (unsigned op = 0, e = DeadInst->getNumOperands(); op != e; ++op) {
       Value *Op = DeadInst->getOperand(op);
@@ -286,6 +311,19 @@ static uint64_t getPointerSize(const Value *V, const DataLayout &DL,
   return MemoryLocation::UnknownSize;
 }
 
+/// Return true if a store to the object \p Underlying cannot be observed
+/// once an exception unwinds out of the function.
+static bool isStoreDeadOnUnwind(const Value *Underlying,
+                                const TargetLibraryInfo *TLI) {
+  if (isa<AllocaInst>(Underlying))
+    return true;
+  // We're looking for a call to an allocation function where the allocation
+  // doesn't escape before the last throwing instruction; PointerMayBeCaptured
+  // reasonably fast approximation.
+  return isAllocLikeFn(Underlying, TLI) &&
+         !PointerMayBeCaptured(Underlying, false, true);
+}
+
 namespace {
 enum OverwriteResult { OW_Begin, OW_Complete, OW_End, OW_Unknown };
 }
@@ -987,7 +1025,8 @@ static bool eliminateNoopStore(Instruction *Inst, BasicBlock::iterator &BBI,
 
 static bool eliminateDeadStores(BasicBlock &BB, AliasAnalysis *AA,
                                 MemoryDependenceResults *MD, DominatorTree *DT,
-                                const TargetLibraryInfo *TLI) {
+                                const TargetLibraryInfo *TLI,
+                                bool UseMemorySSA) {
   const DataLayout &DL = BB.getModule()->getDataLayout();
   bool MadeChange = false;
 
@@ -1030,6 +1069,10 @@ static bool eliminateDeadStores(BasicBlock &BB, AliasAnalysis *AA,
       continue;
     }
 
+    // Killing stores have already been handled by the MemorySSA walk.
+    if (UseMemorySSA)
+      continue;
+
     // If we find something that writes memory, get its memory dependence.
     MemDepResult InstDep = MD->getDependency(Inst);
 
@@ -1076,20 +1119,9 @@ static bool eliminateDeadStores(BasicBlock &BB, AliasAnalysis *AA,
       // the store.
       size_t DepIndex = InstrOrdering.lookup(DepWrite);
       assert(DepIndex && "Unexpected instruction");
-      if (DepIndex <= LastThrowingInstIndex) {
-        const Value* Underlying = GetUnderlyingObject(DepLoc.Ptr, DL);
-        bool IsStoreDeadOnUnwind = isa<AllocaInst>(Underlying);
-        if (!IsStoreDeadOnUnwind) {
-            // We're looking for a call to an allocation function
-            // where the allocation doesn't escape before the last
-            // throwing instruction; PointerMayBeCaptured
-            // reasonably fast approximation.
-            IsStoreDeadOnUnwind = isAllocLikeFn(Underlying, TLI) &&
-                !PointerMayBeCaptured(Underlying, false, true);
-        }
-        if (!IsStoreDeadOnUnwind)
-          break;
-      }
+      if (DepIndex <= LastThrowingInstIndex &&
+          !isStoreDeadOnUnwind(GetUnderlyingObject(DepLoc.Ptr, DL), TLI))
+        break;
 
       // If we find a write that is a) removable (i.e., non-volatile), b) is
       // completely obliterated by the store to 'Loc', and c) which we know that
@@ -1157,15 +1189,191 @@ static bool eliminateDeadStores(BasicBlock &BB, AliasAnalysis *AA,
   return MadeChange;
 }
 
+//===----------------------------------------------------------------------===//
+// MemorySSA-based elimination
+//===----------------------------------------------------------------------===//
+
+/// Return true if \p Ptr names the same address every time it is evaluated,
+/// so that a store through it in one loop iteration can be compared with a
+/// store through it in another.  This holds for pointers that are constants,
+/// arguments, or computed in the entry block, possibly followed by casts and
+/// constant-offset GEPs.
+static bool isGuaranteedLoopInvariant(const Value *Ptr) {
+  Ptr = Ptr->stripPointerCasts();
+  if (auto *GEP = dyn_cast<GEPOperator>(Ptr))
+    if (GEP->hasAllConstantIndices())
+      Ptr = GEP->getPointerOperand()->stripPointerCasts();
+
+  if (auto *I = dyn_cast<Instruction>(Ptr))
+    return I->getParent() == &I->getFunction()->getEntryBlock();
+  return true;
+}
+
+/// Return true if \p Later executes on every path from \p Earlier to the
+/// function exit.  If both are in the same block, \p Later must follow
+/// \p Earlier, and \p ThrowsBetween is set if an instruction between them
+/// may throw.  Otherwise \p ThrowsBetween is conservatively set.
+static bool postDominates(Instruction *Later, Instruction *Earlier,
+                          PostDominatorTree &PDT, bool &ThrowsBetween) {
+  ThrowsBetween = true;
+  BasicBlock *BB = Earlier->getParent();
+  if (Later->getParent() != BB)
+    return PDT.dominates(Later->getParent(), BB);
+
+  ThrowsBetween = false;
+  for (auto I = std::next(Earlier->getIterator()), E = BB->end(); I != E;
+       ++I) {
+    if (&*I == Later)
+      return true;
+    ThrowsBetween |= I->mayThrow();
+  }
+  return false;
+}
+
+/// Walk the MemorySSA uses of the write \p Dead and return true if its
+/// location is completely overwritten on every path before it can be read.
+///
+/// The walk stops at each write that completely overwrites the location.  The
+/// store is dead if no visited access may read the location and at least one
+/// of the overwriting writes (or a set of partial writes that together cover
+/// the location) post-dominates it.  Since every path to the exit passes such
+/// a write, the stopping points cut every path from \p Dead.
+static bool isDeadOnAllPaths(Instruction *Dead, const MemoryLocation &Loc,
+                             bool DeadOnUnwind, bool FunctionMayThrow,
+                             AliasAnalysis &AA, BatchAAResults &BatchAA,
+                             MemorySSA &MSSA, PostDominatorTree &PDT,
+                             const TargetLibraryInfo &TLI) {
+  const DataLayout &DL = Dead->getModule()->getDataLayout();
+  InstOverlapIntervalsTy IOL;
+  bool FoundKiller = false;
+  unsigned ScanLimit = MemorySSAScanLimit;
+
+  SmallVector<MemoryAccess *, 16> WorkList;
+  SmallPtrSet<MemoryAccess *, 16> Visited;
+  auto PushUsers = [&](MemoryAccess *MA) {
+    for (User *U : MA->users())
+      if (Visited.insert(cast<MemoryAccess>(U)).second)
+        WorkList.push_back(cast<MemoryAccess>(U));
+  };
+  PushUsers(MSSA.getMemoryAccess(Dead));
+
+  while (!WorkList.empty()) {
+    MemoryAccess *MA = WorkList.pop_back_val();
+    if (ScanLimit-- == 0) {
+      ++NumMemorySSAScanLimit;
+      return false;
+    }
+
+    if (isa<MemoryPhi>(MA)) {
+      PushUsers(MA);
+      continue;
+    }
+
+    Instruction *UseInst = cast<MemoryUseOrDef>(MA)->getMemoryInst();
+    // Around a loop, Dead overwrites its own (loop-invariant) location.
+    if (UseInst == Dead)
+      continue;
+
+    if (BatchAA.getModRefInfo(UseInst, Loc) & MRI_Ref)
+      return false;
+    if (isa<MemoryUse>(MA))
+      continue;
+
+    if (hasMemoryWrite(UseInst, TLI)) {
+      MemoryLocation LaterLoc = getLocForWrite(UseInst, AA);
+      if (LaterLoc.Ptr && isGuaranteedLoopInvariant(LaterLoc.Ptr)) {
+        bool ThrowsBetween;
+        bool IsPostDom = postDominates(UseInst, Dead, PDT, ThrowsBetween);
+        // Only writes on every path may contribute to partial overwrites.
+        InstOverlapIntervalsTy ScratchIOL;
+        int64_t EarlierOff, LaterOff;
+        OverwriteResult OR =
+            isOverwrite(LaterLoc, Loc, DL, TLI, EarlierOff, LaterOff, Dead,
+                        IsPostDom ? IOL : ScratchIOL);
+        if (OR == OW_Complete) {
+          if (IsPostDom && (DeadOnUnwind || !FunctionMayThrow ||
+                            !ThrowsBetween)) {
+            DEBUG(dbgs() << "DSE: Remove Dead Store:\n  DEAD: " << *Dead
+                         << "\n  KILLER: " << *UseInst << '\n');
+            if (UseInst->getParent() != Dead->getParent())
+              ++NumCrossBlockStores;
+            FoundKiller = true;
+          }
+          continue;
+        }
+      }
+    }
+    PushUsers(MA);
+  }
+  return FoundKiller;
+}
+
+/// Delete stores whose value is overwritten on every path before being read,
+/// using MemorySSA to find the later writes in any block.
+static bool eliminateDeadStoresMemorySSA(Function &F, AliasAnalysis *AA,
+                                         MemoryDependenceResults *MD,
+                                         MemorySSA *MSSA, DominatorTree *DT,
+                                         PostDominatorTree *PDT,
+                                         const TargetLibraryInfo *TLI) {
+  const DataLayout &DL = F.getParent()->getDataLayout();
+  bool FunctionMayThrow = false;
+  SmallVector<WeakTrackingVH, 64> Candidates;
+  for (BasicBlock &BB : F) {
+    if (!DT->isReachableFromEntry(&BB))
+      continue;
+    for (Instruction &I : BB) {
+      FunctionMayThrow |= I.mayThrow();
+      if (hasMemoryWrite(&I, *TLI) && isRemovable(&I))
+        Candidates.push_back(&I);
+    }
+  }
+
+  bool MadeChange = false;
+  InstOverlapIntervalsTy IOL;
+  DenseMap<Instruction *, size_t> InstrOrdering;
+  // Candidates overlapping in their def-use chains re-ask the same questions;
+  // the cache only has to be dropped when an instruction is deleted.
+  BatchAAResults BatchAA(*AA);
+  for (WeakTrackingVH &V : Candidates) {
+    auto *Dead = cast_or_null<Instruction>(V);
+    if (!Dead)
+      continue;
+
+    MemoryLocation Loc = getLocForWrite(Dead, *AA);
+    if (!Loc.Ptr || Loc.Size == MemoryLocation::UnknownSize ||
+        !isGuaranteedLoopInvariant(Loc.Ptr))
+      continue;
+    bool DeadOnUnwind =
+        isStoreDeadOnUnwind(GetUnderlyingObject(Loc.Ptr, DL), TLI);
+
+    if (!isDeadOnAllPaths(Dead, Loc, DeadOnUnwind, FunctionMayThrow, *AA,
+                          BatchAA, *MSSA, *PDT, *TLI))
+      continue;
+
+    BasicBlock::iterator BBI(Dead);
+    deleteDeadInstruction(Dead, &BBI, *MD, *TLI, IOL, &InstrOrdering,
+                          nullptr, MSSA);
+    BatchAA.clear();
+    ++NumFastStores;
+    MadeChange = true;
+  }
+  return MadeChange;
+}
+
 static bool eliminateDeadStores(Function &F, AliasAnalysis *AA,
                                 MemoryDependenceResults *MD, DominatorTree *DT,
-                                const TargetLibraryInfo *TLI) {
+                                const TargetLibraryInfo *TLI,
+                                MemorySSA *MSSA = nullptr,
+                                PostDominatorTree *PDT = nullptr) {
   bool MadeChange = false;
+  if (MSSA)
+    MadeChange |= eliminateDeadStoresMemorySSA(F, AA, MD, MSSA, DT, PDT, TLI);
+
   for (BasicBlock &BB : F)
     // Only check non-dead blocks.  Dead blocks may have strange pointer
     // cycles that will confuse alias analysis.
     if (DT->isReachableFromEntry(&BB))
-      MadeChange |= eliminateDeadStores(BB, AA, MD, DT, TLI);
+      MadeChange |= eliminateDeadStores(BB, AA, MD, DT, TLI, MSSA != nullptr);
 
   return MadeChange;
 }
@@ -1178,8 +1386,14 @@ PreservedAnalyses DSEPass::run(Function &F, FunctionAnalysisManager &AM) {
   DominatorTree *DT = &AM.getResult<DominatorTreeAnalysis>(F);
   MemoryDependenceResults *MD = &AM.getResult<MemoryDependenceAnalysis>(F);
   const TargetLibraryInfo *TLI = &AM.getResult<TargetLibraryAnalysis>(F);
+  MemorySSA *MSSA = nullptr;
+  PostDominatorTree *PDT = nullptr;
+  if (EnableMemorySSA) {
+    MSSA = &AM.getResult<MemorySSAAnalysis>(F).getMSSA();
+    PDT = &AM.getResult<PostDominatorTreeAnalysis>(F);
+  }
 
-  if (!eliminateDeadStores(F, AA, MD, DT, TLI))
+  if (!eliminateDeadStores(F, AA, MD, DT, TLI, MSSA, PDT))
     return PreservedAnalyses::all();
 
   PreservedAnalyses PA;
@@ -1207,8 +1421,14 @@ public:
         &getAnalysis<MemoryDependenceWrapperPass>().getMemDep();
     const TargetLibraryInfo *TLI =
         &getAnalysis<TargetLibraryInfoWrapperPass>().getTLI();
+    MemorySSA *MSSA = nullptr;
+    PostDominatorTree *PDT = nullptr;
+    if (EnableMemorySSA) {
+      MSSA = &getAnalysis<MemorySSAWrapperPass>().getMSSA();
+      PDT = &getAnalysis<PostDominatorTreeWrapperPass>().getPostDomTree();
+    }
 
-    return eliminateDeadStores(F, AA, MD, DT, TLI);
+    return eliminateDeadStores(F, AA, MD, DT, TLI, MSSA, PDT);
   }
 
   void getAnalysisUsage(AnalysisUsage &AU) const override {
@@ -1217,6 +1437,10 @@ public:
     AU.addRequired<AAResultsWrapperPass>();
     AU.addRequired<MemoryDependenceWrapperPass>();
     AU.addRequired<TargetLibraryInfoWrapperPass>();
+    if (EnableMemorySSA) {
+      AU.addRequired<MemorySSAWrapperPass>();
+      AU.addRequired<PostDominatorTreeWrapperPass>();
+    }
     AU.addPreserved<DominatorTreeWrapperPass>();
     AU.addPreserved<GlobalsAAWrapperPass>();
     AU.addPreserved<MemoryDependenceWrapperPass>();
@@ -1233,6 +1457,8 @@ INITIALIZE_PASS_DEPENDENCY(DominatorTreeWrapperPass)
 INITIALIZE_PASS_DEPENDENCY(AAResultsWrapperPass)
 INITIALIZE_PASS_DEPENDENCY(GlobalsAAWrapperPass)
 INITIALIZE_PASS_DEPENDENCY(MemoryDependenceWrapperPass)
+INITIALIZE_PASS_DEPENDENCY(MemorySSAWrapperPass)
+INITIALIZE_PASS_DEPENDENCY(PostDominatorTreeWrapperPass)
 INITIALIZE_PASS_DEPENDENCY(TargetLibraryInfoWrapperPass)
 INITIALIZE_PASS_END(DSELegacyPass, "dse", "Dead Store Elimination", false,
                     false)
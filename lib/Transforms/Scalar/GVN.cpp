@@ -36,6 +36,7 @@
 #include "llvm/Analysis/OptimizationDiagnosticInfo.h"
 #include "llvm/Analysis/PHITransAddr.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
+#include "llvm/IR/CompileTimeBudget.h"
 #include "llvm/IR/DataLayout.h"
 #include "llvm/IR/Dominators.h"
 #include "llvm/IR/GlobalVariable.h"
@@ -1865,13 +1866,16 @@ bool GVN::runImpl(Function &F, AssumptionCache &RunAC, DominatorTree &RunDT,
 
   unsigned Iteration = 0;
   while (ShouldContinue) {
+    // Over budget, settle for what the iterations so far have found.
+    if (Iteration > 0 && CompileTimeBudget::shouldDegrade(F, DEBUG_TYPE))
+      break;
     DEBUG(dbgs() << "GVN iteration: " << Iteration << "\n");
     ShouldContinue = iterateOnFunction(F);
     Changed |= ShouldContinue;
     ++Iteration;
   }
 
-  if (EnablePRE) {
+  if (EnablePRE && !CompileTimeBudget::shouldDegrade(F, DEBUG_TYPE)) {
     // Fabricate val-num for dead-code in order to suppress assertion in
     // performPRE().
     assignValNumForDeadCode();
@@ -42,6 +42,8 @@
 #include "llvm/Analysis/LoopInfo.h"
 #include "llvm/Analysis/LoopPass.h"
 #include "llvm/Analysis/MemoryBuiltins.h"
+#include "llvm/Analysis/MemorySSA.h"
+#include "llvm/Analysis/MemorySSAUpdater.h"
 #include "llvm/Analysis/OptimizationDiagnosticInfo.h"
 #include "llvm/Analysis/ScalarEvolution.h"
 #include "llvm/Analysis/ScalarEvolutionAliasAnalysis.h"
@@ -77,6 +79,10 @@ STATISTIC(NumHoisted, "Number of instructions hoisted out of loop");
 STATISTIC(NumMovedLoads, "Number of load insts hoisted or sunk");
 STATISTIC(NumMovedCalls, "Number of call insts hoisted or sunk");
 STATISTIC(NumPromoted, "Number of memory locations promoted to registers");
+STATISTIC(NumMssaOptCapped,
+          "Number of MemorySSA clobber queries skipped by the per-loop cap");
+STATISTIC(NumMssaPromotionCapped,
+          "Number of loops not promoted for having too many memory accesses");
 
 /// Memory promotion is enabled by default.
 static cl::opt<bool>
@@ -88,16 +94,32 @@ static cl::opt<uint32_t> MaxNumUsesTraversed(
     cl::desc("Max num uses visited for identifying load "
              "invariance in loop using invariant start (default = 8)"));
 
+static cl::opt<bool> EnableMSSALoopDependency(
+    "enable-mssa-loop-dependency", cl::Hidden, cl::init(false),
+    cl::desc("Use MemorySSA instead of an AliasSetTracker to answer memory "
+             "dependence queries in LICM"));
+
+static cl::opt<unsigned> LicmMssaOptCap(
+    "licm-mssa-optimization-cap", cl::Hidden, cl::init(100),
+    cl::desc("Max number of MemorySSA clobber walks per loop in LICM; past "
+             "this, the defining access is used as a conservative answer"));
+
+static cl::opt<unsigned> LicmMssaMaxAccPromotion(
+    "licm-mssa-max-acc-promotion", cl::Hidden, cl::init(250),
+    cl::desc("Max number of memory accesses in a loop for which LICM builds "
+             "alias sets to promote memory to registers when MemorySSA is "
+             "in use"));
+
 static bool inSubLoop(BasicBlock *BB, Loop *CurLoop, LoopInfo *LI);
 static bool isNotUsedInLoop(const Instruction &I, const Loop *CurLoop,
                             const LoopSafetyInfo *SafetyInfo);
 static bool hoist(Instruction &I, const DominatorTree *DT, const Loop *CurLoop,
                   const LoopSafetyInfo *SafetyInfo,
-                  OptimizationRemarkEmitter *ORE);
+                  OptimizationRemarkEmitter *ORE, MemorySSAUpdater *MSSAU);
 static bool sink(Instruction &I, const LoopInfo *LI, const DominatorTree *DT,
                  const Loop *CurLoop, AliasSetTracker *CurAST,
                  const LoopSafetyInfo *SafetyInfo,
-                 OptimizationRemarkEmitter *ORE);
+                 OptimizationRemarkEmitter *ORE, MemorySSAUpdater *MSSAU);
 static bool isSafeToExecuteUnconditionally(Instruction &Inst,
                                            const DominatorTree *DT,
                                            const Loop *CurLoop,
@@ -107,6 +129,14 @@ static bool isSafeToExecuteUnconditionally(Instruction &Inst,
 static bool pointerInvalidatedByLoop(Value *V, uint64_t Size,
                                      const AAMDNodes &AAInfo,
                                      AliasSetTracker *CurAST);
+static bool pointerInvalidatedByLoopWithMSSA(MemorySSA *MSSA,
+                                             MemoryUseOrDef *MUD,
+                                             Loop *CurLoop,
+                                             unsigned &LicmMssaOptCounter);
+static void eraseInstruction(Instruction &I, AliasSetTracker *AST,
+                             MemorySSAUpdater *MSSAU);
+static MemoryUseOrDef *findNextMemoryAccess(Instruction *I, MemorySSA *MSSA);
+static void insertMemoryAccess(Instruction *I, MemorySSAUpdater *MSSAU);
 static Instruction *
 CloneInstructionInExitBlock(Instruction &I, BasicBlock &ExitBlock, PHINode &PN,
                             const LoopInfo *LI,
@@ -116,7 +146,8 @@ namespace {
 struct LoopInvariantCodeMotion {
   bool runOnLoop(Loop *L, AliasAnalysis *AA, LoopInfo *LI, DominatorTree *DT,
                  TargetLibraryInfo *TLI, ScalarEvolution *SE,
-                 OptimizationRemarkEmitter *ORE, bool DeleteAST, bool Rhino);
+                 OptimizationRemarkEmitter *ORE, bool DeleteAST, bool Rhino,
+                 MemorySSA *MSSA = nullptr);
 
   DenseMap<Loop *, AliasSetTracker *> &getLoopToAliasSetMap() {
     return LoopToAliasSetMap;
@@ -155,8 +186,10 @@ exit:
 
 AliasSetTracker *
 collectAliasInfoForLoopAtPoint(Loop *L, LoopInfo *LI,
-                                                 AliasAnalysis *AA, Instruction* I, bool collectBefore, bool ignoreBlock=false) {
-  auto CurAST = new AliasSetTracker(*AA);
+                                                 AliasAnalysis *AA, Instruction* I, bool collectBefore, bool ignoreBlock=false,
+                                                 BatchAAResults *BatchAA=nullptr) {
+  auto CurAST = BatchAA ? new AliasSetTracker(*AA, *BatchAA)
+                        : new AliasSetTracker(*AA);
 
   std::set<BasicBlock*> Blocks;
   for (Loop *L2 : L->getSubLoops()) {
@@ -249,12 +282,16 @@ struct LegacyLICMCommonPass : public LoopPass {
     // pass.  Function analyses need to be preserved across loop transformations
     // but ORE cannot be preserved (see comment before the pass definition).
     OptimizationRemarkEmitter ORE(L->getHeader()->getParent());
+    MemorySSA *MSSA = useMemorySSA()
+                          ? &getAnalysis<MemorySSAWrapperPass>().getMSSA()
+                          : nullptr;
     return LICM.runOnLoop(L,
                           &getAnalysis<AAResultsWrapperPass>().getAAResults(),
                           &getAnalysis<LoopInfoWrapperPass>().getLoopInfo(),
                           &getAnalysis<DominatorTreeWrapperPass>().getDomTree(),
                           &getAnalysis<TargetLibraryInfoWrapperPass>().getTLI(),
-                          SE ? &SE->getSE() : nullptr, &ORE, false, Rhino);
+                          SE ? &SE->getSE() : nullptr, &ORE, false, Rhino,
+                          MSSA);
   }
 
   /// This transformation requires natural loop information & requires that
@@ -263,6 +300,10 @@ struct LegacyLICMCommonPass : public LoopPass {
   void getAnalysisUsage(AnalysisUsage &AU) const override {
     AU.setPreservesCFG();
     AU.addRequired<TargetLibraryInfoWrapperPass>();
+    if (useMemorySSA()) {
+      AU.addRequired<MemorySSAWrapperPass>();
+      AU.addPreserved<MemorySSAWrapperPass>();
+    }
     getLoopAnalysisUsage(AU);
   }
 
@@ -279,6 +320,10 @@ struct LegacyLICMCommonPass : public LoopPass {
 private:
   LoopInvariantCodeMotion LICM;
 
+  /// The Rhino variant keeps its per-point alias sets, which MemorySSA does
+  /// not model.
+  static bool useMemorySSA() { return EnableMSSALoopDependency && !Rhino; }
+
   /// cloneBasicBlockAnalysis - Simple Analysis hook. Clone alias set info.
   void cloneBasicBlockAnalysis(BasicBlock *From, BasicBlock *To,
                                Loop *L) override {
@@ -323,6 +368,9 @@ PreservedAnalyses LICMPass::run(Loop &L, LoopAnalysisManager &AM,
     report_fatal_error("LICM: OptimizationRemarkEmitterAnalysis not "
                        "cached at a higher level");
 
+  // MemorySSA is not yet part of the standard loop analyses and is not kept
+  // up to date by the other loop passes, so a cached result could be stale.
+  // Only the legacy pass, which can require and preserve it, uses it.
   LoopInvariantCodeMotion LICM;
   if (!LICM.runOnLoop(&L, &AR.AA, &AR.LI, &AR.DT, &AR.TLI, &AR.SE, ORE, true, Rhino))
     return PreservedAnalyses::all();
@@ -342,6 +390,7 @@ INITIALIZE_PASS_BEGIN(LegacyLICMPass, "licm", "Loop Invariant Code Motion",
                       false, false)
 INITIALIZE_PASS_DEPENDENCY(LoopPass)
 INITIALIZE_PASS_DEPENDENCY(TargetLibraryInfoWrapperPass)
+INITIALIZE_PASS_DEPENDENCY(MemorySSAWrapperPass)
 INITIALIZE_PASS_END(LegacyLICMPass, "licm", "Loop Invariant Code Motion", false,
                     false)
 
@@ -376,12 +425,25 @@ bool LoopInvariantCodeMotion::runOnLoop(Loop *L, AliasAnalysis *AA,
                                         TargetLibraryInfo *TLI,
                                         ScalarEvolution *SE,
                                         OptimizationRemarkEmitter *ORE,
-                                        bool DeleteAST, bool Rhino) {
+                                        bool DeleteAST, bool Rhino,
+                                        MemorySSA *MSSA) {
   bool Changed = false;
 
   assert(L->isLCSSAForm(*DT) && "Loop is not in LCSSA form.");
 
-  AliasSetTracker *CurAST = collectAliasInfoForLoop(L, LI, AA);
+  // With MemorySSA, hoisting and sinking query the loop's MemorySSA defs
+  // directly, so the alias sets are only built if they are needed for
+  // promotion.  The empty tracker keeps the deleteValue/copyValue calls on
+  // the shared paths valid.
+  std::unique_ptr<MemorySSAUpdater> MSSAU;
+  unsigned LicmMssaOptCounter = 0;
+  AliasSetTracker *CurAST;
+  if (MSSA) {
+    MSSAU = make_unique<MemorySSAUpdater>(MSSA);
+    CurAST = new AliasSetTracker(*AA);
+  } else {
+    CurAST = collectAliasInfoForLoop(L, LI, AA);
+  }
 
   // Get the preheader block to move instructions into...
   BasicBlock *Preheader = L->getLoopPreheader();
@@ -402,10 +464,12 @@ bool LoopInvariantCodeMotion::runOnLoop(Loop *L, AliasAnalysis *AA,
   //
   if (L->hasDedicatedExits())
     Changed |= sinkRegion(DT->getNode(L->getHeader()), AA, LI, DT, TLI, L,
-                          CurAST, &SafetyInfo, ORE, Rhino);
+                          CurAST, &SafetyInfo, ORE, Rhino, MSSAU.get(),
+                          &LicmMssaOptCounter);
   if (Preheader)
     Changed |= hoistRegion(DT->getNode(L->getHeader()), AA, LI, DT, TLI, L,
-                           CurAST, &SafetyInfo, ORE, Rhino);
+                           CurAST, &SafetyInfo, ORE, Rhino, MSSAU.get(),
+                           &LicmMssaOptCounter);
 
   // Now that all loop invariants have been removed from the loop, promote any
   // memory references to scalars that we can.
@@ -414,7 +478,23 @@ bool LoopInvariantCodeMotion::runOnLoop(Loop *L, AliasAnalysis *AA,
   // make sure we catch that. An additional load may be generated in the
   // preheader for SSA updater, so also avoid sinking when no preheader
   // is available.
-  if (!DisablePromotion && Preheader && L->hasDedicatedExits()) {
+  bool PromotionTooCostly = false;
+  if (MSSA && !DisablePromotion) {
+    unsigned NumAccesses = 0;
+    for (BasicBlock *BB : L->blocks())
+      if (const auto *Accesses = MSSA->getBlockAccesses(BB))
+        NumAccesses += Accesses->size();
+    if (NumAccesses > LicmMssaMaxAccPromotion) {
+      ++NumMssaPromotionCapped;
+      PromotionTooCostly = true;
+    } else {
+      for (BasicBlock *BB : L->blocks())
+        CurAST->add(*BB);
+    }
+  }
+
+  if (!DisablePromotion && !PromotionTooCostly && Preheader &&
+      L->hasDedicatedExits()) {
     // Figure out the loop exits and their insertion points
     SmallVector<BasicBlock *, 8> ExitBlocks;
     L->getUniqueExitBlocks(ExitBlocks);
@@ -438,7 +518,8 @@ bool LoopInvariantCodeMotion::runOnLoop(Loop *L, AliasAnalysis *AA,
       for (AliasSet &AS : *CurAST)
         Promoted |=
             promoteLoopAccessesToScalars(AS, ExitBlocks, InsertPts, PIC, LI, DT,
-                                         TLI, L, CurAST, &SafetyInfo, ORE);
+                                         TLI, L, CurAST, &SafetyInfo, ORE,
+                                         MSSAU.get());
 
       // Once we have promoted values across the loop body we have to
       // recursively reform LCSSA as any nested loop may now have values defined
@@ -459,10 +540,15 @@ bool LoopInvariantCodeMotion::runOnLoop(Loop *L, AliasAnalysis *AA,
   assert(L->isLCSSAForm(*DT) && "Loop not left in LCSSA form after LICM!");
   assert((!L->getParentLoop() || L->getParentLoop()->isLCSSAForm(*DT)) &&
          "Parent loop not left in LCSSA form after LICM!");
+#ifdef EXPENSIVE_CHECKS
+  if (MSSA)
+    MSSA->verifyMemorySSA();
+#endif
 
   // If this loop is nested inside of another one, save the alias information
-  // for when we process the outer loop.
-  if (L->getParentLoop() && !DeleteAST)
+  // for when we process the outer loop.  The MemorySSA path rebuilds its alias
+  // sets from scratch, so there is nothing to save.
+  if (L->getParentLoop() && !DeleteAST && !MSSA)
     LoopToAliasSetMap[L] = CurAST;
   else
     delete CurAST;
@@ -480,7 +566,8 @@ bool LoopInvariantCodeMotion::runOnLoop(Loop *L, AliasAnalysis *AA,
 bool llvm::sinkRegion(DomTreeNode *N, AliasAnalysis *AA, LoopInfo *LI,
                       DominatorTree *DT, TargetLibraryInfo *TLI, Loop *CurLoop,
                       AliasSetTracker *CurAST, LoopSafetyInfo *SafetyInfo,
-                      OptimizationRemarkEmitter *ORE, bool Rhino) {
+                      OptimizationRemarkEmitter *ORE, bool Rhino,
+                      MemorySSAUpdater *MSSAU, unsigned *LicmMssaOptCounter) {
 
   // Verify inputs.
   assert(N != nullptr && AA != nullptr && LI != nullptr && DT != nullptr &&
@@ -497,15 +584,24 @@ bool llvm::sinkRegion(DomTreeNode *N, AliasAnalysis *AA, LoopInfo *LI,
   const std::vector<DomTreeNode *> &Children = N->getChildren();
   for (DomTreeNode *Child : Children)
     Changed |=
-        sinkRegion(Child, AA, LI, DT, TLI, CurLoop, CurAST, SafetyInfo, ORE, Rhino);
+        sinkRegion(Child, AA, LI, DT, TLI, CurLoop, CurAST, SafetyInfo, ORE, Rhino,
+                   MSSAU, LicmMssaOptCounter);
 
   // Only need to process the contents of this block if it is not part of a
   // subloop (which would already have been processed).
   if (inSubLoop(BB, CurLoop, LI))
     return Changed;
 
-  if (Rhino)
-    CurAST = collectAliasInfoForLoopAtPoint(CurLoop, LI, AA, &*--BB->end(), /*collectBefore*/false, /*onlyBlock*/true);
+  // The per-block tracker is rebuilt from scratch for every block, so its
+  // queries can share a cache for as long as the block is being processed.
+  // The tracker is destroyed before the cache, since its value handles clear
+  // the cache when a value is deleted.
+  BatchAAResults BatchAA(*AA);
+  std::unique_ptr<AliasSetTracker> BlockAST;
+  if (Rhino) {
+    BlockAST.reset(collectAliasInfoForLoopAtPoint(CurLoop, LI, AA, &*--BB->end(), /*collectBefore*/false, /*onlyBlock*/true, &BatchAA));
+    CurAST = BlockAST.get();
+  }
 
   for (BasicBlock::iterator II = BB->end(); II != BB->begin();) {
     Instruction &I = *--II;
@@ -517,8 +613,7 @@ bool llvm::sinkRegion(DomTreeNode *N, AliasAnalysis *AA, LoopInfo *LI,
     if (isInstructionTriviallyDead(&I, TLI)) {
       DEBUG(dbgs() << "LICM deleting dead inst: " << I << '\n');
       ++II;
-      CurAST->deleteValue(&I);
-      I.eraseFromParent();
+      eraseInstruction(I, CurAST, MSSAU);
       Changed = true;
       continue;
     }
@@ -529,9 +624,10 @@ bool llvm::sinkRegion(DomTreeNode *N, AliasAnalysis *AA, LoopInfo *LI,
     // operands of the instruction are loop invariant.
     //
     if (isNotUsedInLoop(I, CurLoop, SafetyInfo) &&
-        canSinkOrHoistInst(I, AA, DT, CurLoop, CurAST, SafetyInfo, ORE)) {
+        canSinkOrHoistInst(I, AA, DT, CurLoop, CurAST, SafetyInfo, ORE, MSSAU,
+                           LicmMssaOptCounter)) {
       ++II;
-      Changed |= sink(I, LI, DT, CurLoop, CurAST, SafetyInfo, ORE);
+      Changed |= sink(I, LI, DT, CurLoop, CurAST, SafetyInfo, ORE, MSSAU);
     }
   }
   return Changed;
@@ -545,7 +641,8 @@ bool llvm::sinkRegion(DomTreeNode *N, AliasAnalysis *AA, LoopInfo *LI,
 bool llvm::hoistRegion(DomTreeNode *N, AliasAnalysis *AA, LoopInfo *LI,
                        DominatorTree *DT, TargetLibraryInfo *TLI, Loop *CurLoop,
                        AliasSetTracker *CurAST, LoopSafetyInfo *SafetyInfo,
-                       OptimizationRemarkEmitter *ORE, bool Rhino) {
+                       OptimizationRemarkEmitter *ORE, bool Rhino,
+                       MemorySSAUpdater *MSSAU, unsigned *LicmMssaOptCounter) {
   // Verify inputs.
   assert(N != nullptr && AA != nullptr && LI != nullptr && DT != nullptr &&
          CurLoop != nullptr && CurAST != nullptr && SafetyInfo != nullptr &&
@@ -560,9 +657,14 @@ bool llvm::hoistRegion(DomTreeNode *N, AliasAnalysis *AA, LoopInfo *LI,
   // Only need to process the contents of this block if it is not part of a
   // subloop (which would already have been processed).
   bool Changed = false;
+  AliasSetTracker *LoopAST = CurAST;
   if (!inSubLoop(BB, CurLoop, LI)) {
-    if (Rhino)
-      CurAST = collectAliasInfoForLoopAtPoint(CurLoop, LI, AA, &*BB->begin(), /*collectBefore*/true, /*onlyBlock*/true);
+    BatchAAResults BatchAA(*AA);
+    std::unique_ptr<AliasSetTracker> BlockAST;
+    if (Rhino) {
+      BlockAST.reset(collectAliasInfoForLoopAtPoint(CurLoop, LI, AA, &*BB->begin(), /*collectBefore*/true, /*onlyBlock*/true, &BatchAA));
+      CurAST = BlockAST.get();
+    }
 
     for (BasicBlock::iterator II = BB->begin(), E = BB->end(); II != E;) {
       Instruction &I = *II++;
@@ -576,10 +678,8 @@ bool llvm::hoistRegion(DomTreeNode *N, AliasAnalysis *AA, LoopInfo *LI,
         DEBUG(dbgs() << "LICM folding inst: " << I << "  --> " << *C << '\n');
         CurAST->copyValue(&I, C);
         I.replaceAllUsesWith(C);
-        if (isInstructionTriviallyDead(&I, TLI)) {
-          CurAST->deleteValue(&I);
-          I.eraseFromParent();
-        }
+        if (isInstructionTriviallyDead(&I, TLI))
+          eraseInstruction(I, CurAST, MSSAU);
         Changed = true;
         continue;
       }
@@ -600,9 +700,10 @@ bool llvm::hoistRegion(DomTreeNode *N, AliasAnalysis *AA, LoopInfo *LI,
         Product->setFastMathFlags(I.getFastMathFlags());
         Product->insertAfter(&I);
         I.replaceAllUsesWith(Product);
+        CurAST->deleteValue(&I);
         I.eraseFromParent();
 
-        hoist(*ReciprocalDivisor, DT, CurLoop, SafetyInfo, ORE);
+        hoist(*ReciprocalDivisor, DT, CurLoop, SafetyInfo, ORE, MSSAU);
         Changed = true;
         continue;
       }
@@ -612,18 +713,20 @@ bool llvm::hoistRegion(DomTreeNode *N, AliasAnalysis *AA, LoopInfo *LI,
       // is safe to hoist the instruction.
       //
       if (CurLoop->hasLoopInvariantOperands(&I) &&
-          canSinkOrHoistInst(I, AA, DT, CurLoop, CurAST, SafetyInfo, ORE) &&
+          canSinkOrHoistInst(I, AA, DT, CurLoop, CurAST, SafetyInfo, ORE,
+                             MSSAU, LicmMssaOptCounter) &&
           isSafeToExecuteUnconditionally(
               I, DT, CurLoop, SafetyInfo, ORE,
               CurLoop->getLoopPreheader()->getTerminator()))
-        Changed |= hoist(I, DT, CurLoop, SafetyInfo, ORE);
+        Changed |= hoist(I, DT, CurLoop, SafetyInfo, ORE, MSSAU);
     }
   }
 
   const std::vector<DomTreeNode *> &Children = N->getChildren();
   for (DomTreeNode *Child : Children)
     Changed |=
-        hoistRegion(Child, AA, LI, DT, TLI, CurLoop, CurAST, SafetyInfo, ORE, Rhino);
+        hoistRegion(Child, AA, LI, DT, TLI, CurLoop, LoopAST, SafetyInfo, ORE, Rhino,
+                    MSSAU, LicmMssaOptCounter);
   return Changed;
 }
 
@@ -719,7 +822,11 @@ static bool isLoadInvariantInLoop(LoadInst *LI, DominatorTree *DT,
 bool llvm::canSinkOrHoistInst(Instruction &I, AAResults *AA, DominatorTree *DT,
                               Loop *CurLoop, AliasSetTracker* CurAST,
                               LoopSafetyInfo *SafetyInfo,
-                              OptimizationRemarkEmitter *ORE) {
+                              OptimizationRemarkEmitter *ORE,
+                              MemorySSAUpdater *MSSAU,
+                              unsigned *LicmMssaOptCounter) {
+  assert((!MSSAU || LicmMssaOptCounter) &&
+         "MemorySSA queries need a per-loop counter");
   // Loads have extra constraints we have to verify before we can hoist them.
   if (LoadInst *LI = dyn_cast<LoadInst>(&I)) {
     if (!LI->isUnordered())
@@ -745,7 +852,12 @@ bool llvm::canSinkOrHoistInst(Instruction &I, AAResults *AA, DominatorTree *DT,
     LI->getAAMetadata(AAInfo);
 
     bool Invalidated =
-        pointerInvalidatedByLoop(LI->getOperand(0), Size, AAInfo, CurAST);
+        MSSAU ? pointerInvalidatedByLoopWithMSSA(
+                    MSSAU->getMemorySSA(),
+                    MSSAU->getMemorySSA()->getMemoryAccess(LI), CurLoop,
+                    *LicmMssaOptCounter)
+              : pointerInvalidatedByLoop(LI->getOperand(0), Size, AAInfo,
+                                         CurAST);
     // Check loop-invariant address because this may also be a sinkable load
     // whose address is not necessarily loop-invariant.
     if (ORE && Invalidated && CurLoop->isLoopInvariant(LI->getPointerOperand()))
@@ -769,6 +881,14 @@ bool llvm::canSinkOrHoistInst(Instruction &I, AAResults *AA, DominatorTree *DT,
     if (Behavior == FMRB_DoesNotAccessMemory)
       return true;
     if (AliasAnalysis::onlyReadsMemory(Behavior)) {
+      // With MemorySSA, the call's clobbering access already accounts for
+      // exactly the memory it may read.
+      if (MSSAU)
+        return !pointerInvalidatedByLoopWithMSSA(
+            MSSAU->getMemorySSA(),
+            MSSAU->getMemorySSA()->getMemoryAccess(CI), CurLoop,
+            *LicmMssaOptCounter);
+
       // A readonly argmemonly function only reads from memory pointed to by
       // it's arguments with arbitrary offsets.  If we can prove there are no
       // writes to this memory in the loop, we can hoist or sink.
@@ -949,7 +1069,7 @@ CloneInstructionInExitBlock(Instruction &I, BasicBlock &ExitBlock, PHINode &PN,
 static bool sink(Instruction &I, const LoopInfo *LI, const DominatorTree *DT,
                  const Loop *CurLoop, AliasSetTracker *CurAST,
                  const LoopSafetyInfo *SafetyInfo,
-                 OptimizationRemarkEmitter *ORE) {
+                 OptimizationRemarkEmitter *ORE, MemorySSAUpdater *MSSAU) {
   DEBUG(dbgs() << "LICM sinking instruction: " << I << "\n");
   ORE->emit(OptimizationRemark(DEBUG_TYPE, "InstSunk", &I)
             << "sinking " << ore::NV("Inst", &I));
@@ -1002,16 +1122,18 @@ static bool sink(Instruction &I, const LoopInfo *LI, const DominatorTree *DT,
     auto It = SunkCopies.find(ExitBlock);
     if (It != SunkCopies.end())
       New = It->second;
-    else
+    else {
       New = SunkCopies[ExitBlock] =
           CloneInstructionInExitBlock(I, *ExitBlock, *PN, LI, SafetyInfo);
+      if (MSSAU && MSSAU->getMemorySSA()->getMemoryAccess(&I))
+        insertMemoryAccess(New, MSSAU);
+    }
 
     PN->replaceAllUsesWith(New);
     PN->eraseFromParent();
   }
 
-  CurAST->deleteValue(&I);
-  I.eraseFromParent();
+  eraseInstruction(I, CurAST, MSSAU);
   return Changed;
 }
 
@@ -1020,7 +1142,7 @@ static bool sink(Instruction &I, const LoopInfo *LI, const DominatorTree *DT,
 ///
 static bool hoist(Instruction &I, const DominatorTree *DT, const Loop *CurLoop,
                   const LoopSafetyInfo *SafetyInfo,
-                  OptimizationRemarkEmitter *ORE) {
+                  OptimizationRemarkEmitter *ORE, MemorySSAUpdater *MSSAU) {
   auto *Preheader = CurLoop->getLoopPreheader();
   DEBUG(dbgs() << "LICM hoisting to " << Preheader->getName() << ": " << I
                << "\n");
@@ -1040,6 +1162,16 @@ static bool hoist(Instruction &I, const DominatorTree *DT, const Loop *CurLoop,
 
   // Move the new node to the Preheader, before its terminator.
   I.moveBefore(Preheader->getTerminator());
+  if (MSSAU)
+    if (MemoryUseOrDef *OldMA = MSSAU->getMemorySSA()->getMemoryAccess(&I)) {
+      // The terminator may itself have an access (e.g. a detach), so place
+      // the moved access before the next one rather than at the block end.
+      if (MemoryUseOrDef *Next =
+              findNextMemoryAccess(&I, MSSAU->getMemorySSA()))
+        MSSAU->moveBefore(OldMA, Next);
+      else
+        MSSAU->moveToPlace(OldMA, Preheader, MemorySSA::End);
+    }
 
   // Do not retain debug locations when we are moving instructions to different
   // basic blocks, because we want to avoid jumpy line tables. Calls, however,
@@ -1092,6 +1224,7 @@ class LoopPromoter : public LoadAndStorePromoter {
   SmallVectorImpl<Instruction *> &LoopInsertPts;
   PredIteratorCache &PredCache;
   AliasSetTracker &AST;
+  MemorySSAUpdater *MSSAU;
   LoopInfo &LI;
   DebugLoc DL;
   int Alignment;
@@ -1118,11 +1251,12 @@ public:
                SmallPtrSetImpl<Value *> &PMA,
                SmallVectorImpl<BasicBlock *> &LEB,
                SmallVectorImpl<Instruction *> &LIP, PredIteratorCache &PIC,
-               AliasSetTracker &ast, LoopInfo &li, DebugLoc dl, int alignment,
-               bool UnorderedAtomic, const AAMDNodes &AATags)
+               AliasSetTracker &ast, MemorySSAUpdater *MSSAU, LoopInfo &li,
+               DebugLoc dl, int alignment, bool UnorderedAtomic,
+               const AAMDNodes &AATags)
       : LoadAndStorePromoter(Insts, S), SomePtr(SP), PointerMustAliases(PMA),
         LoopExitBlocks(LEB), LoopInsertPts(LIP), PredCache(PIC), AST(ast),
-        LI(li), DL(std::move(dl)), Alignment(alignment),
+        MSSAU(MSSAU), LI(li), DL(std::move(dl)), Alignment(alignment),
         UnorderedAtomic(UnorderedAtomic),AATags(AATags) {}
 
   bool isInstInList(Instruction *I,
@@ -1153,6 +1287,8 @@ public:
       NewSI->setDebugLoc(DL);
       if (AATags)
         NewSI->setAAMetadata(AATags);
+      if (MSSAU)
+        insertMemoryAccess(NewSI, MSSAU);
     }
   }
 
@@ -1160,7 +1296,12 @@ public:
     // Update alias analysis.
     AST.copyValue(LI, V);
   }
-  void instructionDeleted(Instruction *I) const override { AST.deleteValue(I); }
+  void instructionDeleted(Instruction *I) const override {
+    AST.deleteValue(I);
+    if (MSSAU)
+      if (MemoryAccess *MA = MSSAU->getMemorySSA()->getMemoryAccess(I))
+        MSSAU->removeMemoryAccess(MA);
+  }
 };
 } // end anon namespace
 
@@ -1174,7 +1315,7 @@ bool llvm::promoteLoopAccessesToScalars(
     SmallVectorImpl<Instruction *> &InsertPts, PredIteratorCache &PIC,
     LoopInfo *LI, DominatorTree *DT, const TargetLibraryInfo *TLI,
     Loop *CurLoop, AliasSetTracker *CurAST, LoopSafetyInfo *SafetyInfo,
-    OptimizationRemarkEmitter *ORE) {
+    OptimizationRemarkEmitter *ORE, MemorySSAUpdater *MSSAU) {
   // Verify inputs.
   assert(LI != nullptr && DT != nullptr && CurLoop != nullptr &&
          CurAST != nullptr && SafetyInfo != nullptr &&
@@ -1450,7 +1591,7 @@ bool llvm::promoteLoopAccessesToScalars(
   SmallVector<PHINode *, 16> NewPHIs;
   SSAUpdater SSA(&NewPHIs);
   LoopPromoter Promoter(SomePtr, LoopUses, SSA, PointerMustAliases, ExitBlocks,
-                        InsertPts, PIC, *CurAST, *LI, DL, Alignment,
+                        InsertPts, PIC, *CurAST, MSSAU, *LI, DL, Alignment,
                         SawUnorderedAtomic, AATags);
 
   // Set up the preheader to have a definition of the value.  It is the live-out
@@ -1463,6 +1604,8 @@ bool llvm::promoteLoopAccessesToScalars(
   PreheaderLoad->setDebugLoc(DL);
   if (AATags)
     PreheaderLoad->setAAMetadata(AATags);
+  if (MSSAU)
+    insertMemoryAccess(PreheaderLoad, MSSAU);
   SSA.AddAvailableValue(Preheader, PreheaderLoad);
 
   // Rewrite all the loads in the loop and remember all the definitions from
@@ -1471,7 +1614,7 @@ bool llvm::promoteLoopAccessesToScalars(
 
   // If the SSAUpdater didn't use the load in the preheader, just zap it now.
   if (PreheaderLoad->use_empty())
-    PreheaderLoad->eraseFromParent();
+    eraseInstruction(*PreheaderLoad, CurAST, MSSAU);
 
   return true;
 }
@@ -1540,6 +1683,63 @@ static bool pointerInvalidatedByLoop(Value *V, uint64_t Size,
   return CurAST->getAliasSetForPointer(V, Size, AAInfo).isMod();
 }
 
+/// Return true if the memory read by \p MUD may be written inside CurLoop,
+/// i.e. if its clobbering access is a def or phi in the loop.  Accesses without
+/// MemorySSA information are conservatively treated as invalidated.
+static bool pointerInvalidatedByLoopWithMSSA(MemorySSA *MSSA,
+                                             MemoryUseOrDef *MUD,
+                                             Loop *CurLoop,
+                                             unsigned &LicmMssaOptCounter) {
+  if (!MUD || !isa<MemoryUse>(MUD))
+    return true;
+
+  MemoryAccess *Source;
+  if (LicmMssaOptCounter < LicmMssaOptCap) {
+    Source = MSSA->getWalker()->getClobberingMemoryAccess(MUD);
+    ++LicmMssaOptCounter;
+  } else {
+    // The defining access is a def or phi that dominates the use; if it is
+    // outside of the loop, so is the clobber.
+    Source = MUD->getDefiningAccess();
+    ++NumMssaOptCapped;
+  }
+  return !MSSA->isLiveOnEntryDef(Source) &&
+         CurLoop->contains(Source->getBlock());
+}
+
+/// Remove \p I from the IR, the alias sets and MemorySSA.
+static void eraseInstruction(Instruction &I, AliasSetTracker *AST,
+                             MemorySSAUpdater *MSSAU) {
+  AST->deleteValue(&I);
+  if (MSSAU)
+    if (MemoryAccess *MA = MSSAU->getMemorySSA()->getMemoryAccess(&I))
+      MSSAU->removeMemoryAccess(MA);
+  I.eraseFromParent();
+}
+
+/// Return the first memory access after \p I in its block, if any.
+static MemoryUseOrDef *findNextMemoryAccess(Instruction *I, MemorySSA *MSSA) {
+  for (Instruction *Next = I->getNextNode(); Next; Next = Next->getNextNode())
+    if (MemoryUseOrDef *MUD = MSSA->getMemoryAccess(Next))
+      return MUD;
+  return nullptr;
+}
+
+/// Create the MemorySSA access for \p I, which LICM has just inserted into
+/// the IR, and hook it up to the surrounding defs.
+static void insertMemoryAccess(Instruction *I, MemorySSAUpdater *MSSAU) {
+  MemoryAccess *NewMA;
+  if (MemoryUseOrDef *Next = findNextMemoryAccess(I, MSSAU->getMemorySSA()))
+    NewMA = MSSAU->createMemoryAccessBefore(I, nullptr, Next);
+  else
+    NewMA = MSSAU->createMemoryAccessInBB(I, nullptr, I->getParent(),
+                                          MemorySSA::End);
+  if (auto *MD = dyn_cast<MemoryDef>(NewMA))
+    MSSAU->insertDef(MD, /*RenameUses=*/true);
+  else
+    MSSAU->insertUse(cast<MemoryUse>(NewMA));
+}
+
 /// Little predicate that returns true if the specified basic block is in
 /// a subloop of the current one, not the current one itself.
 ///
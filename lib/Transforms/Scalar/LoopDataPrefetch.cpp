@@ -59,17 +59,41 @@ static cl::opt<unsigned> MaxPrefetchIterationsAhead(
     "max-prefetch-iters-ahead",
     cl::desc("Max number of iterations to prefetch ahead"), cl::Hidden);
 
+static cl::opt<bool>
+    PrefetchIndirect("loop-prefetch-indirect", cl::Hidden, cl::init(true),
+                     cl::desc("Prefetch indirect accesses of the form "
+                              "A[B[i]]"));
+
+// Each indirect prefetch costs a load, the clamping of its iteration and a
+// copy of the address computation, so only a few are worth it in one loop.
+static cl::opt<unsigned> MaxIndirectPrefetches(
+    "max-indirect-prefetches", cl::Hidden, cl::init(4),
+    cl::desc("Max number of indirect prefetches inserted in a loop"));
+
 STATISTIC(NumPrefetches, "Number of prefetches inserted");
+STATISTIC(NumIndirectPrefetches, "Number of indirect prefetches inserted");
 
 namespace {
 
+/// An access whose address is computed from an index loaded in the loop.
+struct IndirectAccess {
+  /// The load or store to prefetch for.
+  Instruction *MemI;
+  /// The load of the index, whose address is an affine recurrence.
+  LoadInst *IndexLoad;
+  /// The address accessed by MemI.
+  const SCEV *PtrSCEV;
+  /// The instructions computing the address from the index, in order.
+  SmallVector<Instruction *, 4> Chain;
+};
+
 /// Loop prefetch implementation class.
 class LoopDataPrefetch {
 public:
-  LoopDataPrefetch(AssumptionCache *AC, LoopInfo *LI, ScalarEvolution *SE,
-                   const TargetTransformInfo *TTI,
+  LoopDataPrefetch(AssumptionCache *AC, DominatorTree *DT, LoopInfo *LI,
+                   ScalarEvolution *SE, const TargetTransformInfo *TTI,
                    OptimizationRemarkEmitter *ORE)
-      : AC(AC), LI(LI), SE(SE), TTI(TTI), ORE(ORE) {}
+      : AC(AC), DT(DT), LI(LI), SE(SE), TTI(TTI), ORE(ORE) {}
 
   bool run();
 
@@ -80,6 +104,19 @@ private:
   /// warrant a prefetch.
   bool isStrideLargeEnough(const SCEVAddRecExpr *AR);
 
+  /// \brief If \p PtrValue is computed from a value loaded with an affine
+  /// address in \p L, return that load and fill \p Chain with the
+  /// instructions that compute \p PtrValue from it, in execution order.
+  LoadInst *getIndexLoad(Loop *L, Value *PtrValue,
+                         SmallVectorImpl<Instruction *> &Chain);
+
+  /// \brief Check that once entered, \p L runs exactly as many iterations
+  /// as its computable trip count and exits only from its latch.
+  bool runsToTripCount(Loop *L);
+
+  /// \brief Insert a prefetch of \p PtrValue before \p MemI.
+  void insertPrefetch(Instruction *MemI, Value *PtrValue);
+
   unsigned getMinPrefetchStride() {
     if (MinPrefetchStride.getNumOccurrences() > 0)
       return MinPrefetchStride;
@@ -99,6 +136,7 @@ private:
   }
 
   AssumptionCache *AC;
+  DominatorTree *DT;
   LoopInfo *LI;
   ScalarEvolution *SE;
   const TargetTransformInfo *TTI;
@@ -115,6 +153,7 @@ public:
 
   void getAnalysisUsage(AnalysisUsage &AU) const override {
     AU.addRequired<AssumptionCacheTracker>();
+    AU.addRequired<DominatorTreeWrapperPass>();
     AU.addPreserved<DominatorTreeWrapperPass>();
     AU.addRequired<LoopInfoWrapperPass>();
     AU.addPreserved<LoopInfoWrapperPass>();
@@ -134,6 +173,7 @@ char LoopDataPrefetchLegacyPass::ID = 0;
 INITIALIZE_PASS_BEGIN(LoopDataPrefetchLegacyPass, "loop-data-prefetch",
                       "Loop Data Prefetch", false, false)
 INITIALIZE_PASS_DEPENDENCY(AssumptionCacheTracker)
+INITIALIZE_PASS_DEPENDENCY(DominatorTreeWrapperPass)
 INITIALIZE_PASS_DEPENDENCY(TargetTransformInfoWrapperPass)
 INITIALIZE_PASS_DEPENDENCY(LoopInfoWrapperPass)
 INITIALIZE_PASS_DEPENDENCY(OptimizationRemarkEmitterWrapperPass)
@@ -145,6 +185,17 @@ FunctionPass *llvm::createLoopDataPrefetchPass() {
   return new LoopDataPrefetchLegacyPass();
 }
 
+/// Return the address accessed by \p I if it is a load, or a store and writes
+/// are prefetched.
+static Value *getPrefetchedPointer(Instruction *I) {
+  if (LoadInst *LMemI = dyn_cast<LoadInst>(I))
+    return LMemI->getPointerOperand();
+  if (StoreInst *SMemI = dyn_cast<StoreInst>(I))
+    if (PrefetchWrites)
+      return SMemI->getPointerOperand();
+  return nullptr;
+}
+
 bool LoopDataPrefetch::isStrideLargeEnough(const SCEVAddRecExpr *AR) {
   unsigned TargetMinStride = getMinPrefetchStride();
   // No need to check if any stride goes.
@@ -161,8 +212,81 @@ bool LoopDataPrefetch::isStrideLargeEnough(const SCEVAddRecExpr *AR) {
   return TargetMinStride <= AbsStride;
 }
 
+LoadInst *LoopDataPrefetch::getIndexLoad(Loop *L, Value *PtrValue,
+                                         SmallVectorImpl<Instruction *> &Chain) {
+  // Walk back from the address through the GEP and any casts or arithmetic
+  // with loop-invariant operands until we reach the load of the index.
+  Value *V = PtrValue;
+  while (Chain.size() < 4) {
+    auto *I = dyn_cast<Instruction>(V);
+    if (!I || !L->contains(I))
+      return nullptr;
+
+    if (auto *IndexLoad = dyn_cast<LoadInst>(I)) {
+      if (!IndexLoad->isSimple() || Chain.empty())
+        return nullptr;
+      auto *AR = dyn_cast<SCEVAddRecExpr>(
+          SE->getSCEV(IndexLoad->getPointerOperand()));
+      if (!AR || AR->getLoop() != L || !AR->isAffine())
+        return nullptr;
+      std::reverse(Chain.begin(), Chain.end());
+      return IndexLoad;
+    }
+
+    if (!isa<GetElementPtrInst>(I) && !isa<CastInst>(I) &&
+        !isa<BinaryOperator>(I))
+      return nullptr;
+    if (I->mayHaveSideEffects() || !isSafeToSpeculativelyExecute(I))
+      return nullptr;
+
+    // Exactly one operand may vary in the loop.
+    Value *Varying = nullptr;
+    for (Value *Op : I->operands()) {
+      if (L->isLoopInvariant(Op))
+        continue;
+      if (Varying)
+        return nullptr;
+      Varying = Op;
+    }
+    if (!Varying)
+      return nullptr;
+
+    Chain.push_back(I);
+    V = Varying;
+  }
+  return nullptr;
+}
+
+bool LoopDataPrefetch::runsToTripCount(Loop *L) {
+  BasicBlock *Latch = L->getLoopLatch();
+  if (!Latch || L->getExitingBlock() != Latch)
+    return false;
+  if (isa<SCEVCouldNotCompute>(SE->getBackedgeTakenCount(L)))
+    return false;
+  for (const auto BB : L->blocks())
+    for (auto &I : *BB)
+      if (!isGuaranteedToTransferExecutionToSuccessor(&I))
+        return false;
+  return true;
+}
+
+void LoopDataPrefetch::insertPrefetch(Instruction *MemI, Value *PtrValue) {
+  BasicBlock *BB = MemI->getParent();
+  IRBuilder<> Builder(MemI);
+  Module *M = BB->getParent()->getParent();
+  Type *I32 = Type::getInt32Ty(BB->getContext());
+  Value *PrefetchFunc = Intrinsic::getDeclaration(M, Intrinsic::prefetch);
+  Builder.CreateCall(
+      PrefetchFunc,
+      {PtrValue,
+       ConstantInt::get(I32, MemI->mayReadFromMemory() ? 0 : 1),
+       ConstantInt::get(I32, 3), ConstantInt::get(I32, 1)});
+  ++NumPrefetches;
+}
+
 PreservedAnalyses LoopDataPrefetchPass::run(Function &F,
                                             FunctionAnalysisManager &AM) {
+  DominatorTree *DT = &AM.getResult<DominatorTreeAnalysis>(F);
   LoopInfo *LI = &AM.getResult<LoopAnalysis>(F);
   ScalarEvolution *SE = &AM.getResult<ScalarEvolutionAnalysis>(F);
   AssumptionCache *AC = &AM.getResult<AssumptionAnalysis>(F);
@@ -170,7 +294,7 @@ PreservedAnalyses LoopDataPrefetchPass::run(Function &F,
       &AM.getResult<OptimizationRemarkEmitterAnalysis>(F);
   const TargetTransformInfo *TTI = &AM.getResult<TargetIRAnalysis>(F);
 
-  LoopDataPrefetch LDP(AC, LI, SE, TTI, ORE);
+  LoopDataPrefetch LDP(AC, DT, LI, SE, TTI, ORE);
   bool Changed = LDP.run();
 
   if (Changed) {
@@ -187,6 +311,7 @@ bool LoopDataPrefetchLegacyPass::runOnFunction(Function &F) {
   if (skipFunction(F))
     return false;
 
+  DominatorTree *DT = &getAnalysis<DominatorTreeWrapperPass>().getDomTree();
   LoopInfo *LI = &getAnalysis<LoopInfoWrapperPass>().getLoopInfo();
   ScalarEvolution *SE = &getAnalysis<ScalarEvolutionWrapperPass>().getSE();
   AssumptionCache *AC =
@@ -196,7 +321,7 @@ bool LoopDataPrefetchLegacyPass::runOnFunction(Function &F) {
   const TargetTransformInfo *TTI =
       &getAnalysis<TargetTransformInfoWrapperPass>().getTTI(F);
 
-  LoopDataPrefetch LDP(AC, LI, SE, TTI, ORE);
+  LoopDataPrefetch LDP(AC, DT, LI, SE, TTI, ORE);
   return LDP.run();
 }
 
@@ -255,20 +380,61 @@ bool LoopDataPrefetch::runOnLoop(Loop *L) {
                << " iterations ahead (loop size: " << LoopSize << ") in "
                << L->getHeader()->getParent()->getName() << ": " << *L);
 
+  // Find the indirect accesses A[f(B[i])] first.  The index B[i + d] is
+  // loaded speculatively to prefetch A[f(B[i + d])], clamping i + d to the
+  // last iteration.  That only reads memory the loop reads anyway if the loop
+  // runs to its trip count and the index load executes on every iteration.
+  // The index loads are then prefetched twice as far ahead as the rest, so
+  // that B[i + d] is usually in cache by the time it is loaded here.
+  SmallVector<IndirectAccess, 4> IndirectAccesses;
+  SmallPtrSet<Instruction *, 4> IndexLoads;
+  if (PrefetchIndirect && runsToTripCount(L)) {
+    BasicBlock *Latch = L->getLoopLatch();
+    for (const auto BB : L->blocks()) {
+      for (auto &I : *BB) {
+        Value *PtrValue = getPrefetchedPointer(&I);
+        if (!PtrValue || PtrValue->getType()->getPointerAddressSpace())
+          continue;
+
+        SmallVector<Instruction *, 4> Chain;
+        LoadInst *IndexLoad = getIndexLoad(L, PtrValue, Chain);
+        if (!IndexLoad || !DT->dominates(IndexLoad->getParent(), Latch))
+          continue;
+
+        // Don't prefetch the same cache line twice for one index.
+        const SCEV *PtrSCEV = SE->getSCEV(PtrValue);
+        bool DupPref = false;
+        for (const auto &Access : IndirectAccesses) {
+          if (Access.IndexLoad != IndexLoad)
+            continue;
+          const SCEV *PtrDiff = SE->getMinusSCEV(PtrSCEV, Access.PtrSCEV);
+          if (const SCEVConstant *ConstPtrDiff =
+              dyn_cast<SCEVConstant>(PtrDiff)) {
+            int64_t PD = std::abs(ConstPtrDiff->getValue()->getSExtValue());
+            if (PD < (int64_t) TTI->getCacheLineSize()) {
+              DupPref = true;
+              break;
+            }
+          }
+        }
+        if (DupPref)
+          continue;
+
+        if (IndirectAccesses.size() == MaxIndirectPrefetches)
+          break;
+        IndirectAccesses.push_back({&I, IndexLoad, PtrSCEV, Chain});
+        IndexLoads.insert(IndexLoad);
+      }
+    }
+  }
+
   SmallVector<std::pair<Instruction *, const SCEVAddRecExpr *>, 16> PrefLoads;
   for (const auto BB : L->blocks()) {
     for (auto &I : *BB) {
-      Value *PtrValue;
-      Instruction *MemI;
-
-      if (LoadInst *LMemI = dyn_cast<LoadInst>(&I)) {
-        MemI = LMemI;
-        PtrValue = LMemI->getPointerOperand();
-      } else if (StoreInst *SMemI = dyn_cast<StoreInst>(&I)) {
-        if (!PrefetchWrites) continue;
-        MemI = SMemI;
-        PtrValue = SMemI->getPointerOperand();
-      } else continue;
+      Value *PtrValue = getPrefetchedPointer(&I);
+      if (!PtrValue)
+        continue;
+      Instruction *MemI = &I;
 
       unsigned PtrAddrSpace = PtrValue->getType()->getPointerAddressSpace();
       if (PtrAddrSpace)
@@ -305,8 +471,9 @@ bool LoopDataPrefetch::runOnLoop(Loop *L) {
       if (DupPref)
         continue;
 
+      unsigned Ahead = IndexLoads.count(MemI) ? 2 * ItersAhead : ItersAhead;
       const SCEV *NextLSCEV = SE->getAddExpr(LSCEVAddRec, SE->getMulExpr(
-        SE->getConstant(LSCEVAddRec->getType(), ItersAhead),
+        SE->getConstant(LSCEVAddRec->getType(), Ahead),
         LSCEVAddRec->getStepRecurrence(*SE)));
       if (!isSafeToExpand(NextLSCEV, *SE))
         continue;
@@ -317,16 +484,7 @@ bool LoopDataPrefetch::runOnLoop(Loop *L) {
       SCEVExpander SCEVE(*SE, I.getModule()->getDataLayout(), "prefaddr");
       Value *PrefPtrValue = SCEVE.expandCodeFor(NextLSCEV, I8Ptr, MemI);
 
-      IRBuilder<> Builder(MemI);
-      Module *M = BB->getParent()->getParent();
-      Type *I32 = Type::getInt32Ty(BB->getContext());
-      Value *PrefetchFunc = Intrinsic::getDeclaration(M, Intrinsic::prefetch);
-      Builder.CreateCall(
-          PrefetchFunc,
-          {PrefPtrValue,
-           ConstantInt::get(I32, MemI->mayReadFromMemory() ? 0 : 1),
-           ConstantInt::get(I32, 3), ConstantInt::get(I32, 1)});
-      ++NumPrefetches;
+      insertPrefetch(MemI, PrefPtrValue);
       DEBUG(dbgs() << "  Access: " << *PtrValue << ", SCEV: " << *LSCEV
                    << "\n");
       ORE->emit(OptimizationRemark(DEBUG_TYPE, "Prefetched", MemI)
@@ -336,6 +494,58 @@ bool LoopDataPrefetch::runOnLoop(Loop *L) {
     }
   }
 
+  for (const auto &Access : IndirectAccesses) {
+    Instruction *MemI = Access.MemI;
+    LoadInst *IndexLoad = Access.IndexLoad;
+
+    // Compute the address of the index umin(i + d, trip count - 1) iterations
+    // into the loop.
+    const SCEV *BECount = SE->getBackedgeTakenCount(L);
+    Type *CountTy = BECount->getType();
+    const SCEV *Iteration = SE->getAddRecExpr(
+        SE->getConstant(CountTy, ItersAhead), SE->getOne(CountTy), L,
+        SCEV::FlagAnyWrap);
+    Iteration = SE->getUMinExpr(Iteration, BECount);
+    const auto *IndexAR =
+        cast<SCEVAddRecExpr>(SE->getSCEV(IndexLoad->getPointerOperand()));
+    Iteration = SE->getTruncateOrZeroExtend(
+        Iteration, SE->getEffectiveSCEVType(IndexAR->getType()));
+    const SCEV *IndexAddr = IndexAR->evaluateAtIteration(Iteration, *SE);
+    if (!isSafeToExpand(IndexAddr, *SE))
+      continue;
+
+    SCEVExpander SCEVE(*SE, MemI->getModule()->getDataLayout(), "prefidx");
+    Value *IndexPtr = SCEVE.expandCodeFor(
+        IndexAddr, IndexLoad->getPointerOperandType(), MemI);
+
+    // Load the index and repeat the address computation on it.  The copy may
+    // compute an address the loop never accesses, so drop any flags that
+    // would make it poison.
+    IRBuilder<> Builder(MemI);
+    ValueToValueMapTy VMap;
+    VMap[IndexLoad] = Builder.CreateAlignedLoad(
+        IndexPtr, IndexLoad->getAlignment(), IndexLoad->getName() + ".pref");
+    Instruction *PrefAddr = nullptr;
+    for (Instruction *I : Access.Chain) {
+      PrefAddr = I->clone();
+      PrefAddr->dropPoisonGeneratingFlags();
+      RemapInstruction(PrefAddr, VMap,
+                       RF_NoModuleLevelChanges | RF_IgnoreMissingLocals);
+      Builder.Insert(PrefAddr, I->getName() + ".pref");
+      VMap[I] = PrefAddr;
+    }
+    Value *PrefPtrValue =
+        Builder.CreateBitCast(PrefAddr, Type::getInt8PtrTy(MemI->getContext()));
+
+    insertPrefetch(MemI, PrefPtrValue);
+    ++NumIndirectPrefetches;
+    DEBUG(dbgs() << "  Indirect access: " << *MemI << ", index: "
+                 << *IndexLoad << "\n");
+    ORE->emit(OptimizationRemark(DEBUG_TYPE, "PrefetchedIndirect", MemI)
+              << "prefetched indirect memory access");
+
+    MadeChange = true;
+  }
+
   return MadeChange;
 }
-
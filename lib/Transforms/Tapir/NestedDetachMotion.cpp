@@ -40,7 +40,10 @@ struct NestedDetachMotion : public FunctionPass {
         populateDetachedCFG(*det2, DT, functionPieces, reattachB, ExitBlocks, false);
         bool legal = true;
 
-        AliasSetTracker CurAST(AA);
+        // Nothing is mutated while the tracker is built and queried, so all
+        // of its alias queries can share one cache.
+        BatchAAResults BatchAA(AA);
+        AliasSetTracker CurAST(AA, BatchAA);
         for (Instruction &I : *det->getDetached()) {
           if (det2->getSyncRegion() == &I)
             continue;
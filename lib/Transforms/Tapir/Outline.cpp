@@ -15,6 +15,7 @@
 #include "llvm/Transforms/Tapir/Outline.h"
 #include "llvm/IR/DebugInfo.h"
 #include "llvm/IR/DIBuilder.h"
+#include "llvm/IR/FunctionArena.h"
 #include "llvm/IR/IntrinsicInst.h"
 #include "llvm/Transforms/Utils/Cloning.h"
 #include "llvm/Transforms/Utils/BasicBlockUtils.h"
@@ -102,6 +103,8 @@ void llvm::CloneIntoFunction(
     const StringRef NameSuffix, SmallPtrSetImpl<BasicBlock *> *ExitBlocks,
     DISubprogram *SP, ClonedCodeInfo *CodeInfo,
     ValueMapTypeRemapper *TypeMapper, ValueMaterializer *Materializer) {
+  FunctionArena::Scope ArenaScope(NewFunc->getOrCreateArena());
+
   // Get the predecessors of the exit blocks
   SmallPtrSet<const BasicBlock *, 4> ExitBlockPreds, ClonedEBPreds;
   if (ExitBlocks)
@@ -11,6 +11,7 @@
 #include "llvm/IR/Function.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/CFG.h"
+#include "llvm/IR/CompileTimeBudget.h"
 #include "llvm/ADT/SmallSet.h"
 
 #include <deque>
@@ -41,6 +42,10 @@ struct SyncElimination : public FunctionPass {
     bool ChangedAny = false;
 
     while (true) {
+      // Keep the remaining syncs once the function is out of time.
+      if (CompileTimeBudget::shouldDegrade(F, "sync-elimination"))
+        break;
+
       bool Changed = false;
 
       for (BasicBlock &block: F) {
@@ -60,6 +60,7 @@
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/Analysis/CodeMetrics.h"
 #include "llvm/Analysis/GlobalsModRef.h"
+#include "llvm/Analysis/Loads.h"
 #include "llvm/Analysis/LoopInfo.h"
 #include "llvm/Analysis/LoopIterator.h"
 #include "llvm/Analysis/LoopPass.h"
@@ -110,6 +111,9 @@ using namespace llvm::PatternMatch;
 
 STATISTIC(LoopsVectorized, "Number of loops vectorized");
 STATISTIC(LoopsAnalyzed, "Number of loops analyzed for vectorization");
+STATISTIC(OuterLoopsVectorized, "Number of outer loops vectorized");
+STATISTIC(EarlyExitLoopsVectorized,
+          "Number of loops with an early exit vectorized");
 
 static cl::opt<bool>
     EnableIfConversion("enable-if-conversion", cl::init(true), cl::Hidden,
@@ -218,6 +222,18 @@ static cl::opt<unsigned> PragmaVectorizeSCEVCheckThreshold(
     cl::desc("The maximum number of SCEV checks allowed with a "
              "vectorize(enable) pragma"));
 
+static cl::opt<bool> EnableOuterLoopVectorize(
+    "enable-outer-loop-vectorize", cl::init(false), cl::Hidden,
+    cl::desc("Vectorize outer loops marked with a vectorize(enable) pragma "
+             "along their induction variable, keeping the inner loop as a "
+             "loop with a trip count that is uniform across lanes."));
+
+static cl::opt<bool> EnableEarlyExitVectorize(
+    "enable-early-exit-vectorize", cl::init(false), cl::Hidden,
+    cl::desc("Vectorize read-only loops with a single exit besides the latch, "
+             "such as search loops, when their loads are known to be "
+             "dereferenceable for the whole trip count."));
+
 /// Create an analysis remark that explains why vectorization failed
 ///
 /// \p PassName is the name of the pass (e.g. can be AlwaysPrint).  \p
@@ -2322,6 +2338,16 @@ static void addAcyclicInnerLoop(Loop &L, SmallVectorImpl<Loop *> &V) {
     addAcyclicInnerLoop(*InnerL, V);
 }
 
+/// Collect the loops whose only subloop is an innermost loop.
+static void addOuterLoopCandidates(Loop &L, SmallVectorImpl<Loop *> &V) {
+  if (L.getSubLoops().size() == 1 && L.getSubLoops()[0]->empty()) {
+    V.push_back(&L);
+    return;
+  }
+  for (Loop *InnerL : L)
+    addOuterLoopCandidates(*InnerL, V);
+}
+
 /// The LoopVectorize Pass.
 template <bool Rhino>
 struct LoopVectorizeCommonPass : public FunctionPass {
@@ -7907,6 +7933,1148 @@ static void AddRuntimeUnrollDisableMetaData(Loop *L) {
   }
 }
 
+namespace {
+
+/// WideningVectorizer holds what is shared by the vectorizers for loops that
+/// LoopVectorizationLegality does not handle. The loop body must be a chain
+/// of blocks, which is widened as a whole and without predication: lane L of
+/// vector iteration I runs iteration I * VF + L of the original loop. Values
+/// that do not depend on the induction variable are computed once per vector
+/// iteration.
+class WideningVectorizer {
+public:
+  /// Return the vectorization factor to use, or 1 if the cost model finds
+  /// that vectorizing the loop does not pay off.
+  unsigned selectVectorizationFactor();
+
+protected:
+  WideningVectorizer(Loop *L, ScalarEvolution *SE, LoopInfo *LI,
+                     DominatorTree *DT, const TargetTransformInfo *TTI,
+                     OptimizationRemarkEmitter *ORE,
+                     const LoopVectorizeHints &Hints)
+      : TheLoop(L), SE(SE), LI(LI), DT(DT), TTI(TTI), ORE(ORE), Hints(Hints),
+        DL(L->getHeader()->getModule()->getDataLayout()) {}
+  virtual ~WideningVectorizer() = default;
+
+  /// How a load or store accesses memory across the lanes.
+  enum AccessKind {
+    AK_Uniform,     ///< All lanes access the same address.
+    AK_Consecutive, ///< Lanes access adjacent elements.
+    AK_Gather       ///< Lanes access unrelated addresses.
+  };
+
+  OptimizationRemarkAnalysis createMissedAnalysis(StringRef RemarkName,
+                                                  Instruction *I = nullptr) {
+    return ::createMissedAnalysis(Hints.vectorizeAnalysisPassName(),
+                                  RemarkName, TheLoop, I);
+  }
+
+  /// Return the block that follows \p BB in the chain of blocks of the loop,
+  /// given that \p BB ends in a conditional branch, or null if \p BB may not
+  /// branch.
+  virtual BasicBlock *getChainSuccessor(BasicBlock *BB) const = 0;
+
+  /// Return how many times the instructions of \p BB run per iteration.
+  virtual unsigned getBlockWeight(BasicBlock *BB) const { return 1; }
+
+  /// Widen a phi with more than one incoming value, other than the
+  /// induction variable.
+  virtual void widenPhi(PHINode *Phi, IRBuilder<> &B) {
+    llvm_unreachable("Unexpected phi in the loop");
+  }
+
+  bool collectBlocks();
+  bool setInduction(PHINode *Phi);
+  bool canWidenInstruction(Instruction &I);
+  void collectVaryingValues();
+  const SCEV *getStrideAlongLoop(const SCEV *S) const;
+  void collectAccessKinds();
+
+  bool isVarying(const Value *V) const { return Varying.count(V); }
+  AccessKind getAccessKind(Instruction *I) const;
+  unsigned getInstructionCost(Instruction *I, unsigned VF) const;
+  unsigned getLoopCost(unsigned VF) const;
+
+  Value *getInductionValue(IRBuilder<> &B, Value *Count, const Twine &Name);
+  Value *createVectorInduction(IRBuilder<> &B, PHINode *Index);
+  Value *getScalarValue(Value *V) const;
+  Value *getVectorValue(Value *V);
+  Value *getLane0Value(Value *V, IRBuilder<> &B);
+  void widenBlock(BasicBlock *BB, IRBuilder<> &B);
+  void widenInstruction(Instruction &I, IRBuilder<> &B);
+  void widenMemoryInstruction(Instruction &I, IRBuilder<> &B);
+  void removeDeadInstructions(ArrayRef<BasicBlock *> NewBlocks);
+
+  Loop *TheLoop;
+  ScalarEvolution *SE;
+  LoopInfo *LI;
+  DominatorTree *DT;
+  const TargetTransformInfo *TTI;
+  OptimizationRemarkEmitter *ORE;
+  const LoopVectorizeHints &Hints;
+  const DataLayout &DL;
+
+  /// The blocks of the loop in execution order.
+  SmallVector<BasicBlock *, 8> Blocks;
+  /// The induction variable of the loop and its descriptor.
+  PHINode *Induction = nullptr;
+  InductionDescriptor IndDesc;
+  /// Values that differ between the lanes.
+  SmallPtrSet<const Value *, 32> Varying;
+  /// The access kind of every load and store in the loop.
+  DenseMap<const Instruction *, AccessKind> AccessKinds;
+
+  // State used while generating code.
+  unsigned VF = 1;
+  BasicBlock *VectorPH = nullptr;
+  Loop *VectorLoop = nullptr;
+  DenseMap<Value *, Value *> ScalarMap;
+  DenseMap<Value *, Value *> VectorMap;
+  DenseMap<Value *, Value *> Lane0Map;
+};
+
+/// OuterLoopVectorizer vectorizes a loop whose body contains exactly one
+/// innermost loop along the outer induction variable. The inner loop is kept
+/// as a loop nested in the vector body. It must exit after the same number
+/// of iterations in every lane, so that its exit branch stays scalar and no
+/// lane needs to be masked off.
+///
+/// Memory dependences between the outer iterations are not checked: the
+/// outer loop must carry a vectorize(enable) pragma asserting that its
+/// iterations are independent.
+class OuterLoopVectorizer : public WideningVectorizer {
+public:
+  OuterLoopVectorizer(Loop *L, ScalarEvolution *SE, LoopInfo *LI,
+                      DominatorTree *DT, const TargetTransformInfo *TTI,
+                      OptimizationRemarkEmitter *ORE,
+                      const LoopVectorizeHints &Hints)
+      : WideningVectorizer(L, SE, LI, DT, TTI, ORE, Hints) {}
+
+  /// Return true if the loop nest has a shape and contents that can be
+  /// vectorized along the outer loop.
+  bool canVectorize();
+
+  /// Create the vector loop nest, keeping the original nest to run the
+  /// remaining iterations.
+  void vectorize(unsigned Width);
+
+private:
+  BasicBlock *getChainSuccessor(BasicBlock *BB) const override;
+  unsigned getBlockWeight(BasicBlock *BB) const override;
+  void widenPhi(PHINode *Phi, IRBuilder<> &B) override;
+
+  Loop *InnerLoop = nullptr;
+  /// The backedge-taken count of the outer loop.
+  const SCEV *BackedgeTakenCount = nullptr;
+
+  // State used while generating code.
+  BasicBlock *VectorBody = nullptr;
+  BasicBlock *VectorInner = nullptr;
+  SmallVector<std::pair<PHINode *, PHINode *>, 4> InnerPhis;
+};
+
+/// EarlyExitLoopVectorizer vectorizes an innermost loop that, besides its
+/// counted exit in the latch, may leave early from one other block, such as
+/// a search loop. Every lane evaluates the early exit condition, and as soon
+/// as any lane would exit, the original loop takes over at the first
+/// iteration of that vector iteration to find the exact one. The vector loop
+/// also leaves at least one iteration to the original loop, so that all the
+/// exits of the loop stay in the original loop.
+///
+/// Lanes past the early exit are executed speculatively, so the loop must
+/// not write to memory, and every load must be known to be dereferenceable
+/// for all the iterations the latch allows.
+class EarlyExitLoopVectorizer : public WideningVectorizer {
+public:
+  EarlyExitLoopVectorizer(Loop *L, ScalarEvolution *SE, LoopInfo *LI,
+                          DominatorTree *DT, const TargetTransformInfo *TTI,
+                          OptimizationRemarkEmitter *ORE,
+                          const LoopVectorizeHints &Hints)
+      : WideningVectorizer(L, SE, LI, DT, TTI, ORE, Hints) {}
+
+  /// Return true if the loop has a single early exit and contents that can
+  /// be executed speculatively.
+  bool canVectorize();
+
+  /// Create the vector loop, keeping the original loop to find the exact
+  /// exiting iteration and to run the remaining iterations.
+  void vectorize(unsigned Width);
+
+private:
+  BasicBlock *getChainSuccessor(BasicBlock *BB) const override;
+
+  /// The block other than the latch that leaves the loop.
+  BasicBlock *EarlyExiting = nullptr;
+  /// The number of times the latch branches back if the loop does not leave
+  /// early.
+  const SCEV *LatchExitCount = nullptr;
+};
+
+} // end anonymous namespace
+
+/// Walk the blocks of the loop from the header, following unconditional
+/// branches and the conditional ones the vectorizer accepts, and check that
+/// the walk covers the loop and ends in the latch.
+bool WideningVectorizer::collectBlocks() {
+  BasicBlock *BB = TheLoop->getHeader();
+  while (Blocks.size() < TheLoop->getNumBlocks()) {
+    Blocks.push_back(BB);
+    if (BB == TheLoop->getLoopLatch())
+      break;
+    auto *Br = dyn_cast<BranchInst>(BB->getTerminator());
+    if (!Br)
+      break;
+    BB = Br->isConditional() ? getChainSuccessor(BB) : Br->getSuccessor(0);
+    if (!BB)
+      break;
+  }
+  if (Blocks.size() != TheLoop->getNumBlocks() ||
+      Blocks.back() != TheLoop->getLoopLatch()) {
+    ORE->emit(createMissedAnalysis("LoopControlFlow")
+              << "loop contains control flow that cannot be vectorized "
+                 "without predication");
+    return false;
+  }
+  return true;
+}
+
+bool WideningVectorizer::setInduction(PHINode *Phi) {
+  if (Induction ||
+      !InductionDescriptor::isInductionPHI(Phi, TheLoop, SE, IndDesc) ||
+      IndDesc.getKind() != InductionDescriptor::IK_IntInduction ||
+      !IndDesc.getConstIntStepValue()) {
+    ORE->emit(createMissedAnalysis("NonInductionPHI", Phi)
+              << "loop has a value carried across iterations other than its "
+                 "induction variable");
+    return false;
+  }
+  Induction = Phi;
+  return true;
+}
+
+/// Return true if \p I, which is not a phi or a branch, can be widened.
+bool WideningVectorizer::canWidenInstruction(Instruction &I) {
+  if (isa<LoadInst>(&I) || isa<StoreInst>(&I)) {
+    if ((isa<LoadInst>(&I) && !cast<LoadInst>(&I)->isSimple()) ||
+        (isa<StoreInst>(&I) && !cast<StoreInst>(&I)->isSimple()) ||
+        !VectorType::isValidElementType(getMemInstValueType(&I))) {
+      ORE->emit(createMissedAnalysis("CantVectorizeInstruction", &I)
+                << "instruction cannot be vectorized");
+      return false;
+    }
+  } else if (!isa<BinaryOperator>(&I) && !isa<CastInst>(&I) &&
+             !isa<CmpInst>(&I) && !isa<SelectInst>(&I) &&
+             !isa<GetElementPtrInst>(&I)) {
+    ORE->emit(createMissedAnalysis("CantVectorizeInstruction", &I)
+              << "instruction cannot be vectorized");
+    return false;
+  }
+
+  if (!I.getType()->isVoidTy() &&
+      !VectorType::isValidElementType(I.getType())) {
+    ORE->emit(createMissedAnalysis("CantVectorizeInstructionReturnType", &I)
+              << "instruction return type cannot be vectorized");
+    return false;
+  }
+  return true;
+}
+
+void WideningVectorizer::collectVaryingValues() {
+  // A value varies across the lanes if it depends on the induction variable,
+  // including through the phis of an inner loop.
+  Varying.insert(Induction);
+  bool Changed = true;
+  while (Changed) {
+    Changed = false;
+    for (BasicBlock *BB : Blocks)
+      for (Instruction &I : *BB) {
+        if (I.getType()->isVoidTy() || isVarying(&I))
+          continue;
+        if (any_of(I.operands(), [&](Value *Op) { return isVarying(Op); })) {
+          Varying.insert(&I);
+          Changed = true;
+        }
+      }
+  }
+}
+
+/// Return the amount by which \p S changes from one iteration of the loop to
+/// the next, or null if that amount is not invariant in the loop.
+const SCEV *WideningVectorizer::getStrideAlongLoop(const SCEV *S) const {
+  if (SE->isLoopInvariant(S, TheLoop))
+    return SE->getZero(S->getType());
+  auto *AR = dyn_cast<SCEVAddRecExpr>(S);
+  if (!AR || !AR->isAffine() || !TheLoop->contains(AR->getLoop()))
+    return nullptr;
+  const SCEV *Step = AR->getStepRecurrence(*SE);
+  if (!SE->isLoopInvariant(Step, TheLoop))
+    return nullptr;
+  if (AR->getLoop() == TheLoop)
+    return Step;
+  // A recurrence of an inner loop starts at a value that may itself advance
+  // with the loop.
+  return getStrideAlongLoop(AR->getStart());
+}
+
+void WideningVectorizer::collectAccessKinds() {
+  for (BasicBlock *BB : Blocks)
+    for (Instruction &I : *BB) {
+      if (!isa<LoadInst>(&I) && !isa<StoreInst>(&I))
+        continue;
+      Value *Ptr = getPointerOperand(&I);
+      AccessKind Kind = AK_Gather;
+      if (!isVarying(Ptr)) {
+        Kind = AK_Uniform;
+      } else {
+        Type *Ty = getMemInstValueType(&I);
+        uint64_t Size = DL.getTypeAllocSize(Ty);
+        auto *Stride = dyn_cast_or_null<SCEVConstant>(
+            getStrideAlongLoop(SE->getSCEV(Ptr)));
+        if (Stride && Size == DL.getTypeStoreSize(Ty) &&
+            Stride->getAPInt() == Size)
+          Kind = AK_Consecutive;
+      }
+      AccessKinds[&I] = Kind;
+    }
+}
+
+WideningVectorizer::AccessKind
+WideningVectorizer::getAccessKind(Instruction *I) const {
+  auto It = AccessKinds.find(I);
+  assert(It != AccessKinds.end() && "Not a memory access of the loop");
+  return It->second;
+}
+
+unsigned WideningVectorizer::getInstructionCost(Instruction *I,
+                                                unsigned VF) const {
+  // Uniform values are computed once for all the lanes.
+  if (VF > 1 && !isa<StoreInst>(I) && !isVarying(I))
+    return getInstructionCost(I, 1);
+
+  Type *ValTy = isa<StoreInst>(I) ? getMemInstValueType(I) : I->getType();
+  Type *VectorTy = ToVectorTy(ValTy, VF);
+  unsigned Opcode = I->getOpcode();
+  switch (Opcode) {
+  case Instruction::GetElementPtr:
+  case Instruction::PHI:
+  case Instruction::Br:
+    return 0;
+  case Instruction::Load:
+  case Instruction::Store: {
+    unsigned Alignment = getMemInstAlignment(I);
+    unsigned AS = getMemInstAddressSpace(I);
+    unsigned ScalarCost = TTI->getMemoryOpCost(Opcode, ValTy, Alignment, AS);
+    if (VF == 1)
+      return ScalarCost;
+    switch (getAccessKind(I)) {
+    case AK_Uniform:
+      return ScalarCost;
+    case AK_Consecutive:
+      return TTI->getMemoryOpCost(Opcode, VectorTy, Alignment, AS);
+    case AK_Gather:
+      break;
+    }
+    bool IsLoad = Opcode == Instruction::Load;
+    if (IsLoad ? TTI->isLegalMaskedGather(VectorTy)
+               : TTI->isLegalMaskedScatter(VectorTy))
+      return TTI->getGatherScatterOpCost(Opcode, VectorTy,
+                                         getPointerOperand(I), false,
+                                         Alignment);
+    // Each lane is accessed on its own, extracting the address and inserting
+    // or extracting the value.
+    unsigned Overhead =
+        TTI->getVectorInstrCost(Instruction::ExtractElement,
+                                ToVectorTy(getPointerOperand(I)->getType(), VF)) +
+        TTI->getVectorInstrCost(IsLoad ? Instruction::InsertElement
+                                       : Instruction::ExtractElement,
+                                VectorTy);
+    return VF * (ScalarCost + Overhead);
+  }
+  case Instruction::ICmp:
+  case Instruction::FCmp:
+    return TTI->getCmpSelInstrCost(
+        Opcode, ToVectorTy(I->getOperand(0)->getType(), VF));
+  case Instruction::Select: {
+    Value *Cond = cast<SelectInst>(I)->getCondition();
+    return TTI->getCmpSelInstrCost(
+        Opcode, VectorTy,
+        isVarying(Cond) ? ToVectorTy(Cond->getType(), VF) : Cond->getType());
+  }
+  default:
+    if (auto *Cast = dyn_cast<CastInst>(I))
+      return TTI->getCastInstrCost(Opcode, VectorTy,
+                                   ToVectorTy(Cast->getSrcTy(), VF));
+    assert(isa<BinaryOperator>(I) && "Unexpected instruction in the loop");
+    return TTI->getArithmeticInstrCost(Opcode, VectorTy);
+  }
+}
+
+unsigned WideningVectorizer::getLoopCost(unsigned VF) const {
+  unsigned Cost = 0;
+  for (BasicBlock *BB : Blocks) {
+    unsigned Weight = getBlockWeight(BB);
+    for (Instruction &I : *BB)
+      Cost += Weight * getInstructionCost(&I, VF);
+  }
+  return Cost;
+}
+
+unsigned WideningVectorizer::selectVectorizationFactor() {
+  if (unsigned UserVF = Hints.getWidth()) {
+    DEBUG(dbgs() << "LV: Using user VF " << UserVF << ".\n");
+    return UserVF;
+  }
+
+  unsigned WidestType = 8;
+  for (BasicBlock *BB : Blocks)
+    for (Instruction &I : *BB) {
+      Type *Ty = isa<StoreInst>(&I) ? getMemInstValueType(&I) : I.getType();
+      if (!Ty->isVoidTy())
+        WidestType =
+            std::max<unsigned>(WidestType, DL.getTypeSizeInBits(Ty));
+    }
+  unsigned MaxVF = TTI->getRegisterBitWidth(true) / WidestType;
+
+  unsigned BestVF = 1;
+  unsigned BestCost = getLoopCost(1);
+  DEBUG(dbgs() << "LV: Scalar loop costs: " << BestCost << ".\n");
+  for (unsigned VF = 2; VF <= MaxVF; VF *= 2) {
+    unsigned Cost = getLoopCost(VF);
+    DEBUG(dbgs() << "LV: Vector loop of width " << VF << " costs: " << Cost
+                 << ".\n");
+    // Compare the cost per iteration of the original loop.
+    if (Cost * BestVF < BestCost * VF) {
+      BestVF = VF;
+      BestCost = Cost;
+    }
+  }
+  return BestVF;
+}
+
+/// Return the value of the induction variable after \p Count iterations.
+Value *WideningVectorizer::getInductionValue(IRBuilder<> &B, Value *Count,
+                                             const Twine &Name) {
+  // The preheader may already branch to the vector loop, so take the start
+  // value from the descriptor.
+  Value *Start = IndDesc.getStartValue();
+  ConstantInt *Step = IndDesc.getConstIntStepValue();
+  Value *Offset = Step->isOne() ? Count : B.CreateMul(Count, Step);
+  auto *C = dyn_cast<Constant>(Start);
+  return C && C->isNullValue() ? Offset : B.CreateAdd(Start, Offset, Name);
+}
+
+/// Create the induction variable of every lane for the vector iteration
+/// starting at iteration \p Index, and return that of the first lane.
+Value *WideningVectorizer::createVectorInduction(IRBuilder<> &B,
+                                                 PHINode *Index) {
+  Value *ScalarIV = getInductionValue(B, Index, "iv");
+  int64_t Step = IndDesc.getConstIntStepValue()->getSExtValue();
+  SmallVector<Constant *, 8> LaneSteps;
+  for (unsigned Lane = 0; Lane < VF; ++Lane)
+    LaneSteps.push_back(ConstantInt::getSigned(Index->getType(), Lane * Step));
+  VectorMap[Induction] =
+      B.CreateAdd(B.CreateVectorSplat(VF, ScalarIV, "broadcast"),
+                  ConstantVector::get(LaneSteps), "vec.iv");
+  Lane0Map[Induction] = ScalarIV;
+  return ScalarIV;
+}
+
+Value *WideningVectorizer::getScalarValue(Value *V) const {
+  auto *I = dyn_cast<Instruction>(V);
+  if (!I || !TheLoop->contains(I))
+    return V;
+  assert(!isVarying(V) && "No scalar value for a varying value");
+  auto It = ScalarMap.find(V);
+  assert(It != ScalarMap.end() && "Use before definition");
+  return It->second;
+}
+
+Value *WideningVectorizer::getVectorValue(Value *V) {
+  if (auto *C = dyn_cast<Constant>(V))
+    return ConstantVector::getSplat(VF, C);
+  auto It = VectorMap.find(V);
+  if (It != VectorMap.end())
+    return It->second;
+
+  // Broadcast a uniform value right after its definition, or in the
+  // preheader if it is defined outside of the loop.
+  assert(!isVarying(V) && "Use before definition");
+  Value *Scalar = getScalarValue(V);
+  IRBuilder<> B(VectorPH->getTerminator());
+  auto *I = dyn_cast<Instruction>(Scalar);
+  if (I && VectorLoop->contains(I)) {
+    if (isa<PHINode>(I))
+      B.SetInsertPoint(I->getParent(), I->getParent()->getFirstInsertionPt());
+    else if (Instruction *Next = I->getNextNode())
+      B.SetInsertPoint(Next);
+    else
+      B.SetInsertPoint(I->getParent());
+  }
+  Value *Splat = B.CreateVectorSplat(VF, Scalar, "broadcast");
+  VectorMap[V] = Splat;
+  return Splat;
+}
+
+/// Return the value \p V has in the first lane, computing it at the insert
+/// point of \p B if it is not available yet.
+Value *WideningVectorizer::getLane0Value(Value *V, IRBuilder<> &B) {
+  if (!isVarying(V))
+    return getScalarValue(V);
+  auto It = Lane0Map.find(V);
+  if (It != Lane0Map.end())
+    return It->second;
+
+  Value *Lane0;
+  auto *I = cast<Instruction>(V);
+  if (isa<GetElementPtrInst>(I) || isa<CastInst>(I) ||
+      isa<BinaryOperator>(I)) {
+    // Address computations are cheaper to redo on scalars than to extract.
+    Instruction *Clone = I->clone();
+    for (unsigned Op = 0, E = I->getNumOperands(); Op != E; ++Op)
+      Clone->setOperand(Op, getLane0Value(I->getOperand(Op), B));
+    Lane0 = B.Insert(Clone);
+  } else {
+    Lane0 = B.CreateExtractElement(getVectorValue(V), B.getInt32(0));
+  }
+  Lane0Map[V] = Lane0;
+  return Lane0;
+}
+
+/// Emit the instructions of \p BB, other than its terminator, at the insert
+/// point of \p B.
+void WideningVectorizer::widenBlock(BasicBlock *BB, IRBuilder<> &B) {
+  for (Instruction &I : *BB) {
+    if (isa<BranchInst>(&I) || &I == Induction)
+      continue;
+    auto *Phi = dyn_cast<PHINode>(&I);
+    if (!Phi) {
+      widenInstruction(I, B);
+    } else if (Phi->getNumIncomingValues() != 1) {
+      widenPhi(Phi, B);
+    } else {
+      // Single-entry phis, such as LCSSA phis, forward their value.
+      Value *In = Phi->getIncomingValue(0);
+      if (isVarying(Phi))
+        VectorMap[Phi] = getVectorValue(In);
+      else
+        ScalarMap[Phi] = getScalarValue(In);
+    }
+  }
+}
+
+void WideningVectorizer::widenMemoryInstruction(Instruction &I,
+                                                IRBuilder<> &B) {
+  auto *LI = dyn_cast<LoadInst>(&I);
+  Type *ScalarTy = getMemInstValueType(&I);
+  auto *VectorTy = VectorType::get(ScalarTy, VF);
+  Value *Ptr = getPointerOperand(&I);
+  unsigned Alignment = getMemInstAlignment(&I);
+  if (!Alignment)
+    Alignment = DL.getABITypeAlignment(ScalarTy);
+
+  if (getAccessKind(&I) == AK_Consecutive) {
+    Value *VecPtr = B.CreateBitCast(
+        getLane0Value(Ptr, B),
+        VectorTy->getPointerTo(getMemInstAddressSpace(&I)));
+    if (LI)
+      VectorMap[&I] = B.CreateAlignedLoad(VecPtr, Alignment, "wide.load");
+    else
+      B.CreateAlignedStore(
+          getVectorValue(cast<StoreInst>(&I)->getValueOperand()), VecPtr,
+          Alignment);
+    return;
+  }
+
+  Value *Ptrs = getVectorValue(Ptr);
+  if (LI && TTI->isLegalMaskedGather(VectorTy)) {
+    VectorMap[&I] = B.CreateMaskedGather(Ptrs, Alignment, nullptr, nullptr,
+                                         "wide.masked.gather");
+    return;
+  }
+  if (!LI && TTI->isLegalMaskedScatter(VectorTy)) {
+    B.CreateMaskedScatter(
+        getVectorValue(cast<StoreInst>(&I)->getValueOperand()), Ptrs,
+        Alignment);
+    return;
+  }
+
+  // Access each lane on its own.
+  Value *Vec = LI ? UndefValue::get(VectorTy)
+                  : getVectorValue(cast<StoreInst>(&I)->getValueOperand());
+  for (unsigned Lane = 0; Lane < VF; ++Lane) {
+    Value *LanePtr = B.CreateExtractElement(Ptrs, B.getInt32(Lane));
+    if (LI)
+      Vec = B.CreateInsertElement(
+          Vec, B.CreateAlignedLoad(LanePtr, Alignment), B.getInt32(Lane));
+    else
+      B.CreateAlignedStore(B.CreateExtractElement(Vec, B.getInt32(Lane)),
+                           LanePtr, Alignment);
+  }
+  if (LI)
+    VectorMap[&I] = Vec;
+}
+
+void WideningVectorizer::widenInstruction(Instruction &I, IRBuilder<> &B) {
+  if (isa<StoreInst>(&I) || (isVarying(&I) && isa<LoadInst>(&I))) {
+    widenMemoryInstruction(I, B);
+    return;
+  }
+
+  // Uniform instructions are cloned once for all the lanes.
+  if (!isVarying(&I)) {
+    Instruction *Clone = I.clone();
+    for (unsigned Op = 0, E = I.getNumOperands(); Op != E; ++Op)
+      Clone->setOperand(Op, getScalarValue(I.getOperand(Op)));
+    ScalarMap[&I] = B.Insert(Clone, I.getName());
+    return;
+  }
+
+  Value *V;
+  if (auto *BO = dyn_cast<BinaryOperator>(&I)) {
+    V = B.CreateBinOp(BO->getOpcode(), getVectorValue(BO->getOperand(0)),
+                      getVectorValue(BO->getOperand(1)), I.getName());
+  } else if (auto *Cast = dyn_cast<CastInst>(&I)) {
+    V = B.CreateCast(Cast->getOpcode(), getVectorValue(Cast->getOperand(0)),
+                     VectorType::get(Cast->getDestTy(), VF), I.getName());
+  } else if (auto *Cmp = dyn_cast<CmpInst>(&I)) {
+    Value *LHS = getVectorValue(Cmp->getOperand(0));
+    Value *RHS = getVectorValue(Cmp->getOperand(1));
+    V = isa<ICmpInst>(Cmp)
+            ? B.CreateICmp(Cmp->getPredicate(), LHS, RHS, I.getName())
+            : B.CreateFCmp(Cmp->getPredicate(), LHS, RHS, I.getName());
+  } else if (auto *Sel = dyn_cast<SelectInst>(&I)) {
+    // A uniform condition selects whole vectors.
+    Value *Cond = Sel->getCondition();
+    V = B.CreateSelect(isVarying(Cond) ? getVectorValue(Cond)
+                                       : getScalarValue(Cond),
+                       getVectorValue(Sel->getTrueValue()),
+                       getVectorValue(Sel->getFalseValue()), I.getName());
+  } else {
+    // A GEP whose base or indices vary yields a vector of pointers.
+    auto *GEP = cast<GetElementPtrInst>(&I);
+    auto GetOperand = [&](Value *Op) {
+      return isVarying(Op) ? getVectorValue(Op) : getScalarValue(Op);
+    };
+    SmallVector<Value *, 4> Indices;
+    for (Value *Idx : GEP->indices())
+      Indices.push_back(GetOperand(Idx));
+    Value *Base = GetOperand(GEP->getPointerOperand());
+    V = GEP->isInBounds()
+            ? B.CreateInBoundsGEP(GEP->getSourceElementType(), Base, Indices,
+                                  I.getName())
+            : B.CreateGEP(GEP->getSourceElementType(), Base, Indices,
+                          I.getName());
+  }
+  if (auto *VI = dyn_cast<Instruction>(V))
+    VI->copyIRFlags(&I);
+  VectorMap[&I] = V;
+}
+
+/// Values only the original control flow needed, such as the widened update
+/// of the induction variable, are left dead by the widening.
+void WideningVectorizer::removeDeadInstructions(
+    ArrayRef<BasicBlock *> NewBlocks) {
+  SmallVector<WeakVH, 64> NewInsts;
+  for (BasicBlock *BB : NewBlocks)
+    for (Instruction &I : *BB)
+      NewInsts.push_back(&I);
+  for (WeakVH &V : NewInsts)
+    if (auto *I = dyn_cast_or_null<Instruction>(V))
+      if (isInstructionTriviallyDead(I))
+        RecursivelyDeleteTriviallyDeadInstructions(I);
+}
+
+BasicBlock *OuterLoopVectorizer::getChainSuccessor(BasicBlock *BB) const {
+  return BB == InnerLoop->getLoopLatch() ? InnerLoop->getExitBlock() : nullptr;
+}
+
+unsigned OuterLoopVectorizer::getBlockWeight(BasicBlock *BB) const {
+  // The inner loop runs the same number of times in the scalar and vector
+  // nests, but it still weighs more than the rest of the outer loop body.
+  if (!InnerLoop->contains(BB))
+    return 1;
+  return std::max(1u, SE->getSmallConstantTripCount(InnerLoop));
+}
+
+bool OuterLoopVectorizer::canVectorize() {
+  if (TheLoop->getSubLoops().size() != 1) {
+    ORE->emit(createMissedAnalysis("OuterLoopShape")
+              << "outer loop does not contain exactly one inner loop");
+    return false;
+  }
+  InnerLoop = TheLoop->getSubLoops()[0];
+  if (!InnerLoop->empty()) {
+    ORE->emit(createMissedAnalysis("OuterLoopShape")
+              << "outer loop contains a loop nest deeper than two levels");
+    return false;
+  }
+
+  for (Loop *L : {TheLoop, InnerLoop}) {
+    if (!L->getLoopPreheader() || !L->getLoopLatch() || !L->getExitBlock() ||
+        L->getExitingBlock() != L->getLoopLatch()) {
+      ORE->emit(createMissedAnalysis("CFGNotUnderstood")
+                << "loop control flow is not understood by vectorizer");
+      return false;
+    }
+  }
+  if (!isa<BranchInst>(TheLoop->getLoopPreheader()->getTerminator())) {
+    ORE->emit(createMissedAnalysis("CFGNotUnderstood")
+              << "loop control flow is not understood by vectorizer");
+    return false;
+  }
+
+  // The blocks must form a chain from the header to the latch, in which only
+  // the inner loop latch branches.
+  if (!collectBlocks())
+    return false;
+
+  BackedgeTakenCount = SE->getBackedgeTakenCount(TheLoop);
+  if (isa<SCEVCouldNotCompute>(BackedgeTakenCount)) {
+    ORE->emit(createMissedAnalysis("CantComputeNumberOfIterations")
+              << "could not determine number of loop iterations");
+    return false;
+  }
+
+  for (BasicBlock *BB : Blocks) {
+    for (Instruction &I : *BB) {
+      if (auto *Phi = dyn_cast<PHINode>(&I)) {
+        if (BB == TheLoop->getHeader()) {
+          if (!setInduction(Phi))
+            return false;
+        } else if (BB != InnerLoop->getHeader() &&
+                   Phi->getNumIncomingValues() != 1) {
+          ORE->emit(createMissedAnalysis("LoopControlFlow", Phi)
+                    << "loop contains control flow that cannot be vectorized "
+                       "without predication");
+          return false;
+        }
+      } else if (!isa<BranchInst>(&I) && !canWidenInstruction(I)) {
+        return false;
+      }
+
+      for (User *U : I.users()) {
+        if (!TheLoop->contains(cast<Instruction>(U))) {
+          ORE->emit(createMissedAnalysis("ValueUsedOutsideLoop", &I)
+                    << "value could not be identified as an induction or "
+                       "reduction variable");
+          return false;
+        }
+      }
+    }
+  }
+
+  if (!Induction) {
+    ORE->emit(createMissedAnalysis("NoInductionVariable")
+              << "outer loop induction variable could not be identified");
+    return false;
+  }
+  if (SE->getTypeSizeInBits(BackedgeTakenCount->getType()) >
+      Induction->getType()->getPrimitiveSizeInBits()) {
+    ORE->emit(createMissedAnalysis("CantComputeNumberOfIterations")
+              << "could not determine number of loop iterations");
+    return false;
+  }
+
+  collectVaryingValues();
+
+  auto *InnerBr = cast<BranchInst>(InnerLoop->getLoopLatch()->getTerminator());
+  if (isVarying(InnerBr->getCondition())) {
+    ORE->emit(createMissedAnalysis("DivergentInnerLoop", InnerBr)
+              << "inner loop trip count differs between outer iterations");
+    return false;
+  }
+
+  collectAccessKinds();
+  for (BasicBlock *BB : Blocks)
+    for (Instruction &I : *BB)
+      if (isa<StoreInst>(&I) && getAccessKind(&I) == AK_Uniform) {
+        ORE->emit(createMissedAnalysis("StoreToUniformAddress", &I)
+                  << "every outer iteration stores to the same address");
+        return false;
+      }
+
+  DEBUG(dbgs() << "LV: Outer loop with " << Varying.size()
+               << " varying values can be vectorized.\n");
+  return true;
+}
+
+/// Phis of the inner loop header become phis of the vector inner loop, which
+/// are scalar if they are uniform.
+void OuterLoopVectorizer::widenPhi(PHINode *Phi, IRBuilder<> &B) {
+  assert(Phi->getParent() == InnerLoop->getHeader() && "Unexpected phi");
+  Value *Init = Phi->getIncomingValueForBlock(InnerLoop->getLoopPreheader());
+  PHINode *NewPhi;
+  if (isVarying(Phi)) {
+    NewPhi = B.CreatePHI(VectorType::get(Phi->getType(), VF), 2,
+                         Phi->getName());
+    NewPhi->addIncoming(getVectorValue(Init), VectorBody);
+    VectorMap[Phi] = NewPhi;
+  } else {
+    NewPhi = B.CreatePHI(Phi->getType(), 2, Phi->getName());
+    NewPhi->addIncoming(getScalarValue(Init), VectorBody);
+    ScalarMap[Phi] = NewPhi;
+  }
+  InnerPhis.push_back({Phi, NewPhi});
+}
+
+void OuterLoopVectorizer::vectorize(unsigned Width) {
+  /*
+   The vector nest is created next to the original one, which runs the
+   remaining iterations:
+
+       [ ] <-- preheader: trip count check.
+      /  |
+     |  [ ] <-- vector.ph
+     |   |
+     |  [ ] <-----.  vector.body: outer blocks before the inner loop.
+     |   |        |
+     |  [ ] <-.   |  vector.inner: the inner loop, with a scalar exit.
+     |   |____|   |
+     |  [ ] ______|  vector.latch: outer blocks after the inner loop.
+     |   |
+     |  [ ] <-- middle.block
+     |  /  \
+     | /    |
+    [ ]     |  <-- scalar.ph
+     |      |
+    [ ]     |  <-- original loop nest.
+     |     /
+    [ ] <--  exit block.
+   */
+  VF = Width;
+  BasicBlock *Preheader = TheLoop->getLoopPreheader();
+  BasicBlock *Header = TheLoop->getHeader();
+  BasicBlock *ExitBlock = TheLoop->getExitBlock();
+  Function *F = Header->getParent();
+  LLVMContext &Context = F->getContext();
+
+  VectorPH = BasicBlock::Create(Context, "vector.ph", F, Header);
+  VectorBody = BasicBlock::Create(Context, "vector.body", F, Header);
+  VectorInner = BasicBlock::Create(Context, "vector.inner", F, Header);
+  BasicBlock *VectorLatch =
+      BasicBlock::Create(Context, "vector.latch", F, Header);
+  BasicBlock *MiddleBlock =
+      BasicBlock::Create(Context, "middle.block", F, Header);
+  BasicBlock *ScalarPH = BasicBlock::Create(Context, "scalar.ph", F, Header);
+
+  // Register the new loops before anything relies on LoopInfo.
+  VectorLoop = new Loop();
+  Loop *VectorInnerLoop = new Loop();
+  if (Loop *ParentLoop = TheLoop->getParentLoop()) {
+    ParentLoop->addChildLoop(VectorLoop);
+    for (BasicBlock *BB : {VectorPH, MiddleBlock, ScalarPH})
+      ParentLoop->addBasicBlockToLoop(BB, *LI);
+  } else {
+    LI->addTopLevelLoop(VectorLoop);
+  }
+  VectorLoop->addChildLoop(VectorInnerLoop);
+  VectorLoop->addBasicBlockToLoop(VectorBody, *LI);
+  VectorInnerLoop->addBasicBlockToLoop(VectorInner, *LI);
+  VectorLoop->addBasicBlockToLoop(VectorLatch, *LI);
+
+  // Compute the number of iterations the vector loop covers, and skip it if
+  // that is zero or the trip count overflows.
+  Type *IdxTy = Induction->getType();
+  IRBuilder<> B(Preheader->getTerminator());
+  SCEVExpander Exp(*SE, DL, "outer.vec");
+  Value *BTC = B.CreateZExtOrTrunc(
+      Exp.expandCodeFor(BackedgeTakenCount, BackedgeTakenCount->getType(),
+                        Preheader->getTerminator()),
+      IdxTy);
+  Value *Count =
+      B.CreateAdd(BTC, ConstantInt::get(IdxTy, 1), "outer.trip.count");
+  Value *Bypass = B.CreateOr(
+      B.CreateICmpULT(BTC, ConstantInt::get(IdxTy, VF - 1), "min.iters.check"),
+      B.CreateICmpEQ(Count, ConstantInt::get(IdxTy, 0)));
+  Value *VectorCount =
+      B.CreateSub(Count, B.CreateURem(Count, ConstantInt::get(IdxTy, VF)),
+                  "n.vec");
+  ReplaceInstWithInst(Preheader->getTerminator(),
+                      BranchInst::Create(ScalarPH, VectorPH, Bypass));
+  BranchInst::Create(VectorBody, VectorPH);
+
+  B.SetInsertPoint(VectorBody);
+  PHINode *Index = B.CreatePHI(IdxTy, 2, "index");
+  Index->addIncoming(ConstantInt::get(IdxTy, 0), VectorPH);
+  createVectorInduction(B, Index);
+
+  // Emit the blocks of the outer loop in order, folding the parts before and
+  // after the inner loop into the vector body and latch.
+  BasicBlock *InnerLatch = InnerLoop->getLoopLatch();
+  for (BasicBlock *BB : Blocks) {
+    if (BB == InnerLoop->getHeader()) {
+      B.CreateBr(VectorInner);
+      B.SetInsertPoint(VectorInner);
+    } else if (BB == InnerLoop->getExitBlock()) {
+      B.SetInsertPoint(VectorLatch);
+    }
+    widenBlock(BB, B);
+    if (BB == InnerLatch) {
+      auto *Br = cast<BranchInst>(InnerLatch->getTerminator());
+      bool ExitOnTrue = Br->getSuccessor(0) != InnerLoop->getHeader();
+      B.CreateCondBr(getScalarValue(Br->getCondition()),
+                     ExitOnTrue ? VectorLatch : VectorInner,
+                     ExitOnTrue ? VectorInner : VectorLatch);
+    }
+  }
+
+  for (auto &P : InnerPhis) {
+    Value *Next = P.first->getIncomingValueForBlock(InnerLatch);
+    P.second->addIncoming(isVarying(P.first) ? getVectorValue(Next)
+                                              : getScalarValue(Next),
+                          VectorInner);
+  }
+
+  Value *IndexNext =
+      B.CreateAdd(Index, ConstantInt::get(IdxTy, VF), "index.next");
+  Index->addIncoming(IndexNext, VectorLatch);
+  B.CreateCondBr(B.CreateICmpEQ(IndexNext, VectorCount), MiddleBlock,
+                 VectorBody);
+
+  // Leave the nest if the vector loop covered every iteration, otherwise
+  // resume the original nest where the vector loop stopped.
+  B.SetInsertPoint(MiddleBlock);
+  Value *EndValue = getInductionValue(B, VectorCount, "ind.end");
+  B.CreateCondBr(B.CreateICmpEQ(Count, VectorCount, "cmp.n"), ExitBlock,
+                 ScalarPH);
+  for (Instruction &I : *ExitBlock) {
+    auto *Phi = dyn_cast<PHINode>(&I);
+    if (!Phi)
+      break;
+    Phi->addIncoming(Phi->getIncomingValueForBlock(TheLoop->getLoopLatch()),
+                     MiddleBlock);
+  }
+
+  B.SetInsertPoint(ScalarPH);
+  PHINode *Resume = B.CreatePHI(IdxTy, 2, "bc.resume.val");
+  Resume->addIncoming(EndValue, MiddleBlock);
+  Resume->addIncoming(Induction->getIncomingValueForBlock(Preheader),
+                      Preheader);
+  B.CreateBr(Header);
+  int PreheaderIdx = Induction->getBasicBlockIndex(Preheader);
+  Induction->setIncomingBlock(PreheaderIdx, ScalarPH);
+  Induction->setIncomingValue(PreheaderIdx, Resume);
+
+  removeDeadInstructions({VectorBody, VectorInner, VectorLatch});
+
+  DT->addNewBlock(VectorPH, Preheader);
+  DT->addNewBlock(VectorBody, VectorPH);
+  DT->addNewBlock(VectorInner, VectorBody);
+  DT->addNewBlock(VectorLatch, VectorInner);
+  DT->addNewBlock(MiddleBlock, VectorLatch);
+  DT->addNewBlock(ScalarPH, Preheader);
+  DT->changeImmediateDominator(Header, ScalarPH);
+  DT->changeImmediateDominator(
+      ExitBlock, DT->findNearestCommonDominator(
+                     DT->getNode(ExitBlock)->getIDom()->getBlock(),
+                     MiddleBlock));
+
+  SE->forgetLoop(TheLoop);
+}
+
+BasicBlock *EarlyExitLoopVectorizer::getChainSuccessor(BasicBlock *BB) const {
+  if (BB != EarlyExiting)
+    return nullptr;
+  auto *Br = cast<BranchInst>(BB->getTerminator());
+  return TheLoop->contains(Br->getSuccessor(0)) ? Br->getSuccessor(0)
+                                                : Br->getSuccessor(1);
+}
+
+bool EarlyExitLoopVectorizer::canVectorize() {
+  BasicBlock *Latch = TheLoop->getLoopLatch();
+  SmallVector<BasicBlock *, 4> ExitingBlocks;
+  TheLoop->getExitingBlocks(ExitingBlocks);
+  if (!TheLoop->getLoopPreheader() || !Latch || ExitingBlocks.size() != 2 ||
+      !is_contained(ExitingBlocks, Latch) ||
+      !isa<BranchInst>(TheLoop->getLoopPreheader()->getTerminator())) {
+    ORE->emit(createMissedAnalysis("CFGNotUnderstood")
+              << "loop control flow is not understood by vectorizer");
+    return false;
+  }
+  EarlyExiting =
+      ExitingBlocks[0] == Latch ? ExitingBlocks[1] : ExitingBlocks[0];
+  if (!isa<BranchInst>(EarlyExiting->getTerminator()) || !collectBlocks())
+    return false;
+
+  LatchExitCount = SE->getExitCount(TheLoop, Latch);
+  if (isa<SCEVCouldNotCompute>(LatchExitCount)) {
+    ORE->emit(createMissedAnalysis("CantComputeNumberOfIterations")
+              << "could not determine number of loop iterations");
+    return false;
+  }
+
+  for (BasicBlock *BB : Blocks) {
+    for (Instruction &I : *BB) {
+      if (auto *Phi = dyn_cast<PHINode>(&I)) {
+        if (BB == TheLoop->getHeader() && !setInduction(Phi))
+          return false;
+        continue;
+      }
+      if (isa<BranchInst>(&I))
+        continue;
+      if (!canWidenInstruction(I))
+        return false;
+      if (I.mayWriteToMemory()) {
+        ORE->emit(createMissedAnalysis("EarlyExitWithStore", &I)
+                  << "loop with an early exit writes to memory");
+        return false;
+      }
+      if (!isa<LoadInst>(&I) && !isSafeToSpeculativelyExecute(&I)) {
+        ORE->emit(createMissedAnalysis("CantSpeculateInstruction", &I)
+                  << "instruction past the early exit cannot be speculated");
+        return false;
+      }
+    }
+  }
+
+  if (!Induction) {
+    ORE->emit(createMissedAnalysis("NoInductionVariable")
+              << "loop induction variable could not be identified");
+    return false;
+  }
+  if (SE->getTypeSizeInBits(LatchExitCount->getType()) >
+      Induction->getType()->getPrimitiveSizeInBits()) {
+    ORE->emit(createMissedAnalysis("CantComputeNumberOfIterations")
+              << "could not determine number of loop iterations");
+    return false;
+  }
+
+  // Lanes past the early exit load from addresses the original loop might
+  // never have reached.
+  for (BasicBlock *BB : Blocks)
+    for (Instruction &I : *BB) {
+      auto *Load = dyn_cast<LoadInst>(&I);
+      if (Load && !isDereferenceableAndAlignedInLoop(Load, TheLoop, *SE, *DT)) {
+        ORE->emit(createMissedAnalysis("CantSpeculateLoad", Load)
+                  << "cannot prove that loads past the early exit are "
+                     "dereferenceable");
+        return false;
+      }
+    }
+
+  collectVaryingValues();
+  collectAccessKinds();
+
+  DEBUG(dbgs() << "LV: Loop with an early exit from "
+               << EarlyExiting->getName() << " can be vectorized.\n");
+  return true;
+}
+
+void EarlyExitLoopVectorizer::vectorize(unsigned Width) {
+  /*
+   The original loop runs the iterations after the vector loop, starting
+   either at the vector iteration in which some lane exits early, or after
+   the last vector iteration:
+
+       [ ] <-- preheader: trip count check.
+      /  |
+     |  [ ] <-- vector.ph
+     |   |
+     |  [ ] <---.  vector.body: any lane exiting early?
+     |   | \    |
+     |   |  [ ]-'  vector.latch
+     |   |  /
+    [ ] <---  scalar.ph
+     |
+    [ ] <-- original loop, with all the exits.
+   */
+  VF = Width;
+  BasicBlock *Preheader = TheLoop->getLoopPreheader();
+  BasicBlock *Header = TheLoop->getHeader();
+  Function *F = Header->getParent();
+  LLVMContext &Context = F->getContext();
+
+  VectorPH = BasicBlock::Create(Context, "vector.ph", F, Header);
+  BasicBlock *VectorBody =
+      BasicBlock::Create(Context, "vector.body", F, Header);
+  BasicBlock *VectorLatch =
+      BasicBlock::Create(Context, "vector.latch", F, Header);
+  BasicBlock *ScalarPH = BasicBlock::Create(Context, "scalar.ph", F, Header);
+
+  VectorLoop = new Loop();
+  if (Loop *ParentLoop = TheLoop->getParentLoop()) {
+    ParentLoop->addChildLoop(VectorLoop);
+    for (BasicBlock *BB : {VectorPH, ScalarPH})
+      ParentLoop->addBasicBlockToLoop(BB, *LI);
+  } else {
+    LI->addTopLevelLoop(VectorLoop);
+  }
+  VectorLoop->addBasicBlockToLoop(VectorBody, *LI);
+  VectorLoop->addBasicBlockToLoop(VectorLatch, *LI);
+
+  // The latch branches back ExitCount times, so the loop runs at most
+  // ExitCount + 1 iterations. Leaving the last one to the original loop
+  // makes the vector loop cover ExitCount rounded down to a multiple of VF.
+  Type *IdxTy = Induction->getType();
+  Constant *Step = ConstantInt::get(IdxTy, VF);
+  IRBuilder<> B(Preheader->getTerminator());
+  SCEVExpander Exp(*SE, DL, "early.exit.vec");
+  Value *ExitCount = B.CreateZExtOrTrunc(
+      Exp.expandCodeFor(LatchExitCount, LatchExitCount->getType(),
+                        Preheader->getTerminator()),
+      IdxTy);
+  Value *Bypass = B.CreateICmpULT(ExitCount, Step, "min.iters.check");
+  Value *VectorCount =
+      B.CreateSub(ExitCount, B.CreateURem(ExitCount, Step), "n.vec");
+  ReplaceInstWithInst(Preheader->getTerminator(),
+                      BranchInst::Create(ScalarPH, VectorPH, Bypass));
+  BranchInst::Create(VectorBody, VectorPH);
+
+  B.SetInsertPoint(VectorBody);
+  PHINode *Index = B.CreatePHI(IdxTy, 2, "index");
+  Index->addIncoming(ConstantInt::get(IdxTy, 0), VectorPH);
+  Value *ScalarIV = createVectorInduction(B, Index);
+  for (BasicBlock *BB : Blocks)
+    widenBlock(BB, B);
+
+  // Hand over to the original loop as soon as any lane exits early.
+  auto *ExitBr = cast<BranchInst>(EarlyExiting->getTerminator());
+  bool ExitOnTrue = !TheLoop->contains(ExitBr->getSuccessor(0));
+  Value *Cond = ExitBr->getCondition();
+  Value *AnyExit;
+  if (isVarying(Cond)) {
+    Value *Exits = getVectorValue(Cond);
+    if (!ExitOnTrue)
+      Exits = B.CreateNot(Exits);
+    Type *MaskTy = B.getIntNTy(VF);
+    AnyExit = B.CreateICmpNE(B.CreateBitCast(Exits, MaskTy),
+                             ConstantInt::get(MaskTy, 0), "any.exit");
+  } else {
+    AnyExit = getScalarValue(Cond);
+    if (!ExitOnTrue)
+      AnyExit = B.CreateNot(AnyExit);
+  }
+  B.CreateCondBr(AnyExit, ScalarPH, VectorLatch);
+
+  B.SetInsertPoint(VectorLatch);
+  Value *IndexNext = B.CreateAdd(Index, Step, "index.next");
+  Index->addIncoming(IndexNext, VectorLatch);
+  Value *EndValue = getInductionValue(B, IndexNext, "ind.end");
+  B.CreateCondBr(B.CreateICmpEQ(IndexNext, VectorCount), ScalarPH,
+                 VectorBody);
+
+  B.SetInsertPoint(ScalarPH);
+  PHINode *Resume = B.CreatePHI(IdxTy, 3, "bc.resume.val");
+  Resume->addIncoming(ScalarIV, VectorBody);
+  Resume->addIncoming(EndValue, VectorLatch);
+  Resume->addIncoming(Induction->getIncomingValueForBlock(Preheader),
+                      Preheader);
+  B.CreateBr(Header);
+  int PreheaderIdx = Induction->getBasicBlockIndex(Preheader);
+  Induction->setIncomingBlock(PreheaderIdx, ScalarPH);
+  Induction->setIncomingValue(PreheaderIdx, Resume);
+
+  removeDeadInstructions({VectorBody, VectorLatch});
+
+  DT->addNewBlock(VectorPH, Preheader);
+  DT->addNewBlock(VectorBody, VectorPH);
+  DT->addNewBlock(VectorLatch, VectorBody);
+  DT->addNewBlock(ScalarPH, Preheader);
+  DT->changeImmediateDominator(Header, ScalarPH);
+
+  SE->forgetLoop(TheLoop);
+}
+
 bool LoopVectorizePass::processLoop(Loop *L) {
   assert(L->empty() && "Only process inner loops.");
 
@@ -7946,6 +9114,10 @@ bool LoopVectorizePass::processLoop(Loop *L) {
     return false;
   }
 
+  // LoopVectorizationLegality only handles loops that exit from the latch.
+  if (EnableEarlyExitVectorize && !L->getExitingBlock())
+    return processEarlyExitLoop(L);
+
   PredicatedScalarEvolution PSE(*SE, *L);
 
   // Check if it is legal to vectorize the loop.
@@ -8153,6 +9325,115 @@ bool LoopVectorizePass::processLoop(Loop *L) {
   return true;
 }
 
+bool LoopVectorizePass::processOuterLoop(Loop *L) {
+  assert(!L->empty() && "Only process outer loops.");
+
+  DEBUG(dbgs() << "\nLV: Checking an outer loop in \""
+               << L->getHeader()->getParent()->getName() << "\" from "
+               << getDebugLocString(L) << "\n");
+
+  LoopVectorizeHints Hints(L, DisableUnrolling, *ORE);
+
+  // Dependences between the outer iterations are not analyzed, so only loops
+  // whose iterations the user asserted to be independent are considered.
+  if (Hints.getForce() != LoopVectorizeHints::FK_Enabled) {
+    DEBUG(dbgs() << "LV: Not vectorizing outer loop: No #pragma vectorize "
+                    "enable.\n");
+    return false;
+  }
+
+  Function *F = L->getHeader()->getParent();
+  if (!Hints.allowVectorization(F, L, AlwaysVectorize) ||
+      F->hasFnAttribute(Attribute::NoImplicitFloat))
+    return false;
+
+  OuterLoopVectorizer OLV(L, SE, LI, DT, TTI, ORE, Hints);
+  if (!OLV.canVectorize()) {
+    DEBUG(dbgs() << "LV: Not vectorizing outer loop: Cannot prove "
+                    "legality.\n");
+    return false;
+  }
+
+  unsigned VF = OLV.selectVectorizationFactor();
+  if (VF == 1) {
+    DEBUG(dbgs() << "LV: Outer loop vectorization is possible but not "
+                    "beneficial.\n");
+    ORE->emit(OptimizationRemarkMissed(Hints.vectorizeAnalysisPassName(),
+                                       "VectorizationNotBeneficial",
+                                       L->getStartLoc(), L->getHeader())
+              << "the cost-model indicates that vectorizing the outer loop "
+                 "is not beneficial");
+    return false;
+  }
+
+  DEBUG(dbgs() << "LV: Vectorizing outer loop with VF " << VF << ".\n");
+  OLV.vectorize(VF);
+  ++LoopsVectorized;
+  ++OuterLoopsVectorized;
+
+  using namespace ore;
+  ORE->emit(OptimizationRemark(LV_NAME, "Vectorized", L->getStartLoc(),
+                               L->getHeader())
+            << "vectorized outer loop (vectorization width: "
+            << NV("VectorizationFactor", VF) << ")");
+
+  // Mark the loop as already vectorized to avoid vectorizing again.
+  Hints.setAlreadyVectorized();
+
+  DEBUG(verifyFunction(*L->getHeader()->getParent()));
+  return true;
+}
+
+bool LoopVectorizePass::processEarlyExitLoop(Loop *L) {
+  DEBUG(dbgs() << "LV: Checking a loop with an early exit in \""
+               << L->getHeader()->getParent()->getName() << "\" from "
+               << getDebugLocString(L) << "\n");
+
+  // The caller has already checked that the hints allow vectorization.
+  LoopVectorizeHints Hints(L, DisableUnrolling, *ORE);
+  Function *F = L->getHeader()->getParent();
+  if (F->hasFnAttribute(Attribute::NoImplicitFloat))
+    return false;
+
+  EarlyExitLoopVectorizer EEV(L, SE, LI, DT, TTI, ORE, Hints);
+  if (!EEV.canVectorize()) {
+    DEBUG(dbgs() << "LV: Not vectorizing loop with an early exit: Cannot "
+                    "prove legality.\n");
+    emitMissedWarning(F, L, Hints, ORE);
+    return false;
+  }
+
+  unsigned VF = EEV.selectVectorizationFactor();
+  if (VF == 1) {
+    DEBUG(dbgs() << "LV: Vectorization of the loop with an early exit is "
+                    "possible but not beneficial.\n");
+    ORE->emit(OptimizationRemarkMissed(Hints.vectorizeAnalysisPassName(),
+                                       "VectorizationNotBeneficial",
+                                       L->getStartLoc(), L->getHeader())
+              << "the cost-model indicates that vectorization is not "
+                 "beneficial");
+    return false;
+  }
+
+  DEBUG(dbgs() << "LV: Vectorizing loop with an early exit with VF " << VF
+               << ".\n");
+  EEV.vectorize(VF);
+  ++LoopsVectorized;
+  ++EarlyExitLoopsVectorized;
+
+  using namespace ore;
+  ORE->emit(OptimizationRemark(LV_NAME, "Vectorized", L->getStartLoc(),
+                               L->getHeader())
+            << "vectorized loop with an early exit (vectorization width: "
+            << NV("VectorizationFactor", VF) << ")");
+
+  // Mark the loop as already vectorized to avoid vectorizing again.
+  Hints.setAlreadyVectorized();
+
+  DEBUG(verifyFunction(*L->getHeader()->getParent()));
+  return true;
+}
+
 bool LoopVectorizePass::runImpl(
     Function &F, ScalarEvolution &SE_, LoopInfo &LI_, TargetTransformInfo &TTI_,
     DominatorTree &DT_, BlockFrequencyInfo &BFI_, TargetLibraryInfo *TLI_,
@@ -8202,6 +9483,21 @@ bool LoopVectorizePass::runImpl(
 
   LoopsAnalyzed += Worklist.size();
 
+  // Vectorize the outer loops first. The inner loops collected above are
+  // those of the original nests, which remain as the scalar remainders.
+  if (EnableOuterLoopVectorize) {
+    SmallVector<Loop *, 4> OuterWorklist;
+    for (Loop *L : *LI)
+      addOuterLoopCandidates(*L, OuterWorklist);
+    LoopsAnalyzed += OuterWorklist.size();
+
+    while (!OuterWorklist.empty()) {
+      Loop *L = OuterWorklist.pop_back_val();
+      Changed |= formLCSSARecursively(*L, *DT, LI, SE);
+      Changed |= processOuterLoop(L);
+    }
+  }
+
   // Now walk the identified inner loops.
   while (!Worklist.empty()) {
     Loop *L = Worklist.pop_back_val();
@@ -26,6 +26,7 @@
 #include "llvm/Analysis/ScalarEvolutionExpressions.h"
 #include "llvm/Analysis/ValueTracking.h"
 #include "llvm/Analysis/VectorUtils.h"
+#include "llvm/IR/CompileTimeBudget.h"
 #include "llvm/IR/DataLayout.h"
 #include "llvm/IR/Dominators.h"
 #include "llvm/IR/IRBuilder.h"
@@ -93,6 +94,12 @@ static cl::opt<unsigned> MinTreeSize(
     "slp-min-tree-size", cl::init(3), cl::Hidden,
     cl::desc("Only vectorize small trees if they are fully vectorizable"));
 
+static cl::opt<bool> VectorizeNonPowerOf2(
+    "slp-vectorize-non-power-of-2", cl::init(false), cl::Hidden,
+    cl::desc("Attempt to vectorize store chains and lists whose length is "
+             "not a power of two, such as the components of 3-element "
+             "vectors, as a single padded vector"));
+
 static cl::opt<bool>
     ViewSLPTree("view-slp-tree", cl::Hidden,
                 cl::desc("Display the SLP trees with Graphviz"));
@@ -156,23 +163,6 @@ static bool isSplat(ArrayRef<Value *> VL) {
   return true;
 }
 
-///\returns Opcode that can be clubbed with \p Op to create an alternate
-/// sequence which can later be merged as a ShuffleVector instruction.
-static unsigned getAltOpcode(unsigned Op) {
-  switch (Op) {
-  case Instruction::FAdd:
-    return Instruction::FSub;
-  case Instruction::FSub:
-    return Instruction::FAdd;
-  case Instruction::Add:
-    return Instruction::Sub;
-  case Instruction::Sub:
-    return Instruction::Add;
-  default:
-    return 0;
-  }
-}
-
 /// true if the \p Value is odd, false otherwise.
 static bool isOdd(unsigned Value) {
   return Value & 1;
@@ -182,25 +172,84 @@ static bool isOdd(unsigned Value) {
 /// of an alternate sequence which can later be merged as
 /// a ShuffleVector instruction.
 static bool canCombineAsAltInst(unsigned Op) {
-  return Op == Instruction::FAdd || Op == Instruction::FSub ||
-         Op == Instruction::Sub || Op == Instruction::Add;
+  return Instruction::isBinaryOp(Op);
 }
 
-/// \returns ShuffleVector instruction if instructions in \p VL have
-///  alternate fadd,fsub / fsub,fadd/add,sub/sub,add sequence.
-/// (i.e. e.g. opcodes of fadd,fsub,fadd,fsub...)
+///\returns The opcode of the first instruction in \p VL whose opcode differs
+/// from that of \p VL[0], which can be clubbed with it to create an alternate
+/// sequence, or 0 if all the opcodes are the same.
+static unsigned getAltOpcode(ArrayRef<Value *> VL) {
+  unsigned Opcode = cast<Instruction>(VL[0])->getOpcode();
+  for (Value *V : VL)
+    if (cast<Instruction>(V)->getOpcode() != Opcode)
+      return cast<Instruction>(V)->getOpcode();
+  return 0;
+}
+
+/// \returns ShuffleVector instruction if instructions in \p VL are binary
+/// operators with exactly two different opcodes, in any order.
+/// (i.e. e.g. opcodes of fadd,fsub,fadd,fsub or mul,mul,udiv,mul...)
 static unsigned isAltInst(ArrayRef<Value *> VL) {
   Instruction *I0 = dyn_cast<Instruction>(VL[0]);
   unsigned Opcode = I0->getOpcode();
-  unsigned AltOpcode = getAltOpcode(Opcode);
+  unsigned AltOpcode = 0;
   for (int i = 1, e = VL.size(); i < e; i++) {
     Instruction *I = dyn_cast<Instruction>(VL[i]);
-    if (!I || I->getOpcode() != (isOdd(i) ? AltOpcode : Opcode))
+    if (!I || !canCombineAsAltInst(I->getOpcode()))
+      return 0;
+    if (I->getOpcode() == Opcode)
+      continue;
+    if (AltOpcode && I->getOpcode() != AltOpcode)
       return 0;
+    AltOpcode = I->getOpcode();
   }
   return Instruction::ShuffleVector;
 }
 
+/// \returns true if the opcodes of the alternate sequence \p VL alternate
+/// between even and odd lanes, which targets can blend cheaply.
+static bool isAlternatingAltInst(ArrayRef<Value *> VL) {
+  unsigned Opcode = cast<Instruction>(VL[0])->getOpcode();
+  for (unsigned i = 1, e = VL.size(); i < e; ++i)
+    if ((cast<Instruction>(VL[i])->getOpcode() != Opcode) != isOdd(i))
+      return false;
+  return true;
+}
+
+/// \returns true if \p VL alternates add and sub or fadd and fsub between
+/// even and odd lanes, which targets often have a single instruction for.
+static bool isAddSubAltInst(ArrayRef<Value *> VL) {
+  unsigned Opcode = cast<Instruction>(VL[0])->getOpcode();
+  unsigned AltOpcode = getAltOpcode(VL);
+  bool IsAddSub =
+      (Opcode == Instruction::Add && AltOpcode == Instruction::Sub) ||
+      (Opcode == Instruction::Sub && AltOpcode == Instruction::Add);
+  bool IsFAddFSub =
+      (Opcode == Instruction::FAdd && AltOpcode == Instruction::FSub) ||
+      (Opcode == Instruction::FSub && AltOpcode == Instruction::FAdd);
+  return (IsAddSub || IsFAddFSub) && isAlternatingAltInst(VL);
+}
+
+/// \returns true if both opcodes of the alternate sequence \p VL may be
+/// executed on every lane, given its right-hand operands \p Right. Integer
+/// division and remainder are only executed on divisors that cannot trap.
+static bool canExecuteAltOpcodesOnAllLanes(ArrayRef<Value *> VL,
+                                           ArrayRef<Value *> Right) {
+  for (unsigned Opcode :
+       {cast<Instruction>(VL[0])->getOpcode(), getAltOpcode(VL)}) {
+    if (Opcode != Instruction::UDiv && Opcode != Instruction::SDiv &&
+        Opcode != Instruction::URem && Opcode != Instruction::SRem)
+      continue;
+    bool IsSigned = Opcode == Instruction::SDiv || Opcode == Instruction::SRem;
+    for (Value *V : Right) {
+      auto *C = dyn_cast<ConstantInt>(V);
+      if (!C || C->isZero() || (IsSigned && C->isMinusOne()))
+        return false;
+    }
+  }
+  return true;
+}
+
 /// \returns The opcode if all of the Instructions in \p VL have the same
 /// opcode, or zero.
 static unsigned getSameOpcode(ArrayRef<Value *> VL) {
@@ -211,7 +260,7 @@ static unsigned getSameOpcode(ArrayRef<Value *> VL) {
   for (int i = 1, e = VL.size(); i < e; i++) {
     Instruction *I = dyn_cast<Instruction>(VL[i]);
     if (!I || Opcode != I->getOpcode()) {
-      if (canCombineAsAltInst(Opcode) && i == 1)
+      if (canCombineAsAltInst(Opcode))
         return isAltInst(VL);
       return 0;
     }
@@ -445,6 +494,10 @@ private:
   /// roots. This method calculates the cost of extracting the values.
   int getGatherCost(ArrayRef<Value *> VL);
 
+  /// \returns the cost of the vector operations and blend that replace the
+  /// alternate sequence \p VL of type \p VecTy, relative to its scalars.
+  int getAltShuffleCost(ArrayRef<Value *> VL, VectorType *VecTy);
+
   /// \brief Set the Builder insert point to one after the last instruction in
   /// the bundle
   void setInsertPointAfterBundle(ArrayRef<Value *> VL);
@@ -1608,18 +1661,41 @@ void BoUpSLP::buildTree_rec(ArrayRef<Value *> VL, unsigned Depth,
         DEBUG(dbgs() << "SLP: ShuffleVector are not vectorized.\n");
         return;
       }
-      newTreeEntry(VL, true, UserTreeIdx);
-      DEBUG(dbgs() << "SLP: added a ShuffleVector op.\n");
-
       // Reorder operands if reordering would enable vectorization.
       if (isa<BinaryOperator>(VL0)) {
         ValueList Left, Right;
         reorderAltShuffleOperands(VL, Left, Right);
+        if (!canExecuteAltOpcodesOnAllLanes(VL, Right)) {
+          BS.cancelScheduling(VL, VL0);
+          newTreeEntry(VL, false, UserTreeIdx);
+          DEBUG(dbgs() << "SLP: Gathering alternate sequence that may "
+                          "trap.\n");
+          return;
+        }
+        // Other than an addsub, two vector operations and a blend can cost
+        // more than inserting the scalar results, e.g. when one opcode is a
+        // vector multiply, so hold the bundle to the same threshold as the
+        // whole tree.
+        if (!isAddSubAltInst(VL) &&
+            getAltShuffleCost(VL, VectorType::get(VL0->getType(), VL.size())) -
+                    getGatherCost(VL) >=
+                -SLPCostThreshold) {
+          BS.cancelScheduling(VL, VL0);
+          newTreeEntry(VL, false, UserTreeIdx);
+          DEBUG(dbgs() << "SLP: Gathering alternate sequence that is cheaper "
+                          "to insert.\n");
+          return;
+        }
+        newTreeEntry(VL, true, UserTreeIdx);
+        DEBUG(dbgs() << "SLP: added a ShuffleVector op.\n");
         buildTree_rec(Left, Depth + 1, UserTreeIdx);
         buildTree_rec(Right, Depth + 1, UserTreeIdx);
         return;
       }
 
+      newTreeEntry(VL, true, UserTreeIdx);
+      DEBUG(dbgs() << "SLP: added a ShuffleVector op.\n");
+
       for (unsigned i = 0, e = VL0->getNumOperands(); i < e; ++i) {
         ValueList Operands;
         // Prepare the operand vector.
@@ -1912,32 +1988,8 @@ int BoUpSLP::getEntryCost(TreeEntry *E) {
 
       return VecCallCost - ScalarCallCost;
     }
-    case Instruction::ShuffleVector: {
-      TargetTransformInfo::OperandValueKind Op1VK =
-          TargetTransformInfo::OK_AnyValue;
-      TargetTransformInfo::OperandValueKind Op2VK =
-          TargetTransformInfo::OK_AnyValue;
-      int ScalarCost = 0;
-      int VecCost = 0;
-      for (Value *i : VL) {
-        Instruction *I = cast<Instruction>(i);
-        if (!I)
-          break;
-        ScalarCost +=
-            TTI->getArithmeticInstrCost(I->getOpcode(), ScalarTy, Op1VK, Op2VK);
-      }
-      // VecCost is equal to sum of the cost of creating 2 vectors
-      // and the cost of creating shuffle.
-      Instruction *I0 = cast<Instruction>(VL[0]);
-      VecCost =
-          TTI->getArithmeticInstrCost(I0->getOpcode(), VecTy, Op1VK, Op2VK);
-      Instruction *I1 = cast<Instruction>(VL[1]);
-      VecCost +=
-          TTI->getArithmeticInstrCost(I1->getOpcode(), VecTy, Op1VK, Op2VK);
-      VecCost +=
-          TTI->getShuffleCost(TargetTransformInfo::SK_Alternate, VecTy, 0);
-      return VecCost - ScalarCost;
-    }
+    case Instruction::ShuffleVector:
+      return getAltShuffleCost(VL, VecTy);
     default:
       llvm_unreachable("Unknown instruction");
   }
@@ -2113,6 +2165,29 @@ int BoUpSLP::getTreeCost() {
   return Cost;
 }
 
+int BoUpSLP::getAltShuffleCost(ArrayRef<Value *> VL, VectorType *VecTy) {
+  TargetTransformInfo::OperandValueKind Op1VK =
+      TargetTransformInfo::OK_AnyValue;
+  TargetTransformInfo::OperandValueKind Op2VK =
+      TargetTransformInfo::OK_AnyValue;
+  Type *ScalarTy = VecTy->getElementType();
+  int ScalarCost = 0;
+  for (Value *V : VL)
+    ScalarCost += TTI->getArithmeticInstrCost(cast<Instruction>(V)->getOpcode(),
+                                              ScalarTy, Op1VK, Op2VK);
+  // VecCost is equal to sum of the cost of creating 2 vectors
+  // and the cost of creating shuffle.
+  int VecCost = TTI->getArithmeticInstrCost(
+      cast<Instruction>(VL[0])->getOpcode(), VecTy, Op1VK, Op2VK);
+  VecCost +=
+      TTI->getArithmeticInstrCost(getAltOpcode(VL), VecTy, Op1VK, Op2VK);
+  VecCost += TTI->getShuffleCost(isAlternatingAltInst(VL)
+                                     ? TargetTransformInfo::SK_Alternate
+                                     : TargetTransformInfo::SK_PermuteTwoSrc,
+                                 VecTy, 0);
+  return VecCost - ScalarCost;
+}
+
 int BoUpSLP::getGatherCost(Type *Ty) {
   int Cost = 0;
   for (unsigned i = 0, e = cast<VectorType>(Ty)->getNumElements(); i < e; ++i)
@@ -2814,29 +2889,29 @@ Value *BoUpSLP::vectorizeTree(TreeEntry *E) {
       Value *V0 = Builder.CreateBinOp(BinOp0->getOpcode(), LHS, RHS);
 
       // Create a vector of LHS op2 RHS
-      Instruction *VL1 = cast<Instruction>(E->Scalars[1]);
-      BinaryOperator *BinOp1 = cast<BinaryOperator>(VL1);
-      Value *V1 = Builder.CreateBinOp(BinOp1->getOpcode(), LHS, RHS);
+      unsigned AltOpcode = getAltOpcode(E->Scalars);
+      Value *V1 = Builder.CreateBinOp(
+          static_cast<Instruction::BinaryOps>(AltOpcode), LHS, RHS);
 
       // Create shuffle to take alternate operations from the vector.
-      // Also, gather up odd and even scalar ops to propagate IR flags to
-      // each vector operation.
-      ValueList OddScalars, EvenScalars;
+      // Also, gather up the scalar ops of each opcode to propagate IR flags
+      // to each vector operation.
+      ValueList AltScalars, MainScalars;
       unsigned e = E->Scalars.size();
       SmallVector<Constant *, 8> Mask(e);
       for (unsigned i = 0; i < e; ++i) {
-        if (isOdd(i)) {
+        if (cast<Instruction>(E->Scalars[i])->getOpcode() == AltOpcode) {
           Mask[i] = Builder.getInt32(e + i);
-          OddScalars.push_back(E->Scalars[i]);
+          AltScalars.push_back(E->Scalars[i]);
         } else {
           Mask[i] = Builder.getInt32(i);
-          EvenScalars.push_back(E->Scalars[i]);
+          MainScalars.push_back(E->Scalars[i]);
         }
       }
 
       Value *ShuffleMask = ConstantVector::get(Mask);
-      propagateIRFlags(V0, EvenScalars);
-      propagateIRFlags(V1, OddScalars);
+      propagateIRFlags(V0, MainScalars);
+      propagateIRFlags(V1, AltScalars);
 
       Value *V = Builder.CreateShuffleVector(V0, V1, ShuffleMask);
       E->VectorizedValue = V;
@@ -3870,6 +3945,10 @@ bool SLPVectorizerPass::runImpl(Function &F, ScalarEvolution *SE_,
 
   // Scan the blocks in the function in post order.
   for (auto BB : post_order(&F.getEntryBlock())) {
+    // Leave the remaining blocks scalar once the function is out of time.
+    if (CompileTimeBudget::shouldDegrade(F, DEBUG_TYPE))
+      break;
+
     collectSeedInstructions(BB);
 
     // Vectorize trees that end at stores.
@@ -4026,15 +4105,29 @@ bool SLPVectorizerPass::vectorizeStores(ArrayRef<StoreInst *> Stores,
 
     // FIXME: Is division-by-2 the correct step? Should we assert that the
     // register size is a power-of-2?
+    bool Vectorized = false;
     for (unsigned Size = R.getMaxVecRegSize(); Size >= R.getMinVecRegSize();
          Size /= 2) {
       if (vectorizeStoreChain(Operands, R, Size)) {
-        // Mark the vectorized stores so that we don't vectorize them again.
-        VectorizedStores.insert(Operands.begin(), Operands.end());
-        Changed = true;
+        Vectorized = true;
         break;
       }
     }
+
+    // A chain that no power-of-two width covers, such as the components of a
+    // 3-element vector, may still fit in a single register with padding.
+    if (!Vectorized && VectorizeNonPowerOf2 && Operands.size() > 2 &&
+        !isPowerOf2_32(Operands.size())) {
+      unsigned Size = Operands.size() * R.getVectorElementSize(Operands[0]);
+      Vectorized =
+          Size <= R.getMaxVecRegSize() && vectorizeStoreChain(Operands, R, Size);
+    }
+
+    if (Vectorized) {
+      // Mark the vectorized stores so that we don't vectorize them again.
+      VectorizedStores.insert(Operands.begin(), Operands.end());
+      Changed = true;
+    }
   }
 
   return Changed;
@@ -4137,7 +4230,7 @@ bool SLPVectorizerPass::tryToVectorizeList(ArrayRef<Value *> VL, BoUpSLP &R,
       else
         OpsWidth = VF;
 
-      if (!isPowerOf2_32(OpsWidth) || OpsWidth < 2)
+      if ((!isPowerOf2_32(OpsWidth) && !VectorizeNonPowerOf2) || OpsWidth < 2)
         break;
 
       // Check that a previous iteration of this loop did not delete the Value.
@@ -4313,16 +4406,25 @@ namespace {
 ///     |
 ///   *p =
 ///
+/// The reduction operations may also be min or max operations of a single
+/// kind, each written as a compare and a select, such as
+///   %c = icmp sgt i32 %a, %b
+///   %m = select i1 %c, i32 %a, i32 %b
+///
 class HorizontalReduction {
+  using MinMaxKind = RecurrenceDescriptor::MinMaxRecurrenceKind;
+
   SmallVector<Value *, 16> ReductionOps;
   SmallVector<Value *, 32> ReducedVals;
   // Use map vector to make stable output.
   MapVector<Instruction *, Value *> ExtraArgs;
 
-  BinaryOperator *ReductionRoot = nullptr;
+  Instruction *ReductionRoot = nullptr;
 
-  /// The opcode of the reduction.
+  /// The opcode of the reduction, if it is not a min/max reduction.
   Instruction::BinaryOps ReductionOpcode = Instruction::BinaryOpsEnd;
+  /// The kind of a min/max reduction, or MRK_Invalid.
+  MinMaxKind ReductionMinMaxKind = RecurrenceDescriptor::MRK_Invalid;
   /// The opcode of the values we perform a reduction on.
   unsigned ReducedValueOpcode = 0;
   /// Should we model this reduction as a pairwise reduction tree or a tree that
@@ -4349,11 +4451,71 @@ class HorizontalReduction {
     }
   }
 
+  /// \returns the kind of min/max operation \p I performs as the select of
+  /// a compare and select pair, or MRK_Invalid. Floating-point min/max
+  /// operations can only be reassociated if they ignore NaNs.
+  static MinMaxKind getMinMaxKind(Instruction *I) {
+    if (!isa<SelectInst>(I))
+      return RecurrenceDescriptor::MRK_Invalid;
+    RecurrenceDescriptor::InstDesc Prev(false, nullptr);
+    RecurrenceDescriptor::InstDesc Desc =
+        RecurrenceDescriptor::isMinMaxSelectCmpPattern(I, Prev);
+    if (!Desc.isRecurrence())
+      return RecurrenceDescriptor::MRK_Invalid;
+    MinMaxKind Kind = Desc.getMinMaxKind();
+    if ((Kind == RecurrenceDescriptor::MRK_FloatMin ||
+         Kind == RecurrenceDescriptor::MRK_FloatMax) &&
+        !cast<FPMathOperator>(I->getOperand(0))->hasNoNaNs())
+      return RecurrenceDescriptor::MRK_Invalid;
+    return Kind;
+  }
+
+  bool isMinMax() const {
+    return ReductionMinMaxKind != RecurrenceDescriptor::MRK_Invalid;
+  }
+
+  /// \returns true if \p I is an operation of the reduction.
+  bool isReductionOp(Instruction *I) const {
+    if (isMinMax())
+      return getMinMaxKind(I) == ReductionMinMaxKind;
+    return I->getOpcode() == ReductionOpcode;
+  }
+
+  /// The index of the first of the two reduced operands of a reduction
+  /// operation: a select takes its condition first.
+  unsigned getFirstOperandIndex() const { return isMinMax() ? 1 : 0; }
+
+  /// \returns the operand of the reduction operation \p I that is visited at
+  /// \p Edge. The operands of a min/max are visited in the order its compare
+  /// names them, so either predicate form lists values in source order.
+  Value *getReductionOperand(Instruction *I, unsigned Edge) const {
+    if (isMinMax() &&
+        I->getOperand(1) == cast<CmpInst>(I->getOperand(0))->getOperand(1))
+      Edge = Edge == 1 ? 2 : 1;
+    return I->getOperand(Edge);
+  }
+
+  /// The number of uses a reduction operation or reduced value has in its
+  /// parent operation: a min/max uses its operands in the compare too.
+  unsigned getRequiredNumberOfUses() const { return isMinMax() ? 2 : 1; }
+
+  /// Emit a reduction operation of \p LHS and \p RHS, with the IR flags
+  /// common to \p FlagsFrom.
+  Value *createOp(IRBuilder<> &Builder, Value *LHS, Value *RHS,
+                  const Twine &Name, ArrayRef<Value *> FlagsFrom) {
+    if (isMinMax())
+      return RecurrenceDescriptor::createMinMaxOp(Builder, ReductionMinMaxKind,
+                                                  LHS, RHS);
+    Value *Op = Builder.CreateBinOp(ReductionOpcode, LHS, RHS, Name);
+    propagateIRFlags(Op, FlagsFrom);
+    return Op;
+  }
+
 public:
   HorizontalReduction() = default;
 
   /// \brief Try to find a reduction tree.
-  bool matchAssociativeReduction(PHINode *Phi, BinaryOperator *B) {
+  bool matchAssociativeReduction(PHINode *Phi, Instruction *B) {
     assert((!Phi || is_contained(Phi->operands(), B)) &&
            "Thi phi needs to use the binary operator");
 
@@ -4361,12 +4523,13 @@ public:
     //  r *= v1 + v2 + v3 + v4
     // In such a case start looking for a tree rooted in the first '+'.
     if (Phi) {
-      if (B->getOperand(0) == Phi) {
+      unsigned First = isa<SelectInst>(B) ? 1 : 0;
+      if (B->getOperand(First) == Phi) {
         Phi = nullptr;
-        B = dyn_cast<BinaryOperator>(B->getOperand(1));
-      } else if (B->getOperand(1) == Phi) {
+        B = dyn_cast<Instruction>(B->getOperand(First + 1));
+      } else if (B->getOperand(First + 1) == Phi) {
         Phi = nullptr;
-        B = dyn_cast<BinaryOperator>(B->getOperand(0));
+        B = dyn_cast<Instruction>(B->getOperand(First));
       }
     }
 
@@ -4377,27 +4540,43 @@ public:
     if (!isValidElementType(Ty))
       return false;
 
-    ReductionOpcode = B->getOpcode();
+    ReductionMinMaxKind = getMinMaxKind(B);
     ReducedValueOpcode = 0;
     ReductionRoot = B;
 
-    // We currently only support adds.
-    if ((ReductionOpcode != Instruction::Add &&
-         ReductionOpcode != Instruction::FAdd) ||
-        !B->isAssociative())
-      return false;
+    // The compares of a min/max chain are visited before the chain's root, so
+    // only match the chain from its outermost operation.
+    if (isMinMax())
+      for (User *U : B->users()) {
+        auto *UI = dyn_cast<Instruction>(U);
+        if (UI && UI->getParent() == B->getParent() && isReductionOp(UI))
+          return false;
+      }
+
+    // We currently only support adds and min/max operations.
+    if (!isMinMax()) {
+      auto *BinOp = dyn_cast<BinaryOperator>(B);
+      if (!BinOp)
+        return false;
+      ReductionOpcode = BinOp->getOpcode();
+      if ((ReductionOpcode != Instruction::Add &&
+           ReductionOpcode != Instruction::FAdd) ||
+          !B->isAssociative())
+        return false;
+    }
 
     // Post order traverse the reduction tree starting at B. We only handle true
     // trees containing only binary operators or selects.
+    unsigned FirstEdge = getFirstOperandIndex();
     SmallVector<std::pair<Instruction *, unsigned>, 32> Stack;
-    Stack.push_back(std::make_pair(B, 0));
+    Stack.push_back(std::make_pair(B, FirstEdge));
     while (!Stack.empty()) {
       Instruction *TreeN = Stack.back().first;
       unsigned EdgeToVist = Stack.back().second++;
-      bool IsReducedValue = TreeN->getOpcode() != ReductionOpcode;
+      bool IsReducedValue = !isReductionOp(TreeN);
 
       // Postorder vist.
-      if (EdgeToVist == 2 || IsReducedValue) {
+      if (EdgeToVist == FirstEdge + 2 || IsReducedValue) {
         if (IsReducedValue)
           ReducedVals.push_back(TreeN);
         else {
@@ -4414,8 +4593,12 @@ public:
             // Stack[Stack.size() - 2] always points to the parent operation.
             markExtraArg(Stack[Stack.size() - 2], TreeN);
             ExtraArgs.erase(TreeN);
-          } else
+          } else {
             ReductionOps.push_back(TreeN);
+            // The compare of a min/max goes away with its select.
+            if (isMinMax())
+              ReductionOps.push_back(TreeN->getOperand(0));
+          }
         }
         // Retract.
         Stack.pop_back();
@@ -4423,7 +4606,7 @@ public:
       }
 
       // Visit left or right.
-      Value *NextV = TreeN->getOperand(EdgeToVist);
+      Value *NextV = getReductionOperand(TreeN, EdgeToVist);
       if (NextV != Phi) {
         auto *I = dyn_cast<Instruction>(NextV);
         // Continue analysis if the next operand is a reduction operation or
@@ -4431,7 +4614,7 @@ public:
         // the first met operation != reduction operation is considered as the
         // reduced value class.
         if (I && (!ReducedValueOpcode || I->getOpcode() == ReducedValueOpcode ||
-                  I->getOpcode() == ReductionOpcode)) {
+                  isReductionOp(I))) {
           // Only handle trees in the current basic block.
           if (I->getParent() != B->getParent()) {
             // I is an extra argument for TreeN (its parent operation).
@@ -4441,15 +4624,15 @@ public:
 
           // Each tree node needs to have one user except for the ultimate
           // reduction.
-          if (!I->hasOneUse() && I != B) {
+          if (!I->hasNUses(getRequiredNumberOfUses()) && I != B) {
             // I is an extra argument for TreeN (its parent operation).
             markExtraArg(Stack.back(), I);
             continue;
           }
 
-          if (I->getOpcode() == ReductionOpcode) {
+          if (isReductionOp(I)) {
             // We need to be able to reassociate the reduction operations.
-            if (!I->isAssociative()) {
+            if (!isMinMax() && !I->isAssociative()) {
               // I is an extra argument for TreeN (its parent operation).
               markExtraArg(Stack.back(), I);
               continue;
@@ -4464,7 +4647,7 @@ public:
           } else if (!ReducedValueOpcode)
             ReducedValueOpcode = I->getOpcode();
 
-          Stack.push_back(std::make_pair(I, 0));
+          Stack.push_back(std::make_pair(I, FirstEdge));
           continue;
         }
       }
@@ -4537,9 +4720,8 @@ public:
           emitReduction(VectorizedRoot, Builder, ReduxWidth, ReductionOps, TTI);
       if (VectorizedTree) {
         Builder.SetCurrentDebugLocation(Loc);
-        VectorizedTree = Builder.CreateBinOp(ReductionOpcode, VectorizedTree,
-                                             ReducedSubTree, "bin.rdx");
-        propagateIRFlags(VectorizedTree, ReductionOps);
+        VectorizedTree = createOp(Builder, VectorizedTree, ReducedSubTree,
+                                  "bin.rdx", ReductionOps);
       } else
         VectorizedTree = ReducedSubTree;
       i += ReduxWidth;
@@ -4551,9 +4733,7 @@ public:
       for (; i < NumReducedVals; ++i) {
         auto *I = cast<Instruction>(ReducedVals[i]);
         Builder.SetCurrentDebugLocation(I->getDebugLoc());
-        VectorizedTree =
-            Builder.CreateBinOp(ReductionOpcode, VectorizedTree, I);
-        propagateIRFlags(VectorizedTree, ReductionOps);
+        VectorizedTree = createOp(Builder, VectorizedTree, I, "", ReductionOps);
       }
       for (auto &Pair : ExternallyUsedValues) {
         assert(!Pair.second.empty() &&
@@ -4561,9 +4741,8 @@ public:
         // Add each externally used value to the final reduction.
         for (auto *I : Pair.second) {
           Builder.SetCurrentDebugLocation(I->getDebugLoc());
-          VectorizedTree = Builder.CreateBinOp(ReductionOpcode, VectorizedTree,
-                                               Pair.first, "bin.extra");
-          propagateIRFlags(VectorizedTree, I);
+          VectorizedTree = createOp(Builder, VectorizedTree, Pair.first,
+                                    "bin.extra", I);
         }
       }
       // Update users.
@@ -4583,6 +4762,32 @@ private:
     Type *ScalarTy = FirstReducedVal->getType();
     Type *VecTy = VectorType::get(ScalarTy, ReduxWidth);
 
+    if (isMinMax()) {
+      // Min/max reductions are emitted as a splitting reduction of compares
+      // and selects.
+      IsPairwiseReduction = false;
+      unsigned CmpOpcode = ScalarTy->isFloatingPointTy() ? Instruction::FCmp
+                                                         : Instruction::ICmp;
+      Type *CondTy = Type::getInt1Ty(ScalarTy->getContext());
+      Type *VecCondTy = VectorType::get(CondTy, ReduxWidth);
+      int VecReduxCost =
+          TTI->getVectorInstrCost(Instruction::ExtractElement, VecTy, 0);
+      for (unsigned i = ReduxWidth; i != 1; i >>= 1)
+        VecReduxCost +=
+            TTI->getShuffleCost(TargetTransformInfo::SK_PermuteSingleSrc,
+                                VecTy) +
+            TTI->getCmpSelInstrCost(CmpOpcode, VecTy, VecCondTy) +
+            TTI->getCmpSelInstrCost(Instruction::Select, VecTy, VecCondTy);
+      int ScalarReduxCost =
+          (ReduxWidth - 1) *
+          (TTI->getCmpSelInstrCost(CmpOpcode, ScalarTy, CondTy) +
+           TTI->getCmpSelInstrCost(Instruction::Select, ScalarTy, CondTy));
+      DEBUG(dbgs() << "SLP: Adding cost " << VecReduxCost - ScalarReduxCost
+                   << " for min/max reduction that starts with "
+                   << *FirstReducedVal << "\n");
+      return VecReduxCost - ScalarReduxCost;
+    }
+
     int PairwiseRdxCost = TTI->getReductionCost(ReductionOpcode, VecTy, true);
     int SplittingRdxCost = TTI->getReductionCost(ReductionOpcode, VecTy, false);
 
@@ -4610,6 +4815,23 @@ private:
     assert(isPowerOf2_32(ReduxWidth) &&
            "We only handle power-of-two reductions for now");
 
+    if (isMinMax()) {
+      TargetTransformInfo::ReductionFlags Flags;
+      Flags.IsMaxOp =
+          ReductionMinMaxKind == RecurrenceDescriptor::MRK_UIntMax ||
+          ReductionMinMaxKind == RecurrenceDescriptor::MRK_SIntMax ||
+          ReductionMinMaxKind == RecurrenceDescriptor::MRK_FloatMax;
+      Flags.IsSigned =
+          ReductionMinMaxKind == RecurrenceDescriptor::MRK_SIntMin ||
+          ReductionMinMaxKind == RecurrenceDescriptor::MRK_SIntMax;
+      bool IsFloat = VectorizedValue->getType()->isFPOrFPVectorTy();
+      // Only NaN-free floating-point reductions are matched.
+      Flags.NoNaN = IsFloat;
+      return createSimpleTargetReduction(
+          Builder, TTI, IsFloat ? Instruction::FCmp : Instruction::ICmp,
+          VectorizedValue, Flags);
+    }
+
     if (!IsPairwiseReduction)
       return createSimpleTargetReduction(
           Builder, TTI, ReductionOpcode, VectorizedValue,
@@ -4797,9 +5019,9 @@ static bool tryToVectorizeHorReductionOrInstOperands(
     auto *Inst = dyn_cast<Instruction>(V);
     if (!Inst || isa<PHINode>(Inst))
       continue;
-    if (auto *BI = dyn_cast<BinaryOperator>(Inst)) {
+    if (isa<BinaryOperator>(Inst) || isa<SelectInst>(Inst)) {
       HorizontalReduction HorRdx;
-      if (HorRdx.matchAssociativeReduction(P, BI)) {
+      if (HorRdx.matchAssociativeReduction(P, Inst)) {
         if (HorRdx.tryToReduce(R, TTI)) {
           Res = true;
           // Set P to nullptr to avoid re-analysis of phi node in
@@ -4809,9 +5031,10 @@ static bool tryToVectorizeHorReductionOrInstOperands(
         }
       }
       if (P) {
-        Inst = dyn_cast<Instruction>(BI->getOperand(0));
-        if (Inst == P)
-          Inst = dyn_cast<Instruction>(BI->getOperand(1));
+        unsigned First = isa<SelectInst>(Inst) ? 1 : 0;
+        Value *Op = Inst->getOperand(First);
+        Inst = dyn_cast<Instruction>(Op == P ? Inst->getOperand(First + 1)
+                                             : Op);
         if (!Inst) {
           // Set P to nullptr to avoid re-analysis of phi node in
           // matchAssociativeReduction function unless this is the root node.
@@ -4845,7 +5068,7 @@ bool SLPVectorizerPass::vectorizeRootInstruction(PHINode *P, Value *V,
   if (!I)
     return false;
 
-  if (!isa<BinaryOperator>(I))
+  if (!isa<BinaryOperator>(I) && !isa<SelectInst>(I))
     P = nullptr;
   // Try to match and vectorize a horizontal reduction.
   return tryToVectorizeHorReductionOrInstOperands(
@@ -0,0 +1,64 @@
+; RUN: llc -mtriple=aarch64-linux-gnu -mcpu=cortex-a57 -O2 \
+; RUN:     -aarch64-enable-pipeliner -pipeliner-check-reorder-window=false \
+; RUN:     -stats -o /dev/null < %s 2>&1 | FileCheck %s
+; RUN: llc -mtriple=aarch64-linux-gnu -mcpu=cortex-a57 -O2 \
+; RUN:     -aarch64-enable-pipeliner -stats -o /dev/null < %s 2>&1 \
+; RUN:     | FileCheck %s --check-prefix=WINDOW
+; RUN: llc -mtriple=aarch64-linux-gnu -mcpu=cortex-a57 -O2 \
+; RUN:     -aarch64-enable-pipeliner -pipeliner-check-reorder-window=false \
+; RUN:     -verify-machineinstrs < %s | FileCheck %s --check-prefix=ASM
+; REQUIRES: asserts
+
+; The loop is controlled by a compare of the induction variable, which the
+; prolog blocks repeat to skip the kernel for short trip counts.  Its body is
+; small enough for the out-of-order window of the core to overlap iterations
+; on its own, so it is only pipelined when that check is disabled.
+
+; CHECK: 1 pipeliner - Number of loops software pipelined
+; WINDOW: 1 pipeliner - Number of loops that we attempt to pipeline
+; WINDOW-NOT: Number of loops software pipelined
+
+; The prolog starts the first iteration and skips the kernel if it is the
+; only one.  The kernel finishes one iteration while it starts the next, with
+; a single compare of the induction variable, and the epilog finishes the
+; last one.
+; ASM-LABEL: saxpy:
+; ASM:       fmul
+; ASM:       cmp {{x[0-9]+}}, x2
+; ASM-NEXT:  b.ge [[EPILOG:.LBB[0-9_]+]]
+; ASM:     [[KERNEL:.LBB[0-9_]+]]:
+; ASM:       fadd
+; ASM-NEXT:  str
+; ASM:       ldr
+; ASM:       cmp {{x[0-9]+}}, x2
+; ASM-NOT:   cmp
+; ASM:       fmul
+; ASM-NEXT:  b.lt [[KERNEL]]
+; ASM-NEXT: [[EPILOG]]:
+; ASM-NEXT:  fadd
+; ASM-NEXT:  str
+
+define void @saxpy(float* noalias nocapture %y, float* noalias nocapture readonly %x, float %a, i64 %n) {
+entry:
+  %cmp10 = icmp sgt i64 %n, 0
+  br i1 %cmp10, label %for.body.preheader, label %for.end
+
+for.body.preheader:
+  br label %for.body
+
+for.body:
+  %i = phi i64 [ %i.next, %for.body ], [ 0, %for.body.preheader ]
+  %px = getelementptr inbounds float, float* %x, i64 %i
+  %vx = load float, float* %px, align 4
+  %mul = fmul float %vx, %a
+  %py = getelementptr inbounds float, float* %y, i64 %i
+  %vy = load float, float* %py, align 4
+  %add = fadd float %mul, %vy
+  store float %add, float* %py, align 4
+  %i.next = add nuw nsw i64 %i, 1
+  %cmp = icmp slt i64 %i.next, %n
+  br i1 %cmp, label %for.body, label %for.end
+
+for.end:
+  ret void
+}
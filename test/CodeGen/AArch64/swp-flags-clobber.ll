@@ -0,0 +1,56 @@
+; RUN: llc -mtriple=aarch64-linux-gnu -mcpu=cortex-a57 -O2 \
+; RUN:     -aarch64-enable-pipeliner -pipeliner-check-reorder-window=false \
+; RUN:     -debug-only=pipeliner -o /dev/null < %s 2>&1 | FileCheck %s
+; RUN: llc -mtriple=aarch64-linux-gnu -mcpu=cortex-a57 -O2 \
+; RUN:     -aarch64-enable-pipeliner -pipeliner-check-reorder-window=false \
+; RUN:     -verify-machineinstrs < %s | FileCheck %s --check-prefix=ASM
+; REQUIRES: asserts
+
+; The loop body has two compares, each read by a csel.  The dependences only
+; order the instructions of one iteration, so the schedule with II=7 places
+; the first compare of an iteration between the second compare and csel of
+; the previous one.  That schedule has to be rejected.
+
+; CHECK: Try to schedule with 7
+; CHECK: clobbers %NZCV between
+; CHECK: Schedule Found? 1
+
+; Each csel in the kernel reads the flags of its own compare.
+; ASM-LABEL: clamp:
+; ASM:     [[KERNEL:.LBB[0-9_]+]]:
+; ASM:       cmp {{w[0-9]+}}, w3
+; ASM-NOT:   cmp
+; ASM:       csel {{w[0-9]+}}, {{w[0-9]+}}, w3, gt
+; ASM-NOT:   cmp
+; ASM:       cmp {{w[0-9]+}}, w4
+; ASM-NOT:   cmp
+; ASM:       csel {{w[0-9]+}}, {{w[0-9]+}}, w4, lt
+; ASM-NEXT:  cmp {{x[0-9]+}}, x5
+; ASM-NEXT:  b.lt [[KERNEL]]
+
+define void @clamp(i32* noalias nocapture %y, i32* noalias nocapture readonly %x, i32* noalias nocapture readonly %z, i32 %a, i32 %b, i64 %n) {
+entry:
+  %cmp10 = icmp sgt i64 %n, 0
+  br i1 %cmp10, label %for.body, label %for.end
+
+for.body:
+  %i = phi i64 [ %i.next, %for.body ], [ 0, %entry ]
+  %px = getelementptr inbounds i32, i32* %x, i64 %i
+  %vx = load i32, i32* %px, align 4
+  %pz = getelementptr inbounds i32, i32* %z, i64 %i
+  %vz = load i32, i32* %pz, align 4
+  %c = icmp sgt i32 %vz, %a
+  %s = select i1 %c, i32 %vx, i32 %a
+  %c2 = icmp slt i32 %s, %b
+  %m1 = mul nsw i32 %s, %vz
+  %m2 = mul nsw i32 %m1, %vz
+  %s2 = select i1 %c2, i32 %m2, i32 %b
+  %py = getelementptr inbounds i32, i32* %y, i64 %i
+  store i32 %s2, i32* %py, align 4
+  %i.next = add nuw nsw i64 %i, 1
+  %cmp = icmp slt i64 %i.next, %n
+  br i1 %cmp, label %for.body, label %for.end
+
+for.end:
+  ret void
+}
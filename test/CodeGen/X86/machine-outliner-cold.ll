@@ -0,0 +1,89 @@
+; RUN: llc -enable-machine-outliner -mtriple=x86_64-linux-gnu < %s \
+; RUN:     | FileCheck %s
+; RUN: llc -enable-machine-outliner -outliner-cold-only \
+; RUN:     -mtriple=x86_64-linux-gnu < %s | FileCheck %s --check-prefix=COLD
+; RUN: llc -enable-machine-outliner -outliner-parallel-benefit \
+; RUN:     -outliner-parallel-benefit-threshold=0 \
+; RUN:     -mtriple=x86_64-linux-gnu < %s | FileCheck %s
+
+; Sequences repeated in hot code are outlined into .text, while sequences only
+; repeated in cold functions are outlined into .text.unlikely. With
+; -outliner-cold-only the hot functions are left alone.
+
+define void @hot1() #0 {
+; CHECK-LABEL: hot1:
+; CHECK: callq [[HOT:.LOUTLINED_FUNCTION_[0-9]+]]
+; COLD-LABEL: hot1:
+; COLD-NOT: callq
+; COLD: retq
+  %1 = alloca i32, align 4
+  %2 = alloca i32, align 4
+  %3 = alloca i32, align 4
+  %4 = alloca i32, align 4
+  store volatile i32 1, i32* %1, align 4
+  store volatile i32 2, i32* %2, align 4
+  store volatile i32 3, i32* %3, align 4
+  store volatile i32 4, i32* %4, align 4
+  ret void
+}
+
+define void @hot2() #0 {
+; CHECK-LABEL: hot2:
+; CHECK: callq [[HOT]]
+; COLD-LABEL: hot2:
+; COLD-NOT: callq
+; COLD: retq
+  %1 = alloca i32, align 4
+  %2 = alloca i32, align 4
+  %3 = alloca i32, align 4
+  %4 = alloca i32, align 4
+  store volatile i32 1, i32* %1, align 4
+  store volatile i32 2, i32* %2, align 4
+  store volatile i32 3, i32* %3, align 4
+  store volatile i32 4, i32* %4, align 4
+  ret void
+}
+
+define void @cold1() #1 {
+; CHECK-LABEL: cold1:
+; CHECK: callq [[COLDFN:.LOUTLINED_FUNCTION_[0-9]+]]
+; COLD-LABEL: cold1:
+; COLD: callq [[COLDFN:.LOUTLINED_FUNCTION_[0-9]+]]
+  %1 = alloca i32, align 4
+  %2 = alloca i32, align 4
+  %3 = alloca i32, align 4
+  %4 = alloca i32, align 4
+  store volatile i32 5, i32* %1, align 4
+  store volatile i32 6, i32* %2, align 4
+  store volatile i32 7, i32* %3, align 4
+  store volatile i32 8, i32* %4, align 4
+  ret void
+}
+
+define void @cold2() #1 {
+; CHECK-LABEL: cold2:
+; CHECK: callq [[COLDFN]]
+; COLD-LABEL: cold2:
+; COLD: callq [[COLDFN]]
+  %1 = alloca i32, align 4
+  %2 = alloca i32, align 4
+  %3 = alloca i32, align 4
+  %4 = alloca i32, align 4
+  store volatile i32 5, i32* %1, align 4
+  store volatile i32 6, i32* %2, align 4
+  store volatile i32 7, i32* %3, align 4
+  store volatile i32 8, i32* %4, align 4
+  ret void
+}
+
+; CHECK: .section .text.unlikely,"ax",@progbits
+; CHECK: [[COLDFN]]:
+; CHECK: movl $5,
+
+; COLD: .section .text.unlikely,"ax",@progbits
+; COLD: [[COLDFN]]:
+; COLD: movl $5,
+; COLD-NOT: {{^}}.LOUTLINED_FUNCTION_{{[0-9]+}}:
+
+attributes #0 = { noredzone nounwind "no-frame-pointer-elim"="true" }
+attributes #1 = { cold noredzone nounwind "no-frame-pointer-elim"="true" }
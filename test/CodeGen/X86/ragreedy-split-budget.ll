@@ -0,0 +1,67 @@
+; RUN: llc -mtriple=x86_64-linux-gnu -O2 -verify-machineinstrs \
+; RUN:     -debug-only=regalloc -o /dev/null < %s 2>&1 \
+; RUN:     | FileCheck %s --check-prefix=DEFAULT
+; RUN: llc -mtriple=x86_64-linux-gnu -O2 -verify-machineinstrs \
+; RUN:     -huge-split-live-blocks=1 -huge-split-max-candidates=0 \
+; RUN:     -debug-only=regalloc -o /dev/null < %s 2>&1 \
+; RUN:     | FileCheck %s --check-prefix=CANDIDATES
+; RUN: llc -mtriple=x86_64-linux-gnu -O2 -verify-machineinstrs \
+; RUN:     -grow-region-complexity-budget=1 -debug-only=regalloc -stats \
+; RUN:     -o /dev/null < %s 2>&1 | FileCheck %s --check-prefix=BUDGET
+; REQUIRES: asserts
+
+; The inline asm clobbers every general purpose register, so the arguments,
+; which are live across the loop, have to be split or spilled.  When region
+; splitting runs out of candidates or of its complexity budget, the greedy
+; allocator falls back to per-block splitting, which isolates the block with
+; two uses of %a, and spills the other arguments.
+
+; DEFAULT: Cost of isolating all blocks =
+; DEFAULT-NEXT: %R{{[A-Z0-9]+}} static = {{.*}} with bundles
+; DEFAULT-NOT: Candidate limit reached
+; DEFAULT-NOT: over budget
+
+; CANDIDATES: Cost of isolating all blocks =
+; CANDIDATES-NEXT: Candidate limit reached for huge live range
+; CANDIDATES-NEXT: Inline spilling
+; CANDIDATES: Cost of isolating all blocks =
+; CANDIDATES-NEXT: Candidate limit reached for huge live range
+; CANDIDATES-NEXT: enterIntvBefore
+
+; BUDGET: Compact region bundles, over budget, none.
+; BUDGET-NEXT: Cost of isolating all blocks =
+; BUDGET-NEXT: %R{{[A-Z0-9]+}} static = {{.*}}, over budget, giving up.
+; BUDGET-NOT: with bundles
+; BUDGET: regalloc - Number of split regions abandoned for compile time
+
+define i64 @f(i64 %a, i64 %b, i64 %n, i64* %p) {
+entry:
+  br label %loop
+
+loop:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %latch ]
+  %acc = phi i64 [ 0, %entry ], [ %acc.next, %latch ]
+  %c = icmp slt i64 %i, %b
+  br i1 %c, label %clobber, label %use
+
+clobber:
+  call void asm sideeffect "", "~{rax},~{rbx},~{rcx},~{rdx},~{rsi},~{rdi},~{rbp},~{r8},~{r9},~{r10},~{r11},~{r12},~{r13},~{r14},~{r15},~{dirflag},~{fpsr},~{flags}"()
+  br label %latch
+
+use:
+  %x0 = add i64 %acc, %a
+  %x = mul i64 %x0, %a
+  br label %latch
+
+latch:
+  %acc.next = phi i64 [ %acc, %clobber ], [ %x, %use ]
+  %i.next = add i64 %i, 1
+  %q = getelementptr i64, i64* %p, i64 %i
+  store i64 %acc.next, i64* %q
+  %d = icmp ne i64 %i.next, %n
+  br i1 %d, label %loop, label %exit
+
+exit:
+  %r = add i64 %acc.next, %a
+  ret i64 %r
+}
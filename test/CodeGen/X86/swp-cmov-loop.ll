@@ -0,0 +1,45 @@
+; RUN: llc -mtriple=x86_64-linux-gnu -mcpu=skylake -O2 \
+; RUN:     -x86-enable-pipeliner -pipeliner-check-reorder-window=false \
+; RUN:     -x86-cmov-converter=false -verify-machineinstrs < %s | FileCheck %s
+; RUN: llc -mtriple=x86_64-linux-gnu -mcpu=skylake -O2 \
+; RUN:     -x86-enable-pipeliner -pipeliner-check-reorder-window=false \
+; RUN:     -x86-cmov-converter=false -stats -o /dev/null < %s 2>&1 \
+; RUN:     | FileCheck %s --check-prefix=STATS
+; REQUIRES: asserts
+
+; The cmov reads the flags set by the compare in front of it.  Almost every
+; X86 instruction also defines the flags, so no instruction of another
+; iteration may be placed between the two.  The loop is left alone rather
+; than pipelined with a clobbered compare.
+
+; STATS: 1 pipeliner - Number of loops that we attempt to pipeline
+; STATS-NOT: Number of loops software pipelined
+
+; CHECK-LABEL: clamp:
+; CHECK:     [[LOOP:.LBB[0-9_]+]]:
+; CHECK:       movl (%rsi,[[I:%r[0-9a-z]+]],4), [[X:%[a-z0-9]+]]
+; CHECK-NEXT:  cmpl %edx, [[X]]
+; CHECK-NEXT:  cmovll %edx, [[X]]
+; CHECK-NEXT:  movl [[X]], (%rdi,[[I]],4)
+; CHECK:       jl [[LOOP]]
+
+define void @clamp(i32* noalias nocapture %y, i32* noalias nocapture readonly %x, i32 %a, i64 %n) {
+entry:
+  %cmp10 = icmp sgt i64 %n, 0
+  br i1 %cmp10, label %for.body, label %for.end
+
+for.body:
+  %i = phi i64 [ %i.next, %for.body ], [ 0, %entry ]
+  %px = getelementptr inbounds i32, i32* %x, i64 %i
+  %vx = load i32, i32* %px, align 4
+  %c = icmp sgt i32 %vx, %a
+  %s = select i1 %c, i32 %vx, i32 %a
+  %py = getelementptr inbounds i32, i32* %y, i64 %i
+  store i32 %s, i32* %py, align 4
+  %i.next = add nuw nsw i64 %i, 1
+  %cmp = icmp slt i64 %i.next, %n
+  br i1 %cmp, label %for.body, label %for.end
+
+for.end:
+  ret void
+}
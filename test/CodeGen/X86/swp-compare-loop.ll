@@ -0,0 +1,54 @@
+; RUN: llc -mtriple=x86_64-linux-gnu -mcpu=skylake -O2 \
+; RUN:     -x86-enable-pipeliner -pipeliner-check-reorder-window=false \
+; RUN:     -verify-machineinstrs < %s | FileCheck %s
+; RUN: llc -mtriple=x86_64-linux-gnu -mcpu=skylake -O2 \
+; RUN:     -x86-enable-pipeliner -pipeliner-check-reorder-window=false \
+; RUN:     -stats -o /dev/null < %s 2>&1 | FileCheck %s --check-prefix=STATS
+; REQUIRES: asserts
+
+; The loop is controlled by a compare of the induction variable.  The prolog
+; starts the first iteration and repeats the compare to skip the kernel if it
+; is the only one.  The kernel stores the result of one iteration while it
+; computes the next, and the epilog stores the last one.
+
+; STATS: 1 pipeliner - Number of loops software pipelined
+
+; CHECK-LABEL: saxpy:
+; CHECK:       vmulss
+; CHECK-NEXT:  vaddss
+; CHECK:       cmpq %rdx, {{%r[0-9a-z]+}}
+; CHECK-NEXT:  jge [[EPILOG:.LBB[0-9_]+]]
+; CHECK:     [[KERNEL:.LBB[0-9_]+]]:
+; CHECK:       vmulss
+; CHECK:       vmovss %xmm1, (%rdi,{{%r[0-9a-z]+}},4)
+; CHECK-NEXT:  vaddss
+; CHECK:       cmpq %rdx, {{%r[0-9a-z]+}}
+; CHECK-NEXT:  jl [[KERNEL]]
+; CHECK-NEXT: [[EPILOG]]:
+; CHECK-NEXT:  vmovss %xmm1, (%rdi,{{%r[0-9a-z]+}},4)
+; CHECK-NEXT: .LBB
+
+define void @saxpy(float* noalias nocapture %y, float* noalias nocapture readonly %x, float %a, i64 %n) {
+entry:
+  %cmp10 = icmp sgt i64 %n, 0
+  br i1 %cmp10, label %for.body.preheader, label %for.end
+
+for.body.preheader:
+  br label %for.body
+
+for.body:
+  %i = phi i64 [ %i.next, %for.body ], [ 0, %for.body.preheader ]
+  %px = getelementptr inbounds float, float* %x, i64 %i
+  %vx = load float, float* %px, align 4
+  %mul = fmul float %vx, %a
+  %py = getelementptr inbounds float, float* %y, i64 %i
+  %vy = load float, float* %py, align 4
+  %add = fadd float %mul, %vy
+  store float %add, float* %py, align 4
+  %i.next = add nuw nsw i64 %i, 1
+  %cmp = icmp slt i64 %i.next, %n
+  br i1 %cmp, label %for.body, label %for.end
+
+for.end:
+  ret void
+}
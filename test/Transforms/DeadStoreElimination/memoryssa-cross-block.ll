@@ -0,0 +1,138 @@
+; RUN: opt < %s -basicaa -dse -enable-dse-memoryssa -S | FileCheck %s
+; RUN: opt < %s -aa-pipeline=basic-aa -passes=dse -enable-dse-memoryssa -S | FileCheck %s
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+
+declare void @use(i32)
+
+; The store in the entry block is overwritten after the diamond on both paths.
+define void @diamond(i32* noalias %P, i1 %c) {
+; CHECK-LABEL: @diamond(
+; CHECK-NEXT: entry:
+; CHECK-NEXT: br i1 %c
+entry:
+  store i32 1, i32* %P
+  br i1 %c, label %bb1, label %bb2
+bb1:
+  br label %bb3
+bb2:
+  br label %bb3
+bb3:
+; CHECK: bb3:
+; CHECK-NEXT: store i32 0, i32* %P
+  store i32 0, i32* %P
+  ret void
+}
+
+; The store is read on one path, so it must stay.
+define void @diamond_read(i32* noalias %P, i1 %c) {
+; CHECK-LABEL: @diamond_read(
+; CHECK-NEXT: entry:
+; CHECK-NEXT: store i32 1, i32* %P
+entry:
+  store i32 1, i32* %P
+  br i1 %c, label %bb1, label %bb2
+bb1:
+  %v = load i32, i32* %P
+  call void @use(i32 %v) nounwind readnone
+  br label %bb3
+bb2:
+  br label %bb3
+bb3:
+  store i32 0, i32* %P
+  ret void
+}
+
+; The store is only overwritten on one path, so it must stay.
+define void @one_path(i32* noalias %P, i1 %c) {
+; CHECK-LABEL: @one_path(
+; CHECK-NEXT: entry:
+; CHECK-NEXT: store i32 1, i32* %P
+entry:
+  store i32 1, i32* %P
+  br i1 %c, label %bb1, label %bb2
+bb1:
+  store i32 0, i32* %P
+  br label %bb2
+bb2:
+  ret void
+}
+
+; The store to a loop-invariant location inside the loop is overwritten after
+; the loop.
+define void @loop_invariant(i32* noalias %P, i32 %n) {
+; CHECK-LABEL: @loop_invariant(
+; CHECK: loop:
+; CHECK-NEXT: %i = phi
+; CHECK-NEXT: %i.next = add
+entry:
+  br label %loop
+loop:
+  %i = phi i32 [ 0, %entry ], [ %i.next, %loop ]
+  store i32 %i, i32* %P
+  %i.next = add i32 %i, 1
+  %cmp = icmp slt i32 %i.next, %n
+  br i1 %cmp, label %loop, label %exit
+exit:
+; CHECK: exit:
+; CHECK-NEXT: store i32 0, i32* %P
+  store i32 0, i32* %P
+  ret void
+}
+
+; A store through a pointer that changes every iteration is not killed by a
+; store through the last value of that pointer.
+define void @loop_variant(i32* noalias %P, i64 %n) {
+; CHECK-LABEL: @loop_variant(
+; CHECK: loop:
+; CHECK: store i32 1, i32* %gep
+entry:
+  br label %loop
+loop:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %loop ]
+  %gep = getelementptr inbounds i32, i32* %P, i64 %i
+  store i32 1, i32* %gep
+  %i.next = add i64 %i, 1
+  %cmp = icmp slt i64 %i.next, %n
+  br i1 %cmp, label %loop, label %exit
+exit:
+  store i32 0, i32* %gep
+  ret void
+}
+
+; Two partial overwrites in later blocks together cover the earlier store.
+define void @partial(i32* noalias %P, i1 %c) {
+; CHECK-LABEL: @partial(
+; CHECK-NEXT: entry:
+; CHECK-NEXT: %P16 = bitcast
+; CHECK-NEXT: br i1 %c
+entry:
+  store i32 1, i32* %P
+  %P16 = bitcast i32* %P to i16*
+  br i1 %c, label %bb1, label %bb2
+bb1:
+  br label %bb2
+bb2:
+  store i16 2, i16* %P16
+  %P16.1 = getelementptr inbounds i16, i16* %P16, i64 1
+  br label %bb3
+bb3:
+  store i16 3, i16* %P16.1
+  ret void
+}
+
+; A call that may throw between the stores keeps a store to an escaping
+; location alive.
+declare void @may_throw()
+
+define void @throw_between(i32* %P) {
+; CHECK-LABEL: @throw_between(
+; CHECK-NEXT: entry:
+; CHECK-NEXT: store i32 1, i32* %P
+entry:
+  store i32 1, i32* %P
+  call void @may_throw() readnone
+  br label %bb1
+bb1:
+  store i32 0, i32* %P
+  ret void
+}
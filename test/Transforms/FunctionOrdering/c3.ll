@@ -0,0 +1,72 @@
+; RUN: opt -function-ordering -function-order-file=%t.order -S < %s \
+; RUN:     | FileCheck %s
+; RUN: FileCheck %s --check-prefix=ORDER < %t.order
+; RUN: opt -passes=function-ordering -S < %s | FileCheck %s
+
+; @hot2 is always called from @hot1, which is always called from @main, so
+; the three form one cluster in call order. @rare is called from @main too
+; rarely to be pulled into its cluster, and is laid out after the denser
+; @unrelated. Functions without a profile come last.
+
+target triple = "x86_64-pc-linux-gnu"
+
+declare void @work()
+
+; CHECK: declare void @work()
+; CHECK: define void @main()
+; CHECK: define void @hot1()
+; CHECK: define void @hot2()
+; CHECK: define void @unrelated()
+; CHECK: define void @rare()
+; CHECK: define void @noprof()
+
+; ORDER:      main
+; ORDER-NEXT: hot1
+; ORDER-NEXT: hot2
+; ORDER-NEXT: unrelated
+; ORDER-NEXT: rare
+; ORDER-NOT:  noprof
+
+define void @noprof() {
+  call void @main()
+  ret void
+}
+
+define void @rare() !prof !15 {
+  call void @work()
+  ret void
+}
+
+define void @hot2() !prof !16 {
+  ret void
+}
+
+define void @unrelated() !prof !17 {
+  ret void
+}
+
+define void @main() !prof !16 {
+entry:
+  call void @hot1()
+  %c = call i1 @cond()
+  br i1 %c, label %slow, label %exit, !prof !18
+
+slow:
+  call void @rare()
+  br label %exit
+
+exit:
+  ret void
+}
+
+define void @hot1() !prof !16 {
+  call void @hot2()
+  ret void
+}
+
+declare i1 @cond()
+
+!15 = !{!"function_entry_count", i64 20}
+!16 = !{!"function_entry_count", i64 1000}
+!17 = !{!"function_entry_count", i64 50}
+!18 = !{!"branch_weights", i32 1, i32 999}
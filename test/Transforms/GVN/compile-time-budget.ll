@@ -0,0 +1,46 @@
+; RUN: opt < %s -gvn -S | FileCheck %s --check-prefix=FULL
+; RUN: opt < %s -gvn -function-compile-time-budget=0.000000001 -S | FileCheck %s --check-prefix=DEGRADED
+; RUN: opt < %s -gvn -pass-compile-time-limit=0.000000001 -S | FileCheck %s --check-prefix=DEGRADED
+; RUN: opt < %s -gvn -function-compile-time-budget=0.000000001 \
+; RUN:   -pass-remarks-analysis=gvn -disable-output 2>&1 | FileCheck %s --check-prefix=REMARK
+
+; Once a function is out of compile time, GVN still removes full redundancies
+; but skips PRE.
+
+; REMARK: remark: {{.*}}compile-time budget exceeded after {{[0-9.]+}}s; running in a degraded mode
+
+@H = common global i32 0
+@G = common global i32 0
+
+declare i32 @foo()
+
+define i32 @test(i32 %x) {
+; FULL-LABEL: @test(
+; FULL: %add2.pre-phi = phi i32
+; FULL-NEXT: %r1 = add i32 %x, 7
+; FULL-NOT: add i32 %x, 7
+;
+; DEGRADED-LABEL: @test(
+; DEGRADED-NOT: %.pre
+; DEGRADED: bb1:
+; DEGRADED-NEXT: %add2 = add i32 %x, 42
+; DEGRADED-NEXT: %r1 = add i32 %x, 7
+; DEGRADED-NOT: add i32 %x, 7
+entry:
+  %c = call i32 @foo()
+  %cmp = icmp ne i32 %c, 0
+  br i1 %cmp, label %bb, label %bb1
+
+bb:
+  %add1 = add i32 %x, 42
+  store i32 %add1, i32* @G
+  br label %bb1
+
+bb1:
+  %add2 = add i32 %x, 42
+  %r1 = add i32 %x, 7
+  %r2 = add i32 %x, 7
+  store i32 %add2, i32* @H
+  %sum = add i32 %r1, %r2
+  ret i32 %sum
+}
@@ -0,0 +1,48 @@
+; RUN: opt -hotcoldsplit -hotcoldsplit-static=false -S < %s | FileCheck %s
+
+; With a profile, a block that is never executed is outlined even though
+; nothing in it is cold on its own.
+
+target triple = "x86_64-pc-linux-gnu"
+
+declare void @work(i32)
+
+define void @rare(i32 %x) !prof !15 {
+; CHECK-LABEL: define void @rare(
+; CHECK:       codeRepl:
+; CHECK-NEXT:    call void @rare.cold.1(i32 %x)
+; CHECK-NEXT:    br label %exit
+entry:
+  %cmp = icmp slt i32 %x, 0
+  br i1 %cmp, label %unlikely, label %exit, !prof !16
+
+unlikely:
+  call void @work(i32 %x)
+  call void @work(i32 0)
+  br label %exit
+
+exit:
+  call void @work(i32 1)
+  ret void
+}
+
+; CHECK-LABEL: define internal void @rare.cold.1(i32 %x)
+; CHECK-SAME:  !section_prefix
+
+!llvm.module.flags = !{!1}
+!1 = !{i32 1, !"ProfileSummary", !2}
+!2 = !{!3, !4, !5, !6, !7, !8, !9, !10}
+!3 = !{!"ProfileFormat", !"InstrProf"}
+!4 = !{!"TotalCount", i64 10000}
+!5 = !{!"MaxCount", i64 1000}
+!6 = !{!"MaxInternalCount", i64 1}
+!7 = !{!"MaxFunctionCount", i64 1000}
+!8 = !{!"NumCounts", i64 3}
+!9 = !{!"NumFunctions", i64 3}
+!10 = !{!"DetailedSummary", !11}
+!11 = !{!12, !13, !14}
+!12 = !{i32 10000, i64 100, i32 1}
+!13 = !{i32 999000, i64 100, i32 1}
+!14 = !{i32 999999, i64 1, i32 2}
+!15 = !{!"function_entry_count", i64 1000}
+!16 = !{!"branch_weights", i32 0, i32 1000}
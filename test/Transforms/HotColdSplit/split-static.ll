@@ -0,0 +1,118 @@
+; RUN: opt -hotcoldsplit -S < %s | FileCheck %s
+; RUN: opt -passes=hotcoldsplit -S < %s | FileCheck %s
+; RUN: opt -hotcoldsplit -hotcoldsplit-threshold=100 -S < %s \
+; RUN:     | FileCheck %s --check-prefix=NOSPLIT
+
+; Without a profile, blocks that end in unreachable or call cold functions,
+; and the blocks that only lead to them, are outlined.
+
+target triple = "x86_64-pc-linux-gnu"
+
+declare void @abort() noreturn nounwind
+declare void @report(i32) cold nounwind
+declare void @log(i32) nounwind
+declare void @work(i32)
+declare i32 @setjmp(i8*) returns_twice
+
+; The error path never returns, so neither does the call to it.
+define void @error_path(i32 %x) {
+; CHECK-LABEL: define void @error_path(
+; CHECK:       codeRepl:
+; CHECK-NEXT:    call void @error_path.cold.1(i32 %x) [[NORETURN:#[0-9]+]]
+; CHECK-NEXT:    unreachable
+; CHECK:       ok:
+; CHECK-NEXT:    call void @work(i32 %x)
+; NOSPLIT-LABEL: define void @error_path(
+; NOSPLIT-NOT:   cold.1
+entry:
+  %cmp = icmp slt i32 %x, 0
+  br i1 %cmp, label %fail, label %ok
+
+fail:
+  call void @log(i32 %x)
+  call void @log(i32 0)
+  br label %die
+
+die:
+  call void @abort()
+  unreachable
+
+ok:
+  call void @work(i32 %x)
+  ret void
+}
+
+; A slow path that rejoins the hot code is outlined into a function that
+; returns to it.
+define i32 @cold_call(i32 %x) {
+; CHECK-LABEL: define i32 @cold_call(
+; CHECK:       codeRepl:
+; CHECK-NEXT:    call void @cold_call.cold.1(i32 %x)
+; CHECK-NEXT:    br label %join
+entry:
+  %cmp = icmp eq i32 %x, 0
+  br i1 %cmp, label %slow, label %join
+
+slow:
+  call void @report(i32 %x)
+  call void @report(i32 1)
+  br label %join
+
+join:
+  %r = phi i32 [ 1, %slow ], [ %x, %entry ]
+  ret i32 %r
+}
+
+; A cold block that calls setjmp must stay where it is.
+define void @returns_twice(i8* %buf, i32 %x) {
+; CHECK-LABEL: define void @returns_twice(
+; CHECK-NOT:   cold.1
+; CHECK:       ret void
+entry:
+  %cmp = icmp slt i32 %x, 0
+  br i1 %cmp, label %fail, label %ok
+
+fail:
+  %r = call i32 @setjmp(i8* %buf)
+  call void @log(i32 %r)
+  call void @abort()
+  unreachable
+
+ok:
+  ret void
+}
+
+; Cold functions are left alone.
+define void @already_cold(i32 %x) cold {
+; CHECK-LABEL: define void @already_cold(
+; CHECK-NOT:   cold.1
+; CHECK:       ret void
+entry:
+  %cmp = icmp slt i32 %x, 0
+  br i1 %cmp, label %fail, label %ok
+
+fail:
+  call void @log(i32 %x)
+  call void @abort()
+  unreachable
+
+ok:
+  ret void
+}
+
+; CHECK-LABEL: define internal void @error_path.cold.1(i32 %x)
+; CHECK-SAME:  [[COLD:#[0-9]+]] !section_prefix [[UNLIKELY:![0-9]+]]
+; CHECK:         call void @log(i32 %x)
+; CHECK:         call void @abort()
+; CHECK-NEXT:    unreachable
+
+; CHECK-LABEL: define internal void @cold_call.cold.1(i32 %x)
+; CHECK-SAME:  [[COLD_RET:#[0-9]+]] !section_prefix [[UNLIKELY]]
+; CHECK:         ret void
+; CHECK:         call void @report(i32 %x)
+; CHECK-NEXT:    call void @report(i32 1)
+
+; CHECK-DAG: attributes [[COLD]] = { cold minsize noinline noreturn }
+; CHECK-DAG: attributes [[COLD_RET]] = { cold minsize noinline }
+; CHECK-DAG: attributes [[NORETURN]] = { noreturn }
+; CHECK: [[UNLIKELY]] = !{!"function_section_prefix", !".unlikely"}
@@ -0,0 +1,84 @@
+; RUN: opt -hot-leaf-cc -S < %s | FileCheck %s
+
+target triple = "x86_64-unknown-linux-gnu"
+
+@fp = global i32 (i32)* null
+
+; CHECK-LABEL: define internal preserve_mostcc i32 @hot_leaf(
+define internal i32 @hot_leaf(i32 %x) !prof !15 {
+  %y = mul i32 %x, 7
+  %z = add i32 %y, 3
+  ret i32 %z
+}
+
+; CHECK-LABEL: define internal i32 @cold_leaf(
+define internal i32 @cold_leaf(i32 %x) !prof !16 {
+  %y = add i32 %x, 1
+  ret i32 %y
+}
+
+; CHECK-LABEL: define internal void @hot_memcpy(
+define internal void @hot_memcpy(i8* %d, i8* %s) !prof !15 {
+  call void @llvm.memcpy.p0i8.p0i8.i64(i8* %d, i8* %s, i64 64, i32 1, i1 false)
+  ret void
+}
+
+; CHECK-LABEL: define i32 @hot_external(
+define i32 @hot_external(i32 %x) !prof !15 {
+  %y = add i32 %x, 2
+  ret i32 %y
+}
+
+; CHECK-LABEL: define internal i32 @hot_address_taken(
+define internal i32 @hot_address_taken(i32 %x) !prof !15 {
+  %y = add i32 %x, 4
+  ret i32 %y
+}
+
+; Taking the address of one of its blocks does not take the function's.
+; CHECK-LABEL: define internal preserve_mostcc i8* @hot_block_address(
+define internal i8* @hot_block_address(i32 %x) !prof !15 {
+entry:
+  br label %bb
+
+bb:
+  ret i8* blockaddress(@hot_block_address, %bb)
+}
+
+; CHECK-LABEL: define i32 @caller(
+; CHECK: call preserve_mostcc i32 @hot_leaf(i32 %x)
+; CHECK: call i32 @cold_leaf(i32 %a)
+; CHECK: call void @hot_memcpy(
+; CHECK: call i32 @hot_external(i32 %b)
+; CHECK: call i32 @hot_address_taken(i32 %c)
+; CHECK: call preserve_mostcc i8* @hot_block_address(i32 %d)
+define i32 @caller(i32 %x, i8* %p, i8* %q) !prof !15 {
+  store i32 (i32)* @hot_address_taken, i32 (i32)** @fp
+  %a = call i32 @hot_leaf(i32 %x)
+  %b = call i32 @cold_leaf(i32 %a)
+  call void @hot_memcpy(i8* %p, i8* %q)
+  %c = call i32 @hot_external(i32 %b)
+  %d = call i32 @hot_address_taken(i32 %c)
+  %e = call i8* @hot_block_address(i32 %d)
+  ret i32 %d
+}
+
+declare void @llvm.memcpy.p0i8.p0i8.i64(i8*, i8*, i64, i32, i1)
+
+!llvm.module.flags = !{!1}
+!1 = !{i32 1, !"ProfileSummary", !2}
+!2 = !{!3, !4, !5, !6, !7, !8, !9, !10}
+!3 = !{!"ProfileFormat", !"InstrProf"}
+!4 = !{!"TotalCount", i64 10000}
+!5 = !{!"MaxCount", i64 1000}
+!6 = !{!"MaxInternalCount", i64 1}
+!7 = !{!"MaxFunctionCount", i64 1000}
+!8 = !{!"NumCounts", i64 3}
+!9 = !{!"NumFunctions", i64 3}
+!10 = !{!"DetailedSummary", !11}
+!11 = !{!12, !13, !14}
+!12 = !{i32 10000, i64 100, i32 1}
+!13 = !{i32 999000, i64 100, i32 1}
+!14 = !{i32 999999, i64 1, i32 2}
+!15 = !{!"function_entry_count", i64 1000}
+!16 = !{!"function_entry_count", i64 1}
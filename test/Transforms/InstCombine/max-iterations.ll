@@ -0,0 +1,36 @@
+; RUN: opt < %s -instcombine -S | FileCheck %s
+; RUN: opt < %s -instcombine -instcombine-incremental=false -S | FileCheck %s
+; RUN: opt < %s -instcombine -instcombine-max-iterations=0 -S | FileCheck %s --check-prefix=NOITER
+
+; Each combine enables the next one through the operand chain.
+define i32 @chain(i32 %x) {
+; CHECK-LABEL: @chain(
+; CHECK-NEXT: ret i32 %x
+;
+; NOITER-LABEL: @chain(
+; NOITER-NEXT: %a = xor i32 %x, -1
+; NOITER-NEXT: %b = xor i32 %a, -1
+; NOITER-NEXT: %c = add i32 %b, 0
+; NOITER-NEXT: ret i32 %c
+  %a = xor i32 %x, -1
+  %b = xor i32 %a, -1
+  %c = add i32 %b, 0
+  ret i32 %c
+}
+
+; Once the branch condition folds to a constant, the next iteration has to
+; sweep the whole function again to empty the block that became unreachable.
+define i32 @branch(i32 %x) {
+; CHECK-LABEL: @branch(
+; CHECK: dead:
+; CHECK-NEXT: ret i32 undef
+  %a = xor i32 %x, -1
+  %b = xor i32 %a, -1
+  %c = icmp ne i32 %b, %x
+  br i1 %c, label %dead, label %live
+dead:
+  %d = mul i32 %x, 3
+  ret i32 %d
+live:
+  ret i32 %x
+}
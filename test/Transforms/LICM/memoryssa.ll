@@ -0,0 +1,101 @@
+; RUN: opt < %s -basicaa -licm -enable-mssa-loop-dependency -S | FileCheck %s
+; RUN: opt < %s -basicaa -licm -enable-mssa-loop-dependency -licm-mssa-max-acc-promotion=0 -S | FileCheck %s --check-prefix=NOPROMO
+
+@G = global i32 0
+
+declare i32 @readonly_fn(i32*) readonly nounwind
+
+; The load is clobbered only outside of the loop, so it is hoisted even though
+; the loop stores to a different object.
+define void @hoist_load(i32* noalias %P, i32* noalias %Q, i32 %n) {
+; CHECK-LABEL: @hoist_load(
+; CHECK: entry:
+; CHECK-NEXT: %v = load i32, i32* %P
+; CHECK-NEXT: br label %loop
+entry:
+  br label %loop
+
+loop:
+  %i = phi i32 [ 0, %entry ], [ %i.next, %loop ]
+  %v = load i32, i32* %P
+  %gep = getelementptr inbounds i32, i32* %Q, i32 %i
+  store i32 %v, i32* %gep
+  %i.next = add i32 %i, 1
+  %cmp = icmp slt i32 %i.next, %n
+  br i1 %cmp, label %loop, label %exit
+
+exit:
+  ret void
+}
+
+; A store in the loop may alias the load, so it must stay.
+define void @no_hoist_clobbered(i32* %P, i32* %Q, i32 %n) {
+; CHECK-LABEL: @no_hoist_clobbered(
+; CHECK: loop:
+; CHECK: %v = load i32, i32* %P
+entry:
+  br label %loop
+
+loop:
+  %i = phi i32 [ 0, %entry ], [ %i.next, %loop ]
+  %v = load i32, i32* %P
+  %gep = getelementptr inbounds i32, i32* %Q, i32 %i
+  store i32 %v, i32* %gep
+  %i.next = add i32 %i, 1
+  %cmp = icmp slt i32 %i.next, %n
+  br i1 %cmp, label %loop, label %exit
+
+exit:
+  ret void
+}
+
+; A readonly call whose memory is not written in the loop is hoisted.
+define i32 @hoist_call(i32* noalias %P, i32* noalias %Q, i32 %n) {
+; CHECK-LABEL: @hoist_call(
+; CHECK: entry:
+; CHECK-NEXT: %c = call i32 @readonly_fn(i32* %P)
+; CHECK-NEXT: br label %loop
+entry:
+  br label %loop
+
+loop:
+  %i = phi i32 [ 0, %entry ], [ %i.next, %loop ]
+  %c = call i32 @readonly_fn(i32* %P)
+  store i32 %c, i32* %Q
+  %i.next = add i32 %i, 1
+  %cmp = icmp slt i32 %i.next, %n
+  br i1 %cmp, label %loop, label %exit
+
+exit:
+  ret i32 %c
+}
+
+; Scalar promotion still works when the alias sets are built from MemorySSA's
+; loop, and is skipped when the loop has too many accesses.
+define void @promote(i32 %n) {
+; CHECK-LABEL: @promote(
+; CHECK: entry:
+; CHECK-NEXT: %G.promoted = load i32, i32* @G
+; CHECK: exit:
+; CHECK-NEXT: %[[LCSSA:.*]] = phi i32 [ %x2
+; CHECK-NEXT: store i32 %[[LCSSA]], i32* @G
+;
+; NOPROMO-LABEL: @promote(
+; NOPROMO: loop:
+; NOPROMO: %x = load i32, i32* @G
+; NOPROMO: store i32 %x2, i32* @G
+entry:
+  br label %loop
+
+loop:
+  %i = phi i32 [ 0, %entry ], [ %i.next, %loop ]
+  %x = load i32, i32* @G
+  %x2 = add i32 %x, 1
+  store i32 %x2, i32* @G
+  %i.next = add i32 %i, 1
+  %cmp = icmp slt i32 %i.next, %n
+  br i1 %cmp, label %loop, label %exit
+
+exit:
+  ret void
+}
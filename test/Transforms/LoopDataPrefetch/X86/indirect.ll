@@ -0,0 +1,139 @@
+; RUN: opt -mcpu=haswell -loop-data-prefetch -loop-prefetch-writes -S < %s | FileCheck %s
+; RUN: opt -mcpu=haswell -passes=loop-data-prefetch -loop-prefetch-writes -S < %s | FileCheck %s
+; RUN: opt -mcpu=haswell -loop-data-prefetch -loop-prefetch-indirect=false -S < %s | FileCheck %s --check-prefix=NOIND
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+; The index B[i + d] is loaded ahead of time, clamped to the last iteration,
+; to prefetch A[B[i + d]].  B itself is left to the hardware prefetcher.
+define i32 @gather(i32* nocapture readonly %A, i32* nocapture readonly %B, i64 %n) {
+; CHECK-LABEL: @gather(
+; CHECK: for.body:
+; CHECK: select
+; CHECK: %idx = load i32, i32* %arrayidx
+; CHECK: %idx.pref = load i32, i32*
+; CHECK-NEXT: %idx.ext.pref = sext i32 %idx.pref to i64
+; CHECK-NEXT: %arrayidx2.pref = getelementptr i32, i32* %A, i64 %idx.ext.pref
+; CHECK-NEXT: [[PTR:%.*]] = bitcast i32* %arrayidx2.pref to i8*
+; CHECK-NEXT: call void @llvm.prefetch(i8* [[PTR]], i32 0, i32 3, i32 1)
+; CHECK-NEXT: %val = load i32, i32* %arrayidx2
+; CHECK-NOT: call void @llvm.prefetch
+; CHECK: for.end:
+;
+; NOIND-LABEL: @gather(
+; NOIND-NOT: call void @llvm.prefetch
+; NOIND: ret i32
+entry:
+  br label %for.body
+
+for.body:
+  %iv = phi i64 [ 0, %entry ], [ %iv.next, %for.body ]
+  %sum = phi i32 [ 0, %entry ], [ %add, %for.body ]
+  %arrayidx = getelementptr inbounds i32, i32* %B, i64 %iv
+  %idx = load i32, i32* %arrayidx, align 4
+  %idx.ext = sext i32 %idx to i64
+  %arrayidx2 = getelementptr inbounds i32, i32* %A, i64 %idx.ext
+  %val = load i32, i32* %arrayidx2, align 4
+  %add = add nsw i32 %val, %sum
+  %iv.next = add nuw nsw i64 %iv, 1
+  %exitcond = icmp eq i64 %iv.next, %n
+  br i1 %exitcond, label %for.end, label %for.body
+
+for.end:
+  ret i32 %add
+}
+
+; Loading the index ahead is not safe if the loop may leave early: B may end
+; at the element that makes it exit.
+define i32 @early_exit(i32* nocapture readonly %A, i32* nocapture readonly %B, i64 %n) {
+; CHECK-LABEL: @early_exit(
+; CHECK-NOT: call void @llvm.prefetch
+; CHECK: ret i32
+entry:
+  br label %for.body
+
+for.body:
+  %iv = phi i64 [ 0, %entry ], [ %iv.next, %for.inc ]
+  %sum = phi i32 [ 0, %entry ], [ %add, %for.inc ]
+  %arrayidx = getelementptr inbounds i32, i32* %B, i64 %iv
+  %idx = load i32, i32* %arrayidx, align 4
+  %done = icmp slt i32 %idx, 0
+  br i1 %done, label %for.end, label %for.inc
+
+for.inc:
+  %idx.ext = sext i32 %idx to i64
+  %arrayidx2 = getelementptr inbounds i32, i32* %A, i64 %idx.ext
+  %val = load i32, i32* %arrayidx2, align 4
+  %add = add nsw i32 %val, %sum
+  %iv.next = add nuw nsw i64 %iv, 1
+  %exitcond = icmp eq i64 %iv.next, %n
+  br i1 %exitcond, label %for.end, label %for.body
+
+for.end:
+  %r = phi i32 [ %sum, %for.body ], [ %add, %for.inc ]
+  ret i32 %r
+}
+
+; Nor if the index is only loaded on some iterations.
+define i32 @conditional(i32* nocapture readonly %A, i32* nocapture readonly %B, i8* nocapture readonly %M, i64 %n) {
+; CHECK-LABEL: @conditional(
+; CHECK-NOT: call void @llvm.prefetch
+; CHECK: ret i32
+entry:
+  br label %for.body
+
+for.body:
+  %iv = phi i64 [ 0, %entry ], [ %iv.next, %for.inc ]
+  %sum = phi i32 [ 0, %entry ], [ %sum.next, %for.inc ]
+  %mp = getelementptr inbounds i8, i8* %M, i64 %iv
+  %m = load i8, i8* %mp, align 1
+  %set = icmp ne i8 %m, 0
+  br i1 %set, label %if.then, label %for.inc
+
+if.then:
+  %arrayidx = getelementptr inbounds i32, i32* %B, i64 %iv
+  %idx = load i32, i32* %arrayidx, align 4
+  %idx.ext = sext i32 %idx to i64
+  %arrayidx2 = getelementptr inbounds i32, i32* %A, i64 %idx.ext
+  %val = load i32, i32* %arrayidx2, align 4
+  %add = add nsw i32 %val, %sum
+  br label %for.inc
+
+for.inc:
+  %sum.next = phi i32 [ %sum, %for.body ], [ %add, %if.then ]
+  %iv.next = add nuw nsw i64 %iv, 1
+  %exitcond = icmp eq i64 %iv.next, %n
+  br i1 %exitcond, label %for.end, label %for.body
+
+for.end:
+  ret i32 %sum.next
+}
+
+; Only strides the hardware prefetchers do not follow are prefetched.
+define void @strides(double* nocapture %a, double* nocapture readonly %b) {
+; CHECK-LABEL: @strides(
+; CHECK: for.body:
+; CHECK-NOT: call void @llvm.prefetch
+; CHECK: %x = load double, double* %small
+; CHECK-NEXT: %iv.large = mul nuw nsw i64 %iv, 512
+; CHECK-NEXT: %large = getelementptr inbounds double, double* %a, i64 %iv.large
+; CHECK-NEXT: call void @llvm.prefetch
+; CHECK-NEXT: store double %x, double* %large
+entry:
+  br label %for.body
+
+for.body:
+  %iv = phi i64 [ 0, %entry ], [ %iv.next, %for.body ]
+  %small = getelementptr inbounds double, double* %b, i64 %iv
+  %x = load double, double* %small, align 8
+  %iv.large = mul nuw nsw i64 %iv, 512
+  %large = getelementptr inbounds double, double* %a, i64 %iv.large
+  store double %x, double* %large, align 8
+  %iv.next = add nuw nsw i64 %iv, 1
+  %exitcond = icmp eq i64 %iv.next, 1600
+  br i1 %exitcond, label %for.end, label %for.body
+
+for.end:
+  ret void
+}
@@ -0,0 +1,118 @@
+; RUN: opt < %s -loop-vectorize -enable-early-exit-vectorize -force-vector-width=4 -S | FileCheck %s
+; RUN: opt < %s -loop-vectorize -force-vector-width=4 -S | FileCheck %s --check-prefix=OFF
+; RUN: opt < %s -loop-vectorize -enable-early-exit-vectorize -force-vector-width=4 \
+; RUN:   -pass-remarks=loop-vectorize -pass-remarks-analysis=loop-vectorize \
+; RUN:   -disable-output 2>&1 | FileCheck %s --check-prefix=REMARK
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+
+; REMARK: remark: <unknown>:0:0: vectorized loop with an early exit (vectorization width: 4)
+; REMARK: remark: <unknown>:0:0: loop not vectorized: cannot prove that loads past the early exit are dereferenceable
+; REMARK: remark: <unknown>:0:0: loop not vectorized: loop with an early exit writes to memory
+; REMARK-NOT: vectorized loop with an early exit
+
+@A = global [1024 x i32] zeroinitializer, align 4
+
+; Every load of @A up to the latch trip count is dereferenceable, so all the
+; lanes can compare their element and the original loop takes over in the
+; vector iteration that finds %v.
+define i64 @find(i32 %v) {
+; CHECK-LABEL: @find(
+; CHECK: entry:
+; CHECK: br i1 false, label %scalar.ph, label %vector.ph
+; CHECK: vector.ph:
+; CHECK: [[SPLAT:%.*]] = shufflevector <4 x i32> {{.*}}, <4 x i32> undef, <4 x i32> zeroinitializer
+; CHECK: vector.body:
+; CHECK-NEXT: %index = phi i64 [ 0, %vector.ph ], [ %index.next, %vector.latch ]
+; CHECK-NEXT: [[GEP:%.*]] = getelementptr inbounds [1024 x i32], [1024 x i32]* @A, i64 0, i64 %index
+; CHECK-NEXT: [[PTR:%.*]] = bitcast i32* [[GEP]] to <4 x i32>*
+; CHECK-NEXT: %wide.load = load <4 x i32>, <4 x i32>* [[PTR]], align 4
+; CHECK-NEXT: [[FOUND:%.*]] = icmp eq <4 x i32> %wide.load, [[SPLAT]]
+; CHECK-NEXT: [[MASK:%.*]] = bitcast <4 x i1> [[FOUND]] to i4
+; CHECK-NEXT: %any.exit = icmp ne i4 [[MASK]], 0
+; CHECK-NEXT: br i1 %any.exit, label %scalar.ph, label %vector.latch
+; CHECK: vector.latch:
+; CHECK-NEXT: %index.next = add i64 %index, 4
+; CHECK-NEXT: [[DONE:%.*]] = icmp eq i64 %index.next, 1020
+; CHECK-NEXT: br i1 [[DONE]], label %scalar.ph, label %vector.body
+; CHECK: scalar.ph:
+; CHECK-NEXT: %bc.resume.val = phi i64 [ %index, %vector.body ], [ %index.next, %vector.latch ], [ 0, %entry ]
+; CHECK-NEXT: br label %loop
+; CHECK: loop:
+; CHECK-NEXT: %i = phi i64 [ %bc.resume.val, %scalar.ph ], [ %i.next, %latch ]
+; CHECK: exit:
+; CHECK-NEXT: %r = phi i64 [ %i, %loop ], [ -1, %latch ]
+;
+; OFF-LABEL: @find(
+; OFF-NOT: vector.body
+; OFF: ret i64
+entry:
+  br label %loop
+
+loop:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %latch ]
+  %gep = getelementptr inbounds [1024 x i32], [1024 x i32]* @A, i64 0, i64 %i
+  %x = load i32, i32* %gep, align 4
+  %found = icmp eq i32 %x, %v
+  br i1 %found, label %exit, label %latch
+
+latch:
+  %i.next = add nuw nsw i64 %i, 1
+  %done = icmp eq i64 %i.next, 1024
+  br i1 %done, label %exit, label %loop
+
+exit:
+  %r = phi i64 [ %i, %loop ], [ -1, %latch ]
+  ret i64 %r
+}
+
+; Nothing is known about the memory past the element that matches, so the
+; loads of the later lanes might fault.
+define i64 @find_unknown(i32* %p, i32 %v) {
+; CHECK-LABEL: @find_unknown(
+; CHECK-NOT: vector.body
+; CHECK: ret i64
+entry:
+  br label %loop
+
+loop:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %latch ]
+  %gep = getelementptr inbounds i32, i32* %p, i64 %i
+  %x = load i32, i32* %gep, align 4
+  %found = icmp eq i32 %x, %v
+  br i1 %found, label %exit, label %latch
+
+latch:
+  %i.next = add nuw nsw i64 %i, 1
+  %done = icmp eq i64 %i.next, 1024
+  br i1 %done, label %exit, label %loop
+
+exit:
+  %r = phi i64 [ %i, %loop ], [ -1, %latch ]
+  ret i64 %r
+}
+
+; Stores past the early exit cannot be undone.
+define void @store_until(i32 %v) {
+; CHECK-LABEL: @store_until(
+; CHECK-NOT: vector.body
+; CHECK: ret void
+entry:
+  br label %loop
+
+loop:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %latch ]
+  %gep = getelementptr inbounds [1024 x i32], [1024 x i32]* @A, i64 0, i64 %i
+  %x = load i32, i32* %gep, align 4
+  %found = icmp eq i32 %x, %v
+  br i1 %found, label %exit, label %latch
+
+latch:
+  store i32 0, i32* %gep, align 4
+  %i.next = add nuw nsw i64 %i, 1
+  %done = icmp eq i64 %i.next, 1024
+  br i1 %done, label %exit, label %loop
+
+exit:
+  ret void
+}
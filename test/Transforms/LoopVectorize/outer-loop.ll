@@ -0,0 +1,219 @@
+; RUN: opt < %s -loop-vectorize -enable-outer-loop-vectorize -S | FileCheck %s
+; RUN: opt < %s -loop-vectorize -S | FileCheck %s --check-prefix=OFF
+; RUN: opt < %s -loop-vectorize -enable-outer-loop-vectorize \
+; RUN:   -pass-remarks=loop-vectorize -pass-remarks-analysis=loop-vectorize \
+; RUN:   -disable-output 2>&1 | FileCheck %s --check-prefix=REMARK
+
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+
+; OFF-NOT: vector.inner
+
+; REMARK: remark: <unknown>:0:0: vectorized outer loop (vectorization width: 4)
+; REMARK: remark: <unknown>:0:0: vectorized outer loop (vectorization width: 4)
+; REMARK: remark: <unknown>:0:0: loop not vectorized: inner loop trip count differs between outer iterations
+; REMARK-NOT: vectorized outer loop
+
+; for (i = 0; i < n; i++) {
+;   float s = 0;
+;   for (j = 0; j < m; j++)
+;     s += in[j * n + i];
+;   out[i] = s;
+; }
+;
+; Adjacent outer iterations read adjacent columns, so the inner loop loads and
+; the final store are consecutive across the lanes.
+define void @sum_columns(float* noalias %out, float* noalias %in, i64 %n, i64 %m) {
+; CHECK-LABEL: @sum_columns(
+; CHECK: entry:
+; CHECK: %min.iters.check = icmp ult i64 {{.*}}, 3
+; CHECK: br i1 {{.*}}, label %scalar.ph, label %vector.ph
+; CHECK: vector.body:
+; CHECK-NEXT: %index = phi i64 [ 0, %vector.ph ], [ %index.next, %vector.latch ]
+; CHECK-NEXT: br label %vector.inner
+; CHECK: vector.inner:
+; CHECK-NEXT: [[J:%.*]] = phi i64 [ 0, %vector.body ], [ [[JNEXT:%.*]], %vector.inner ]
+; CHECK-NEXT: [[ACC:%.*]] = phi <4 x float> [ zeroinitializer, %vector.body ], [ [[ACCNEXT:%.*]], %vector.inner ]
+; CHECK-NEXT: [[ROW:%.*]] = mul i64 [[J]], %n
+; CHECK-NEXT: [[IDX:%.*]] = add i64 [[ROW]], %index
+; CHECK-NEXT: [[GEP:%.*]] = getelementptr inbounds float, float* %in, i64 [[IDX]]
+; CHECK-NEXT: [[PTR:%.*]] = bitcast float* [[GEP]] to <4 x float>*
+; CHECK-NEXT: %wide.load = load <4 x float>, <4 x float>* [[PTR]], align 4
+; CHECK-NEXT: [[ACCNEXT]] = fadd <4 x float> [[ACC]], %wide.load
+; CHECK-NEXT: [[JNEXT]] = add nuw nsw i64 [[J]], 1
+; CHECK-NEXT: [[COND:%.*]] = icmp eq i64 [[JNEXT]], %m
+; CHECK-NEXT: br i1 [[COND]], label %vector.latch, label %vector.inner
+; CHECK: vector.latch:
+; CHECK-NEXT: [[OUTGEP:%.*]] = getelementptr inbounds float, float* %out, i64 %index
+; CHECK-NEXT: [[OUTPTR:%.*]] = bitcast float* [[OUTGEP]] to <4 x float>*
+; CHECK-NEXT: store <4 x float> [[ACCNEXT]], <4 x float>* [[OUTPTR]], align 4
+; CHECK-NEXT: %index.next = add i64 %index, 4
+; CHECK-NEXT: [[DONE:%.*]] = icmp eq i64 %index.next, %n.vec
+; CHECK-NEXT: br i1 [[DONE]], label %middle.block, label %vector.body
+; CHECK: middle.block:
+; CHECK: %cmp.n = icmp eq i64 %outer.trip.count, %n.vec
+; CHECK-NEXT: br i1 %cmp.n, label %exit, label %scalar.ph
+; CHECK: scalar.ph:
+; CHECK-NEXT: %bc.resume.val = phi i64 [ %n.vec, %middle.block ], [ 0, %entry ]
+; CHECK-NEXT: br label %outer
+; CHECK: outer:
+; CHECK-NEXT: %i = phi i64 [ %bc.resume.val, %scalar.ph ], [ %i.next, %outer.latch ]
+entry:
+  br label %outer
+
+outer:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %outer.latch ]
+  br label %inner
+
+inner:
+  %j = phi i64 [ 0, %outer ], [ %j.next, %inner ]
+  %acc = phi float [ 0.0, %outer ], [ %acc.next, %inner ]
+  %row = mul i64 %j, %n
+  %idx = add i64 %row, %i
+  %p = getelementptr inbounds float, float* %in, i64 %idx
+  %v = load float, float* %p, align 4
+  %acc.next = fadd float %acc, %v
+  %j.next = add nuw nsw i64 %j, 1
+  %inner.cond = icmp eq i64 %j.next, %m
+  br i1 %inner.cond, label %outer.latch, label %inner
+
+outer.latch:
+  %acc.lcssa = phi float [ %acc.next, %inner ]
+  %q = getelementptr inbounds float, float* %out, i64 %i
+  store float %acc.lcssa, float* %q, align 4
+  %i.next = add nuw nsw i64 %i, 1
+  %outer.cond = icmp eq i64 %i.next, %n
+  br i1 %outer.cond, label %exit, label %outer, !llvm.loop !0
+
+exit:
+  ret void
+}
+
+; for (i = 0; i < n; i++) {
+;   float s = 0;
+;   for (j = 0; j < m; j++)
+;     s += in[i * m + j];
+;   out[i] = s;
+; }
+;
+; The lanes read from different rows, so without gather support the loads in
+; the inner loop are split into one load per lane.
+define void @sum_rows(float* noalias %out, float* noalias %in, i64 %n, i64 %m) {
+; CHECK-LABEL: @sum_rows(
+; CHECK: vector.inner:
+; CHECK: [[PTRS:%.*]] = getelementptr inbounds float, float* %in, <4 x i64>
+; CHECK: [[P0:%.*]] = extractelement <4 x float*> [[PTRS]], i32 0
+; CHECK: [[V0:%.*]] = load float, float* [[P0]], align 4
+; CHECK: insertelement <4 x float> undef, float [[V0]], i32 0
+; CHECK: [[P3:%.*]] = extractelement <4 x float*> [[PTRS]], i32 3
+; CHECK: [[V3:%.*]] = load float, float* [[P3]], align 4
+; CHECK: insertelement <4 x float> {{.*}}, float [[V3]], i32 3
+; CHECK: br i1 {{.*}}, label %vector.latch, label %vector.inner
+; CHECK: vector.latch:
+; CHECK: store <4 x float>
+entry:
+  br label %outer
+
+outer:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %outer.latch ]
+  %base = mul i64 %i, %m
+  br label %inner
+
+inner:
+  %j = phi i64 [ 0, %outer ], [ %j.next, %inner ]
+  %acc = phi float [ 0.0, %outer ], [ %acc.next, %inner ]
+  %idx = add i64 %base, %j
+  %p = getelementptr inbounds float, float* %in, i64 %idx
+  %v = load float, float* %p, align 4
+  %acc.next = fadd float %acc, %v
+  %j.next = add nuw nsw i64 %j, 1
+  %inner.cond = icmp eq i64 %j.next, %m
+  br i1 %inner.cond, label %outer.latch, label %inner
+
+outer.latch:
+  %acc.lcssa = phi float [ %acc.next, %inner ]
+  %q = getelementptr inbounds float, float* %out, i64 %i
+  store float %acc.lcssa, float* %q, align 4
+  %i.next = add nuw nsw i64 %i, 1
+  %outer.cond = icmp eq i64 %i.next, %n
+  br i1 %outer.cond, label %exit, label %outer, !llvm.loop !0
+
+exit:
+  ret void
+}
+
+; The inner loop runs i + 1 times, so its trip count differs between lanes.
+define void @triangular(float* noalias %out, float* noalias %in, i64 %n) {
+; CHECK-LABEL: @triangular(
+; CHECK-NOT: vector.inner
+; CHECK: ret void
+entry:
+  br label %outer
+
+outer:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %outer.latch ]
+  br label %inner
+
+inner:
+  %j = phi i64 [ 0, %outer ], [ %j.next, %inner ]
+  %acc = phi float [ 0.0, %outer ], [ %acc.next, %inner ]
+  %row = mul i64 %j, %n
+  %idx = add i64 %row, %i
+  %p = getelementptr inbounds float, float* %in, i64 %idx
+  %v = load float, float* %p, align 4
+  %acc.next = fadd float %acc, %v
+  %j.next = add nuw nsw i64 %j, 1
+  %inner.cond = icmp ugt i64 %j.next, %i
+  br i1 %inner.cond, label %outer.latch, label %inner
+
+outer.latch:
+  %acc.lcssa = phi float [ %acc.next, %inner ]
+  %q = getelementptr inbounds float, float* %out, i64 %i
+  store float %acc.lcssa, float* %q, align 4
+  %i.next = add nuw nsw i64 %i, 1
+  %outer.cond = icmp eq i64 %i.next, %n
+  br i1 %outer.cond, label %exit, label %outer, !llvm.loop !0
+
+exit:
+  ret void
+}
+
+; Without the pragma, dependences between outer iterations are not known to
+; be absent.
+define void @no_pragma(float* noalias %out, float* noalias %in, i64 %n, i64 %m) {
+; CHECK-LABEL: @no_pragma(
+; CHECK-NOT: vector.inner
+; CHECK: ret void
+entry:
+  br label %outer
+
+outer:
+  %i = phi i64 [ 0, %entry ], [ %i.next, %outer.latch ]
+  br label %inner
+
+inner:
+  %j = phi i64 [ 0, %outer ], [ %j.next, %inner ]
+  %acc = phi float [ 0.0, %outer ], [ %acc.next, %inner ]
+  %row = mul i64 %j, %n
+  %idx = add i64 %row, %i
+  %p = getelementptr inbounds float, float* %in, i64 %idx
+  %v = load float, float* %p, align 4
+  %acc.next = fadd float %acc, %v
+  %j.next = add nuw nsw i64 %j, 1
+  %inner.cond = icmp eq i64 %j.next, %m
+  br i1 %inner.cond, label %outer.latch, label %inner
+
+outer.latch:
+  %acc.lcssa = phi float [ %acc.next, %inner ]
+  %q = getelementptr inbounds float, float* %out, i64 %i
+  store float %acc.lcssa, float* %q, align 4
+  %i.next = add nuw nsw i64 %i, 1
+  %outer.cond = icmp eq i64 %i.next, %n
+  br i1 %outer.cond, label %exit, label %outer
+
+exit:
+  ret void
+}
+
+!0 = distinct !{!0, !1, !2}
+!1 = !{!"llvm.loop.vectorize.enable", i1 true}
+!2 = !{!"llvm.loop.vectorize.width", i32 4}
@@ -152,10 +152,11 @@ entry:
   ret void
 }
 
+; The opcodes need not alternate between even and odd lanes.
 ; CHECK-LABEL: @No_faddfsub
-; CHECK-NOT: fadd <4 x float>
-; CHECK-NOT: fsub <4 x float>
-; CHECK-NOT: shufflevector
+; CHECK: %2 = fadd <4 x float> %0, %1
+; CHECK: %3 = fsub <4 x float> %0, %1
+; CHECK: %4 = shufflevector <4 x float> %2, <4 x float> %3, <4 x i32> <i32 0, i32 1, i32 2, i32 7>
 ; Function Attrs: nounwind uwtable
 define void @No_faddfsub() #0 {
 entry:
@@ -0,0 +1,103 @@
+; RUN: opt < %s -mtriple=x86_64-unknown-linux -mcpu=corei7-avx -slp-vectorizer -slp-threshold=-100 -S | FileCheck %s
+
+; Bundles of binary operators with two opcodes in any lane order become two
+; vector operations blended by a shuffle.
+
+define void @fadd_fmul(float* noalias %r, float* noalias %a, float* noalias %b) {
+; CHECK-LABEL: @fadd_fmul(
+; CHECK: [[A:%.*]] = load <4 x float>
+; CHECK: [[B:%.*]] = load <4 x float>
+; CHECK: [[ADD:%.*]] = fadd <4 x float> [[A]], [[B]]
+; CHECK: [[MUL:%.*]] = fmul <4 x float> [[A]], [[B]]
+; CHECK: [[RES:%.*]] = shufflevector <4 x float> [[ADD]], <4 x float> [[MUL]], <4 x i32> <i32 0, i32 5, i32 6, i32 3>
+; CHECK: store <4 x float> [[RES]]
+  %a1p = getelementptr inbounds float, float* %a, i64 1
+  %a2p = getelementptr inbounds float, float* %a, i64 2
+  %a3p = getelementptr inbounds float, float* %a, i64 3
+  %b1p = getelementptr inbounds float, float* %b, i64 1
+  %b2p = getelementptr inbounds float, float* %b, i64 2
+  %b3p = getelementptr inbounds float, float* %b, i64 3
+  %r1p = getelementptr inbounds float, float* %r, i64 1
+  %r2p = getelementptr inbounds float, float* %r, i64 2
+  %r3p = getelementptr inbounds float, float* %r, i64 3
+  %a0 = load float, float* %a, align 4
+  %a1 = load float, float* %a1p, align 4
+  %a2 = load float, float* %a2p, align 4
+  %a3 = load float, float* %a3p, align 4
+  %b0 = load float, float* %b, align 4
+  %b1 = load float, float* %b1p, align 4
+  %b2 = load float, float* %b2p, align 4
+  %b3 = load float, float* %b3p, align 4
+  %r0 = fadd float %a0, %b0
+  %r1 = fmul float %a1, %b1
+  %r2 = fmul float %a2, %b2
+  %r3 = fadd float %a3, %b3
+  store float %r0, float* %r, align 4
+  store float %r1, float* %r1p, align 4
+  store float %r2, float* %r2p, align 4
+  store float %r3, float* %r3p, align 4
+  ret void
+}
+
+; Every lane divides, so the divisors must all be safe.
+define void @mul_udiv(i32* noalias %r, i32* noalias %a) {
+; CHECK-LABEL: @mul_udiv(
+; CHECK: [[A:%.*]] = load <4 x i32>
+; CHECK: [[MUL:%.*]] = mul <4 x i32> [[A]], <i32 3, i32 5, i32 7, i32 9>
+; CHECK: [[DIV:%.*]] = udiv <4 x i32> [[A]], <i32 3, i32 5, i32 7, i32 9>
+; CHECK: [[RES:%.*]] = shufflevector <4 x i32> [[MUL]], <4 x i32> [[DIV]], <4 x i32> <i32 0, i32 5, i32 2, i32 7>
+; CHECK: store <4 x i32> [[RES]]
+  %a1p = getelementptr inbounds i32, i32* %a, i64 1
+  %a2p = getelementptr inbounds i32, i32* %a, i64 2
+  %a3p = getelementptr inbounds i32, i32* %a, i64 3
+  %r1p = getelementptr inbounds i32, i32* %r, i64 1
+  %r2p = getelementptr inbounds i32, i32* %r, i64 2
+  %r3p = getelementptr inbounds i32, i32* %r, i64 3
+  %a0 = load i32, i32* %a, align 4
+  %a1 = load i32, i32* %a1p, align 4
+  %a2 = load i32, i32* %a2p, align 4
+  %a3 = load i32, i32* %a3p, align 4
+  %r0 = mul i32 %a0, 3
+  %r1 = udiv i32 %a1, 5
+  %r2 = mul i32 %a2, 7
+  %r3 = udiv i32 %a3, 9
+  store i32 %r0, i32* %r, align 4
+  store i32 %r1, i32* %r1p, align 4
+  store i32 %r2, i32* %r2p, align 4
+  store i32 %r3, i32* %r3p, align 4
+  ret void
+}
+
+; The multiplied lanes would divide by values that may be zero.
+define void @mul_udiv_unsafe(i32* noalias %r, i32* noalias %a, i32* noalias %b) {
+; CHECK-LABEL: @mul_udiv_unsafe(
+; CHECK-NOT: udiv <4 x i32>
+; CHECK-NOT: store <4 x i32>
+; CHECK: ret void
+  %a1p = getelementptr inbounds i32, i32* %a, i64 1
+  %a2p = getelementptr inbounds i32, i32* %a, i64 2
+  %a3p = getelementptr inbounds i32, i32* %a, i64 3
+  %b1p = getelementptr inbounds i32, i32* %b, i64 1
+  %b2p = getelementptr inbounds i32, i32* %b, i64 2
+  %b3p = getelementptr inbounds i32, i32* %b, i64 3
+  %r1p = getelementptr inbounds i32, i32* %r, i64 1
+  %r2p = getelementptr inbounds i32, i32* %r, i64 2
+  %r3p = getelementptr inbounds i32, i32* %r, i64 3
+  %a0 = load i32, i32* %a, align 4
+  %a1 = load i32, i32* %a1p, align 4
+  %a2 = load i32, i32* %a2p, align 4
+  %a3 = load i32, i32* %a3p, align 4
+  %b0 = load i32, i32* %b, align 4
+  %b1 = load i32, i32* %b1p, align 4
+  %b2 = load i32, i32* %b2p, align 4
+  %b3 = load i32, i32* %b3p, align 4
+  %r0 = mul i32 %a0, %b0
+  %r1 = udiv i32 %a1, %b1
+  %r2 = mul i32 %a2, %b2
+  %r3 = udiv i32 %a3, %b3
+  store i32 %r0, i32* %r, align 4
+  store i32 %r1, i32* %r1p, align 4
+  store i32 %r2, i32* %r2p, align 4
+  store i32 %r3, i32* %r3p, align 4
+  ret void
+}
@@ -0,0 +1,83 @@
+; RUN: opt < %s -mtriple=x86_64-unknown-linux -mcpu=corei7-avx -basicaa -slp-vectorizer -slp-vectorize-non-power-of-2 -S | FileCheck %s
+; RUN: opt < %s -mtriple=x86_64-unknown-linux -mcpu=corei7-avx -basicaa -slp-vectorizer -S | FileCheck %s --check-prefix=DEFAULT
+
+%vec3 = type { float, float, float }
+
+; r = a * b + c on 3-component vectors.
+define void @fma3(%vec3* noalias %r, %vec3* noalias %a, %vec3* noalias %b, %vec3* noalias %c) {
+; CHECK-LABEL: @fma3(
+; CHECK: [[A:%.*]] = load <3 x float>
+; CHECK: [[B:%.*]] = load <3 x float>
+; CHECK: [[C:%.*]] = load <3 x float>
+; CHECK: [[MUL:%.*]] = fmul <3 x float> [[A]], [[B]]
+; CHECK: [[ADD:%.*]] = fadd <3 x float> [[MUL]], [[C]]
+; CHECK: store <3 x float> [[ADD]]
+;
+; DEFAULT-LABEL: @fma3(
+; DEFAULT-NOT: <3 x float>
+; DEFAULT: ret void
+  %ax = getelementptr inbounds %vec3, %vec3* %a, i64 0, i32 0
+  %ay = getelementptr inbounds %vec3, %vec3* %a, i64 0, i32 1
+  %az = getelementptr inbounds %vec3, %vec3* %a, i64 0, i32 2
+  %bx = getelementptr inbounds %vec3, %vec3* %b, i64 0, i32 0
+  %by = getelementptr inbounds %vec3, %vec3* %b, i64 0, i32 1
+  %bz = getelementptr inbounds %vec3, %vec3* %b, i64 0, i32 2
+  %cx = getelementptr inbounds %vec3, %vec3* %c, i64 0, i32 0
+  %cy = getelementptr inbounds %vec3, %vec3* %c, i64 0, i32 1
+  %cz = getelementptr inbounds %vec3, %vec3* %c, i64 0, i32 2
+  %rx = getelementptr inbounds %vec3, %vec3* %r, i64 0, i32 0
+  %ry = getelementptr inbounds %vec3, %vec3* %r, i64 0, i32 1
+  %rz = getelementptr inbounds %vec3, %vec3* %r, i64 0, i32 2
+  %a0 = load float, float* %ax, align 4
+  %a1 = load float, float* %ay, align 4
+  %a2 = load float, float* %az, align 4
+  %b0 = load float, float* %bx, align 4
+  %b1 = load float, float* %by, align 4
+  %b2 = load float, float* %bz, align 4
+  %c0 = load float, float* %cx, align 4
+  %c1 = load float, float* %cy, align 4
+  %c2 = load float, float* %cz, align 4
+  %m0 = fmul float %a0, %b0
+  %m1 = fmul float %a1, %b1
+  %m2 = fmul float %a2, %b2
+  %s0 = fadd float %m0, %c0
+  %s1 = fadd float %m1, %c1
+  %s2 = fadd float %m2, %c2
+  store float %s0, float* %rx, align 4
+  store float %s1, float* %ry, align 4
+  store float %s2, float* %rz, align 4
+  ret void
+}
+
+; A 3-element build vector is vectorized as a whole.
+define <3 x float> @build3(float* noalias %x, float* noalias %y) {
+; CHECK-LABEL: @build3(
+; CHECK: [[X:%.*]] = load <3 x float>
+; CHECK: [[Y:%.*]] = load <3 x float>
+; CHECK: [[D:%.*]] = fsub <3 x float> [[X]], [[Y]]
+; CHECK: fmul <3 x float> [[D]], [[D]]
+;
+; DEFAULT-LABEL: @build3(
+; DEFAULT-NOT: fsub <3 x float>
+; DEFAULT: ret <3 x float>
+  %x1p = getelementptr inbounds float, float* %x, i64 1
+  %x2p = getelementptr inbounds float, float* %x, i64 2
+  %y1p = getelementptr inbounds float, float* %y, i64 1
+  %y2p = getelementptr inbounds float, float* %y, i64 2
+  %x0 = load float, float* %x, align 4
+  %x1 = load float, float* %x1p, align 4
+  %x2 = load float, float* %x2p, align 4
+  %y0 = load float, float* %y, align 4
+  %y1 = load float, float* %y1p, align 4
+  %y2 = load float, float* %y2p, align 4
+  %d0 = fsub float %x0, %y0
+  %d1 = fsub float %x1, %y1
+  %d2 = fsub float %x2, %y2
+  %p0 = fmul float %d0, %d0
+  %p1 = fmul float %d1, %d1
+  %p2 = fmul float %d2, %d2
+  %v0 = insertelement <3 x float> undef, float %p0, i32 0
+  %v1 = insertelement <3 x float> %v0, float %p1, i32 1
+  %v2 = insertelement <3 x float> %v1, float %p2, i32 2
+  ret <3 x float> %v2
+}
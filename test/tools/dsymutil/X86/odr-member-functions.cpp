@@ -5,6 +5,9 @@
  */
 
 // RUN: llvm-dsymutil -f -oso-prepend-path=%p/../Inputs/odr-member-functions -y %p/dummy-debug-map.map -o - | llvm-dwarfdump -debug-dump=info - | FileCheck %s
+// RUN: llvm-dsymutil -f -num-threads 1 -oso-prepend-path=%p/../Inputs/odr-member-functions -y %p/dummy-debug-map.map -o %t.j1
+// RUN: llvm-dsymutil -f -num-threads 4 -oso-prepend-path=%p/../Inputs/odr-member-functions -y %p/dummy-debug-map.map -o %t.j4
+// RUN: cmp %t.j1 %t.j4
 
 struct S {
   __attribute__((always_inline)) void foo() { bar(); }
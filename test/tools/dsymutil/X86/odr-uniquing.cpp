@@ -13,6 +13,9 @@
 
 // RUN: llvm-dsymutil -f -oso-prepend-path=%p/../Inputs/odr-uniquing -y %p/dummy-debug-map.map -o - | llvm-dwarfdump -debug-dump=info - | FileCheck -check-prefix=ODR -check-prefix=CHECK %s
 // RUN: llvm-dsymutil -f -oso-prepend-path=%p/../Inputs/odr-uniquing -y %p/dummy-debug-map.map -no-odr -o - | llvm-dwarfdump -debug-dump=info - | FileCheck -check-prefix=NOODR -check-prefix=CHECK %s
+// RUN: llvm-dsymutil -f -num-threads 1 -oso-prepend-path=%p/../Inputs/odr-uniquing -y %p/dummy-debug-map.map -o %t.j1
+// RUN: llvm-dsymutil -f -num-threads 4 -oso-prepend-path=%p/../Inputs/odr-uniquing -y %p/dummy-debug-map.map -o %t.j4
+// RUN: cmp %t.j1 %t.j4
 
 // The first compile unit contains all the types:
 // CHECK: TAG_compile_unit
@@ -35,9 +35,13 @@
 #include "llvm/Object/MachO.h"
 #include "llvm/Support/LEB128.h"
 #include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Target/TargetMachine.h"
 #include "llvm/Target/TargetOptions.h"
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <tuple>
 
@@ -1121,8 +1125,10 @@ public:
   /// \brief Link the contents of the DebugMap.
   bool link(const DebugMap &);
 
-  void reportWarning(const Twine &Warning,
-                     const DWARFDie *DIE = nullptr) const;
+  /// Report a warning about \p DMO, or about the debug object currently
+  /// being linked if it is null.
+  void reportWarning(const Twine &Warning, const DWARFDie *DIE = nullptr,
+                     const DebugMapObject *DMO = nullptr) const;
 
 private:
   /// \brief Called at the start of a debug object link.
@@ -1198,6 +1204,42 @@ private:
                           bool isLittleEndian);
   };
 
+  /// The state of one object of the debug map between loading it and
+  /// cloning its debug info. When linking with more than one thread, the
+  /// next objects are loaded and analyzed while the current one is cloned.
+  struct LinkContext {
+    DebugMapObject &DMO;
+    /// Keeps the object alive when it is not loaded through the linker's
+    /// BinHolder, which only holds one object at a time.
+    BinaryHolder BinHolder;
+    RelocationManager RelocMgr;
+    std::unique_ptr<DWARFContextInMemory> DwarfContext;
+    std::vector<std::unique_ptr<CompileUnit>> CompileUnits;
+    /// Set once the units have been created and their ODR contexts analyzed.
+    bool Analyzed = false;
+
+    LinkContext(DwarfLinker &Linker, DebugMapObject &DMO, bool Verbose)
+        : DMO(DMO), BinHolder(Verbose), RelocMgr(Linker) {}
+  };
+
+  /// Load the object of \p Context through \p BinHolder, find the
+  /// relocations that correspond to debug map entries and read its debug
+  /// info. Return false if there is nothing to link in it.
+  bool loadContext(LinkContext &Context, BinaryHolder &BinHolder,
+                   const DebugMap &Map);
+
+  /// Return true if the units of \p Context refer to clang modules. Loading
+  /// a module clones it into the output, so it has to happen in order with
+  /// the cloning of the objects.
+  static bool usesClangModules(const LinkContext &Context);
+
+  /// Create the units of \p Context, loading the clang modules they refer
+  /// to, and analyze their ODR contexts.
+  void analyzeContext(LinkContext &Context, DebugMap &ModuleMap);
+
+  /// Mark the DIEs of \p Context to keep, then clone and emit them.
+  void cloneContext(LinkContext &Context);
+
   /// \defgroup FindRootDIEs Find DIEs corresponding to debug map entries.
   ///
   /// @{
@@ -1450,6 +1492,14 @@ private:
   /// \brief The Dwarf string pool
   NonRelocatableStringpool StringPool;
 
+  /// The pool interning the names used for ODR uniquing. It is separate
+  /// from StringPool so that objects can be analyzed while another one is
+  /// cloned.
+  NonRelocatableStringpool UniquingStringPool;
+
+  /// Serializes the warnings of the loading and cloning threads.
+  mutable std::mutex WarningMutex;
+
   /// \brief This map is keyed by the entry PC of functions in that
   /// debug object and the associated value is a pair storing the
   /// corresponding end PC and the offset to apply to get the linked
@@ -1737,11 +1787,15 @@ bool DwarfLinker::DIECloner::getDIENames(const DWARFDie &Die,
 
 /// \brief Report a warning to the user, optionaly including
 /// information about a specific \p DIE related to the warning.
-void DwarfLinker::reportWarning(const Twine &Warning,
-                                const DWARFDie *DIE) const {
+void DwarfLinker::reportWarning(const Twine &Warning, const DWARFDie *DIE,
+                                const DebugMapObject *DMO) const {
   StringRef Context = "<debug map>";
-  if (CurrentDebugObject)
-    Context = CurrentDebugObject->getObjectFilename();
+  if (!DMO)
+    DMO = CurrentDebugObject;
+  if (DMO)
+    Context = DMO->getObjectFilename();
+  // Objects may be loaded on another thread than the one cloning.
+  std::lock_guard<std::mutex> Lock(WarningMutex);
   warn(Warning, Context);
 
   if (!Options.Verbose || !DIE)
@@ -1818,12 +1872,35 @@ static bool analyzeContextInfo(const DWARFDie &DIE,
       (DIE.getTag() == dwarf::DW_TAG_module) ||
       dwarf::toUnsigned(DIE.find(dwarf::DW_AT_declaration), 0);
 
-  // Don't prune it if there is no definition for the DIE.
-  Info.Prune &= Info.Ctxt && Info.Ctxt->getCanonicalDIEOffset();
+  return Info.Prune;
+}
+
+/// Recursive helper to keep the forward declarations that
+/// analyzeContextInfo() selected for pruning when no definition has been
+/// emitted for them. This reads the canonical DIE offsets assigned by the
+/// cloning of the previous units, so it has to run on the cloning thread
+/// right before \p CU's DIEs are selected.
+///
+/// \return true when this DIE and all of its children can be pruned.
+static bool updatePruning(const DWARFDie &DIE, CompileUnit &CU) {
+  CompileUnit::DIEInfo &Info = CU.getInfo(CU.getOrigUnit().getDIEIndex(DIE));
+  if (DIE.hasChildren())
+    for (auto Child: DIE.children())
+      Info.Prune &= updatePruning(Child, CU);
 
+  // Don't prune the DIE if there is no definition for it.
+  Info.Prune = Info.Prune && Info.Ctxt && Info.Ctxt->getCanonicalDIEOffset();
   return Info.Prune;
 }
 
+/// Apply updatePruning() to the DIEs of \p CU. Only the DW_TAG_modules at
+/// the top of the unit can contain DIEs to prune.
+static void updatePruning(CompileUnit &CU) {
+  for (auto Child : CU.getOrigUnit().getUnitDIE().children())
+    if (Child.getTag() == dwarf::DW_TAG_module)
+      updatePruning(Child, CU);
+}
+
 static bool dieNeedsChildrenToBeMeaningful(uint32_t Tag) {
   switch (Tag) {
   default:
@@ -1921,14 +1998,16 @@ findValidRelocsMachO(const object::SectionRef &Section,
     if (isMachOPairedReloc(Obj.getAnyRelocationType(MachOReloc),
                            Obj.getArch())) {
       SkipNext = true;
-      Linker.reportWarning(" unsupported relocation in debug_info section.");
+      Linker.reportWarning(" unsupported relocation in debug_info section.",
+                           nullptr, &DMO);
       continue;
     }
 
     unsigned RelocSize = 1 << Obj.getAnyRelocationLength(MachOReloc);
     uint64_t Offset64 = Reloc.getOffset();
     if ((RelocSize != 4 && RelocSize != 8)) {
-      Linker.reportWarning(" unsupported relocation in debug_info section.");
+      Linker.reportWarning(" unsupported relocation in debug_info section.",
+                           nullptr, &DMO);
       continue;
     }
     uint32_t Offset = Offset64;
@@ -1953,7 +2032,8 @@ findValidRelocsMachO(const object::SectionRef &Section,
       Expected<StringRef> SymbolName = Sym->getName();
       if (!SymbolName) {
         consumeError(SymbolName.takeError());
-        Linker.reportWarning("error getting relocation symbol name.");
+        Linker.reportWarning("error getting relocation symbol name.", nullptr,
+                             &DMO);
         continue;
       }
       if (const auto *Mapping = DMO.lookupSymbol(*SymbolName))
@@ -1977,7 +2057,8 @@ bool DwarfLinker::RelocationManager::findValidRelocs(
     findValidRelocsMachO(Section, *MachOObj, DMO);
   else
     Linker.reportWarning(Twine("unsupported object file type: ") +
-                         Obj.getFileName());
+                             Obj.getFileName(),
+                         nullptr, &DMO);
 
   if (ValidRelocs.empty())
     return false;
@@ -3264,12 +3345,14 @@ DwarfLinker::loadObject(BinaryHolder &BinaryHolder, DebugMapObject &Obj,
   auto ErrOrObjs =
       BinaryHolder.GetObjectFiles(Obj.getObjectFilename(), Obj.getTimestamp());
   if (std::error_code EC = ErrOrObjs.getError()) {
-    reportWarning(Twine(Obj.getObjectFilename()) + ": " + EC.message());
+    reportWarning(Twine(Obj.getObjectFilename()) + ": " + EC.message(),
+                  nullptr, &Obj);
     return EC;
   }
   auto ErrOrObj = BinaryHolder.Get(Map.getTriple());
   if (std::error_code EC = ErrOrObj.getError())
-    reportWarning(Twine(Obj.getObjectFilename()) + ": " + EC.message());
+    reportWarning(Twine(Obj.getObjectFilename()) + ": " + EC.message(),
+                  nullptr, &Obj);
   return ErrOrObj;
 }
 
@@ -3351,8 +3434,9 @@ void DwarfLinker::loadClangModule(StringRef Filename, StringRef ModulePath,
       Unit = llvm::make_unique<CompileUnit>(*CU, UnitID++, !Options.NoODR,
                                             ModuleName);
       Unit->setHasInterestingContent();
-      analyzeContextInfo(CUDie, 0, *Unit, &ODRContexts.getRoot(), StringPool,
-                         ODRContexts);
+      analyzeContextInfo(CUDie, 0, *Unit, &ODRContexts.getRoot(),
+                         UniquingStringPool, ODRContexts);
+      updatePruning(*Unit);
       // Keep everything.
       Unit->markEverythingAsKept();
     }
@@ -3409,6 +3493,97 @@ void DwarfLinker::DIECloner::cloneAllCompileUnits(
   }
 }
 
+bool DwarfLinker::loadContext(LinkContext &Context, BinaryHolder &BinHolder,
+                              const DebugMap &Map) {
+  DebugMapObject &Obj = Context.DMO;
+  if (Options.Verbose)
+    outs() << "DEBUG MAP OBJECT: " << Obj.getObjectFilename() << "\n";
+  auto ErrOrObj = loadObject(BinHolder, Obj, Map);
+  if (!ErrOrObj)
+    return false;
+
+  // Look for relocations that correspond to debug map entries.
+  if (!Context.RelocMgr.findValidRelocsInDebugInfo(*ErrOrObj, Obj)) {
+    if (Options.Verbose)
+      outs() << "No valid relocations found. Skipping.\n";
+    return false;
+  }
+
+  // Setup access to the debug info, and read all of it while we are here.
+  Context.DwarfContext = llvm::make_unique<DWARFContextInMemory>(*ErrOrObj);
+  for (const auto &CU : Context.DwarfContext->compile_units())
+    CU->getUnitDIE(false);
+  return true;
+}
+
+bool DwarfLinker::usesClangModules(const LinkContext &Context) {
+  for (const auto &CU : Context.DwarfContext->compile_units()) {
+    // Skeleton CUs point to the modules.
+    auto CUDie = CU->getUnitDIE(false);
+    if (CUDie.find({dwarf::DW_AT_dwo_name, dwarf::DW_AT_GNU_dwo_name}))
+      return true;
+  }
+  return false;
+}
+
+void DwarfLinker::analyzeContext(LinkContext &Context, DebugMap &ModuleMap) {
+  // In a first phase, just read in the debug info and load all clang modules.
+  for (const auto &CU : Context.DwarfContext->compile_units()) {
+    auto CUDie = CU->getUnitDIE(false);
+    if (Options.Verbose) {
+      outs() << "Input compilation unit:";
+      CUDie.dump(outs(), 0);
+    }
+
+    if (!registerModuleReference(CUDie, *CU, ModuleMap)) {
+      Context.CompileUnits.push_back(llvm::make_unique<CompileUnit>(
+          *CU, UnitID++, !Options.NoODR, ""));
+      maybeUpdateMaxDwarfVersion(CU->getVersion());
+    }
+  }
+
+  // Now build the DIE parent links that we will use during the next phase.
+  for (auto &CurrentUnit : Context.CompileUnits)
+    analyzeContextInfo(CurrentUnit->getOrigUnit().getUnitDIE(), 0,
+                       *CurrentUnit, &ODRContexts.getRoot(),
+                       UniquingStringPool, ODRContexts);
+  Context.Analyzed = true;
+}
+
+void DwarfLinker::cloneContext(LinkContext &Context) {
+  DebugMapObject &Obj = Context.DMO;
+  RelocationManager &RelocMgr = Context.RelocMgr;
+  Units = std::move(Context.CompileUnits);
+
+  // Now that the previous objects have been cloned, decide which module
+  // forward declarations have a definition and can be pruned.
+  for (auto &CurrentUnit : Units)
+    updatePruning(*CurrentUnit);
+
+  // Then mark all the DIEs that need to be present in the linked
+  // output and collect some information about them. Note that this
+  // loop can not be merged with the previous one becaue cross-cu
+  // references require the ParentIdx to be setup for every CU in
+  // the object file before calling this.
+  for (auto &CurrentUnit : Units)
+    lookForDIEsToKeep(RelocMgr, CurrentUnit->getOrigUnit().getUnitDIE(), Obj,
+                      *CurrentUnit, 0);
+
+  // The calls to applyValidRelocs inside cloneDIE will walk the
+  // reloc array again (in the same way findValidRelocsInDebugInfo()
+  // did). We need to reset the NextValidReloc index to the beginning.
+  RelocMgr.resetValidRelocs();
+  if (RelocMgr.hasValidRelocs())
+    DIECloner(*this, RelocMgr, DIEAlloc, Units, Options)
+        .cloneAllCompileUnits(*Context.DwarfContext);
+  if (!Options.NoOutput && !Units.empty())
+    patchFrameInfoForObject(Obj, *Context.DwarfContext,
+                            Units[0]->getOrigUnit().getAddressByteSize());
+
+  // Clean-up before starting working on the next object.
+  endDebugObject();
+}
+
 bool DwarfLinker::link(const DebugMap &Map) {
 
   if (!createStreamer(Map.getTriple(), OutputFilename))
@@ -3420,69 +3595,84 @@ bool DwarfLinker::link(const DebugMap &Map) {
   UnitID = 0;
   DebugMap ModuleMap(Map.getTriple(), Map.getBinaryPath());
 
-  for (const auto &Obj : Map.objects()) {
-    CurrentDebugObject = Obj.get();
-
-    if (Options.Verbose)
-      outs() << "DEBUG MAP OBJECT: " << Obj->getObjectFilename() << "\n";
-    auto ErrOrObj = loadObject(BinHolder, *Obj, Map);
-    if (!ErrOrObj)
-      continue;
+  // Link one loaded object. Its units are analyzed here unless that already
+  // happened on the loading thread.
+  auto LinkObject = [&](LinkContext &Context) {
+    CurrentDebugObject = &Context.DMO;
+    startDebugObject(*Context.DwarfContext, Context.DMO);
+    if (!Context.Analyzed)
+      analyzeContext(Context, ModuleMap);
+    cloneContext(Context);
+  };
 
-    // Look for relocations that correspond to debug map entries.
-    RelocationManager RelocMgr(*this);
-    if (!RelocMgr.findValidRelocsInDebugInfo(*ErrOrObj, *Obj)) {
-      if (Options.Verbose)
-        outs() << "No valid relocations found. Skipping.\n";
-      continue;
+  auto Objects = Map.objects();
+  size_t NumObjects = Objects.end() - Objects.begin();
+  bool Parallel = Options.Threads > 1 && NumObjects > 1 && !Options.Verbose &&
+                  llvm_is_multithreaded();
+
+  if (!Parallel) {
+    for (const auto &Obj : Objects) {
+      CurrentDebugObject = Obj.get();
+      LinkContext Context(*this, *Obj, Options.Verbose);
+      if (loadContext(Context, BinHolder, Map))
+        LinkObject(Context);
     }
-
-    // Setup access to the debug info.
-    DWARFContextInMemory DwarfContext(*ErrOrObj);
-    startDebugObject(DwarfContext, *Obj);
-
-    // In a first phase, just read in the debug info and load all clang modules.
-    for (const auto &CU : DwarfContext.compile_units()) {
-      auto CUDie = CU->getUnitDIE(false);
-      if (Options.Verbose) {
-        outs() << "Input compilation unit:";
-        CUDie.dump(outs(), 0);
+  } else {
+    // Load and analyze the objects on a separate thread, at most
+    // Options.Threads objects ahead of the one being cloned. The ODR
+    // contexts are analyzed in debug map order, and the cloning consumes
+    // the objects in that order too, so the output does not depend on the
+    // scheduling. The analysis only builds the DeclContexts: everything that
+    // reads the canonical DIE offsets assigned by the cloning runs on the
+    // cloning thread. Once an object refers to clang modules, the loading
+    // thread leaves the analysis of it and of all the following objects to
+    // the cloning thread.
+    std::vector<std::unique_ptr<LinkContext>> Contexts(NumObjects);
+    std::mutex ContextsMutex;
+    std::condition_variable ContextsChanged;
+    size_t NumLoaded = 0, NumCloned = 0;
+
+    auto LoadAll = [&]() {
+      bool DeferAnalysis = false;
+      for (size_t I = 0; I != NumObjects; ++I) {
+        {
+          std::unique_lock<std::mutex> Lock(ContextsMutex);
+          ContextsChanged.wait(
+              Lock, [&]() { return I < NumCloned + Options.Threads; });
+        }
+        auto Context = llvm::make_unique<LinkContext>(*this, *Objects.begin()[I],
+                                                      Options.Verbose);
+        if (!loadContext(*Context, Context->BinHolder, Map)) {
+          Context.reset();
+        } else {
+          DeferAnalysis = DeferAnalysis || usesClangModules(*Context);
+          if (!DeferAnalysis)
+            analyzeContext(*Context, ModuleMap);
+        }
+        std::lock_guard<std::mutex> Lock(ContextsMutex);
+        Contexts[I] = std::move(Context);
+        ++NumLoaded;
+        ContextsChanged.notify_all();
       }
+    };
 
-      if (!registerModuleReference(CUDie, *CU, ModuleMap)) {
-        Units.push_back(llvm::make_unique<CompileUnit>(*CU, UnitID++,
-                                                       !Options.NoODR, ""));
-        maybeUpdateMaxDwarfVersion(CU->getVersion());
+    ThreadPool Pool(1);
+    Pool.async(LoadAll);
+    for (size_t I = 0; I != NumObjects; ++I) {
+      std::unique_ptr<LinkContext> Context;
+      {
+        std::unique_lock<std::mutex> Lock(ContextsMutex);
+        ContextsChanged.wait(Lock, [&]() { return I < NumLoaded; });
+        Context = std::move(Contexts[I]);
       }
+      if (Context)
+        LinkObject(*Context);
+      Context.reset();
+      std::lock_guard<std::mutex> Lock(ContextsMutex);
+      ++NumCloned;
+      ContextsChanged.notify_all();
     }
-
-    // Now build the DIE parent links that we will use during the next phase.
-    for (auto &CurrentUnit : Units)
-      analyzeContextInfo(CurrentUnit->getOrigUnit().getUnitDIE(), 0, *CurrentUnit,
-                         &ODRContexts.getRoot(), StringPool, ODRContexts);
-
-    // Then mark all the DIEs that need to be present in the linked
-    // output and collect some information about them. Note that this
-    // loop can not be merged with the previous one becaue cross-cu
-    // references require the ParentIdx to be setup for every CU in
-    // the object file before calling this.
-    for (auto &CurrentUnit : Units)
-      lookForDIEsToKeep(RelocMgr, CurrentUnit->getOrigUnit().getUnitDIE(), *Obj,
-                        *CurrentUnit, 0);
-
-    // The calls to applyValidRelocs inside cloneDIE will walk the
-    // reloc array again (in the same way findValidRelocsInDebugInfo()
-    // did). We need to reset the NextValidReloc index to the beginning.
-    RelocMgr.resetValidRelocs();
-    if (RelocMgr.hasValidRelocs())
-      DIECloner(*this, RelocMgr, DIEAlloc, Units, Options)
-          .cloneAllCompileUnits(DwarfContext);
-    if (!Options.NoOutput && !Units.empty())
-      patchFrameInfoForObject(*Obj, DwarfContext,
-                              Units[0]->getOrigUnit().getAddressByteSize());
-
-    // Clean-up before starting working on the next object.
-    endDebugObject();
+    Pool.wait();
   }
 
   // Emit everything that's global.
@@ -24,6 +24,7 @@
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/thread.h"
 #include <cstdint>
 #include <string>
 
@@ -82,6 +83,15 @@ static opt<bool>
           desc("Do not use ODR (One Definition Rule) for type uniquing."),
           init(false), cat(DsymCategory));
 
+static opt<unsigned> NumThreads(
+    "num-threads",
+    desc("Specifies the maximum number (n) of simultaneous threads to use\n"
+         "when linking. Objects are loaded and analyzed ahead of the one\n"
+         "being cloned, at most n of them. (default = hardware threads)"),
+    value_desc("n"), init(0), cat(DsymCategory));
+static alias NumThreadsA("j", desc("Alias for --num-threads"),
+                         aliasopt(NumThreads));
+
 static opt<bool> DumpDebugMap(
     "dump-debug-map",
     desc("Parse and dump the debug map to standard output. Not DWARF link "
@@ -265,6 +275,12 @@ int main(int argc, char **argv) {
   Options.NoOutput = NoOutput;
   Options.NoODR = NoODR;
   Options.PrependPath = OsoPrependPath;
+  Options.Threads = NumThreads;
+  if (Options.Threads == 0)
+    Options.Threads = llvm::thread::hardware_concurrency();
+  // Keep the verbose output in order.
+  if (Verbose || DumpDebugMap)
+    Options.Threads = 1;
 
   llvm::InitializeAllTargetInfos();
   llvm::InitializeAllTargetMCs();
@@ -32,6 +32,7 @@
 #include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
+#include <atomic>
 
 using namespace llvm;
 
@@ -178,6 +179,28 @@ static void loadInput(const WeightedFile &Input, WriterContext *WC) {
     WC->Err = Reader->getError();
 }
 
+/// Merge \p Contexts[1..] into \p Contexts[0] with \p Merge(Dst, Src), as a
+/// tree of ~lg(N) rounds of merges that run in parallel.
+template <typename ContextT, typename MergeFnT>
+static void reduceContexts(ThreadPool &Pool,
+                           SmallVectorImpl<std::unique_ptr<ContextT>> &Contexts,
+                           MergeFnT Merge) {
+  unsigned Mid = Contexts.size() / 2;
+  unsigned End = Contexts.size();
+  assert(Mid > 0 && "Expected more than one context");
+  do {
+    for (unsigned I = 0; I < Mid; ++I)
+      Pool.async(Merge, Contexts[I].get(), Contexts[I + Mid].get());
+    Pool.wait();
+    if (End & 1) {
+      Pool.async(Merge, Contexts[0].get(), Contexts[End - 1].get());
+      Pool.wait();
+    }
+    End = Mid;
+    Mid /= 2;
+  } while (Mid > 0);
+}
+
 /// Merge the \p Src writer context into \p Dst.
 static void mergeWriterContexts(WriterContext *Dst, WriterContext *Src) {
   bool Reported = false;
@@ -194,13 +217,27 @@ static void mergeWriterContexts(WriterContext *Dst, WriterContext *Src) {
 static void mergeInstrProfile(const WeightedFileVector &Inputs,
                               StringRef OutputFilename,
                               ProfileFormat OutputFormat, bool OutputSparse,
-                              unsigned NumThreads) {
+                              unsigned NumThreads, StringRef OverlayBase) {
   if (OutputFilename.compare("-") == 0)
     exitWithError("Cannot write indexed profdata format to stdout.");
 
   if (OutputFormat != PF_Binary && OutputFormat != PF_Text)
     exitWithError("Unknown format is specified.");
 
+  // Open the base of an overlay before the output, which must not be the
+  // base itself.
+  std::unique_ptr<IndexedInstrProfReader> Base;
+  if (!OverlayBase.empty()) {
+    if (OutputFormat != PF_Binary)
+      exitWithError("An overlay must be written in the binary format.");
+    if (sys::fs::equivalent(OverlayBase, OutputFilename))
+      exitWithError("An overlay cannot replace its base.", OutputFilename);
+    auto BaseOrErr = IndexedInstrProfReader::create(OverlayBase);
+    if (Error E = BaseOrErr.takeError())
+      exitWithError(std::move(E), OverlayBase);
+    Base = std::move(BaseOrErr.get());
+  }
+
   std::error_code EC;
   raw_fd_ostream Output(OutputFilename.data(), EC, sys::fs::F_None);
   if (EC)
@@ -226,31 +263,20 @@ static void mergeInstrProfile(const WeightedFileVector &Inputs,
   } else {
     ThreadPool Pool(NumThreads);
 
-    // Load the inputs in parallel (N/NumThreads serial steps).
-    unsigned Ctx = 0;
-    for (const auto &Input : Inputs) {
-      Pool.async(loadInput, Input, Contexts[Ctx].get());
-      Ctx = (Ctx + 1) % NumThreads;
-    }
+    // Load the inputs in parallel (N/NumThreads serial steps).  Each thread
+    // fills its own context and takes the next input when it is done with
+    // one, so a thread never waits for a context that another thread is
+    // busy with, however uneven the input sizes are.
+    std::atomic<size_t> NextInput(0);
+    for (unsigned I = 0; I < NumThreads; ++I)
+      Pool.async([&Inputs, &NextInput](WriterContext *WC) {
+        for (size_t N; (N = NextInput++) < Inputs.size();)
+          loadInput(Inputs[N], WC);
+      }, Contexts[I].get());
     Pool.wait();
 
     // Merge the writer contexts together (~ lg(NumThreads) serial steps).
-    unsigned Mid = Contexts.size() / 2;
-    unsigned End = Contexts.size();
-    assert(Mid > 0 && "Expected more than one context");
-    do {
-      for (unsigned I = 0; I < Mid; ++I)
-        Pool.async(mergeWriterContexts, Contexts[I].get(),
-                   Contexts[I + Mid].get());
-      Pool.wait();
-      if (End & 1) {
-        Pool.async(mergeWriterContexts, Contexts[0].get(),
-                   Contexts[End - 1].get());
-        Pool.wait();
-      }
-      End = Mid;
-      Mid /= 2;
-    } while (Mid > 0);
+    reduceContexts(Pool, Contexts, mergeWriterContexts);
   }
 
   // Handle deferred hard errors encountered during merging.
@@ -259,7 +285,18 @@ static void mergeInstrProfile(const WeightedFileVector &Inputs,
       exitWithError(std::move(WC->Err), WC->ErrWhence);
 
   InstrProfWriter &Writer = Contexts[0]->Writer;
-  if (OutputFormat == PF_Text) {
+  if (Base) {
+    // Record the base by name if it is next to the overlay, so that the two
+    // can be moved together.
+    SmallString<128> BasePath(OverlayBase), OutputPath(OutputFilename);
+    sys::fs::make_absolute(BasePath);
+    sys::fs::make_absolute(OutputPath);
+    StringRef RecordedPath = BasePath;
+    if (sys::path::parent_path(BasePath) == sys::path::parent_path(OutputPath))
+      RecordedPath = sys::path::filename(BasePath);
+    if (Error E = Writer.writeOverlay(Output, *Base, RecordedPath))
+      exitWithError(std::move(E), OverlayBase);
+  } else if (OutputFormat == PF_Text) {
     if (Error E = Writer.writeText(Output))
       exitWithError(std::move(E));
   } else {
@@ -271,9 +308,101 @@ static sampleprof::SampleProfileFormat FormatMap[] = {
     sampleprof::SPF_None, sampleprof::SPF_Text, sampleprof::SPF_Binary,
     sampleprof::SPF_GCC};
 
+/// The profiles read from one sample profile input.
+struct SampleInputContext {
+  const WeightedFile *Input;
+  std::unique_ptr<LLVMContext> Context;
+  /// Kept alive because the merged profiles refer to the function names
+  /// stored in the reader's memory.
+  std::unique_ptr<sampleprof::SampleProfileReader> Reader;
+  std::error_code EC;
+  std::mutex &ErrLock;
+
+  SampleInputContext(const WeightedFile &Input, std::mutex &ErrLock)
+      : Input(&Input), ErrLock(ErrLock) {}
+};
+
+/// Read a sample profile input, scaling its counts by its weight.
+static void loadSampleInput(SampleInputContext *SC) {
+  using namespace sampleprof;
+  SC->Context = llvm::make_unique<LLVMContext>();
+  auto ReaderOrErr =
+      SampleProfileReader::create(SC->Input->Filename, *SC->Context);
+  if ((SC->EC = ReaderOrErr.getError()))
+    return;
+  SC->Reader = std::move(ReaderOrErr.get());
+  if ((SC->EC = SC->Reader->read()))
+    return;
+  if (SC->Input->Weight == 1)
+    return;
+
+  StringMap<FunctionSamples> &Profiles = SC->Reader->getProfiles();
+  StringMap<FunctionSamples> Scaled;
+  for (auto &I : Profiles) {
+    sampleprof_error Result = Scaled[I.first()].merge(I.second,
+                                                      SC->Input->Weight);
+    if (Result != sampleprof_error::success) {
+      std::lock_guard<std::mutex> ErrGuard(SC->ErrLock);
+      handleMergeWriterError(errorCodeToError(make_error_code(Result)),
+                             SC->Input->Filename, I.first());
+    }
+  }
+  Profiles = std::move(Scaled);
+}
+
+/// Merge the profiles of \p Src into those of \p Dst.
+static void mergeSampleInputs(SampleInputContext *Dst,
+                              SampleInputContext *Src) {
+  using namespace sampleprof;
+  StringMap<FunctionSamples> &DstProfiles = Dst->Reader->getProfiles();
+  for (auto &I : Src->Reader->getProfiles()) {
+    sampleprof_error Result = DstProfiles[I.first()].merge(I.second);
+    if (Result != sampleprof_error::success) {
+      std::lock_guard<std::mutex> ErrGuard(Src->ErrLock);
+      handleMergeWriterError(errorCodeToError(make_error_code(Result)),
+                             Src->Input->Filename, I.first());
+    }
+  }
+  // Src's names stay in use, but its profiles are no longer needed.
+  Src->Reader->getProfiles().clear();
+}
+
+/// Read the inputs with \p NumThreads threads and merge them in a tree.
+static void mergeSampleProfileInParallel(
+    const WeightedFileVector &Inputs,
+    sampleprof::SampleProfileWriter &Writer, unsigned NumThreads) {
+  std::mutex ErrorLock;
+  SmallVector<std::unique_ptr<SampleInputContext>, 8> Contexts;
+  for (const auto &Input : Inputs)
+    Contexts.emplace_back(
+        llvm::make_unique<SampleInputContext>(Input, ErrorLock));
+
+  // Reading, especially of text profiles, is the expensive part; threads
+  // take the next input when they are done with one.
+  ThreadPool Pool(NumThreads);
+  std::atomic<size_t> NextInput(0);
+  for (unsigned I = 0; I < NumThreads; ++I)
+    Pool.async([&Contexts, &NextInput]() {
+      for (size_t N; (N = NextInput++) < Contexts.size();)
+        loadSampleInput(Contexts[N].get());
+    });
+  Pool.wait();
+
+  // Report the first failing input, as the serial merge would.
+  for (const auto &SC : Contexts)
+    if (SC->EC)
+      exitWithErrorCode(SC->EC, SC->Input->Filename);
+
+  // The tree has a fixed shape, so the result does not depend on how the
+  // reads were scheduled.
+  reduceContexts(Pool, Contexts, mergeSampleInputs);
+  Writer.write(Contexts[0]->Reader->getProfiles());
+}
+
 static void mergeSampleProfile(const WeightedFileVector &Inputs,
                                StringRef OutputFilename,
-                               ProfileFormat OutputFormat) {
+                               ProfileFormat OutputFormat,
+                               unsigned NumThreads) {
   using namespace sampleprof;
   auto WriterOrErr =
       SampleProfileWriter::create(OutputFilename, FormatMap[OutputFormat]);
@@ -281,6 +410,16 @@ static void mergeSampleProfile(const WeightedFileVector &Inputs,
     exitWithErrorCode(EC, OutputFilename);
 
   auto Writer = std::move(WriterOrErr.get());
+
+  // If NumThreads is not specified, auto-detect a good default.
+  if (NumThreads == 0)
+    NumThreads = std::max(1U, std::min(std::thread::hardware_concurrency(),
+                                       unsigned(Inputs.size() / 2)));
+  if (NumThreads > 1 && Inputs.size() > 1) {
+    mergeSampleProfileInParallel(Inputs, *Writer, NumThreads);
+    return;
+  }
+
   StringMap<FunctionSamples> ProfileMap;
   SmallVector<std::unique_ptr<sampleprof::SampleProfileReader>, 5> Readers;
   LLVMContext Context;
@@ -428,6 +567,11 @@ static int merge_main(int argc, const char *argv[]) {
       cl::desc("Number of merge threads to use (default: autodetect)"));
   cl::alias NumThreadsA("j", cl::desc("Alias for --num-threads"),
                         cl::aliasopt(NumThreads));
+  cl::opt<std::string> OverlayBase(
+      "overlay-base", cl::init(""), cl::value_desc("profile"),
+      cl::desc("Write only the merged inputs, as an overlay that readers "
+               "add to this indexed profile, instead of a full profile "
+               "(only meaningful for -instr)"));
 
   cl::ParseCommandLineOptions(argc, argv, "LLVM profile data merger\n");
 
@@ -454,9 +598,10 @@ static int merge_main(int argc, const char *argv[]) {
 
   if (ProfileKind == instr)
     mergeInstrProfile(WeightedInputs, OutputFilename, OutputFormat,
-                      OutputSparse, NumThreads);
+                      OutputSparse, NumThreads, OverlayBase);
   else
-    mergeSampleProfile(WeightedInputs, OutputFilename, OutputFormat);
+    mergeSampleProfile(WeightedInputs, OutputFilename, OutputFormat,
+                       NumThreads);
 
   return 0;
 }
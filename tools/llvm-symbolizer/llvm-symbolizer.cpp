@@ -26,10 +26,13 @@
 #include "llvm/Support/Path.h"
 #include "llvm/Support/PrettyStackTrace.h"
 #include "llvm/Support/Signals.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/raw_ostream.h"
 #include <cstdio>
 #include <cstring>
+#include <functional>
 #include <string>
+#include <vector>
 
 using namespace llvm;
 using namespace symbolize;
@@ -88,11 +91,22 @@ static cl::opt<int> ClPrintSourceContextLines(
 static cl::opt<bool> ClVerbose("verbose", cl::init(false),
                                cl::desc("Print verbose line info"));
 
+static cl::opt<std::string>
+    ClCachePath("cache-path", cl::init(""),
+                cl::desc("Directory in which to keep symbolization results "
+                         "for binaries with a build ID across runs"));
+
+static cl::opt<unsigned> ClNumThreads(
+    "num-threads", cl::init(1),
+    cl::desc("Read all of the input before symbolizing it with this many "
+             "threads, one binary per thread at a time (default 1 "
+             "answers each line as it is read)"));
+
 template<typename T>
-static bool error(Expected<T> &ResOrErr) {
+static bool error(Expected<T> &ResOrErr, raw_ostream &ErrOS) {
   if (ResOrErr)
     return false;
-  logAllUnhandledErrors(ResOrErr.takeError(), errs(),
+  logAllUnhandledErrors(ResOrErr.takeError(), ErrOS,
                         "LLVMSymbolizer: error reading file: ");
   return true;
 }
@@ -140,6 +154,86 @@ static bool parseCommand(StringRef InputString, bool &IsData,
   return !StringRef(pos, offset_length).getAsInteger(0, ModuleOffset);
 }
 
+static void symbolizeInput(LLVMSymbolizer &Symbolizer, bool IsData,
+                           const std::string &ModuleName,
+                           uint64_t ModuleOffset, raw_ostream &OS,
+                           raw_ostream &ErrOS) {
+  DIPrinter Printer(OS, ClPrintFunctions != FunctionNameKind::None,
+                    ClPrettyPrint, ClPrintSourceContextLines, ClVerbose);
+  if (ClPrintAddress) {
+    OS << "0x";
+    OS.write_hex(ModuleOffset);
+    StringRef Delimiter = (ClPrettyPrint == true) ? ": " : "\n";
+    OS << Delimiter;
+  }
+  if (IsData) {
+    auto ResOrErr = Symbolizer.symbolizeData(ModuleName, ModuleOffset);
+    Printer << (error(ResOrErr, ErrOS) ? DIGlobal() : ResOrErr.get());
+  } else if (ClPrintInlining) {
+    auto ResOrErr = Symbolizer.symbolizeInlinedCode(ModuleName, ModuleOffset);
+    Printer << (error(ResOrErr, ErrOS) ? DIInliningInfo() : ResOrErr.get());
+  } else {
+    auto ResOrErr = Symbolizer.symbolizeCode(ModuleName, ModuleOffset);
+    Printer << (error(ResOrErr, ErrOS) ? DILineInfo() : ResOrErr.get());
+  }
+  OS << "\n";
+}
+
+namespace {
+struct BatchRequest {
+  bool IsData = false;
+  std::string ModuleName;
+  uint64_t ModuleOffset = 0;
+  std::string Output;
+  std::string Errors;
+};
+} // end anonymous namespace
+
+// Symbolize all of stdin with a pool of threads and print the results in
+// input order.  The symbolizer is not thread-safe, so each thread has its
+// own, and every request for a binary goes to the same thread so that each
+// binary is loaded once.
+static void symbolizeBatch(const LLVMSymbolizer::Options &Opts,
+                           unsigned NumThreads) {
+  std::vector<BatchRequest> Requests;
+  std::vector<std::vector<size_t>> Shards(NumThreads);
+  std::hash<std::string> Hasher;
+  const int kMaxInputStringLength = 1024;
+  char InputString[kMaxInputStringLength];
+  while (fgets(InputString, sizeof(InputString), stdin)) {
+    Requests.emplace_back();
+    BatchRequest &R = Requests.back();
+    if (!parseCommand(StringRef(InputString), R.IsData, R.ModuleName,
+                      R.ModuleOffset)) {
+      R.Output = InputString;
+      continue;
+    }
+    Shards[Hasher(R.ModuleName) % NumThreads].push_back(Requests.size() - 1);
+  }
+
+  ThreadPool Pool(NumThreads);
+  for (const auto &Shard : Shards) {
+    if (Shard.empty())
+      continue;
+    Pool.async([&Opts, &Requests, &Shard]() {
+      LLVMSymbolizer Symbolizer(Opts);
+      for (size_t I : Shard) {
+        BatchRequest &R = Requests[I];
+        raw_string_ostream OS(R.Output), ErrOS(R.Errors);
+        symbolizeInput(Symbolizer, R.IsData, R.ModuleName, R.ModuleOffset, OS,
+                       ErrOS);
+      }
+    });
+  }
+  Pool.wait();
+
+  for (const BatchRequest &R : Requests) {
+    errs() << R.Errors;
+    outs() << R.Output;
+  }
+  outs().flush();
+}
+
 int main(int argc, char **argv) {
   // Print stack trace if we signal out.
   sys::PrintStackTraceOnErrorSignal(argv[0]);
@@ -151,6 +245,7 @@ int main(int argc, char **argv) {
   cl::ParseCommandLineOptions(argc, argv, "llvm-symbolizer\n");
   LLVMSymbolizer::Options Opts(ClPrintFunctions, ClUseSymbolTable, ClDemangle,
                                ClUseRelativeAddress, ClDefaultArch);
+  Opts.CachePath = ClCachePath;
 
   for (const auto &hint : ClDsymHint) {
     if (sys::path::extension(hint) == ".dSYM") {
@@ -160,10 +255,13 @@ int main(int argc, char **argv) {
                 "\" (must have the '.dSYM' extension).\n";
     }
   }
-  LLVMSymbolizer Symbolizer(Opts);
 
-  DIPrinter Printer(outs(), ClPrintFunctions != FunctionNameKind::None,
-                    ClPrettyPrint, ClPrintSourceContextLines, ClVerbose);
+  if (ClNumThreads > 1) {
+    symbolizeBatch(Opts, ClNumThreads);
+    return 0;
+  }
+
+  LLVMSymbolizer Symbolizer(Opts);
 
   const int kMaxInputStringLength = 1024;
   char InputString[kMaxInputStringLength];
@@ -181,24 +279,8 @@ int main(int argc, char **argv) {
       continue;
     }
 
-    if (ClPrintAddress) {
-      outs() << "0x";
-      outs().write_hex(ModuleOffset);
-      StringRef Delimiter = (ClPrettyPrint == true) ? ": " : "\n";
-      outs() << Delimiter;
-    }
-    if (IsData) {
-      auto ResOrErr = Symbolizer.symbolizeData(ModuleName, ModuleOffset);
-      Printer << (error(ResOrErr) ? DIGlobal() : ResOrErr.get());
-    } else if (ClPrintInlining) {
-      auto ResOrErr = Symbolizer.symbolizeInlinedCode(ModuleName, ModuleOffset);
-      Printer << (error(ResOrErr) ? DIInliningInfo()
-                                             : ResOrErr.get());
-    } else {
-      auto ResOrErr = Symbolizer.symbolizeCode(ModuleName, ModuleOffset);
-      Printer << (error(ResOrErr) ? DILineInfo() : ResOrErr.get());
-    }
-    outs() << "\n";
+    symbolizeInput(Symbolizer, IsData, ModuleName, ModuleOffset, outs(),
+                   errs());
     outs().flush();
   }
 
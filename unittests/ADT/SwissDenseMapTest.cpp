@@ -0,0 +1,133 @@
+//===- llvm/unittest/ADT/SwissDenseMapTest.cpp - SwissDenseMap tests ------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/SwissDenseMap.h"
+#include "gtest/gtest.h"
+#include <map>
+#include <memory>
+#include <string>
+
+using namespace llvm;
+
+namespace {
+
+TEST(SwissDenseMapTest, EmptyMap) {
+  SwissDenseMap<unsigned, unsigned> Map;
+  EXPECT_TRUE(Map.empty());
+  EXPECT_EQ(0u, Map.size());
+  EXPECT_TRUE(Map.begin() == Map.end());
+  EXPECT_TRUE(Map.find(1) == Map.end());
+  EXPECT_EQ(0u, Map.count(1));
+  EXPECT_EQ(0u, Map.lookup(1));
+  EXPECT_FALSE(Map.erase(1));
+}
+
+TEST(SwissDenseMapTest, InsertFindErase) {
+  SwissDenseMap<unsigned, unsigned> Map;
+  auto R = Map.insert(std::make_pair(1u, 2u));
+  EXPECT_TRUE(R.second);
+  EXPECT_EQ(1u, R.first->first);
+  EXPECT_EQ(2u, R.first->second);
+
+  // A second insert of the same key does not update the value.
+  R = Map.insert(std::make_pair(1u, 3u));
+  EXPECT_FALSE(R.second);
+  EXPECT_EQ(2u, R.first->second);
+  EXPECT_EQ(1u, Map.size());
+
+  Map[1] = 4;
+  EXPECT_EQ(4u, Map.lookup(1));
+  EXPECT_EQ(0u, Map[5]);
+  EXPECT_EQ(2u, Map.size());
+
+  EXPECT_TRUE(Map.erase(1));
+  EXPECT_EQ(0u, Map.count(1));
+  Map.erase(Map.find(5));
+  EXPECT_TRUE(Map.empty());
+}
+
+// Insert, erase and reinsert enough keys to force several rehashes and to
+// leave tombstones around, checking the result against std::map.
+TEST(SwissDenseMapTest, MatchesStdMap) {
+  SwissDenseMap<int *, unsigned> Map;
+  std::map<int *, unsigned> Ref;
+  int Storage[4096];
+
+  for (unsigned I = 0; I != 4096; ++I) {
+    Map[&Storage[I]] = I;
+    Ref[&Storage[I]] = I;
+  }
+  for (unsigned I = 0; I < 4096; I += 3) {
+    EXPECT_TRUE(Map.erase(&Storage[I]));
+    Ref.erase(&Storage[I]);
+  }
+  for (unsigned I = 0; I < 4096; I += 6) {
+    Map.try_emplace(&Storage[I], I + 1);
+    Ref.insert(std::make_pair(&Storage[I], I + 1));
+  }
+
+  EXPECT_EQ(Ref.size(), Map.size());
+  for (auto &KV : Ref) {
+    auto It = Map.find(KV.first);
+    ASSERT_TRUE(It != Map.end());
+    EXPECT_EQ(KV.second, It->second);
+  }
+
+  unsigned Visited = 0;
+  for (auto KV : Map) {
+    EXPECT_EQ(Ref[KV.first], KV.second);
+    ++Visited;
+  }
+  EXPECT_EQ(Ref.size(), Visited);
+}
+
+TEST(SwissDenseMapTest, CopyMoveAndSwap) {
+  SwissDenseMap<unsigned, std::string> Map;
+  for (unsigned I = 0; I != 100; ++I)
+    Map[I] = std::to_string(I);
+
+  SwissDenseMap<unsigned, std::string> Copy(Map);
+  EXPECT_EQ(100u, Copy.size());
+  EXPECT_EQ("42", Copy.lookup(42));
+
+  SwissDenseMap<unsigned, std::string> Moved(std::move(Copy));
+  EXPECT_TRUE(Copy.empty());
+  EXPECT_EQ("99", Moved.lookup(99));
+
+  SwissDenseMap<unsigned, std::string> Other;
+  Other[1000] = "x";
+  Other.swap(Moved);
+  EXPECT_EQ(1u, Moved.size());
+  EXPECT_EQ(100u, Other.size());
+
+  Map.clear();
+  EXPECT_TRUE(Map.empty());
+  EXPECT_TRUE(Map.begin() == Map.end());
+  Map[7] = "7";
+  EXPECT_EQ("7", Map.lookup(7));
+}
+
+TEST(SwissDenseMapTest, MoveOnlyValues) {
+  SwissDenseMap<unsigned, std::unique_ptr<unsigned>> Map;
+  for (unsigned I = 0; I != 64; ++I)
+    Map.try_emplace(I, new unsigned(I));
+  for (unsigned I = 0; I != 64; ++I)
+    EXPECT_EQ(I, *Map.find(I)->second);
+}
+
+TEST(SwissDenseMapTest, Reserve) {
+  SwissDenseMap<unsigned, unsigned> Map;
+  Map.reserve(1000);
+  size_t MemorySize = Map.getMemorySize();
+  for (unsigned I = 0; I != 1000; ++I)
+    Map[I] = I;
+  EXPECT_EQ(MemorySize, Map.getMemorySize());
+}
+
+} // end anonymous namespace
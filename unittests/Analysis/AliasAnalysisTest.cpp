@@ -205,6 +205,36 @@ TEST_F(AliasAnalysisTest, getModRefInfo) {
   EXPECT_EQ(AA.getModRefInfo(AtomicRMW), MRI_ModRef);
 }
 
+TEST_F(AliasAnalysisTest, BatchAAResults) {
+  FunctionType *FTy =
+      FunctionType::get(Type::getVoidTy(C), std::vector<Type *>(), false);
+  auto *F = cast<Function>(M.getOrInsertFunction("g", FTy));
+  auto *BB = BasicBlock::Create(C, "entry", F);
+  auto IntType = Type::getInt32Ty(C);
+  auto *Value = ConstantInt::get(IntType, 42);
+  auto *A1 = new AllocaInst(IntType, 0, "a1", BB);
+  auto *A2 = new AllocaInst(IntType, 0, "a2", BB);
+  auto *Store1 = new StoreInst(Value, A1, BB);
+  ReturnInst::Create(C, nullptr, BB);
+
+  auto &AA = getAAResults(*F);
+  BatchAAResults BatchAA(AA);
+  MemoryLocation Loc1(A1, 4), Loc2(A2, 4);
+
+  // The cached answers match the uncached ones, in either query order.
+  for (unsigned I = 0; I != 2; ++I) {
+    EXPECT_EQ(AA.alias(Loc1, Loc2), BatchAA.alias(Loc1, Loc2));
+    EXPECT_EQ(AA.alias(Loc2, Loc1), BatchAA.alias(Loc2, Loc1));
+    EXPECT_EQ(MustAlias, BatchAA.alias(Loc1, Loc1));
+    EXPECT_TRUE(BatchAA.isNoAlias(Loc1, Loc2));
+    EXPECT_EQ(MRI_Mod, BatchAA.getModRefInfo(Store1, Loc1));
+    EXPECT_EQ(MRI_NoModRef, BatchAA.getModRefInfo(Store1, Loc2));
+  }
+
+  BatchAA.clear();
+  EXPECT_EQ(NoAlias, BatchAA.alias(Loc1, Loc2));
+}
+
 class AAPassInfraTest : public testing::Test {
 protected:
   LLVMContext C;
@@ -930,5 +930,60 @@ TEST_F(ScalarEvolutionsTest, SCEVZeroExtendExprNonIntegral) {
   EXPECT_FALSE(verifyFunction(*F, &errs()));
 }
 
+// Forgetting a value must drop exactly the backedge-taken counts that use
+// it, including through the reverse map from expressions to loops.
+TEST_F(ScalarEvolutionsTest, ForgetValueDropsDependentBECounts) {
+  LLVMContext C;
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M = parseAssemblyString(
+      "define void @f(i32 %n, i32 %m) { "
+      "entry: "
+      "  %limit = add nuw i32 %n, 1 "
+      "  br label %loop.a "
+      "loop.a: "
+      "  %a = phi i32 [ 0, %entry ], [ %a.inc, %loop.a ] "
+      "  %a.inc = add nuw i32 %a, 1 "
+      "  %a.cmp = icmp ult i32 %a.inc, %limit "
+      "  br i1 %a.cmp, label %loop.a, label %loop.b.ph "
+      "loop.b.ph: "
+      "  br label %loop.b "
+      "loop.b: "
+      "  %b = phi i32 [ 0, %loop.b.ph ], [ %b.inc, %loop.b ] "
+      "  %b.inc = add nuw i32 %b, 1 "
+      "  %b.cmp = icmp ult i32 %b.inc, %m "
+      "  br i1 %b.cmp, label %loop.b, label %exit "
+      "exit: "
+      "  ret void "
+      "} ",
+      Err, C);
+
+  ASSERT_TRUE(M && "Could not parse module?");
+
+  runWithSE(*M, "f", [&](Function &F, LoopInfo &LI, ScalarEvolution &SE) {
+    auto *Limit = cast<BinaryOperator>(&*F.getEntryBlock().begin());
+    Loop *LoopA =
+        LI.getLoopFor(cast<BranchInst>(Limit->getNextNode())->getSuccessor(0));
+    Loop *LoopB = nullptr;
+    for (Loop *L : LI)
+      if (L != LoopA)
+        LoopB = L;
+    ASSERT_TRUE(LoopA && LoopB);
+
+    const SCEV *BTCA = SE.getBackedgeTakenCount(LoopA);
+    const SCEV *BTCB = SE.getBackedgeTakenCount(LoopB);
+    ASSERT_FALSE(isa<SCEVCouldNotCompute>(BTCA));
+    ASSERT_FALSE(isa<SCEVCouldNotCompute>(BTCB));
+
+    // Change the limit of the first loop and tell SCEV about it.
+    Limit->setOperand(1, ConstantInt::get(Limit->getType(), 2));
+    SE.forgetValue(Limit);
+
+    const SCEV *NewBTCA = SE.getBackedgeTakenCount(LoopA);
+    EXPECT_FALSE(isa<SCEVCouldNotCompute>(NewBTCA));
+    EXPECT_NE(BTCA, NewBTCA);
+    EXPECT_EQ(BTCB, SE.getBackedgeTakenCount(LoopB));
+  });
+}
+
 }  // end anonymous namespace
 }  // end namespace llvm
@@ -258,3 +258,50 @@ TEST(ValueTracking, ComputeNumSignBits_PR32045) {
       cast<ReturnInst>(F->getEntryBlock().getTerminator())->getOperand(0);
   EXPECT_EQ(ComputeNumSignBits(RVal, M->getDataLayout()), 1u);
 }
+
+TEST(ValueTracking, QueryCache) {
+  StringRef Assembly = "define i32 @f(i32 %a) { "
+                       "  %and = and i32 %a, 255 "
+                       "  %shl = shl i32 %and, 4 "
+                       "  ret i32 %shl "
+                       "} ";
+
+  LLVMContext Context;
+  SMDiagnostic Error;
+  auto M = parseAssemblyString(Assembly, Error, Context);
+  assert(M && "Bad assembly?");
+
+  auto *F = M->getFunction("f");
+  assert(F && "Bad assembly?");
+  const DataLayout &DL = M->getDataLayout();
+
+  auto *Shl = cast<Instruction>(
+      cast<ReturnInst>(F->getEntryBlock().getTerminator())->getOperand(0));
+  auto *And = cast<Instruction>(Shl->getOperand(0));
+
+  ValueTrackingCache VTC;
+  KnownBits Known =
+      computeKnownBits(Shl, DL, 0, nullptr, nullptr, nullptr, nullptr, &VTC);
+  EXPECT_EQ(0xFFFFF00Fu, Known.Zero.getZExtValue());
+  EXPECT_EQ(20u, ComputeNumSignBits(Shl, DL, 0, nullptr, nullptr, nullptr,
+                                    &VTC));
+  EXPECT_FALSE(isKnownNonZero(Shl, DL, 0, nullptr, nullptr, nullptr, &VTC));
+  EXPECT_FALSE(VTC.empty());
+
+  // Results are keyed on the value, so a hit returns the same answer.
+  KnownBits Cached =
+      computeKnownBits(Shl, DL, 0, nullptr, nullptr, nullptr, nullptr, &VTC);
+  EXPECT_EQ(Known.Zero, Cached.Zero);
+  EXPECT_EQ(Known.One, Cached.One);
+
+  // Replacing the value drops its entries.
+  Shl->replaceAllUsesWith(And);
+  EXPECT_TRUE(VTC.empty());
+
+  // Deleting a value drops its entries.  The return now uses And, so Shl is
+  // the one that can go.
+  computeKnownBits(Shl, DL, 0, nullptr, nullptr, nullptr, nullptr, &VTC);
+  EXPECT_FALSE(VTC.empty());
+  Shl->eraseFromParent();
+  EXPECT_TRUE(VTC.empty());
+}
@@ -9,7 +9,9 @@
 
 #include "llvm/IR/User.h"
 #include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/Constants.h"
 #include "llvm/IR/Function.h"
+#include "llvm/IR/FunctionArena.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
@@ -142,4 +144,48 @@ TEST(UserTest, PersonalityUser) {
   EXPECT_TRUE(TestF->user_empty());
 }
 
+TEST(UserTest, ArenaAllocatedInstructions) {
+  LLVMContext Context;
+  Type *Int32Ty = Type::getInt32Ty(Context);
+  Value *One = ConstantInt::get(Int32Ty, 1);
+
+  // The arena outlives its owner until the last instruction is freed.
+  FunctionArena *Arena = new FunctionArena();
+  BinaryOperator *Add;
+  PHINode *PN;
+  CallInst *Call;
+  {
+    FunctionArena::Scope S(Arena);
+    Add = BinaryOperator::CreateAdd(One, One);
+    PN = PHINode::Create(Int32Ty, 2);
+    FunctionType *FTy = FunctionType::get(Int32Ty, {Int32Ty}, false);
+    Call = CallInst::Create(UndefValue::get(FTy->getPointerTo()), {Add},
+                            OperandBundleDef("deopt", One));
+    {
+      // A null scope puts instructions back on the heap.
+      FunctionArena::Scope Heap(nullptr);
+      delete BinaryOperator::CreateSub(One, One);
+    }
+  }
+  EXPECT_EQ(3u, Arena->getNumLiveObjects());
+  EXPECT_EQ(Add, Call->getArgOperand(0));
+  EXPECT_TRUE(Call->hasOperandBundles());
+
+  // Instructions created outside a scope do not use the arena.
+  BinaryOperator *Mul = BinaryOperator::CreateMul(Add, One);
+  EXPECT_EQ(3u, Arena->getNumLiveObjects());
+
+  // Growing the hung-off operands of a Phi reallocates them.
+  BasicBlock *BB = BasicBlock::Create(Context);
+  PN->addIncoming(Add, BB);
+  PN->addIncoming(Mul, BB);
+  delete PN;
+  delete Call;
+  delete Mul;
+  delete BB;
+  EXPECT_EQ(1u, Arena->getNumLiveObjects());
+  Arena->releaseOwner();
+  delete Add;
+}
+
 } // end anonymous namespace